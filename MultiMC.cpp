@@ -16,6 +16,8 @@
 #include "logic/auth/MojangAccountList.h"
 #include "logic/icons/IconList.h"
 #include "logic/LwjglVersionList.h"
+#include "logic/RunningInstanceList.h"
+#include "logic/assets/AssetObjectStore.h"
 #include "logic/minecraft/MinecraftVersionList.h"
 #include "logic/liteloader/LiteLoaderVersionList.h"
 
@@ -35,6 +37,7 @@
 
 #include "logic/tools/JProfiler.h"
 #include "logic/tools/JVisualVM.h"
+#include "logic/tools/JavaFlightRecorder.h"
 #include "logic/tools/MCEditTool.h"
 
 #include "pathutils.h"
@@ -46,6 +49,8 @@
 #include "logger/QsLogDest.h"
 
 #include "logic/trans/TranslationDownloader.h"
+#include "logic/StartupGraph.h"
+#include "logic/Trace.h"
 
 #ifdef Q_OS_WIN32
 #include <windows.h>
@@ -54,6 +59,25 @@ static const int APPDATA_BUFFER_SIZE = 1024;
 
 using namespace Util::Commandline;
 
+namespace
+{
+/// what the background phases of the startup read, and what they need to know for it
+struct StartupState
+{
+	QString language;
+	bool trackFTB = false;
+	QString ftbLauncherDataRoot;
+	QString ftbRoot;
+	QString iconsDir;
+
+	std::shared_ptr<QTranslator> qtTranslator;
+	std::shared_ptr<QTranslator> mmcTranslator;
+	QJsonDocument accounts;
+	QSet<FTBRecord> ftb;
+	QHash<QString, QImage> icons;
+};
+}
+
 MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, argv)
 {
 	setOrganizationName("MultiMC");
@@ -189,72 +213,163 @@ MultiMC::MultiMC(int &argc, char **argv, bool test_mode) : QApplication(argc, ar
 	QLOG_INFO() << "Application root path      : " << rootPath;
 	QLOG_INFO() << "Static data path           : " << staticDataPath;
 
-	// load settings
-	initGlobalSettings(test_mode);
+	// the parts of the startup and what they need. reading files happens in the background,
+	// the settings and everything that is a QObject stay on this thread.
+	auto state = std::make_shared<StartupState>();
+	m_startupTrace = std::make_shared<Trace>("Startup");
+	m_startup.reset(new StartupGraph(m_startupTrace));
+
+	m_startup->add("Settings", StartupGraph::MainThread, [this, state, test_mode]()
+	{
+		initGlobalSettings(test_mode);
+		QLocale locale(m_settings->get("Language").toString());
+		QLocale::setDefault(locale);
+		QLOG_INFO() << "Your language is" << locale.bcp47Name();
+		state->language = locale.bcp47Name();
+		state->trackFTB = m_settings->get("TrackFTBInstances").toBool();
+		state->ftbLauncherDataRoot = m_settings->get("FTBLauncherDataRoot").toString();
+		state->ftbRoot = m_settings->get("FTBRoot").toString();
+		state->iconsDir = m_settings->get("IconsDir").toString();
+	});
 
 	// load translations
-	initTranslations();
+	m_startup->add("Load translations", StartupGraph::Background, [this, state]()
+	{
+		state->qtTranslator = loadTranslator(
+			"qt_" + state->language, QLibraryInfo::location(QLibraryInfo::TranslationsPath));
+		state->mmcTranslator =
+			loadTranslator("mmc_" + state->language, staticDataPath + "/translations");
+	}, {"Settings"});
+	// the phases that build QObjects come after this one, their strings are translated
+	m_startup->add("Install translations", StartupGraph::MainThread, [this, state]()
+	{
+		m_qt_translator = installTranslation(state->qtTranslator, "Qt");
+		m_mmc_translator = installTranslation(state->mmcTranslator, "MMC");
+	}, {"Load translations"});
 
-	// initialize the updater
-	m_updateChecker.reset(new UpdateChecker());
+	// and accounts
+	m_startup->add("Read accounts", StartupGraph::Background, [state]()
+	{
+		state->accounts = MojangAccountList::readListFile("accounts.json");
+	}, {"Settings"});
+	m_startup->add("Accounts", StartupGraph::MainThread, [this, state]()
+	{
+		m_accounts.reset(new MojangAccountList(this));
+		QLOG_INFO() << "Loading accounts...";
+		m_accounts->setListFilePath("accounts.json", true);
+		m_accounts->loadDocument(state->accounts, "accounts.json");
+	}, {"Read accounts", "Install translations"});
 
-	// initialize the notification checker
-	m_notificationChecker.reset(new NotificationChecker());
+	// the FTB packs are looked for while the instance folder is read
+	m_startup->add("Discover FTB instances", StartupGraph::Background, [state]()
+	{
+		if (state->trackFTB)
+		{
+			state->ftb =
+				InstanceList::discoverFTBInstances(state->ftbLauncherDataRoot, state->ftbRoot);
+		}
+	}, {"Settings"});
 
-	// initialize the news checker
-	m_newsChecker.reset(new NewsChecker(BuildConfig.NEWS_RSS_URL));
+	// the images of the icons are decoded in the background, the icons are made here
+	m_startup->add("Read icons", StartupGraph::Background, [state]()
+	{
+		state->icons = IconList::readIcons(state->iconsDir);
+	}, {"Settings"});
+	m_startup->add("Icons", StartupGraph::MainThread, [this, state]()
+	{
+		m_icons.reset(new IconList(state->icons));
+		state->icons.clear();
+	}, {"Read icons", "Install translations"});
 
-	// initialize the status checker
-	m_statusChecker.reset(new StatusChecker());
+	m_startup->add("Checkers", StartupGraph::MainThread, [this]()
+	{
+		// initialize the updater
+		m_updateChecker.reset(new UpdateChecker());
 
-	m_translationChecker.reset(new TranslationDownloader());
+		// initialize the notification checker
+		m_notificationChecker.reset(new NotificationChecker());
 
-	// and instances
-	auto InstDirSetting = m_settings->getSetting("InstanceDir");
-	// instance path: check for problems with '!' in instance path and warn the user in the log
-	// and rememer that we have to show him a dialog when the gui starts (if it does so)
-	QString instDir = MMC->settings()->get("InstanceDir").toString();
-	QLOG_INFO() << "Instance path              : " << instDir;
-	if (checkProblemticPathJava(QDir(instDir)))
-	{
-		QLOG_WARN()
-			<< "Your instance path contains \'!\' and this is known to cause java problems";
-	}
-	m_instances.reset(new InstanceList(InstDirSetting->get().toString(), this));
-	QLOG_INFO() << "Loading Instances...";
-	m_instances->loadList();
-	connect(InstDirSetting.get(), SIGNAL(SettingChanged(const Setting &, QVariant)),
-			m_instances.get(), SLOT(on_InstFolderChanged(const Setting &, QVariant)));
+		// initialize the news checker
+		m_newsChecker.reset(new NewsChecker(BuildConfig.NEWS_RSS_URL));
 
-	// and accounts
-	m_accounts.reset(new MojangAccountList(this));
-	QLOG_INFO() << "Loading accounts...";
-	m_accounts->setListFilePath("accounts.json", true);
-	m_accounts->loadList();
+		// initialize the status checker
+		m_statusChecker.reset(new StatusChecker());
 
-	// init the http meta cache
-	initHttpMetaCache();
+		m_translationChecker.reset(new TranslationDownloader());
+	}, {"Install translations"});
 
-	// create the global network manager
-	m_qnam.reset(new QNetworkAccessManager(this));
+	m_startup->add("Network", StartupGraph::MainThread, [this]()
+	{
+		// init the http meta cache
+		initHttpMetaCache();
 
-	m_translationChecker->downloadTranslations();
+		// create the global network manager
+		m_qnam.reset(new QNetworkAccessManager(this));
 
-	// init proxy settings
-	updateProxySettings();
+		// init proxy settings
+		updateProxySettings();
+	}, {"Install translations"});
 
-	m_profilers.insert("jprofiler",
-					   std::shared_ptr<BaseProfilerFactory>(new JProfilerFactory()));
-	m_profilers.insert("jvisualvm",
-					   std::shared_ptr<BaseProfilerFactory>(new JVisualVMFactory()));
-	for (auto profiler : m_profilers.values())
+	// and instances
+	m_startup->add("Instances", StartupGraph::MainThread, [this, state]()
+	{
+		auto InstDirSetting = m_settings->getSetting("InstanceDir");
+		// instance path: check for problems with '!' in instance path and warn the user in the
+		// log and rememer that we have to show him a dialog when the gui starts (if it does so)
+		QString instDir = MMC->settings()->get("InstanceDir").toString();
+		QLOG_INFO() << "Instance path              : " << instDir;
+		if (checkProblemticPathJava(QDir(instDir)))
+		{
+			QLOG_WARN()
+				<< "Your instance path contains \'!\' and this is known to cause java problems";
+		}
+		m_instances.reset(new InstanceList(InstDirSetting->get().toString(), this));
+		QLOG_INFO() << "Loading Instances...";
+		if (state->trackFTB)
+		{
+			m_instances->setDiscoveredFTBInstances(state->ftb);
+		}
+		m_instances->loadList();
+		connect(InstDirSetting.get(), SIGNAL(SettingChanged(const Setting &, QVariant)),
+				m_instances.get(), SLOT(on_InstFolderChanged(const Setting &, QVariant)));
+	}, {"Icons", "Discover FTB instances"});
+
+	m_startup->add("Profilers and tools", StartupGraph::MainThread, [this]()
+	{
+		m_profilers.insert("jprofiler",
+						   std::shared_ptr<BaseProfilerFactory>(new JProfilerFactory()));
+		m_profilers.insert("jvisualvm",
+						   std::shared_ptr<BaseProfilerFactory>(new JVisualVMFactory()));
+		m_profilers.insert("jfr",
+						   std::shared_ptr<BaseProfilerFactory>(new JavaFlightRecorderFactory()));
+		for (auto profiler : m_profilers.values())
+		{
+			profiler->registerSettings(m_settings);
+		}
+		m_tools.insert("mcedit", std::shared_ptr<BaseDetachedToolFactory>(new MCEditFactory()));
+		for (auto tool : m_tools.values())
+		{
+			tool->registerSettings(m_settings);
+		}
+	}, {"Install translations"});
+
+	// not needed to show the main window, see finishStartup()
+	m_startup->add("Download translations", StartupGraph::MainThread, [this]()
 	{
-		profiler->registerSettings(m_settings);
+		m_translationChecker->downloadTranslations();
+	}, {"Checkers", "Network"});
+
+	if (!m_startup->run({"Install translations", "Accounts", "Checkers", "Network", "Instances",
+						 "Profilers and tools"}))
+	{
+		QLOG_FATAL() << "MultiMC failed to start.";
+		m_status = MultiMC::Failed;
+		return;
 	}
-	m_tools.insert("mcedit", std::shared_ptr<BaseDetachedToolFactory>(new MCEditFactory()));
-	for (auto tool : m_tools.values())
+	QLOG_INFO() << "Startup phases:";
+	for (auto line : m_startup->summary())
 	{
-		tool->registerSettings(m_settings);
+		QLOG_INFO() << "  " << line;
 	}
 
 	connect(this, SIGNAL(aboutToQuit()), SLOT(onExit()));
@@ -273,44 +388,59 @@ MultiMC::~MultiMC()
 	}
 }
 
-void MultiMC::initTranslations()
+std::shared_ptr<QTranslator> MultiMC::loadTranslator(const QString &name,
+													 const QString &directory)
 {
-	QLocale locale(m_settings->get("Language").toString());
-	QLocale::setDefault(locale);
-	QLOG_INFO() << "Your language is" << locale.bcp47Name();
-	m_qt_translator.reset(new QTranslator());
-	if (m_qt_translator->load("qt_" + locale.bcp47Name(),
-							  QLibraryInfo::location(QLibraryInfo::TranslationsPath)))
-	{
-		QLOG_DEBUG() << "Loading Qt Language File for"
-					 << locale.bcp47Name().toLocal8Bit().constData() << "...";
-		if (!installTranslator(m_qt_translator.get()))
-		{
-			QLOG_ERROR() << "Loading Qt Language File failed.";
-			m_qt_translator.reset();
-		}
+	std::shared_ptr<QTranslator> translator(new QTranslator());
+	if (!translator->load(name, directory))
+	{
+		return nullptr;
 	}
-	else
+	// loaded in the background, used by the GUI
+	translator->moveToThread(QCoreApplication::instance()->thread());
+	return translator;
+}
+
+std::shared_ptr<QTranslator> MultiMC::installTranslation(std::shared_ptr<QTranslator> translator,
+														 const QString &kind)
+{
+	if (!translator)
 	{
-		m_qt_translator.reset();
+		return nullptr;
 	}
+	QLOG_DEBUG() << "Loading" << kind << "Language File for"
+				 << QLocale().bcp47Name().toLocal8Bit().constData() << "...";
+	if (!installTranslator(translator.get()))
+	{
+		QLOG_ERROR() << "Loading" << kind << "Language File failed.";
+		return nullptr;
+	}
+	return translator;
+}
 
-	m_mmc_translator.reset(new QTranslator());
-	if (m_mmc_translator->load("mmc_" + locale.bcp47Name(),
-							   MMC->staticData() + "/translations"))
+void MultiMC::finishStartup()
+{
+	if (!m_startup)
 	{
-		QLOG_DEBUG() << "Loading MMC Language File for"
-					 << locale.bcp47Name().toLocal8Bit().constData() << "...";
-		if (!installTranslator(m_mmc_translator.get()))
-		{
-			QLOG_ERROR() << "Loading MMC Language File failed.";
-			m_mmc_translator.reset();
-		}
+		return;
 	}
-	else
+	QStringList before;
+	for (auto phase : m_startup->phases())
 	{
-		m_mmc_translator.reset();
+		if (m_startup->isDone(phase))
+			before.append(phase);
 	}
+	m_startup->run();
+	for (auto phase : m_startup->phases())
+	{
+		if (m_startup->isDone(phase) && !before.contains(phase))
+		{
+			QLOG_INFO() << "Startup phase" << phase << "took" << m_startup->duration(phase)
+						<< "ms";
+		}
+	}
+	m_startupTrace->save("startup-trace.json");
+	m_startup.reset();
 }
 
 void moveFile(const QString &oldName, const QString &newName)
@@ -350,6 +480,12 @@ void MultiMC::initGlobalSettings(bool test_mode)
 	// Minecraft Sneaky Updates
 	m_settings->registerSetting("AutoUpdateMinecraftVersions", true);
 
+	// Fully update and verify instances on every launch, even when nothing changed since the last
+	// update
+	m_settings->registerSetting("VerifyInstanceOnLaunch", false);
+	// Export the icon and rebuild the virtual assets even if their inputs didn't change
+	m_settings->registerSetting("RebuildLaunchArtifacts", false);
+
 	// Notifications
 	m_settings->registerSetting("ShownNotifications", QString());
 
@@ -513,12 +649,14 @@ void MultiMC::initGlobalSettings(bool test_mode)
 	m_settings->registerSetting({"MinMemAlloc", "MinMemoryAlloc"}, 512);
 	m_settings->registerSetting({"MaxMemAlloc", "MaxMemoryAlloc"}, 1024);
 	m_settings->registerSetting("PermGen", 128);
+	m_settings->registerSetting("AutoMemAlloc", false);
 
 	// Java Settings
 	m_settings->registerSetting("JavaPath", "");
 	m_settings->registerSetting("LastHostname", "");
 	m_settings->registerSetting("JavaDetectionHack", "");
 	m_settings->registerSetting("JvmArgs", "");
+	m_settings->registerSetting("UseClassDataSharing", false);
 
 	// Custom Commands
 	m_settings->registerSetting({"PreLaunchCommand", "PreLaunchCmd"}, "");
@@ -553,6 +691,7 @@ void MultiMC::initHttpMetaCache()
 	m_metacache->addBase("fmllibs", QDir("mods/minecraftforge/libs").absolutePath());
 	m_metacache->addBase("liteloader", QDir("mods/liteloader").absolutePath());
 	m_metacache->addBase("general", QDir("cache").absolutePath());
+	m_metacache->addBase("http", QDir("cache/http").absolutePath());
 	m_metacache->addBase("skins", QDir("accounts/skins").absolutePath());
 	m_metacache->addBase("root", QDir(root()).absolutePath());
 	m_metacache->addBase("translations", QDir(staticData() + "/translations").absolutePath());
@@ -684,6 +823,25 @@ std::shared_ptr<JavaVersionList> MultiMC::javalist()
 	return m_javalist;
 }
 
+std::shared_ptr<RunningInstanceList> MultiMC::runningInstances()
+{
+	if (!m_runningInstances)
+	{
+		m_runningInstances.reset(new RunningInstanceList());
+	}
+	return m_runningInstances;
+}
+
+std::shared_ptr<AssetObjectStore> MultiMC::assetStore()
+{
+	if (!m_assetStore)
+	{
+		m_assetStore.reset(new AssetObjectStore("assets/objects"));
+		m_assetStore->Load();
+	}
+	return m_assetStore;
+}
+
 void MultiMC::installUpdates(const QString updateFilesDir, UpdateFlags flags)
 {
 	// if we are going to update on exit, save the params now
@@ -742,6 +900,7 @@ void MultiMC::installUpdates(const QString updateFilesDir, UpdateFlags flags)
 
 void MultiMC::setIconTheme(const QString& name)
 {
+	XdgIcon::setThemeIndexCacheDir(QDir("cache/icons").absolutePath());
 	XdgIcon::setThemeName(name);
 }
 
@@ -25,6 +25,11 @@ class StatusChecker;
 class BaseProfilerFactory;
 class BaseDetachedToolFactory;
 class TranslationDownloader;
+class RunningInstanceList;
+class AssetObjectStore;
+class StartupGraph;
+class QTranslator;
+class Trace;
 
 #if defined(MMC)
 #undef MMC
@@ -56,6 +61,12 @@ public:
 	MultiMC(int &argc, char **argv, bool test_mode = false);
 	virtual ~MultiMC();
 
+	/*!
+	 * Runs what is left of the startup: the parts the main window doesn't need.
+	 * Call it once the main window is shown.
+	 */
+	void finishStartup();
+
 	std::shared_ptr<SettingsObject> settings()
 	{
 		return m_settings;
@@ -122,6 +133,10 @@ public:
 
 	std::shared_ptr<JavaVersionList> javalist();
 
+	std::shared_ptr<RunningInstanceList> runningInstances();
+
+	std::shared_ptr<AssetObjectStore> assetStore();
+
 	QMap<QString, std::shared_ptr<BaseProfilerFactory>> profilers()
 	{
 		return m_profilers;
@@ -185,7 +200,12 @@ private:
 
 	void initHttpMetaCache();
 
-	void initTranslations();
+	/// loads a translation file. safe to use on any thread.
+	static std::shared_ptr<QTranslator> loadTranslator(const QString &name,
+													   const QString &directory);
+	/// installs a translator made by loadTranslator(). returns it if it was installed.
+	std::shared_ptr<QTranslator> installTranslation(std::shared_ptr<QTranslator> translator,
+													const QString &kind);
 
 private:
 	friend class UpdateCheckerTest;
@@ -209,10 +229,16 @@ private:
 	std::shared_ptr<MinecraftVersionList> m_minecraftlist;
 	std::shared_ptr<JavaVersionList> m_javalist;
 	std::shared_ptr<TranslationDownloader> m_translationChecker;
+	std::shared_ptr<RunningInstanceList> m_runningInstances;
+	std::shared_ptr<AssetObjectStore> m_assetStore;
 
 	QMap<QString, std::shared_ptr<BaseProfilerFactory>> m_profilers;
 	QMap<QString, std::shared_ptr<BaseDetachedToolFactory>> m_tools;
 
+	/// the startup, until finishStartup() is done with it
+	std::unique_ptr<StartupGraph> m_startup;
+	std::shared_ptr<Trace> m_startupTrace;
+
 	QsLogging::DestinationPtr m_fileDestination;
 	QsLogging::DestinationPtr m_debugDestination;
 
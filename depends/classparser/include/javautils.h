@@ -16,6 +16,8 @@
  */
 #pragma once
 #include <QString>
+#include <QStringList>
+#include <QList>
 #include "classparser_config.h"
 
 #define MCVer_Unknown "Unknown"
@@ -25,5 +27,49 @@ namespace javautils
 /**
  * @brief Get the version from a minecraft.jar by parsing its class files. Expensive!
  */
-QString GetMinecraftJarVersion(QString jar);
+CLASSPARSER_EXPORT QString GetMinecraftJarVersion(QString jar);
+
+/// A class defined by a jar
+struct ClassEntry
+{
+	/// internal name, like net/minecraft/client/Minecraft
+	QString name;
+	/// empty for java/lang/Object
+	QString superName;
+	/// class file version, 52 is Java 8
+	int majorVersion = 0;
+	/// CRC-32 of the class file, from the jar's directory
+	quint32 crc = 0;
+	QString jar;
+};
+
+struct ClassIndex
+{
+	/// all the classes, grouped by jar in the order the jars were given
+	QList<ClassEntry> classes;
+	/// what couldn't be read, one line per jar or class file
+	QStringList errors;
+};
+
+/**
+ * @brief Reads the classes of all the jars, a few jars at a time on the global thread pool.
+ *
+ * Only the head of each class file is parsed, in place.
+ */
+CLASSPARSER_EXPORT ClassIndex IndexJarClasses(const QStringList &jars);
+
+/// A class defined by more than one jar
+struct ClassConflict
+{
+	QString name;
+	/// the jars defining it, in index order
+	QStringList jars;
+	/// false if all the copies have the same CRC, so it doesn't matter which one is loaded
+	bool differs = false;
+};
+
+/**
+ * @brief Finds the classes defined more than once in the index.
+ */
+CLASSPARSER_EXPORT QList<ClassConflict> FindClassConflicts(const ClassIndex &index);
 }
@@ -0,0 +1,279 @@
+#pragma once
+#include <stdint.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "errors.h"
+
+namespace util
+{
+/**
+ * Big endian reads from a buffer owned by somebody else.
+ * Reading past the end throws java::classfile_exception.
+ */
+class bounded_reader
+{
+public:
+	bounded_reader(const char *buffer, std::size_t size)
+	{
+		current = start = buffer;
+		end = start + size;
+	}
+	uint8_t u1()
+	{
+		require(1);
+		return uint8_t(*current++);
+	}
+	uint16_t u2()
+	{
+		require(2);
+		uint16_t val = (uint8_t(current[0]) << 8) | uint8_t(current[1]);
+		current += 2;
+		return val;
+	}
+	uint32_t u4()
+	{
+		require(4);
+		uint32_t val = (uint32_t(uint8_t(current[0])) << 24) | (uint8_t(current[1]) << 16) |
+					   (uint8_t(current[2]) << 8) | uint8_t(current[3]);
+		current += 4;
+		return val;
+	}
+	void skip(std::size_t N)
+	{
+		require(N);
+		current += N;
+	}
+	std::size_t offset() const
+	{
+		return current - start;
+	}
+
+private:
+	void require(std::size_t N)
+	{
+		if (std::size_t(end - current) < N)
+			throw java::classfile_exception();
+	}
+	const char *start, *end, *current;
+};
+}
+
+namespace java
+{
+/**
+ * The constant pool of a class file, read in place.
+ *
+ * Only the tag and the position of each constant are recorded. Strings stay in the buffer in
+ * their 'modified UTF-8' until somebody asks for them, so the buffer must outlive the view.
+ */
+class constant_pool_view
+{
+public:
+	enum tag_t : uint8_t
+	{
+		t_hole = 0, // the second slot of a long or double
+		t_utf8 = 1,
+		t_int = 3,
+		t_float = 4,
+		t_long = 5,
+		t_double = 6,
+		t_class = 7,
+		t_string = 8,
+		t_fieldref = 9,
+		t_methodref = 10,
+		t_interface_methodref = 11,
+		t_nameandtype = 12,
+		t_methodhandle = 15,
+		t_methodtype = 16,
+		t_dynamic = 17,
+		t_invokedynamic = 18,
+		t_module = 19,
+		t_package = 20
+	};
+
+	void load(const char *data, util::bounded_reader &reader)
+	{
+		m_data = data;
+		uint16_t count = reader.u2();
+		if (count == 0)
+			throw classfile_exception();
+		m_entries.clear();
+		m_entries.reserve(count);
+		// index 0 is never used
+		m_entries.push_back(entry{t_hole, 0});
+		while (m_entries.size() < count)
+		{
+			uint8_t tag = reader.u1();
+			m_entries.push_back(entry{tag, uint32_t(reader.offset())});
+			switch (tag)
+			{
+			case t_utf8:
+				reader.skip(reader.u2());
+				break;
+			case t_int:
+			case t_float:
+			case t_fieldref:
+			case t_methodref:
+			case t_interface_methodref:
+			case t_nameandtype:
+			case t_dynamic:
+			case t_invokedynamic:
+				reader.skip(4);
+				break;
+			case t_long:
+			case t_double:
+				reader.skip(8);
+				// these take two slots, because java is crazy
+				if (m_entries.size() == count)
+					throw classfile_exception();
+				m_entries.push_back(entry{t_hole, 0});
+				break;
+			case t_class:
+			case t_string:
+			case t_methodtype:
+			case t_module:
+			case t_package:
+				reader.skip(2);
+				break;
+			case t_methodhandle:
+				reader.skip(3);
+				break;
+			default:
+				throw classfile_exception();
+			}
+		}
+	}
+
+	/// number of slots, including the unused slot 0
+	std::size_t size() const
+	{
+		return m_entries.size();
+	}
+	uint8_t tag(std::size_t index) const
+	{
+		if (index >= m_entries.size())
+			throw classfile_exception();
+		return m_entries[index].tag;
+	}
+
+	/// the raw bytes of a UTF-8 constant, still in modified UTF-8
+	const char *utf8_raw(std::size_t index, uint16_t &length) const
+	{
+		const char *at = data_of(index, t_utf8);
+		length = (uint8_t(at[0]) << 8) | uint8_t(at[1]);
+		return at + 2;
+	}
+	bool utf8_starts_with(std::size_t index, const char *prefix) const
+	{
+		uint16_t length;
+		const char *raw = utf8_raw(index, length);
+		std::size_t prefix_length = strlen(prefix);
+		return length >= prefix_length && memcmp(raw, prefix, prefix_length) == 0;
+	}
+	/// a UTF-8 constant, decoded to standard UTF-8
+	std::string utf8(std::size_t index) const
+	{
+		uint16_t length;
+		const char *raw = utf8_raw(index, length);
+		return decode_modified_utf8(raw, length);
+	}
+	/// the internal name of a class constant, like java/lang/Object
+	std::string class_name(std::size_t index) const
+	{
+		const char *at = data_of(index, t_class);
+		return utf8((uint8_t(at[0]) << 8) | uint8_t(at[1]));
+	}
+
+	/**
+	 * Java writes U+0000 as 0xC0 0x80 and characters outside the BMP as two encoded
+	 * surrogates (like CESU-8). Everything else is already standard UTF-8.
+	 */
+	static std::string decode_modified_utf8(const char *raw, std::size_t length)
+	{
+		std::string out;
+		out.reserve(length);
+		const uint8_t *in = (const uint8_t *)raw;
+		for (std::size_t i = 0; i < length; i++)
+		{
+			if (in[i] == 0xC0 && i + 1 < length && in[i + 1] == 0x80)
+			{
+				out.push_back('\0');
+				i++;
+			}
+			else if (in[i] == 0xED && i + 5 < length && (in[i + 1] & 0xF0) == 0xA0 &&
+					 in[i + 3] == 0xED && (in[i + 4] & 0xF0) == 0xB0)
+			{
+				uint32_t high = ((in[i + 1] & 0x0F) << 6) | (in[i + 2] & 0x3F);
+				uint32_t low = ((in[i + 4] & 0x0F) << 6) | (in[i + 5] & 0x3F);
+				uint32_t code = 0x10000 + (high << 10) + low;
+				out.push_back(char(0xF0 | (code >> 18)));
+				out.push_back(char(0x80 | ((code >> 12) & 0x3F)));
+				out.push_back(char(0x80 | ((code >> 6) & 0x3F)));
+				out.push_back(char(0x80 | (code & 0x3F)));
+				i += 5;
+			}
+			else
+			{
+				out.push_back(char(in[i]));
+			}
+		}
+		return out;
+	}
+
+private:
+	struct entry
+	{
+		uint8_t tag;
+		// where the data after the tag starts
+		uint32_t offset;
+	};
+	const char *data_of(std::size_t index, uint8_t expected) const
+	{
+		if (index == 0 || tag(index) != expected)
+			throw classfile_exception();
+		return m_data + m_entries[index].offset;
+	}
+
+	const char *m_data = nullptr;
+	std::vector<entry> m_entries;
+};
+
+/**
+ * The head of a class file: versions, constant pool and the class it defines.
+ *
+ * Nothing is copied out of the buffer. Fields, methods and attributes aren't read.
+ */
+class classfile_view
+{
+public:
+	classfile_view(const char *data, std::size_t size)
+	{
+		util::bounded_reader reader(data, size);
+		if (reader.u4() != 0xCAFEBABE)
+			throw classfile_exception();
+		minor_version = reader.u2();
+		major_version = reader.u2();
+		constants.load(data, reader);
+		access_flags = reader.u2();
+		this_class = reader.u2();
+		super_class = reader.u2();
+	}
+	std::string name() const
+	{
+		return constants.class_name(this_class);
+	}
+	/// empty for java/lang/Object and module-info
+	std::string super_name() const
+	{
+		return super_class ? constants.class_name(super_class) : std::string();
+	}
+
+	uint16_t minor_version;
+	uint16_t major_version;
+	constant_pool_view constants;
+	uint16_t access_flags;
+	uint16_t this_class;
+	uint16_t super_class;
+};
+}
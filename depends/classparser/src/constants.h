@@ -28,7 +28,7 @@ public:
 		buf.read(type);
 		// invalid constant type!
 		if (type > j_nameandtype || type == (type_t)0 || type == (type_t)2)
-			throw new classfile_exception();
+			throw classfile_exception();
 
 		// load data depending on type
 		switch (type)
@@ -199,7 +199,7 @@ public:
 	{
 		if (constant_index == 0 || constant_index > constants.size())
 		{
-			throw new classfile_exception();
+			throw classfile_exception();
 		}
 		return constants[constant_index - 1];
 	}
@@ -14,10 +14,12 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include "classfile.h"
+#include "classview.h"
 #include "javautils.h"
 
 #include <QFile>
+#include <QHash>
+#include <QtConcurrentMap>
 #include <quazipfile.h>
 
 namespace javautils
@@ -44,26 +46,20 @@ QString GetMinecraftJarVersion(QString jarName)
 		return version;
 
 	// read Minecraft.class
-	qint64 size = Minecraft.size();
-	char *classfile = new char[size];
-	Minecraft.read(classfile, size);
+	QByteArray classfile = Minecraft.readAll();
 
-	// parse Minecraft.class
+	// look for the version string, without decoding all the others
 	try
 	{
-		char *temp = classfile;
-		java::classfile MinecraftClass(temp, size);
-		java::constant_pool constants = MinecraftClass.constants;
-		for (java::constant_pool::container_type::const_iterator iter = constants.begin();
-			 iter != constants.end(); iter++)
+		java::classfile_view MinecraftClass(classfile.constData(), classfile.size());
+		auto &constants = MinecraftClass.constants;
+		for (std::size_t i = 1; i < constants.size(); i++)
 		{
-			const java::constant &constant = *iter;
-			if (constant.type != java::constant::j_string_data)
+			if (constants.tag(i) != java::constant_pool_view::t_utf8)
 				continue;
-			const std::string &str = constant.str_data;
-			if (str.compare(0, 20, "Minecraft Minecraft ") == 0)
+			if (constants.utf8_starts_with(i, "Minecraft Minecraft "))
 			{
-				version = str.substr(20).data();
+				version = QString::fromStdString(constants.utf8(i).substr(20));
 				break;
 			}
 		}
@@ -73,11 +69,103 @@ QString GetMinecraftJarVersion(QString jarName)
 	}
 
 	// clean up
-	delete[] classfile;
 	Minecraft.close();
 	zip.close();
 	jar.close();
 
 	return version;
 }
+
+static ClassIndex indexJar(const QString &jarName)
+{
+	ClassIndex index;
+	QuaZip zip(jarName);
+	if (!zip.open(QuaZip::mdUnzip))
+	{
+		index.errors.append(QString("%1: can't open the jar (error %2)")
+								.arg(jarName)
+								.arg(zip.getZipError()));
+		return index;
+	}
+	QuaZipFile entry(&zip);
+	for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile())
+	{
+		QuaZipFileInfo64 info;
+		if (!zip.getCurrentFileInfo(&info) || !info.name.endsWith(".class"))
+			continue;
+		if (!entry.open(QIODevice::ReadOnly))
+		{
+			index.errors.append(QString("%1: can't read %2").arg(jarName, info.name));
+			continue;
+		}
+		QByteArray data = entry.readAll();
+		entry.close();
+		try
+		{
+			java::classfile_view classfile(data.constData(), data.size());
+			ClassEntry found;
+			found.name = QString::fromStdString(classfile.name());
+			found.superName = QString::fromStdString(classfile.super_name());
+			found.majorVersion = classfile.major_version;
+			found.crc = info.crc;
+			found.jar = jarName;
+			index.classes.append(found);
+		}
+		catch (java::classfile_exception &)
+		{
+			index.errors.append(QString("%1: %2 is not a valid class file").arg(jarName, info.name));
+		}
+	}
+	zip.close();
+	return index;
+}
+
+ClassIndex IndexJarClasses(const QStringList &jars)
+{
+	// one task per jar. the jars in a mod folder are many and small enough to balance out
+	QList<ClassIndex> parts = QtConcurrent::blockingMapped(jars, &indexJar);
+	ClassIndex index;
+	for (auto &part : parts)
+	{
+		index.classes.append(part.classes);
+		index.errors.append(part.errors);
+	}
+	return index;
+}
+
+QList<ClassConflict> FindClassConflicts(const ClassIndex &index)
+{
+	QHash<QString, int> first;
+	first.reserve(index.classes.size());
+	QHash<QString, int> conflictIndex;
+	QList<ClassConflict> conflicts;
+	for (int i = 0; i < index.classes.size(); i++)
+	{
+		auto &entry = index.classes[i];
+		auto iter = first.find(entry.name);
+		if (iter == first.end())
+		{
+			first.insert(entry.name, i);
+			continue;
+		}
+		auto &original = index.classes[iter.value()];
+		// the same jar listing a class twice isn't a conflict between jars
+		if (original.jar == entry.jar)
+			continue;
+		auto known = conflictIndex.find(entry.name);
+		if (known == conflictIndex.end())
+		{
+			ClassConflict conflict;
+			conflict.name = entry.name;
+			conflict.jars.append(original.jar);
+			known = conflictIndex.insert(entry.name, conflicts.size());
+			conflicts.append(conflict);
+		}
+		auto &conflict = conflicts[known.value()];
+		if (!conflict.jars.contains(entry.jar))
+			conflict.jars.append(entry.jar);
+		conflict.differs |= entry.crc != original.crc;
+	}
+	return conflicts;
+}
 }
@@ -1,9 +1,11 @@
 #pragma once
 #include <stdint.h>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <exception>
 #include "javaendian.h"
+#include "errors.h"
 
 namespace util
 {
@@ -25,7 +27,8 @@ public:
 		*/
 	template <class T> void read(T &val)
 	{
-		val = *(T *)current;
+		require(sizeof(T));
+		memcpy(&val, current, sizeof(T));
 		current += sizeof(T);
 	}
 	/**
@@ -34,8 +37,8 @@ public:
 		*/
 	template <class T> void read_be(T &val)
 	{
-		val = util::bigswap(*(T *)current);
-		current += sizeof(T);
+		read(val);
+		val = util::bigswap(val);
 	}
 	/**
 		* Read a string in the format:
@@ -46,6 +49,7 @@ public:
 	{
 		uint16_t length = 0;
 		read_be(length);
+		require(length);
 		str.append(current, length);
 		current += length;
 	}
@@ -54,10 +58,18 @@ public:
 		*/
 	void skip(std::size_t N)
 	{
+		require(N);
 		current += N;
 	}
 
 private:
+	// the class files come from mods, don't trust them
+	void require(std::size_t N)
+	{
+		if (std::size_t(end - current) < N)
+			throw java::classfile_exception();
+	}
+
 	char *start, *end, *current;
 };
 }
@@ -40,6 +40,10 @@
 #include <QtCore/QHash>
 #include <QtCore/QDir>
 #include <QtCore/QSettings>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
 #include <QtGui/QPainter>
 #include <QApplication>
 #include <QLatin1Literal>
@@ -58,7 +62,8 @@ static QString fallbackTheme()
 	return QString("hicolor");
 }
 
-QIconLoader::QIconLoader() : m_themeKey(1), m_supportsSvg(false), m_initialized(false)
+QIconLoader::QIconLoader()
+	: m_themeKey(1), m_supportsSvg(false), m_initialized(false), m_useThemeIndex(true)
 {
 }
 
@@ -130,6 +135,13 @@ void QIconLoader::setThemeSearchPath(const QStringList &searchPaths)
 	invalidateKey();
 }
 
+void QIconLoader::setUseThemeIndex(bool use)
+{
+	m_useThemeIndex = use;
+	themeList.clear();
+	invalidateKey();
+}
+
 QStringList QIconLoader::themeSearchPaths() const
 {
 	if (m_iconDirs.isEmpty())
@@ -139,6 +151,195 @@ QStringList QIconLoader::themeSearchPaths() const
 	return m_iconDirs;
 }
 
+// -------- Icon Theme Index -------- //
+
+static const quint32 themeIndexMagic = 0x51495849;
+static const quint32 themeIndexVersion = 1;
+
+QSharedPointer<QIconThemeIndex> QIconThemeIndex::create(const QString &themeName,
+														 const QStringList &contentDirs,
+														 const QVector<QIconDirInfo> &subDirs,
+														 const QString &cacheDir)
+{
+	QSharedPointer<QIconThemeIndex> index(new QIconThemeIndex);
+	index->m_contentDirs = contentDirs;
+	for (int i = 0; i < subDirs.size(); ++i)
+		index->m_subDirs.append(subDirs.at(i).path);
+	index->m_lastCheck.start();
+
+	// resources have no modification times, an index of them would never be rebuilt when
+	// they change with a new build. They are quick to read anyway.
+	bool inResources = false;
+	foreach (const QString &contentDir, contentDirs)
+		inResources |= contentDir.startsWith(QLatin1Char(':'));
+
+	QString cacheFile;
+	if (!cacheDir.isEmpty() && !inResources)
+	{
+		const uint hash = qHash(contentDirs.join(QLatin1Char('\n')) + QLatin1Char('\n') +
+								index->m_subDirs.join(QLatin1Char('\n')));
+		cacheFile = QString("%1/%2-%3.index").arg(cacheDir, themeName, QString::number(hash, 16));
+		if (index->load(cacheFile))
+			return index;
+	}
+	index->build();
+	if (!cacheFile.isEmpty())
+		index->save(cacheFile);
+	return index;
+}
+
+bool QIconThemeIndex::lacks(const QString &iconName) const
+{
+	return !m_icons.contains(iconName);
+}
+
+int QIconThemeIndex::formats(const QString &iconName, int subDir, int contentDir) const
+{
+	const QVector<Location> locations = m_icons.value(iconName);
+	for (int i = 0; i < locations.size(); ++i)
+	{
+		const Location &location = locations.at(i);
+		if (location.subDir == subDir && location.contentDir == contentDir)
+			return location.formats;
+	}
+	return 0;
+}
+
+bool QIconThemeIndex::isStale() const
+{
+	if (m_lastCheck.isValid() && m_lastCheck.elapsed() < 1000)
+		return false;
+	m_lastCheck.start();
+	return stamps(false) != m_stamps.mid(0, m_contentDirs.size());
+}
+
+QVector<qint64> QIconThemeIndex::stamps(bool all) const
+{
+	QVector<qint64> out;
+	const auto stamp = [](const QString &path) -> qint64
+	{
+		const QFileInfo info(path);
+		if (!info.exists())
+			return -1;
+		// resources have no modification time
+		const QDateTime modified = info.lastModified();
+		return modified.isValid() ? modified.toMSecsSinceEpoch() : 0;
+	};
+	foreach (const QString &contentDir, m_contentDirs)
+		out.append(stamp(contentDir));
+	if (all)
+	{
+		foreach (const QString &contentDir, m_contentDirs)
+		{
+			foreach (const QString &subDir, m_subDirs)
+				out.append(stamp(contentDir + QLatin1Char('/') + subDir));
+		}
+	}
+	return out;
+}
+
+void QIconThemeIndex::build()
+{
+	// before reading, so changes made while reading make the index stale
+	m_stamps = stamps(true);
+	m_icons.clear();
+	for (int j = 0; j < m_contentDirs.size(); ++j)
+	{
+		for (int i = 0; i < m_subDirs.size(); ++i)
+		{
+			const QDir dir(m_contentDirs.at(j) + QLatin1Char('/') + m_subDirs.at(i));
+			foreach (const QString &file, dir.entryList(QDir::Files))
+			{
+				int format;
+				if (file.endsWith(QLatin1String(".png")))
+					format = Png;
+				else if (file.endsWith(QLatin1String(".svg")))
+					format = Svg;
+				else if (file.endsWith(QLatin1String(".xpm")))
+					format = Xpm;
+				else
+					continue;
+				QVector<Location> &locations = m_icons[file.left(file.size() - 4)];
+				if (!locations.isEmpty() && locations.last().subDir == i &&
+					locations.last().contentDir == j)
+				{
+					locations.last().formats |= format;
+				}
+				else
+				{
+					Location location = {quint16(i), quint16(j), quint8(format)};
+					locations.append(location);
+				}
+			}
+		}
+	}
+}
+
+bool QIconThemeIndex::load(const QString &path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_5_0);
+	quint32 magic, version;
+	in >> magic >> version;
+	if (magic != themeIndexMagic || version != themeIndexVersion)
+		return false;
+	QStringList contentDirs, subDirs;
+	QVector<qint64> savedStamps;
+	in >> contentDirs >> subDirs >> savedStamps;
+	if (contentDirs != m_contentDirs || subDirs != m_subDirs || savedStamps != stamps(true))
+		return false;
+
+	QHash<QString, QVector<Location>> icons;
+	quint32 count;
+	in >> count;
+	for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+	{
+		QString name;
+		quint32 locationCount;
+		in >> name >> locationCount;
+		QVector<Location> &locations = icons[name];
+		for (quint32 k = 0; k < locationCount && in.status() == QDataStream::Ok; ++k)
+		{
+			Location location;
+			in >> location.subDir >> location.contentDir >> location.formats;
+			locations.append(location);
+		}
+	}
+	if (in.status() != QDataStream::Ok)
+		return false;
+	m_stamps = savedStamps;
+	m_icons = icons;
+	return true;
+}
+
+bool QIconThemeIndex::save(const QString &path) const
+{
+	if (!QDir().mkpath(QFileInfo(path).absolutePath()))
+		return false;
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_5_0);
+	out << themeIndexMagic << themeIndexVersion;
+	out << m_contentDirs << m_subDirs << m_stamps;
+	out << quint32(m_icons.size());
+	for (auto iter = m_icons.constBegin(); iter != m_icons.constEnd(); ++iter)
+	{
+		const QVector<Location> &locations = iter.value();
+		out << iter.key() << quint32(locations.size());
+		for (int k = 0; k < locations.size(); ++k)
+		{
+			const Location &location = locations.at(k);
+			out << location.subDir << location.contentDir << location.formats;
+		}
+	}
+	return file.commit();
+}
+
 QIconTheme::QIconTheme(const QString &themeName) : m_valid(false)
 {
 	QFile themeIndex;
@@ -225,6 +426,11 @@ QIconTheme::QIconTheme(const QString &themeName) : m_valid(false)
 	// Ensure that all themes fall back to hicolor
 	if (!m_parents.contains(QLatin1String("hicolor")))
 		m_parents.append(QLatin1String("hicolor"));
+
+	QIconLoader *loader = QIconLoader::instance();
+	if (loader->useThemeIndex())
+		m_index = QIconThemeIndex::create(themeName, m_contentDirs, m_keyList,
+										  loader->themeIndexCacheDir());
 }
 
 QThemeIconEntries QIconLoader::findIconHelper(const QString &themeName, const QString &iconName,
@@ -239,6 +445,9 @@ QThemeIconEntries QIconLoader::findIconHelper(const QString &themeName, const QS
 	visited << themeName;
 
 	QIconTheme theme = themeList.value(themeName);
+	// read the theme again if its directories changed
+	if (theme.isValid() && theme.index() && theme.index()->isStale())
+		theme = QIconTheme();
 	if (!theme.isValid())
 	{
 		theme = QIconTheme(themeName);
@@ -255,17 +464,26 @@ QThemeIconEntries QIconLoader::findIconHelper(const QString &themeName, const QS
 	const QString pngext(QLatin1String(".png"));
 	const QString xpmext(QLatin1String(".xpm"));
 
+	// with an index, the directories only have to be looked at when the icon is in them
+	const QSharedPointer<QIconThemeIndex> index = theme.index();
+	const int subDirCount = index && index->lacks(iconName) ? 0 : subDirs.size();
+
 	// Add all relevant files
-	for (int i = 0; i < subDirs.size(); ++i)
+	for (int i = 0; i < subDirCount; ++i)
 	{
 		const QIconDirInfo &dirInfo = subDirs.at(i);
 		QString subdir = dirInfo.path;
 
-		foreach (QString contentDir, contentDirs)
+		for (int j = 0; j < contentDirs.size(); ++j)
 		{
-			QDir currentDir(contentDir + '/' + subdir);
+			QDir currentDir(contentDirs.at(j) + '/' + subdir);
+			const int formats = index ? index->formats(iconName, i, j) : 0;
+			const auto exists = [&](const QString &ext, QIconThemeIndex::Format format)
+			{
+				return index ? (formats & format) != 0 : currentDir.exists(iconName + ext);
+			};
 
-			if (currentDir.exists(iconName + pngext))
+			if (exists(pngext, QIconThemeIndex::Png))
 			{
 				PixmapEntry *iconEntry = new PixmapEntry;
 				iconEntry->dir = dirInfo;
@@ -274,7 +492,7 @@ QThemeIconEntries QIconLoader::findIconHelper(const QString &themeName, const QS
 				// scalable to preserve search order afterwards
 				entries.prepend(iconEntry);
 			}
-			else if (m_supportsSvg && currentDir.exists(iconName + svgext))
+			else if (m_supportsSvg && exists(svgext, QIconThemeIndex::Svg))
 			{
 				ScalableEntry *iconEntry = new ScalableEntry;
 				iconEntry->dir = dirInfo;
@@ -282,7 +500,7 @@ QThemeIconEntries QIconLoader::findIconHelper(const QString &themeName, const QS
 				entries.append(iconEntry);
 				break;
 			}
-			else if (currentDir.exists(iconName + xpmext))
+			else if (exists(xpmext, QIconThemeIndex::Xpm))
 			{
 				PixmapEntry *iconEntry = new PixmapEntry;
 				iconEntry->dir = dirInfo;
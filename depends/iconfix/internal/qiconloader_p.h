@@ -52,6 +52,8 @@
 #include <QtCore/QHash>
 #include <QtCore/QVector>
 #include <QtCore/QTypeInfo>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSharedPointer>
 
 
 namespace QtXdg
@@ -133,6 +135,57 @@ private:
 	friend class QIconLoader;
 };
 
+/*
+ * The icon files of one theme: which icons exist in which of its directories, and in which
+ * formats. The directories are read once instead of probing for every icon lookup.
+ *
+ * The index goes stale when one of the theme's content directories changes. It can be saved
+ * to a cache directory, where it stays valid while none of the indexed directories changed.
+ * Themes with directories in the resources aren't saved, their contents change with a build.
+ */
+class QIconThemeIndex
+{
+public:
+	enum Format
+	{
+		Png = 1,
+		Svg = 2,
+		Xpm = 4
+	};
+
+	static QSharedPointer<QIconThemeIndex> create(const QString &themeName,
+												   const QStringList &contentDirs,
+												   const QVector<QIconDirInfo> &subDirs,
+												   const QString &cacheDir);
+
+	/// true if the icon isn't in any of the indexed directories
+	bool lacks(const QString &iconName) const;
+	/// the formats (a mask of Format) of the icon in subDirs[subDir] of contentDirs[contentDir]
+	int formats(const QString &iconName, int subDir, int contentDir) const;
+	/// checks the modification time of the content directories, at most once a second
+	bool isStale() const;
+
+private:
+	struct Location
+	{
+		quint16 subDir;
+		quint16 contentDir;
+		quint8 formats;
+	};
+
+	void build();
+	bool load(const QString &path);
+	bool save(const QString &path) const;
+	QVector<qint64> stamps(bool all) const;
+
+	QStringList m_contentDirs;
+	QStringList m_subDirs;
+	/// modification times of the content directories, then of each indexed directory
+	QVector<qint64> m_stamps;
+	QHash<QString, QVector<Location>> m_icons;
+	mutable QElapsedTimer m_lastCheck;
+};
+
 class QIconTheme
 {
 public:
@@ -160,8 +213,14 @@ public:
 	{
 		return m_valid;
 	}
+	/// null when the theme isn't indexed
+	QSharedPointer<QIconThemeIndex> index()
+	{
+		return m_index;
+	}
 
 private:
+	QSharedPointer<QIconThemeIndex> m_index;
 	QString m_contentDir;
 	QStringList m_contentDirs;
 	QVector<QIconDirInfo> m_keyList;
@@ -199,12 +258,30 @@ public:
 	}
 	void ensureInitialized();
 
+	/// index the directories of the themes instead of probing them for each icon
+	void setUseThemeIndex(bool use);
+	bool useThemeIndex() const
+	{
+		return m_useThemeIndex;
+	}
+	/// where theme indexes are kept between runs, empty to not keep them
+	void setThemeIndexCacheDir(const QString &path)
+	{
+		m_themeIndexCacheDir = path;
+	}
+	QString themeIndexCacheDir() const
+	{
+		return m_themeIndexCacheDir;
+	}
+
 private:
 	QThemeIconEntries findIconHelper(const QString &themeName, const QString &iconName,
 									 QStringList &visited) const;
 	uint m_themeKey;
 	bool m_supportsSvg;
 	bool m_initialized;
+	bool m_useThemeIndex;
+	QString m_themeIndexCacheDir;
 
 	mutable QString m_userTheme;
 	mutable QString m_systemTheme;
@@ -90,6 +90,14 @@ void XdgIcon::setThemeName(const QString &themeName)
 	QtXdg::QIconLoader::instance()->updateSystemTheme();
 }
 
+/************************************************
+ Sets the directory where icon theme indexes are kept.
+ ************************************************/
+void XdgIcon::setThemeIndexCacheDir(const QString &path)
+{
+	QtXdg::QIconLoader::instance()->setThemeIndexCacheDir(path);
+}
+
 /************************************************
  Returns the QIcon corresponding to name in the current icon theme. If no such icon
  is found in the current theme fallback is return instead.
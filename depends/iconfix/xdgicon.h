@@ -40,6 +40,9 @@ public:
 	static QString themeName();
 	static void setThemeName(const QString &themeName);
 
+	/// keep the directory indexes of icon themes in path between runs
+	static void setThemeIndexCacheDir(const QString &path);
+
 protected:
 	explicit XdgIcon();
 	virtual ~XdgIcon();
@@ -76,14 +76,42 @@ public class Utils
 	public static void addToClassPath(String s) throws Exception
 	{
 		File f = new File(s);
+		// MultiMC puts the jars on the class path Java starts with
+		if (isOnClassPath(f))
+			return;
+		ClassLoader loader = ClassLoader.getSystemClassLoader();
+		// Java 9 and newer can't add to the class path at runtime
+		if (!(loader instanceof URLClassLoader))
+			throw new Exception("Java " + System.getProperty("java.version") +
+					" can't add " + s + " to the class path at runtime");
 		URL u = f.toURI().toURL();
-		URLClassLoader urlClassLoader = (URLClassLoader) ClassLoader.getSystemClassLoader();
+		URLClassLoader urlClassLoader = (URLClassLoader) loader;
 		Class urlClass = URLClassLoader.class;
 		Method method = urlClass.getDeclaredMethod("addURL", new Class[]{URL.class});
 		method.setAccessible(true);
 		method.invoke(urlClassLoader, new Object[]{u});
 	}
 
+	/**
+	 * Checks if a file is on the class path Java was started with
+	 *
+	 * @param f the file to look for
+	 * @return true if it's there
+	 */
+	public static boolean isOnClassPath(File f)
+	{
+		String classPath = System.getProperty("java.class.path", "");
+		for (String entry : classPath.split(File.pathSeparator))
+		{
+			try
+			{
+				if (new File(entry).getCanonicalFile().equals(f.getCanonicalFile()))
+					return true;
+			} catch (IOException ignored) {}
+		}
+		return false;
+	}
+
 	/**
 	 * Adds many libraries to the classpath
 	 *
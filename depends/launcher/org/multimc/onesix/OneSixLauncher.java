@@ -345,21 +345,26 @@ public class OneSixLauncher implements Launcher
 		Utils.log();
 		
 		// set the native libs path... the brute force way
-		try
-		{
-			System.setProperty("java.library.path", natives);
-			System.setProperty("org.lwjgl.librarypath", natives);
-			System.setProperty("net.java.games.input.librarypath", natives);
-			// by the power of reflection, initialize native libs again. DIRTY!
-			// this is SO BAD. imagine doing that to ld
-			Field fieldSysPath = ClassLoader.class.getDeclaredField("sys_paths");
-			fieldSysPath.setAccessible( true );
-			fieldSysPath.set( null, null );
-		} catch (Exception e)
+		System.setProperty("org.lwjgl.librarypath", natives);
+		System.setProperty("net.java.games.input.librarypath", natives);
+		// MultiMC passes it to Java already, newer ones don't allow changing it later
+		File libraryPath = new File(System.getProperty("java.library.path", ""));
+		if (!libraryPath.getAbsoluteFile().equals(new File(natives).getAbsoluteFile()))
 		{
-			System.err.println("Failed to set the native library path:");
-			e.printStackTrace(System.err);
-			return -1;
+			try
+			{
+				System.setProperty("java.library.path", natives);
+				// by the power of reflection, initialize native libs again. DIRTY!
+				// this is SO BAD. imagine doing that to ld
+				Field fieldSysPath = ClassLoader.class.getDeclaredField("sys_paths");
+				fieldSysPath.setAccessible( true );
+				fieldSysPath.set( null, null );
+			} catch (Exception e)
+			{
+				System.err.println("Failed to set the native library path:");
+				e.printStackTrace(System.err);
+				return -1;
+			}
 		}
 		
 		// grab the system classloader and ...
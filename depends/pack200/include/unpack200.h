@@ -24,14 +24,168 @@
  */
 
 #pragma once
+#include <stdint.h>
+#include <stdio.h>
 #include <string>
 
+#ifdef QT_CORE_LIB
+#include <QIODevice>
+#endif
+
 /**
  * @brief Unpack a PACK200 file
  *
- * @param input_path Path to the input file in PACK200 format. System native string encoding.
- * @param output_path Path to the output file in PACK200 format. System native string encoding.
+ * @param input The input file in PACK200 format. Closed when done, also on errors.
+ * @param output The output file, a jar. Closed when done, also on errors.
  * @return void
  * @throw std::runtime_error for any error encountered
  */
 void unpack_200(FILE * input, FILE * output);
+
+namespace unpack200
+{
+/// Where the packed bytes come from.
+class Input
+{
+public:
+	virtual ~Input()
+	{
+	}
+	/// reads up to maxlen bytes, returns how many, 0 at the end and -1 on errors
+	virtual int64_t read(void *buffer, int64_t maxlen) = 0;
+};
+
+/// Where the jar goes.
+class Output
+{
+public:
+	virtual ~Output()
+	{
+	}
+	/// writes all of the bytes, returns false on errors
+	virtual bool write(const void *buffer, int64_t len) = 0;
+};
+
+/// Reads a FILE, which stays open.
+class FileInput : public Input
+{
+public:
+	explicit FileInput(FILE *file);
+	int64_t read(void *buffer, int64_t maxlen) override;
+
+private:
+	FILE *m_file;
+};
+
+/// Writes a FILE, which stays open.
+class FileOutput : public Output
+{
+public:
+	explicit FileOutput(FILE *file);
+	bool write(const void *buffer, int64_t len) override;
+
+private:
+	FILE *m_file;
+};
+
+/// Reads bytes in memory, which must live until unpacking is done.
+class MemoryInput : public Input
+{
+public:
+	MemoryInput(const void *data, size_t size);
+	int64_t read(void *buffer, int64_t maxlen) override;
+
+private:
+	const char *m_data;
+	size_t m_size;
+	size_t m_pos = 0;
+};
+
+/// Collects the jar in memory.
+class MemoryOutput : public Output
+{
+public:
+	bool write(const void *buffer, int64_t len) override;
+
+	std::string data;
+};
+
+#ifdef QT_CORE_LIB
+/// Reads an open QIODevice, from where it is.
+class QIODeviceInput : public Input
+{
+public:
+	explicit QIODeviceInput(QIODevice *device) : m_device(device)
+	{
+	}
+	int64_t read(void *buffer, int64_t maxlen) override
+	{
+		return m_device->read((char *)buffer, maxlen);
+	}
+
+private:
+	QIODevice *m_device;
+};
+
+/// Writes an open QIODevice.
+class QIODeviceOutput : public Output
+{
+public:
+	explicit QIODeviceOutput(QIODevice *device) : m_device(device)
+	{
+	}
+	bool write(const void *buffer, int64_t len) override
+	{
+		return m_device->write((const char *)buffer, len) == len;
+	}
+
+private:
+	QIODevice *m_device;
+};
+#endif
+
+/**
+ * @brief Unpacks one pack after another, reusing the memory of the last.
+ *
+ * The unpacker allocates a lot of small tables for every segment. A context keeps the blocks
+ * freed by one segment and hands them out again in the next segment or the next unpack()
+ * call, instead of going back to malloc. It also counts what is allocated, so the memory of
+ * an unpack can be capped.
+ *
+ * A context is used by one thread at a time.
+ */
+class Context
+{
+public:
+	Context();
+	~Context();
+
+	/**
+	 * @brief Unpack all segments of a pack into one jar
+	 * @throw std::runtime_error for any error encountered, or if the memory limit is hit
+	 */
+	void unpack(Input &input, Output &output);
+
+	/// the most bytes the unpacker may hold at once, kept blocks included. 0 for no limit
+	void setMemoryLimit(size_t bytes);
+	size_t memoryLimit() const;
+
+	/// the most bytes that were held at once, since creation or resetPeakMemory()
+	size_t peakMemory() const;
+	void resetPeakMemory();
+	/// bytes held between calls, for reuse
+	size_t keptMemory() const;
+	/// how many allocations were served from kept blocks
+	uint64_t reusedAllocations() const;
+	uint64_t allocations() const;
+	/// gives the kept blocks back to the system
+	void releaseMemory();
+
+private:
+	Context(const Context &) = delete;
+	Context &operator=(const Context &) = delete;
+
+	struct Private;
+	Private *d;
+};
+}
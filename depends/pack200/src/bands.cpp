@@ -181,20 +181,22 @@ int band::getIntTotal()
 		return 0;
 	if (total_memo > 0)
 		return total_memo - 1;
-	int total = getInt();
-	// overflow checks require that none of the addends are <0,
-	// and that the partial sums never overflow (wrap negative)
-	if (total < 0)
-	{
-		unpack_abort("overflow detected");
-	}
-	for (int k = length - 1; k > 0; k--)
+	int total = 0;
+	int batch[BATCH];
+	for (int k = 0; k < length; k += BATCH)
 	{
-		int prev_total = total;
-		total += vs[0].getInt();
-		if (total < prev_total)
+		int n = (length - k < BATCH) ? length - k : (int)BATCH;
+		vs[0].getInts(batch, n);
+		for (int i = 0; i < n; i++)
 		{
-			unpack_abort("overflow detected");
+			// overflow checks require that none of the addends are <0,
+			// and that the partial sums never overflow (wrap negative)
+			int prev_total = total;
+			total += batch[i];
+			if (total < prev_total)
+			{
+				unpack_abort("overflow detected");
+			}
 		}
 	}
 	rewind();
@@ -206,26 +208,37 @@ int band::getIntCount(int tag)
 {
 	if (length == 0)
 		return 0;
+	int batch[BATCH];
 	if (tag >= HIST0_MIN && tag <= HIST0_MAX)
 	{
 		if (hist0 == nullptr)
 		{
 			// Lazily calculate an approximate histogram.
 			hist0 = U_NEW(int, (HIST0_MAX - HIST0_MIN) + 1);
-			for (int k = length; k > 0; k--)
+			for (int k = 0; k < length; k += BATCH)
 			{
-				int x = vs[0].getInt();
-				if (x >= HIST0_MIN && x <= HIST0_MAX)
-					hist0[x - HIST0_MIN] += 1;
+				int n = (length - k < BATCH) ? length - k : (int)BATCH;
+				vs[0].getInts(batch, n);
+				for (int i = 0; i < n; i++)
+				{
+					int x = batch[i];
+					if (x >= HIST0_MIN && x <= HIST0_MAX)
+						hist0[x - HIST0_MIN] += 1;
+				}
 			}
 			rewind();
 		}
 		return hist0[tag - HIST0_MIN];
 	}
 	int total = 0;
-	for (int k = length; k > 0; k--)
+	for (int k = 0; k < length; k += BATCH)
 	{
-		total += (vs[0].getInt() == tag) ? 1 : 0;
+		int n = (length - k < BATCH) ? length - k : (int)BATCH;
+		vs[0].getInts(batch, n);
+		for (int i = 0; i < n; i++)
+		{
+			total += (batch[i] == tag) ? 1 : 0;
+		}
 	}
 	rewind();
 	return total;
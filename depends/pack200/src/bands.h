@@ -134,6 +134,11 @@ struct band
 		assert(ix == nullptr);
 		return vs[0].getInt();
 	}
+	void getInts(int *values, int count)
+	{
+		assert(ix == nullptr);
+		vs[0].getInts(values, count);
+	}
 	entry *getRefN()
 	{
 		assert(ix != nullptr);
@@ -157,6 +162,12 @@ struct band
 		return ((uint64_t)hi << 32) + (((uint64_t)lo << 32) >> 32);
 	}
 
+	// values are decoded in batches of this many, on the stack
+	enum
+	{
+		BATCH = 256
+	};
+
 	int getIntTotal();
 	int getIntCount(int tag);
 
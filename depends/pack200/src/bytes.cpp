@@ -63,7 +63,7 @@ void bytes::realloc(size_t len_)
 		return;
 	}
 	byte *oldptr = ptr;
-	ptr = (len_ >= PSIZE_MAX) ? nullptr : (byte *)::realloc(ptr, add_size(len_, 1));
+	ptr = (len_ >= PSIZE_MAX) ? nullptr : (byte *)must_realloc(ptr, add_size(len_, 1));
 	if (ptr != nullptr)
 	{
 		if (len < len_)
@@ -84,7 +84,7 @@ void bytes::free()
 		return; // escaping from an error
 	if (ptr != nullptr)
 	{
-		::free(ptr);
+		must_free(ptr);
 	}
 	len = 0;
 	ptr = 0;
@@ -199,7 +199,7 @@ void ptrlist::freeAll()
 		void *p = (void *)get(i);
 		if (p != nullptr)
 		{
-			::free(p);
+			must_free(p);
 		}
 	}
 	free();
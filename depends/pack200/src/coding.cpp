@@ -42,6 +42,14 @@
 #include "constants.h"
 #include "unpack.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#define CODING_SSE2 1
+#endif
+
 extern coding basic_codings[];
 
 // CODING_PRIVATE causes a lot of them
@@ -171,7 +179,7 @@ coding *coding::findBySpec(int spec)
 	coding *c = ptr->initFrom(spec);
 	if (c == nullptr)
 	{
-		::free(ptr);
+		must_free(ptr);
 	}
 	else
 		// else caller should free it...
@@ -196,7 +204,7 @@ void coding::free()
 {
 	if (isMalloc)
 	{
-		::free(this);
+		must_free(this);
 	}
 }
 
@@ -270,6 +278,44 @@ uint32_t coding::parse_lgH(byte *&rp, int B, int H, int lgH)
 	return 0;
 }
 
+#ifdef CODING_SSE2
+// index of the lowest set bit of a nonzero x
+static inline int lowestBit(unsigned x)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, x);
+	return (int)index;
+#else
+	return __builtin_ctz(x);
+#endif
+}
+#endif
+
+// Count the bytes starting at rp, at most max, that are less than L.
+// At a value boundary, each such byte is a whole value of a (B,H) coding with L = 256-H.
+// Most band values are small, so these runs are long.
+static int countShortBytes(const byte *rp, int max, int L)
+{
+	assert(L > 0 && L < 256);
+	int n = 0;
+#ifdef CODING_SSE2
+	// b < L exactly when min(b, L-1) == b, unsigned
+	const __m128i last = _mm_set1_epi8((char)(L - 1));
+	for (; n + 16 <= max; n += 16)
+	{
+		__m128i chunk = _mm_loadu_si128((const __m128i *)(rp + n));
+		__m128i isShort = _mm_cmpeq_epi8(_mm_min_epu8(chunk, last), chunk);
+		unsigned isLong = ~_mm_movemask_epi8(isShort) & 0xFFFF;
+		if (isLong != 0)
+			return n + lowestBit(isLong);
+	}
+#endif
+	while (n < max && (rp[n] & 0xFF) < L)
+		n++;
+	return n;
+}
+
 static const char ERB[] = "EOF reading band";
 
 void coding::parseMultiple(byte *&rp, int N, byte *limit, int B, int H)
@@ -296,6 +342,15 @@ void coding::parseMultiple(byte *&rp, int N, byte *limit, int B, int H)
 	int n = B;
 	while (N > 0)
 	{
+		if (n == B && ptr < limit && (*ptr & 0xFF) < L)
+		{
+			// skip a run of one-byte values at once
+			int avail = (int)(limit - ptr);
+			int run = countShortBytes(ptr, N < avail ? N : avail, L);
+			ptr += run;
+			N -= run;
+			continue;
+		}
 		ptr += 1;
 		if (--n == 0)
 		{
@@ -617,6 +672,137 @@ int value_stream::getInt()
 	return 0;
 }
 
+// Decode values of the current segment of vs into values, at most count.
+// parse reads one (B,H) value and decode applies the S and D parts of the coding.
+template <typename Parse, typename Decode>
+static int decodeRun(value_stream &vs, int *values, int count, Parse parse, Decode decode)
+{
+	const int L = vs.c.L();
+	byte *rp = vs.rp;
+	byte *rplimit = vs.rplimit;
+	int n = 0;
+	while (n < count && rp < rplimit)
+	{
+		if (L > 0 && (*rp & 0xFF) < L)
+		{
+			int avail = (int)(rplimit - rp);
+			int run = countShortBytes(rp, count - n < avail ? count - n : avail, L);
+			for (int i = 0; i < run; i++)
+			{
+				values[n + i] = decode((uint32_t)(rp[i] & 0xFF));
+			}
+			rp += run;
+			n += run;
+			continue;
+		}
+		values[n++] = decode(parse(rp));
+	}
+	vs.rp = rp;
+	return n;
+}
+
+template <int B, int lgH> static uint32_t parseLgH(byte *&rp)
+{
+	return coding::parse_lgH(rp, B, 1 << lgH, lgH);
+}
+
+int value_stream::getIntRun(int *values, int count)
+{
+	if (rp >= rplimit)
+		return 0;
+	CODING_PRIVATE(c.spec);
+	auto parseBH = [B, H](byte *&ptr)
+	{ return coding::parse(ptr, B, H); };
+	auto asIs = [](uint32_t uval)
+	{ return (int)uval; };
+	auto signS1 = [](uint32_t uval)
+	{ return (int)DECODE_SIGN_S1(uval); };
+	auto signS = [S](uint32_t uval)
+	{ return S == 0 ? (int)uval : decode_sign(S, uval); };
+	int n = 0;
+	int total = sum;
+	coding *cp = &c;
+	switch (cmk)
+	{
+	case cmk_BYTE1:
+		n = (int)(rplimit - rp) < count ? (int)(rplimit - rp) : count;
+		for (int i = 0; i < n; i++)
+		{
+			values[i] = rp[i] & 0xFF;
+		}
+		rp += n;
+		return n;
+
+	case cmk_CHAR3:
+		return decodeRun(*this, values, count, parseLgH<3, 7>, asIs);
+
+	case cmk_UNSIGNED5:
+		return decodeRun(*this, values, count, parseLgH<5, 6>, asIs);
+
+	case cmk_BCI5:
+		return decodeRun(*this, values, count, parseLgH<5, 2>, asIs);
+
+	case cmk_BRANCH5:
+		return decodeRun(*this, values, count, parseLgH<5, 2>, [](uint32_t uval)
+		{ return decode_sign(2, uval); });
+
+	case cmk_BHS0:
+		return decodeRun(*this, values, count, parseBH, asIs);
+
+	case cmk_BHS1:
+		return decodeRun(*this, values, count, parseBH, signS1);
+
+	case cmk_BHS:
+		return decodeRun(*this, values, count, parseBH, signS);
+
+	case cmk_DELTA5:
+		n = decodeRun(*this, values, count, parseLgH<5, 6>, [&total](uint32_t uval)
+		{ return total += DECODE_SIGN_S1(uval); });
+		break;
+
+	case cmk_BHS1D1full:
+		n = decodeRun(*this, values, count, parseBH, [&total](uint32_t uval)
+		{ return total += (int)DECODE_SIGN_S1(uval); });
+		break;
+
+	case cmk_BHS1D1sub:
+		n = decodeRun(*this, values, count, parseBH, [&total, cp](uint32_t uval)
+		{ return total = cp->sumInUnsignedRange(total, (int)DECODE_SIGN_S1(uval)); });
+		break;
+
+	case cmk_BHSD1:
+		assert(c.isSubrange | c.isFullRange);
+		n = decodeRun(*this, values, count, parseBH, [&total, cp, signS](uint32_t uval)
+		{
+			int delta = signS(uval);
+			return total = cp->isSubrange ? cp->sumInUnsignedRange(total, delta) : total + delta;
+		});
+		break;
+
+	default:
+		// pop codings look their values up, leave them to getInt()
+		return 0;
+	}
+	sum = total;
+	return n;
+}
+
+void value_stream::getInts(int *values, int count)
+{
+	while (count > 0)
+	{
+		int n = getIntRun(values, count);
+		if (n == 0)
+		{
+			// the next coding segment, a pop coding, or the end of the band
+			*values = getInt();
+			n = 1;
+		}
+		values += n;
+		count -= n;
+	}
+}
+
 static int moreCentral(int x, int y)
 { // used to find end of Pop.{F}
 	// Suggested implementation from the Pack200 specification:
@@ -830,14 +1016,20 @@ void coding_method::init(byte *&band_rp, byte *band_limit, byte *&meta_rp, int m
 		// Also verify that they are in bounds.
 		int UN = 0; // one {U} for each zero in {T}
 		value_stream vs = vs0;
-		for (int i = 0; i < N; i++)
+		int tokens[256];
+		for (int k = 0; k < N; k += 256)
 		{
-			uint32_t val = vs.getInt();
-			if (val == 0)
-				UN += 1;
-			if (!(val <= (uint32_t)fVlength))
+			int n = (N - k < 256) ? N - k : 256;
+			vs.getInts(tokens, n);
+			for (int i = 0; i < n; i++)
 			{
-				unpack_abort("pop token out of range");
+				uint32_t val = tokens[i];
+				if (val == 0)
+					UN += 1;
+				if (!(val <= (uint32_t)fVlength))
+				{
+					unpack_abort("pop token out of range");
+				}
 			}
 		}
 		vs.done();
@@ -195,6 +195,14 @@ struct value_stream
 	// Parse and decode a single value.
 	int getInt();
 
+	// Parse and decode count values, exactly as count calls of getInt() would.
+	// Runs of values in one coding segment are decoded in a tight loop.
+	void getInts(int *values, int count);
+
+	// Decode values up to the end of the current coding segment, at most count.
+	// Returns how many, 0 if the next value needs getInt() (pop codings, next segment).
+	int getIntRun(int *values, int count);
+
 	// Parse and decode a single byte, with no error checks.
 	int getByte()
 	{
@@ -38,6 +38,7 @@
 #define ERROR_RESOURCE "Cannot extract resource file"
 #define ERROR_OVERFLOW "Internal buffer overflow"
 #define ERROR_INTERNAL "Internal error"
+#define ERROR_LIMIT "Memory limit of the unpacker exceeded"
 
 #define lengthof(array) (sizeof(array) / sizeof(array[0]))
 
@@ -1075,10 +1075,15 @@ void unpacker::read_Utf8_values(entry *cpMap, int len)
 		}
 
 		byte *chp = chars.ptr;
-		for (int j = 0; j < suffix; j++)
+		int batch[band::BATCH];
+		for (int k = 0; k < suffix; k += band::BATCH)
 		{
-			unsigned short ch = cp_Utf8_chars.getInt();
-			chp = store_Utf8_char(chp, ch);
+			int n = (suffix - k < band::BATCH) ? suffix - k : (int)band::BATCH;
+			cp_Utf8_chars.getInts(batch, n);
+			for (int j = 0; j < n; j++)
+			{
+				chp = store_Utf8_char(chp, (unsigned short)batch[j]);
+			}
 		}
 		// shrink to fit:
 		if (isMalloc)
@@ -1204,9 +1209,15 @@ void unpacker::read_Utf8_values(entry *cpMap, int len)
 void unpacker::read_single_words(band &cp_band, entry *cpMap, int len)
 {
 	cp_band.readData(len);
-	for (int i = 0; i < len; i++)
+	int batch[band::BATCH];
+	for (int k = 0; k < len; k += band::BATCH)
 	{
-		cpMap[i].value.i = cp_band.getInt(); // coding handles signs OK
+		int n = (len - k < band::BATCH) ? len - k : (int)band::BATCH;
+		cp_band.getInts(batch, n);
+		for (int i = 0; i < n; i++)
+		{
+			cpMap[k + i].value.i = batch[i]; // coding handles signs OK
+		}
 	}
 }
 
@@ -3473,7 +3484,7 @@ void constant_pool::computeOutputIndexes()
 // Unpacker Start
 // Deallocate all internal storage and reset to a clean state.
 // Do not disturb any input or output connections, including
-// infileptr, inbytes, read_input_fn, jarout, or errstrm.
+// instream, inbytes, read_input_fn, jarout, or errstrm.
 // Do not reset any unpack options.
 void unpacker::reset()
 {
@@ -3501,14 +3512,14 @@ void unpacker::reset()
 	}
 
 	unpacker save_u = (*this); // save bytewise image
-	infileptr = nullptr;	   // make asserts happy
+	instream = nullptr;	   // make asserts happy
 	jarout = nullptr;		  // do not close the output jar
 	gzin = nullptr;			// do not close the input gzip stream
 	this->free();
 	this->init(read_input_fn);
 
 	// restore selected interface state:
-	infileptr = save_u.infileptr;
+	instream = save_u.instream;
 	inbytes = save_u.inbytes;
 	jarout = save_u.jarout;
 	gzin = save_u.gzin;
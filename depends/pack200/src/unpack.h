@@ -24,6 +24,10 @@
  */
 
 // Global Structures
+namespace unpack200
+{
+class Input;
+}
 struct jar;
 struct gunzip;
 struct band;
@@ -158,7 +162,7 @@ struct unpacker
 	};
 
 	// if running Unix-style, here are the inputs and outputs
-	FILE *infileptr; // buffered
+	unpack200::Input *instream; // buffered
 	bytes inbytes;   // direct
 	gunzip *gzin;	// gunzip filter, if any
 	jar *jarout;	 // output JAR file
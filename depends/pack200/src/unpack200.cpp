@@ -32,6 +32,7 @@
 #include <limits.h>
 #include <time.h>
 #include <stdint.h>
+#include <memory>
 
 #include "constants.h"
 #include "utils.h"
@@ -42,28 +43,24 @@
 #include "unpack.h"
 #include "zip.h"
 
-// Callback for fetching data, Unix style.
-static int64_t read_input_via_stdio(unpacker *u, void *buf, int64_t minlen, int64_t maxlen)
+// Callback for fetching data from the input stream.
+static int64_t read_input_via_stream(unpacker *u, void *buf, int64_t minlen, int64_t maxlen)
 {
-	assert(u->infileptr != nullptr);
+	assert(u->instream != nullptr);
 	assert(minlen <= maxlen); // don't talk nonsense
 	int64_t numread = 0;
 	char *bufptr = (char *)buf;
 	while (numread < minlen)
 	{
 		// read available input, up to buf.length or maxlen
-		int readlen = (1 << 16);
+		int64_t readlen = (1 << 16);
 		if (readlen > (maxlen - numread))
-			readlen = (int)(maxlen - numread);
-		int nr = 0;
-
-		nr = (int)fread(bufptr, 1, readlen, u->infileptr);
-		if (nr <= 0)
-		{
-			if (errno != EINTR)
-				break;
-			nr = 0;
-		}
+			readlen = maxlen - numread;
+		int64_t nr = u->instream->read(bufptr, readlen);
+		if (nr < 0)
+			unpack_abort("read on input failed");
+		if (nr == 0)
+			break;
 		numread += nr;
 		bufptr += nr;
 		assert(numread <= maxlen);
@@ -94,20 +91,8 @@ static int read_magic(unpacker *u, char peek[], int peeklen)
 	return magic;
 }
 
-void unpack_200(FILE *input, FILE *output)
+static void unpack_segments(unpacker &u)
 {
-	unpacker u;
-	u.init(read_input_via_stdio);
-
-	// initialize jar output
-	// the output takes ownership of the file handle
-	jar jarout;
-	jarout.init(&u);
-	jarout.jarfp = output;
-
-	// the input doesn't
-	u.infileptr = input;
-
 	// read the magic!
 	char peek[4];
 	int magic;
@@ -157,6 +142,152 @@ void unpack_200(FILE *input, FILE *output)
 		u.start(peek, sizeof(peek));
 	}
 	u.finish();
+}
+
+void unpack_200(FILE *input, FILE *output)
+{
+	// closed on errors too, the output before the input
+	std::unique_ptr<FILE, int (*)(FILE *)> inputCloser(input, fclose);
+	std::unique_ptr<FILE, int (*)(FILE *)> outputCloser(output, fclose);
+	unpack200::Context context;
+	unpack200::FileInput in(input);
+	unpack200::FileOutput out(output);
+	context.unpack(in, out);
+}
+
+namespace unpack200
+{
+namespace
+{
+// blocks kept between segments and calls, beyond this they go back to the system
+const size_t keepLimit = 32 << 20;
+}
+
+FileInput::FileInput(FILE *file) : m_file(file)
+{
+}
+
+int64_t FileInput::read(void *buffer, int64_t maxlen)
+{
+	for (;;)
+	{
+		size_t nr = fread(buffer, 1, (size_t)maxlen, m_file);
+		if (nr > 0 || feof(m_file))
+			return (int64_t)nr;
+		if (errno != EINTR)
+			return -1;
+		clearerr(m_file);
+	}
+}
+
+FileOutput::FileOutput(FILE *file) : m_file(file)
+{
+}
+
+bool FileOutput::write(const void *buffer, int64_t len)
+{
+	return fwrite(buffer, 1, (size_t)len, m_file) == (size_t)len;
+}
+
+MemoryInput::MemoryInput(const void *data, size_t size) : m_data((const char *)data), m_size(size)
+{
+}
+
+int64_t MemoryInput::read(void *buffer, int64_t maxlen)
+{
+	size_t len = m_size - m_pos;
+	if ((uint64_t)maxlen < len)
+		len = (size_t)maxlen;
+	memcpy(buffer, m_data + m_pos, len);
+	m_pos += len;
+	return (int64_t)len;
+}
+
+bool MemoryOutput::write(const void *buffer, int64_t len)
+{
+	data.append((const char *)buffer, (size_t)len);
+	return true;
+}
+
+struct Context::Private
+{
+	arena memory;
+};
+
+Context::Context() : d(new Private)
+{
+	d->memory.init(keepLimit);
+}
+
+Context::~Context()
+{
+	d->memory.free();
+	delete d;
+}
+
+void Context::unpack(Input &input, Output &output)
+{
+	arena::scope scope(&d->memory);
+	unpacker u;
+	jar jarout;
+	try
+	{
+		// init clears the unpacker first, so it can be freed wherever this throws
+		u.init(read_input_via_stream);
+		u.instream = &input;
+
+		// initialize jar output
+		jarout.init(&u);
+		jarout.jarstream = &output;
+
+		unpack_segments(u);
+	}
+	catch (...)
+	{
+		// hand everything back for the next call
+		u.free();
+		throw;
+	}
 	u.free(); // tidy up malloc blocks
-	fclose(input);
+}
+
+void Context::setMemoryLimit(size_t bytes)
+{
+	d->memory.limit = bytes;
+}
+
+size_t Context::memoryLimit() const
+{
+	return d->memory.limit;
+}
+
+size_t Context::peakMemory() const
+{
+	return d->memory.peak;
+}
+
+void Context::resetPeakMemory()
+{
+	d->memory.peak = d->memory.in_use + d->memory.kept;
+}
+
+size_t Context::keptMemory() const
+{
+	return d->memory.kept;
+}
+
+uint64_t Context::reusedAllocations() const
+{
+	return d->memory.reuses;
+}
+
+uint64_t Context::allocations() const
+{
+	return d->memory.allocations;
+}
+
+void Context::releaseMemory()
+{
+	d->memory.trim();
+}
 }
@@ -48,21 +48,189 @@
 
 #include "unpack.h"
 
-void *must_malloc(size_t size)
+namespace
+{
+// precedes every block, keeps the payload aligned like malloc's
+struct block
+{
+	size_t capacity; // usable bytes after the header
+	block *next;	 // the next kept block of the same class
+};
+const size_t HEADER = 16;
+static_assert(sizeof(block) <= HEADER, "the block header must fit");
+
+thread_local arena *current_arena = nullptr;
+
+inline block *block_of(void *ptr)
+{
+	return (block *)((char *)ptr - HEADER);
+}
+
+inline void *payload_of(block *b)
+{
+	return (char *)b + HEADER;
+}
+
+// Rounds size up to one of four steps per power of two and returns its class,
+// or -1 for sizes too big to keep.
+int size_class(size_t size, size_t *rounded)
+{
+	if (size <= arena::MIN_CLASS)
+	{
+		*rounded = arena::MIN_CLASS;
+		return 0;
+	}
+	int lg = 6; // 2^lg < size <= 2^(lg+1)
+	while (lg < 8 * (int)sizeof(size_t) - 1 && ((size_t)1 << (lg + 1)) < size)
+		lg++;
+	const size_t step = (size_t)1 << (lg - 2);
+	const size_t r = (size + step - 1) & ~(step - 1);
+	const int cls = 1 + (lg - 6) * 4 + (int)(r >> (lg - 2)) - 5;
+	if (cls >= arena::CLASSES)
+		return -1;
+	*rounded = r;
+	return cls;
+}
+
+block *system_alloc(size_t capacity)
+{
+	block *b = (capacity > PSIZE_MAX - HEADER) ? nullptr : (block *)malloc(HEADER + capacity);
+	if (b == nullptr)
+		throw std::runtime_error(ERROR_ENOMEM);
+	b->capacity = capacity;
+	return b;
+}
+
+block *arena_alloc(arena &a, size_t size)
 {
-	size_t msize = size;
-	void *ptr = (msize > PSIZE_MAX) ? nullptr : malloc(msize);
-	if (ptr != nullptr)
+	size_t capacity = size;
+	const int cls = size_class(size, &capacity);
+	const size_t total = HEADER + capacity;
+	block *b = nullptr;
+	if (cls >= 0 && a.free_blocks[cls] != nullptr)
 	{
-		memset(ptr, 0, size);
+		b = (block *)a.free_blocks[cls];
+		a.free_blocks[cls] = b->next;
+		a.kept -= total;
+		a.reuses++;
 	}
 	else
 	{
-		throw std::runtime_error(ERROR_ENOMEM);
+		if (a.limit != 0 && a.in_use + a.kept + total > a.limit)
+		{
+			// what is kept makes room first
+			a.trim();
+			if (a.in_use + total > a.limit)
+				throw std::runtime_error(ERROR_LIMIT);
+		}
+		b = system_alloc(capacity);
 	}
+	a.in_use += total;
+	a.allocations++;
+	if (a.peak < a.in_use + a.kept)
+		a.peak = a.in_use + a.kept;
+	return b;
+}
+
+void arena_release(arena &a, block *b)
+{
+	const size_t total = HEADER + b->capacity;
+	// blocks from before the arena became current were never counted
+	a.in_use = (a.in_use > total) ? a.in_use - total : 0;
+	size_t rounded = 0;
+	const int cls = size_class(b->capacity, &rounded);
+	if (cls < 0 || rounded != b->capacity || a.kept + total > a.keep_limit)
+	{
+		::free(b);
+		return;
+	}
+	b->next = (block *)a.free_blocks[cls];
+	a.free_blocks[cls] = b;
+	a.kept += total;
+}
+}
+
+void *must_malloc(size_t size)
+{
+	if (size > PSIZE_MAX)
+		throw std::runtime_error(ERROR_ENOMEM);
+	arena *a = current_arena;
+	block *b = a ? arena_alloc(*a, size) : system_alloc(size);
+	void *ptr = payload_of(b);
+	memset(ptr, 0, size);
 	return ptr;
 }
 
+void *must_realloc(void *ptr, size_t size)
+{
+	if (ptr == nullptr)
+		return must_malloc(size);
+	block *b = block_of(ptr);
+	if (size <= b->capacity)
+		return ptr;
+	if (size > PSIZE_MAX)
+		throw std::runtime_error(ERROR_ENOMEM);
+	if (current_arena == nullptr)
+	{
+		block *grown = (block *)::realloc(b, HEADER + size);
+		if (grown == nullptr)
+			throw std::runtime_error(ERROR_ENOMEM);
+		grown->capacity = size;
+		return payload_of(grown);
+	}
+	void *grown = payload_of(arena_alloc(*current_arena, size));
+	memcpy(grown, ptr, b->capacity);
+	arena_release(*current_arena, b);
+	return grown;
+}
+
+void must_free(void *ptr)
+{
+	if (ptr == nullptr)
+		return;
+	if (current_arena != nullptr)
+		arena_release(*current_arena, block_of(ptr));
+	else
+		::free(block_of(ptr));
+}
+
+void arena::init(size_t keep_limit_)
+{
+	memset(this, 0, sizeof(*this));
+	keep_limit = keep_limit_;
+}
+
+void arena::trim()
+{
+	for (int i = 0; i < CLASSES; i++)
+	{
+		block *b = (block *)free_blocks[i];
+		while (b != nullptr)
+		{
+			block *next = b->next;
+			::free(b);
+			b = next;
+		}
+		free_blocks[i] = nullptr;
+	}
+	kept = 0;
+}
+
+arena *arena::current()
+{
+	return current_arena;
+}
+
+arena::scope::scope(arena *a) : previous(current_arena)
+{
+	current_arena = a;
+}
+
+arena::scope::~scope()
+{
+	current_arena = previous;
+}
+
 void unpack_abort(const char *msg)
 {
 	if (msg == nullptr)
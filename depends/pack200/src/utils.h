@@ -26,8 +26,55 @@
 // Definitions of our util functions
 
 #include <stdexcept>
+#include <stdint.h>
 
+// All memory of the unpacker comes from here: zeroed, and throwing instead of returning null.
+// Blocks must be given back with must_free, they carry a header for the arena below.
 void *must_malloc(size_t size);
+// keeps the contents, but doesn't zero what is added
+void *must_realloc(void *ptr, size_t size);
+void must_free(void *ptr);
+
+// Meters the allocations of an unpacker and keeps freed blocks to hand out again.
+// While an arena is current, must_malloc rounds sizes up to a few classes per power of two,
+// so a block freed by one segment fits the same request in the next one.
+struct arena
+{
+	enum
+	{
+		// the smallest size class, and how many there are: 64 bytes to 64 MiB
+		MIN_CLASS = 64,
+		CLASSES = 1 + 4 * 20
+	};
+
+	size_t limit;	  // 0, or the most that may be in use and kept together
+	size_t keep_limit; // the most that is kept for reuse
+	size_t in_use;	 // in blocks handed out, headers included
+	size_t kept;	   // in blocks waiting for reuse
+	size_t peak;	   // highest in_use + kept
+	uint64_t allocations;
+	uint64_t reuses;
+	void *free_blocks[CLASSES];
+
+	void init(size_t keep_limit_);
+	// gives the kept blocks back to the system
+	void trim();
+	void free()
+	{
+		trim();
+	}
+
+	// the arena of this thread, nullptr for plain malloc and free
+	static arena *current();
+
+	// makes an arena current for a scope
+	struct scope
+	{
+		arena *previous;
+		explicit scope(arena *a);
+		~scope();
+	};
+};
 
 // overflow management
 #define OVERFLOW ((size_t) - 1)
@@ -47,9 +47,29 @@
 #include "unpack.h"
 
 #include "zip.h"
+#include "unpack200.h"
 
 #include "zlib.h"
 
+// zlib state comes from the arena too, the deflater's is big and made for every file
+static voidpf zlib_alloc(voidpf, uInt items, uInt size)
+{
+	try
+	{
+		return must_malloc(scale_size(items, size));
+	}
+	catch (std::runtime_error &)
+	{
+		// zlib is C, it gets told by a null pointer
+		return Z_NULL;
+	}
+}
+
+static void zlib_free(voidpf, voidpf address)
+{
+	must_free(address);
+}
+
 inline uint32_t jar::get_crc32(uint32_t c, uchar *ptr, uint32_t len)
 {
 	return crc32(c, ptr, len);
@@ -76,18 +96,11 @@ void jar::init(unpacker *u_)
 // Write data to the ZIP output stream.
 void jar::write_data(void *buff, int len)
 {
-	while (len > 0)
-	{
-		int rc = (int)fwrite(buff, 1, len, jarfp);
-		if (rc <= 0)
-		{
-			fprintf(stderr, "Error: write on output file failed err=%d\n", errno);
-			exit(1); // Called only from the native standalone unpacker
-		}
-		output_file_offset += rc;
-		buff = ((char *)buff) + rc;
-		len -= rc;
-	}
+	if (jarstream == nullptr)
+		return; // closed already
+	if (len > 0 && !jarstream->write(buff, len))
+		unpack_abort("write on output failed");
+	output_file_offset += len;
 }
 
 void jar::add_to_jar_directory(const char *fname, bool store, int modtime, int len, int clen,
@@ -241,20 +254,6 @@ void jar::write_central_directory()
 
 // Public API
 
-// Open a Jar file and initialize.
-void jar::openJarFile(const char *fname)
-{
-	if (!jarfp)
-	{
-		jarfp = fopen(fname, "wb");
-		if (!jarfp)
-		{
-			fprintf(stderr, "Error: Could not open jar file: %s\n", fname);
-			exit(3); // Called only from the native standalone unpacker
-		}
-	}
-}
-
 // Add a ZIP entry and copy the file data
 void jar::addJarEntry(const char *fname, bool deflate_hint, int modtime, bytes &head,
 					  bytes &tail)
@@ -303,14 +302,9 @@ void jar::addDirectoryToJarFile(const char *dir_name)
 // Write out the central directory and close the jar file.
 void jar::closeJarFile(bool central)
 {
-	if (jarfp)
-	{
-		fflush(jarfp);
-		if (central)
-			write_central_directory();
-		fflush(jarfp);
-		fclose(jarfp);
-	}
+	if (jarstream && central)
+		write_central_directory();
+	// the stream belongs to the caller, writing stops here
 	reset();
 }
 
@@ -362,6 +356,8 @@ bool jar::deflate_bytes(bytes &head, bytes &tail)
 
 	z_stream zs;
 	BYTES_OF(zs).clear();
+	zs.zalloc = zlib_alloc;
+	zs.zfree = zlib_free;
 
 	// NOTE: the window size should always be -MAX_WBITS normally -15.
 	// unzip/zipup.c and java/Deflater.c
@@ -509,6 +505,8 @@ void gunzip::init(unpacker *u_)
 	assert(u->gzin == nullptr); // once only, please
 	read_input_fn = (void *)u->read_input_fn;
 	zstream = NEW(z_stream, 1);
+	((z_stream *)zstream)->zalloc = zlib_alloc;
+	((z_stream *)zstream)->zfree = zlib_free;
 	u->gzin = this;
 	u->read_input_fn = read_input_via_gzip;
 }
@@ -576,9 +574,9 @@ void gunzip::free()
 	u->gzin = nullptr;
 	u->read_input_fn = (unpacker::read_input_fn_t) this->read_input_fn;
 	inflateEnd((z_stream *)zstream);
-	::free(zstream);
+	must_free(zstream);
 	zstream = nullptr;
-	::free(this);
+	must_free(this);
 }
 
 void gunzip::read_fixed_field(char *buf, size_t buflen)
@@ -28,11 +28,15 @@ typedef unsigned int uint32_t;
 typedef unsigned char uchar;
 
 struct unpacker;
+namespace unpack200
+{
+class Output;
+}
 
 struct jar
 {
 	// JAR file writer
-	FILE *jarfp;
+	unpack200::Output *jarstream;
 	int default_modtime;
 
 	// Used by unix2dostime:
@@ -49,7 +53,6 @@ struct jar
 	unpacker *u;
 
 	// Public Methods
-	void openJarFile(const char *fname);
 	void addJarEntry(const char *fname, bool deflate_hint, int modtime, bytes &head,
 					 bytes &tail);
 	void addDirectoryToJarFile(const char *dir_name);
@@ -26,11 +26,13 @@
 #include <QtWidgets/QAction>
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QButtonGroup>
+#include <QtWidgets/QDockWidget>
 #include <QtWidgets/QHBoxLayout>
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QStatusBar>
 #include <QtWidgets/QToolBar>
+#include <QtWidgets/QTreeView>
 #include <QtWidgets/QWidget>
 
 class Ui_MainWindow
@@ -382,6 +384,8 @@ namespace Ui {
 #include "logic/OneSixInstance.h"
 #include "logic/InstanceFactory.h"
 #include "logic/MinecraftProcess.h"
+#include "logic/LaunchPipeline.h"
+#include "logic/RunningInstanceList.h"
 #include "logic/OneSixUpdate.h"
 #include "logic/java/JavaUtils.h"
 #include "logic/NagUtils.h"
@@ -515,6 +519,28 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
 	statusBar()->addPermanentWidget(m_statusLeft, 1);
 	statusBar()->addPermanentWidget(m_statusRight, 0);
 
+	// running instances panel. it shows itself whenever an instance is launched.
+	{
+		auto runningList = MMC->runningInstances();
+		m_runningView = new QTreeView(this);
+		m_runningView->setRootIsDecorated(false);
+		m_runningView->setUniformRowHeights(true);
+		m_runningView->setModel(runningList.get());
+		m_runningView->header()->setSectionResizeMode(RunningInstanceList::NameColumn,
+													  QHeaderView::Stretch);
+		m_runningView->header()->setStretchLastSection(false);
+		connect(m_runningView, SIGNAL(activated(const QModelIndex &)),
+				SLOT(runningInstanceActivated(const QModelIndex &)));
+
+		m_runningDock = new QDockWidget(tr("Running instances"), this);
+		m_runningDock->setObjectName("runningInstancesDock");
+		m_runningDock->setWidget(m_runningView);
+		addDockWidget(Qt::BottomDockWidgetArea, m_runningDock);
+		m_runningDock->hide();
+		connect(runningList.get(), SIGNAL(rowsInserted(const QModelIndex &, int, int)),
+				m_runningDock, SLOT(show()));
+	}
+
 	// Add "manage accounts" button, right align
 	QWidget *spacer = new QWidget();
 	spacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -1538,6 +1564,15 @@ void MainWindow::doLaunch(bool online, BaseProfilerFactory *profiler)
 	if (!m_selectedInstance)
 		return;
 
+	// every instance has its own natives and game folder, so it can only run once at a time
+	if (MMC->runningInstances()->processFor(m_selectedInstance))
+	{
+		CustomMessageBox::selectable(this, tr("Instance is running"),
+									 tr("%1 is already running.").arg(m_selectedInstance->name()),
+									 QMessageBox::Information)->exec();
+		return;
+	}
+
 	// Find an account to use.
 	std::shared_ptr<MojangAccountList> accounts = MMC->accounts();
 	MojangAccountPtr account = accounts->activeAccount();
@@ -1577,6 +1612,19 @@ void MainWindow::doLaunch(bool online, BaseProfilerFactory *profiler)
 	if (!account.get())
 		return;
 
+	// everything from here until the game prints its first line is timed
+	auto trace = std::make_shared<Trace>(tr("Launch of %1").arg(m_selectedInstance->name()));
+
+	// Update the instance and prepare its launch while the account is being validated.
+	// Nothing in there depends on the account. Both are joined before Minecraft is started.
+	LaunchPipeline *pipeline = nullptr;
+	if (online)
+	{
+		pipeline = new LaunchPipeline(m_selectedInstance, true, this);
+		pipeline->setTrace(trace);
+		pipeline->start();
+	}
+
 	// we try empty password first :)
 	QString password;
 	// we loop until the user succeeds in logging in or gives up
@@ -1592,6 +1640,7 @@ void MainWindow::doLaunch(bool online, BaseProfilerFactory *profiler)
 		auto task = account->login(session, password);
 		if (task)
 		{
+			task->setTrace(trace);
 			// We'll need to validate the access token to make sure the account
 			// is still logged in.
 			ProgressDialog progDialog(this);
@@ -1646,56 +1695,118 @@ void MainWindow::doLaunch(bool online, BaseProfilerFactory *profiler)
 		}
 		case AuthSession::PlayableOnline:
 		{
-			// update first if the server actually responded
-			if (session->auth_server_online)
+			if (pipeline)
 			{
-				updateInstance(m_selectedInstance, session, profiler);
+				finishLaunch(pipeline, session, profiler);
+				pipeline = nullptr;
 			}
 			else
 			{
-				launchInstance(m_selectedInstance, session, profiler);
+				launchInstance(m_selectedInstance, session, profiler, trace);
 			}
 			tryagain = false;
 		}
 		}
 	}
+
+	// the user gave up. let the update finish in the background.
+	if (pipeline)
+	{
+		pipeline->release();
+	}
 }
 
-void MainWindow::updateInstance(InstancePtr instance, AuthSessionPtr session,
-								BaseProfilerFactory *profiler)
+void MainWindow::finishLaunch(LaunchPipeline *pipeline, AuthSessionPtr session,
+							  BaseProfilerFactory *profiler)
 {
-	auto updateTask = instance->doUpdate();
-	if (!updateTask)
+	InstancePtr instance = pipeline->instance();
+	// playing offline, the update servers are most likely out of reach as well. don't wait for
+	// the update to fail, launch with what we have right away. aborting the update gives up
+	// the caches, so the launch below doesn't wait for them.
+	if (pipeline->isRunning() &&
+		(session->status == AuthSession::PlayableOffline || !session->auth_server_online))
 	{
-		launchInstance(instance, session, profiler);
+		TracePtr trace = pipeline->trace();
+		pipeline->abort();
+		pipeline->release();
+		launchInstance(instance, session, profiler, trace);
 		return;
 	}
-	ProgressDialog tDialog(this);
-	connect(updateTask.get(), &Task::succeeded, [this, instance, session, profiler]
-	{ launchInstance(instance, session, profiler); });
-	connect(updateTask.get(), SIGNAL(failed(QString)), SLOT(onGameUpdateError(QString)));
-	tDialog.exec(updateTask.get());
+
+	// wait for whatever the pipeline still has to do
+	if (pipeline->isRunning())
+	{
+		ProgressDialog tDialog(this);
+		tDialog.exec(pipeline);
+	}
+	QString launchScript = pipeline->launchScript();
+	bool succeeded = pipeline->successful();
+	bool updateFailed = pipeline->updateFailed();
+	QString failReason = pipeline->failReason();
+	TracePtr trace = pipeline->trace();
+	pipeline->release();
+
+	if (succeeded)
+	{
+		startInstance(instance, session, launchScript, profiler, trace);
+	}
+	// failing to update is fine if the auth server didn't respond - we can't expect to reach
+	// the update servers either. launch with what we have.
+	else if (updateFailed && !session->auth_server_online)
+	{
+		launchInstance(instance, session, profiler, trace);
+	}
+	else
+	{
+		onGameUpdateError(failReason);
+	}
 }
 
 void MainWindow::launchInstance(InstancePtr instance, AuthSessionPtr session,
-								BaseProfilerFactory *profiler)
+								BaseProfilerFactory *profiler, TracePtr trace)
 {
 	Q_ASSERT_X(instance != NULL, "launchInstance", "instance is NULL");
-	Q_ASSERT_X(session.get() != nullptr, "launchInstance", "session is NULL");
 
-	QString launchScript;
+	// no update, but the preparation writes to the caches too. wait for whoever is using them.
+	LaunchPipeline pipeline(instance, false);
+	pipeline.setTrace(trace);
+	ProgressDialog tDialog(this);
+	tDialog.exec(&pipeline);
+	if (!pipeline.successful())
+		return;
+
+	startInstance(instance, session, pipeline.launchScript(), profiler, trace);
+}
+
+void MainWindow::startInstance(InstancePtr instance, AuthSessionPtr session,
+							   QString launchScript, BaseProfilerFactory *profiler,
+							   TracePtr trace)
+{
+	Q_ASSERT_X(instance != NULL, "startInstance", "instance is NULL");
+	Q_ASSERT_X(session.get() != nullptr, "startInstance", "session is NULL");
 
-	if (!instance->prepareForLaunch(session, launchScript))
+	int span = trace ? trace->begin(tr("Prepare launch for the account"), "launch") : -1;
+	bool prepared = instance->prepareForLaunch(session, launchScript);
+	if (trace)
+		trace->end(span);
+	if (!prepared)
 		return;
 
 	MinecraftProcess *proc = new MinecraftProcess(instance);
+	proc->setTrace(trace);
 	proc->setLaunchScript(launchScript);
 	proc->setWorkdir(instance->minecraftRoot());
 
-	this->hide();
-
-	console = new ConsoleWindow(proc);
-	connect(console, SIGNAL(isClosing()), this, SLOT(instanceEnded()));
+	// forget the consoles that were closed since the last launch
+	for (auto it = m_consoles.begin(); it != m_consoles.end();)
+	{
+		if (it.value().isNull())
+			it = m_consoles.erase(it);
+		else
+			++it;
+	}
+	m_consoles.insert(proc, new ConsoleWindow(proc));
+	MMC->runningInstances()->addProcess(proc);
 
 	proc->setLogin(session);
 	proc->arm();
@@ -1720,9 +1831,14 @@ void MainWindow::launchInstance(InstancePtr instance, AuthSessionPtr session,
 				&BaseProfiler::abortProfiling);
 		dialog.show();
 		connect(profilerInstance, &BaseProfiler::readyToLaunch,
-				[&dialog, this, proc](const QString & message)
+				[&dialog, this, proc, profilerInstance](const QString & message)
 		{
 			dialog.accept();
+			if (!profilerInstance->isInteractive())
+			{
+				proc->launch();
+				return;
+			}
 			QMessageBox msg;
 			msg.setText(tr("The launch of Minecraft itself is delayed until you press the "
 						   "button. This is the right time to setup the profiler, as the "
@@ -1831,9 +1947,16 @@ void MainWindow::selectionBad()
 	setSelectedInstanceById(MMC->settings()->get("SelectedInstance").toString());
 }
 
-void MainWindow::instanceEnded()
+void MainWindow::runningInstanceActivated(const QModelIndex &index)
 {
-	this->show();
+	auto proc = (MinecraftProcess *)index.data(RunningInstanceList::ProcessPointerRole)
+					.value<void *>();
+	QPointer<ConsoleWindow> console = m_consoles.value(proc);
+	if (!console)
+		return;
+	console->show();
+	console->raise();
+	console->activateWindow();
 }
 
 void MainWindow::checkMigrateLegacyAssets()
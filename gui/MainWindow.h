@@ -18,18 +18,24 @@
 #include <QMainWindow>
 #include <QProcess>
 #include <QTimer>
+#include <QMap>
+#include <QPointer>
 
 #include "logic/InstanceList.h"
 #include "logic/BaseInstance.h"
 #include "logic/auth/MojangAccount.h"
 #include "logic/net/NetJob.h"
+#include "logic/Trace.h"
 
 class QToolButton;
 class LabeledToolButton;
 class QLabel;
+class QDockWidget;
+class QTreeView;
 class MinecraftProcess;
 class ConsoleWindow;
 class BaseProfilerFactory;
+class LaunchPipeline;
 class GenericPageProvider;
 
 namespace Ui
@@ -121,22 +127,33 @@ slots:
 	void doLaunch(bool online = true, BaseProfilerFactory *profiler = 0);
 
 	/*!
-	 * Launches the given instance with the given account.
+	 * Launches the given instance with the given account, without updating it.
 	 * This function assumes that the given account has a valid, usable access token.
+	 * The preparation waits until no other launch uses the shared caches.
 	 */
-	void launchInstance(InstancePtr instance, AuthSessionPtr session, BaseProfilerFactory *profiler = 0);
+	void launchInstance(InstancePtr instance, AuthSessionPtr session, BaseProfilerFactory *profiler = 0,
+						TracePtr trace = nullptr);
 
 	/*!
-	 * Prepares the given instance for launch with the given account.
+	 * Waits for the launch pipeline to finish updating and preparing the instance,
+	 * then launches it with the given account. The pipeline is released afterwards.
+	 * The launch is recorded in the pipeline's trace.
 	 */
-	void updateInstance(InstancePtr instance, AuthSessionPtr account, BaseProfilerFactory *profiler = 0);
+	void finishLaunch(LaunchPipeline *pipeline, AuthSessionPtr session, BaseProfilerFactory *profiler = 0);
+
+	/*!
+	 * Starts the instance with the given account and an already prepared launch script.
+	 */
+	void startInstance(InstancePtr instance, AuthSessionPtr session, QString launchScript,
+					   BaseProfilerFactory *profiler = 0, TracePtr trace = nullptr);
 
 	void onGameUpdateError(QString error);
 
 	void taskStart();
 	void taskEnd();
 
-	void instanceEnded();
+	/// shows the console of the running instance that was activated in the running list
+	void runningInstanceActivated(const QModelIndex &index);
 
 	// called when an icon is changed in the icon model.
 	void iconUpdated(QString);
@@ -187,8 +204,9 @@ private:
 	class GroupView *view;
 	InstanceProxyModel *proxymodel;
     NetJobPtr skin_download_job;
-	MinecraftProcess *proc;
-	ConsoleWindow *console;
+	QMap<MinecraftProcess *, QPointer<ConsoleWindow>> m_consoles;
+	QDockWidget *m_runningDock;
+	QTreeView *m_runningView;
 	LabeledToolButton *renameButton;
 	QToolButton *changeIconButton;
 	QToolButton *newsLabel;
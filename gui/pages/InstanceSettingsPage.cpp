@@ -74,12 +74,14 @@ void InstanceSettingsPage::applySettings()
 		m_settings->set("MinMemAlloc", ui->minMemSpinBox->value());
 		m_settings->set("MaxMemAlloc", ui->maxMemSpinBox->value());
 		m_settings->set("PermGen", ui->permGenSpinBox->value());
+		m_settings->set("AutoMemAlloc", ui->autoMemCheckBox->isChecked());
 	}
 	else
 	{
 		m_settings->reset("MinMemAlloc");
 		m_settings->reset("MaxMemAlloc");
 		m_settings->reset("PermGen");
+		m_settings->reset("AutoMemAlloc");
 	}
 
 	// Java Install Settings
@@ -143,6 +145,7 @@ void InstanceSettingsPage::loadSettings()
 	ui->minMemSpinBox->setValue(m_settings->get("MinMemAlloc").toInt());
 	ui->maxMemSpinBox->setValue(m_settings->get("MaxMemAlloc").toInt());
 	ui->permGenSpinBox->setValue(m_settings->get("PermGen").toInt());
+	ui->autoMemCheckBox->setChecked(m_settings->get("AutoMemAlloc").toBool());
 
 	// Java Settings
 	bool overrideJava = m_settings->get("OverrideJava").toBool();
@@ -14,6 +14,13 @@
 #include <QClipboard>
 #include <QDesktopServices>
 #include <QKeyEvent>
+#include <QScrollBar>
+#include <QSaveFile>
+#include <QCryptographicHash>
+#include <QCache>
+#include <QDirIterator>
+#include <QtConcurrentRun>
+#include <algorithm>
 
 #include <pathutils.h>
 #include <MultiMC.h>
@@ -25,10 +32,59 @@
 #include "logic/screenshots/ImgurAlbumCreation.h"
 #include "logic/tasks/SequentialTask.h"
 
-#include "logic/RWStorage.h"
+#include "logic/LRUCache.h"
+#include "logger/QsLog.h"
 
-typedef RWStorage<QString, QIcon> SharedIconCache;
-typedef std::shared_ptr<SharedIconCache> SharedIconCachePtr;
+/// thumbnails by screenshot path, shared by all the screenshot pages
+typedef LRUCache<QString, QImage> SharedThumbnailCache;
+typedef std::shared_ptr<SharedThumbnailCache> SharedThumbnailCachePtr;
+
+static SharedThumbnailCachePtr thumbnailCache()
+{
+	// enough for a few hundred 256x256 thumbnails
+	static auto cache = std::make_shared<SharedThumbnailCache>(64 * 1024 * 1024);
+	return cache;
+}
+
+// the thumbnails on disk beyond this are deleted, the least recently used first
+static const qint64 thumbnailDiskCacheSize = 128 * 1024 * 1024;
+
+static void pruneThumbnailDiskCache(const QString &path, qint64 maxSize)
+{
+	// the access time is updated at least once a day, which is good enough to tell what is used
+	QList<QFileInfo> thumbnails;
+	qint64 total = 0;
+	QDirIterator iter(path, {"*.png"}, QDir::Files);
+	while (iter.hasNext())
+	{
+		iter.next();
+		thumbnails.append(iter.fileInfo());
+		total += iter.fileInfo().size();
+	}
+	if (total <= maxSize)
+		return;
+	auto lastUsed = [](const QFileInfo &info)
+	{
+		return qMax(info.lastRead(), info.lastModified());
+	};
+	std::sort(thumbnails.begin(), thumbnails.end(),
+			  [&lastUsed](const QFileInfo &a, const QFileInfo &b)
+	{
+		return lastUsed(a) < lastUsed(b);
+	});
+	int removed = 0;
+	for (auto &info : thumbnails)
+	{
+		if (total <= maxSize)
+			break;
+		if (QFile::remove(info.absoluteFilePath()))
+		{
+			total -= info.size();
+			removed++;
+		}
+	}
+	QLOG_INFO() << "Removed" << removed << "old thumbnails from" << path;
+}
 
 class ThumbnailingResult : public QObject
 {
@@ -44,23 +100,38 @@ signals:
 class ThumbnailRunnable : public QRunnable
 {
 public:
-	ThumbnailRunnable(QString path, SharedIconCachePtr cache)
+	ThumbnailRunnable(QString path, QString diskCachePath, SharedThumbnailCachePtr cache)
 	{
 		m_path = path;
+		m_diskCachePath = diskCachePath;
 		m_cache = cache;
 	}
 	void run()
 	{
 		QFileInfo info(m_path);
-		if (info.isDir())
+		if (info.isDir() || (info.suffix().compare("png", Qt::CaseInsensitive) != 0))
+		{
+			m_resultEmitter.emitResultsFailed(m_path);
 			return;
-		if ((info.suffix().compare("png", Qt::CaseInsensitive) != 0))
+		}
+
+		// the thumbnail on disk is for this exact version of the file
+		QString key = info.absoluteFilePath() + ":" + QString::number(info.size()) + ":" +
+					  QString::number(info.lastModified().toMSecsSinceEpoch());
+		QString cachedFile =
+			m_diskCachePath + "/" +
+			QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex() + ".png";
+		QImage square;
+		if (square.load(cachedFile, "PNG") && square.size() == QSize(256, 256))
+		{
+			m_cache->add(m_path, square, square.byteCount());
+			m_resultEmitter.emitResultsReady(m_path);
 			return;
+		}
+
 		int tries = 5;
 		while (tries)
 		{
-			if (!m_cache->stale(m_path))
-				return;
 			QImage image(m_path);
 			if (image.isNull())
 			{
@@ -73,24 +144,32 @@ public:
 				small = image.scaledToWidth(512).scaledToWidth(256, Qt::SmoothTransformation);
 			else
 				small = image.scaledToHeight(512).scaledToHeight(256, Qt::SmoothTransformation);
-			auto smallSize = small.size();
 			QPoint offset((256 - small.width()) / 2, (256 - small.height()) / 2);
-			QImage square(QSize(256, 256), QImage::Format_ARGB32);
+			square = QImage(QSize(256, 256), QImage::Format_ARGB32);
 			square.fill(Qt::transparent);
 
 			QPainter painter(&square);
 			painter.drawImage(offset, small);
 			painter.end();
 
-			QIcon icon(QPixmap::fromImage(square));
-			m_cache->add(m_path, icon);
+			if (ensureFilePathExists(cachedFile))
+			{
+				QSaveFile output(cachedFile);
+				if (output.open(QIODevice::WriteOnly) && square.save(&output, "PNG"))
+				{
+					output.commit();
+				}
+			}
+
+			m_cache->add(m_path, square, square.byteCount());
 			m_resultEmitter.emitResultsReady(m_path);
 			return;
 		}
 		m_resultEmitter.emitResultsFailed(m_path);
 	}
 	QString m_path;
-	SharedIconCachePtr m_cache;
+	QString m_diskCachePath;
+	SharedThumbnailCachePtr m_cache;
 	ThumbnailingResult m_resultEmitter;
 };
 
@@ -103,12 +182,27 @@ public:
 	explicit FilterModel(QObject *parent = 0) : QIdentityProxyModel(parent)
 	{
 		m_thumbnailingPool.setMaxThreadCount(4);
-		m_thumbnailCache = std::make_shared<SharedIconCache>();
-		m_thumbnailCache->add("placeholder", MMC->getThemedIcon("screenshot-placeholder"));
+		m_thumbnailCache = thumbnailCache();
+		m_diskCachePath = QDir("cache/thumbnails").absolutePath();
+		// once per run, the page is opened often
+		static bool pruned = false;
+		if (!pruned)
+		{
+			pruned = true;
+			QtConcurrent::run(&pruneThumbnailDiskCache, m_diskCachePath,
+							  thumbnailDiskCacheSize);
+		}
+		// a 256x256 thumbnail costs 256 KiB, this is about 50 of them
+		m_icons.setMaxCost(12 * 1024 * 1024);
+		m_placeholder = MMC->getThemedIcon("screenshot-placeholder");
 		connect(&watcher, SIGNAL(fileChanged(QString)), SLOT(fileChanged(QString)));
 		// FIXME: the watched file set is not updated when files are removed
 	}
-	virtual ~FilterModel() { m_thumbnailingPool.waitForDone(500); }
+	virtual ~FilterModel()
+	{
+		m_queue.clear();
+		m_thumbnailingPool.waitForDone(500);
+	}
 	virtual QVariant data(const QModelIndex &proxyIndex, int role = Qt::DisplayRole) const
 	{
 		auto model = sourceModel();
@@ -124,21 +218,25 @@ public:
 			QVariant result =
 				sourceModel()->data(mapToSource(proxyIndex), QFileSystemModel::FilePathRole);
 			QString filePath = result.toString();
-			QIcon temp;
+			QImage temp;
 			if (!watched.contains(filePath))
 			{
 				((QFileSystemWatcher &)watcher).addPath(filePath);
 				((QSet<QString> &)watched).insert(filePath);
 			}
-			if (m_thumbnailCache->get(filePath, temp))
+			// the views ask for all the items while laying them out. thumbnails are only made
+			// for the ones that are shown, see requestThumbnails
+			if (auto icon = m_icons.object(filePath))
 			{
-				return temp;
+				return *icon;
 			}
-			if (!m_failed.contains(filePath))
+			if (m_thumbnailCache->get(filePath, temp))
 			{
-				((FilterModel *)this)->thumbnailImage(filePath);
+				QIcon icon(QPixmap::fromImage(temp));
+				m_icons.insert(filePath, new QIcon(icon), temp.byteCount());
+				return icon;
 			}
-			return (m_thumbnailCache->get("placeholder"));
+			return m_placeholder;
 		}
 		return sourceModel()->data(mapToSource(proxyIndex), role);
 	}
@@ -159,31 +257,90 @@ public:
 		return model->setData(mapToSource(index), value.toString() + ".png", role);
 	}
 
+	/*!
+	 * Make thumbnails for these items, in this order. Replaces the previous request, so
+	 * scrolling past items doesn't leave work behind.
+	 */
+	void requestThumbnails(const QModelIndexList &indexes)
+	{
+		m_queue.clear();
+		for (auto index : indexes)
+		{
+			QString filePath = data(index, QFileSystemModel::FilePathRole).toString();
+			if (m_failed.contains(filePath) || m_inFlight.contains(filePath) ||
+				m_icons.contains(filePath) || m_thumbnailCache->has(filePath))
+				continue;
+			m_queue.append(filePath);
+		}
+		startThumbnailing();
+	}
+
 private:
+	void startThumbnailing()
+	{
+		// keep the pool busy, but leave the rest queued so it can still be replaced
+		while (!m_queue.isEmpty() && m_inFlight.size() < m_thumbnailingPool.maxThreadCount())
+		{
+			thumbnailImage(m_queue.takeFirst());
+		}
+	}
 	void thumbnailImage(QString path)
 	{
-		auto runnable = new ThumbnailRunnable(path, m_thumbnailCache);
+		m_inFlight.insert(path);
+		auto runnable = new ThumbnailRunnable(path, m_diskCachePath, m_thumbnailCache);
 		connect(&(runnable->m_resultEmitter), SIGNAL(resultsReady(QString)),
 				SLOT(thumbnailReady(QString)));
 		connect(&(runnable->m_resultEmitter), SIGNAL(resultsFailed(QString)),
 				SLOT(thumbnailFailed(QString)));
-		((QThreadPool &)m_thumbnailingPool).start(runnable);
+		m_thumbnailingPool.start(runnable);
+	}
+	void thumbnailChanged(QString path)
+	{
+		auto model = (QFileSystemModel *)sourceModel();
+		if (!model)
+			return;
+		auto index = mapFromSource(model->index(path));
+		if (index.isValid())
+			emit dataChanged(index, index, {Qt::DecorationRole});
 	}
 private slots:
-	void thumbnailReady(QString path) { emit layoutChanged(); }
-	void thumbnailFailed(QString path) { m_failed.insert(path); }
+	void thumbnailReady(QString path)
+	{
+		m_inFlight.remove(path);
+		m_icons.remove(path);
+		thumbnailChanged(path);
+		startThumbnailing();
+	}
+	void thumbnailFailed(QString path)
+	{
+		m_inFlight.remove(path);
+		m_failed.insert(path);
+		startThumbnailing();
+	}
 	void fileChanged(QString filepath)
 	{
-		m_thumbnailCache->setStale(filepath);
-		thumbnailImage(filepath);
+		// the old thumbnail stays until the new one is ready
+		m_failed.remove(filepath);
+		if (!m_inFlight.contains(filepath))
+		{
+			m_queue.removeAll(filepath);
+			m_queue.prepend(filepath);
+			startThumbnailing();
+		}
 		// reinsert the path...
 		watcher.removePath(filepath);
 		watcher.addPath(filepath);
 	}
 
 private:
-	SharedIconCachePtr m_thumbnailCache;
+	SharedThumbnailCachePtr m_thumbnailCache;
+	QString m_diskCachePath;
+	QIcon m_placeholder;
+	/// the icons made from the thumbnails, so data() doesn't convert them every time
+	mutable QCache<QString, QIcon> m_icons;
 	QThreadPool m_thumbnailingPool;
+	QStringList m_queue;
+	QSet<QString> m_inFlight;
 	QSet<QString> m_failed;
 	QSet<QString> watched;
 	QFileSystemWatcher watcher;
@@ -236,6 +393,42 @@ ScreenshotsPage::ScreenshotsPage(BaseInstance *instance, QWidget *parent)
 	ui->listView->setEditTriggers(0);
 	ui->listView->setItemDelegate(new CenteredEditingDelegate(this));
 	connect(ui->listView, SIGNAL(activated(QModelIndex)), SLOT(onItemActivated(QModelIndex)));
+
+	// thumbnails follow the viewport. wait for things to settle before asking for them.
+	m_thumbnailTimer.setSingleShot(true);
+	m_thumbnailTimer.setInterval(50);
+	connect(&m_thumbnailTimer, SIGNAL(timeout()), SLOT(requestVisibleThumbnails()));
+	connect(ui->listView->verticalScrollBar(), SIGNAL(valueChanged(int)),
+			&m_thumbnailTimer, SLOT(start()));
+	connect(ui->listView->verticalScrollBar(), SIGNAL(rangeChanged(int, int)),
+			&m_thumbnailTimer, SLOT(start()));
+	connect(m_filterModel.get(), SIGNAL(rowsInserted(QModelIndex, int, int)),
+			&m_thumbnailTimer, SLOT(start()));
+	connect(m_filterModel.get(), SIGNAL(layoutChanged()), &m_thumbnailTimer, SLOT(start()));
+	connect(m_model.get(), SIGNAL(directoryLoaded(QString)), &m_thumbnailTimer, SLOT(start()));
+}
+
+void ScreenshotsPage::requestVisibleThumbnails()
+{
+	auto root = ui->listView->rootIndex();
+	int rows = m_filterModel->rowCount(root);
+	if (!rows)
+		return;
+
+	// what is visible first, then a screen worth of items above and below it
+	QRect visible = ui->listView->viewport()->rect();
+	QRect nearby = visible.adjusted(0, -visible.height(), 0, visible.height());
+	QModelIndexList shown, prefetched;
+	for (int row = 0; row < rows; row++)
+	{
+		auto index = m_filterModel->index(row, 0, root);
+		QRect rect = ui->listView->visualRect(index);
+		if (rect.intersects(visible))
+			shown.append(index);
+		else if (rect.intersects(nearby))
+			prefetched.append(index);
+	}
+	m_filterModel->requestThumbnails(shown + prefetched);
 }
 
 bool ScreenshotsPage::eventFilter(QObject *obj, QEvent *evt)
@@ -356,6 +549,7 @@ void ScreenshotsPage::opened()
 		QString path = QDir(m_folder).absolutePath();
 		m_model->setRootPath(path);
 		ui->listView->setRootIndex(m_filterModel->mapFromSource(m_model->index(path)));
+		m_thumbnailTimer.start();
 	}
 }
 
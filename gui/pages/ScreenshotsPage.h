@@ -16,13 +16,14 @@
 #pragma once
 
 #include <QWidget>
+#include <QTimer>
 
 #include "logic/OneSixInstance.h"
 #include "BasePage.h"
 #include <MultiMC.h>
 
 class QFileSystemModel;
-class QIdentityProxyModel;
+class FilterModel;
 namespace Ui
 {
 class ScreenshotsPage;
@@ -70,11 +71,13 @@ private slots:
 	void on_renameBtn_clicked();
 	void on_viewFolderBtn_clicked();
 	void onItemActivated(QModelIndex);
+	void requestVisibleThumbnails();
 
 private:
 	Ui::ScreenshotsPage *ui;
 	std::shared_ptr<QFileSystemModel> m_model;
-	std::shared_ptr<QIdentityProxyModel> m_filterModel;
+	std::shared_ptr<FilterModel> m_filterModel;
+	QTimer m_thumbnailTimer;
 	QString m_folder;
 	bool m_valid = false;
 };
@@ -53,6 +53,7 @@ void ExternalToolsPage::loadSettings()
 	auto s = MMC->settings();
 	ui->jprofilerPathEdit->setText(s->get("JProfilerPath").toString());
 	ui->jvisualvmPathEdit->setText(s->get("JVisualVMPath").toString());
+	ui->jcmdPathEdit->setText(s->get("JcmdPath").toString());
 	ui->mceditPathEdit->setText(s->get("MCEditPath").toString());
 
 	// Editors
@@ -63,6 +64,7 @@ void ExternalToolsPage::applySettings()
 	auto s = MMC->settings();
 	s->set("JProfilerPath", ui->jprofilerPathEdit->text());
 	s->set("JVisualVMPath", ui->jvisualvmPathEdit->text());
+	s->set("JcmdPath", ui->jcmdPathEdit->text());
 	s->set("MCEditPath", ui->mceditPathEdit->text());
 
 	// Editors
@@ -156,6 +158,44 @@ void ExternalToolsPage::on_jvisualvmCheckBtn_clicked()
 		QMessageBox::information(this, tr("OK"), tr("JVisualVM setup seems to be OK"));
 	}
 }
+void ExternalToolsPage::on_jcmdPathBtn_clicked()
+{
+	QString raw_dir = ui->jcmdPathEdit->text();
+	QString error;
+	do
+	{
+		raw_dir = QFileDialog::getOpenFileName(this, tr("jcmd Executable"), raw_dir);
+		if (raw_dir.isEmpty())
+		{
+			break;
+		}
+		QString cooked_dir = NormalizePath(raw_dir);
+		if (!MMC->profilers()["jfr"]->check(cooked_dir, &error))
+		{
+			QMessageBox::critical(this, tr("Error"),
+								  tr("Error while checking jcmd:\n%1").arg(error));
+			continue;
+		}
+		else
+		{
+			ui->jcmdPathEdit->setText(cooked_dir);
+			break;
+		}
+	} while (1);
+}
+void ExternalToolsPage::on_jcmdCheckBtn_clicked()
+{
+	QString error;
+	if (!MMC->profilers()["jfr"]->check(ui->jcmdPathEdit->text(), &error))
+	{
+		QMessageBox::critical(this, tr("Error"),
+							  tr("Error while checking jcmd:\n%1").arg(error));
+	}
+	else
+	{
+		QMessageBox::information(this, tr("OK"), tr("jcmd setup seems to be OK"));
+	}
+}
 
 void ExternalToolsPage::on_mceditPathBtn_clicked()
 {
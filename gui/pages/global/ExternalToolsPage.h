@@ -68,6 +68,8 @@ slots:
 	void on_jprofilerCheckBtn_clicked();
 	void on_jvisualvmPathBtn_clicked();
 	void on_jvisualvmCheckBtn_clicked();
+	void on_jcmdPathBtn_clicked();
+	void on_jcmdCheckBtn_clicked();
 	void on_mceditPathBtn_clicked();
 	void on_mceditCheckBtn_clicked();
 	void on_jsonEditorBrowseBtn_clicked();
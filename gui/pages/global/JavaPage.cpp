@@ -65,11 +65,13 @@ void JavaPage::applySettings()
 	s->set("MinMemAlloc", ui->minMemSpinBox->value());
 	s->set("MaxMemAlloc", ui->maxMemSpinBox->value());
 	s->set("PermGen", ui->permGenSpinBox->value());
+	s->set("AutoMemAlloc", ui->autoMemCheckBox->isChecked());
 
 	// Java Settings
 	s->set("JavaPath", ui->javaPathTextBox->text());
 	s->set("JvmArgs", ui->jvmArgsTextBox->text());
 	NagUtils::checkJVMArgs(s->get("JvmArgs").toString(), this->parentWidget());
+	s->set("UseClassDataSharing", ui->classDataSharingCheckBox->isChecked());
 
 	// Custom Commands
 	s->set("PreLaunchCommand", ui->preLaunchCmdTextBox->text());
@@ -82,10 +84,12 @@ void JavaPage::loadSettings()
 	ui->minMemSpinBox->setValue(s->get("MinMemAlloc").toInt());
 	ui->maxMemSpinBox->setValue(s->get("MaxMemAlloc").toInt());
 	ui->permGenSpinBox->setValue(s->get("PermGen").toInt());
+	ui->autoMemCheckBox->setChecked(s->get("AutoMemAlloc").toBool());
 
 	// Java Settings
 	ui->javaPathTextBox->setText(s->get("JavaPath").toString());
 	ui->jvmArgsTextBox->setText(s->get("JvmArgs").toString());
+	ui->classDataSharingCheckBox->setChecked(s->get("UseClassDataSharing").toBool());
 
 	// Custom Commands
 	ui->preLaunchCmdTextBox->setText(s->get("PreLaunchCommand").toString());
@@ -76,6 +76,8 @@ void MinecraftPage::applySettings()
 	auto s = MMC->settings();
 	// Minecraft version updates
 	s->set("AutoUpdateMinecraftVersions", ui->autoupdateMinecraft->isChecked());
+	s->set("VerifyInstanceOnLaunch", ui->verifyOnLaunch->isChecked());
+	s->set("RebuildLaunchArtifacts", ui->rebuildOnLaunch->isChecked());
 
 	// Window Size
 	s->set("LaunchMaximized", ui->maximizedCheckBox->isChecked());
@@ -88,6 +90,8 @@ void MinecraftPage::loadSettings()
 	auto s = MMC->settings();
 	// Minecraft version updates
 	ui->autoupdateMinecraft->setChecked(s->get("AutoUpdateMinecraftVersions").toBool());
+	ui->verifyOnLaunch->setChecked(s->get("VerifyInstanceOnLaunch").toBool());
+	ui->rebuildOnLaunch->setChecked(s->get("RebuildLaunchArtifacts").toBool());
 
 	// Window Size
 	ui->maximizedCheckBox->setChecked(s->get("LaunchMaximized").toBool());
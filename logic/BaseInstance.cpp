@@ -51,6 +51,7 @@ BaseInstance::BaseInstance(const QString &rootDir, SettingsObject *settings, QOb
 	m_settings->registerSetting("OverrideJavaArgs", false);
 	m_settings->registerOverride(globalSettings->getSetting("JavaPath"));
 	m_settings->registerOverride(globalSettings->getSetting("JvmArgs"));
+	m_settings->registerOverride(globalSettings->getSetting("UseClassDataSharing"));
 
 	// Custom Commands
 	m_settings->registerSetting({"OverrideCommands","OverrideLaunchCmd"}, false);
@@ -68,6 +69,7 @@ BaseInstance::BaseInstance(const QString &rootDir, SettingsObject *settings, QOb
 	m_settings->registerOverride(globalSettings->getSetting("MinMemAlloc"));
 	m_settings->registerOverride(globalSettings->getSetting("MaxMemAlloc"));
 	m_settings->registerOverride(globalSettings->getSetting("PermGen"));
+	m_settings->registerOverride(globalSettings->getSetting("AutoMemAlloc"));
 
 	// Console
 	m_settings->registerSetting("OverrideConsole", false);
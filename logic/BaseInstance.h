@@ -98,6 +98,25 @@ public:
 
 	virtual QStringList extraArguments() const;
 
+	/// how many mods the game loads, for sizing its heap
+	virtual int loadedModCount()
+	{
+		return 0;
+	}
+	/// the size of the assets of the current version in bytes, for sizing the heap
+	virtual qint64 assetsSize()
+	{
+		return 0;
+	}
+
+	/// what the launch preparation has to say in the launch log. cleared by taking it.
+	QStringList takeLaunchNotes()
+	{
+		QStringList notes = m_launchNotes;
+		m_launchNotes.clear();
+		return notes;
+	}
+
 	virtual QString intendedVersionId() const = 0;
 	virtual bool setIntendedVersionId(QString version) = 0;
 
@@ -164,7 +183,20 @@ public:
 	/// returns a valid update task
 	virtual std::shared_ptr<Task> doUpdate() = 0;
 
-	/// returns a valid minecraft process, ready for launch with the given account.
+	/// returns the update task to run before a launch, or nullptr if the instance is known to be
+	/// up to date
+	virtual std::shared_ptr<Task> doLaunchUpdate()
+	{
+		return doUpdate();
+	}
+
+	/*!
+	 * Does the part of the launch preparation that doesn't need an account (icon, assets, class
+	 * path) and starts the launch script with it. This can run while the account is validated.
+	 */
+	virtual bool prepareLocalLaunch(QString & launchScript) = 0;
+
+	/// finishes the launch script started by prepareLocalLaunch with the given account.
 	virtual bool prepareForLaunch(AuthSessionPtr account, QString & launchScript) = 0;
 
 	/// do any necessary cleanups after the instance finishes. also runs before
@@ -216,6 +248,7 @@ protected:
 	std::shared_ptr<SettingsObject> m_settings;
 	InstanceFlags m_flags;
 	bool m_isRunning = false;
+	QStringList m_launchNotes;
 };
 
 Q_DECLARE_METATYPE(std::shared_ptr<BaseInstance>)
@@ -24,6 +24,7 @@
 #include <QJsonArray>
 #include <QXmlStreamReader>
 #include <QRegularExpression>
+#include <QSaveFile>
 #include <pathutils.h>
 
 #include "MultiMC.h"
@@ -36,10 +37,15 @@
 #include "gui/groupview/GroupView.h"
 
 const static int GROUP_FILE_FORMAT_VERSION = 1;
+/// how long group changes wait for more before they are written
+const static int GROUP_SAVE_DELAY_MS = 500;
 
 InstanceList::InstanceList(const QString &instDir, QObject *parent)
 	: QAbstractListModel(parent), m_instDir(instDir)
 {
+	m_groupSaveTimer.setSingleShot(true);
+	m_groupSaveTimer.setInterval(GROUP_SAVE_DELAY_MS);
+	connect(&m_groupSaveTimer, &QTimer::timeout, this, &InstanceList::saveGroupList);
 	connect(MMC, &MultiMC::aboutToQuit, this, &InstanceList::saveGroupList);
 
 	if (!QDir::current().exists(m_instDir))
@@ -50,6 +56,10 @@ InstanceList::InstanceList(const QString &instDir, QObject *parent)
 
 InstanceList::~InstanceList()
 {
+	if (m_groupSaveTimer.isActive())
+	{
+		saveGroupList();
+	}
 }
 
 int InstanceList::rowCount(const QModelIndex &parent) const
@@ -120,8 +130,13 @@ Qt::ItemFlags InstanceList::flags(const QModelIndex &index) const
 
 void InstanceList::groupChanged()
 {
-	// save the groups. save all of them.
-	saveGroupList();
+	auto inst = qobject_cast<BaseInstance *>(sender());
+	if (inst)
+	{
+		untrackGroup(inst->id());
+		trackGroup(inst);
+	}
+	m_groupSaveTimer.start();
 }
 
 QStringList InstanceList::getGroups()
@@ -129,63 +144,66 @@ QStringList InstanceList::getGroups()
 	return m_groups.toList();
 }
 
-void InstanceList::saveGroupList()
+void InstanceList::trackGroup(BaseInstance *inst)
 {
-	QString groupFileName = m_instDir + "/instgroups.json";
-	QFile groupFile(groupFileName);
-
-	// if you can't open the file, fail
-	if (!groupFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
-	{
-		// An error occurred. Ignore it.
-		QLOG_ERROR() << "Failed to save instance group file.";
+	QString group = inst->group();
+	if (group.isEmpty())
 		return;
-	}
-	QTextStream out(&groupFile);
-	QMap<QString, QSet<QString>> groupMap;
-	for (auto instance : m_instances)
-	{
-		QString id = instance->id();
-		QString group = instance->group();
-		if (group.isEmpty())
-			continue;
-
-		// keep a list/set of groups for choosing
-		m_groups.insert(group);
+	// keep a list/set of groups for choosing
+	m_groups.insert(group);
+	m_groupMembers[group].insert(inst->id());
+}
 
-		if (!groupMap.count(group))
-		{
-			QSet<QString> set;
-			set.insert(id);
-			groupMap[group] = set;
-		}
+void InstanceList::untrackGroup(const QString &id)
+{
+	for (auto iter = m_groupMembers.begin(); iter != m_groupMembers.end();)
+	{
+		iter->remove(id);
+		if (iter->isEmpty())
+			iter = m_groupMembers.erase(iter);
 		else
-		{
-			QSet<QString> &set = groupMap[group];
-			set.insert(id);
-		}
+			iter++;
 	}
+}
+
+QByteArray InstanceList::groupListJson() const
+{
 	QJsonObject toplevel;
 	toplevel.insert("formatVersion", QJsonValue(QString("1")));
 	QJsonObject groupsArr;
-	for (auto iter = groupMap.begin(); iter != groupMap.end(); iter++)
+	for (auto iter = m_groupMembers.begin(); iter != m_groupMembers.end(); iter++)
 	{
-		auto list = iter.value();
-		auto name = iter.key();
+		// sorted, so the same groups always give the same file
+		QStringList ids = iter.value().toList();
+		ids.sort();
 		QJsonObject groupObj;
-		QJsonArray instanceArr;
 		groupObj.insert("hidden", QJsonValue(QString("false")));
-		for (auto item : list)
-		{
-			instanceArr.append(QJsonValue(item));
-		}
-		groupObj.insert("instances", instanceArr);
-		groupsArr.insert(name, groupObj);
+		groupObj.insert("instances", QJsonArray::fromStringList(ids));
+		groupsArr.insert(iter.key(), groupObj);
 	}
 	toplevel.insert("groups", groupsArr);
-	QJsonDocument doc(toplevel);
-	groupFile.write(doc.toJson());
-	groupFile.close();
+	return QJsonDocument(toplevel).toJson();
+}
+
+void InstanceList::saveGroupList()
+{
+	m_groupSaveTimer.stop();
+	QByteArray contents = groupListJson();
+	if (contents == m_savedGroupList)
+		return;
+
+	QString groupFileName = m_instDir + "/instgroups.json";
+	QSaveFile groupFile(groupFileName);
+
+	// if you can't write the file, fail
+	if (!groupFile.open(QIODevice::WriteOnly) || groupFile.write(contents) != contents.size() ||
+		!groupFile.commit())
+	{
+		// An error occurred. Ignore it.
+		QLOG_ERROR() << "Failed to save instance group file.";
+		return;
+	}
+	m_savedGroupList = contents;
 }
 
 void InstanceList::loadGroupList(QMap<QString, QString> &groupMap)
@@ -283,11 +301,12 @@ void InstanceList::loadGroupList(QMap<QString, QString> &groupMap)
 	}
 }
 
-QSet<FTBRecord> InstanceList::discoverFTBInstances()
+QSet<FTBRecord> InstanceList::discoverFTBInstances(const QString &launcherDataRoot,
+													const QString &ftbRoot)
 {
 	QSet<FTBRecord> records;
-	QDir dir = QDir(MMC->settings()->get("FTBLauncherDataRoot").toString());
-	QDir dataDir = QDir(MMC->settings()->get("FTBRoot").toString());
+	QDir dir = QDir(launcherDataRoot);
+	QDir dataDir = QDir(ftbRoot);
 	if (!dataDir.exists())
 	{
 		QLOG_INFO() << "The FTB directory specified does not exist. Please check your settings";
@@ -379,10 +398,27 @@ QSet<FTBRecord> InstanceList::discoverFTBInstances()
 	return records;
 }
 
+void InstanceList::setDiscoveredFTBInstances(const QSet<FTBRecord> &records)
+{
+	m_discoveredFTB = records;
+	m_hasDiscoveredFTB = true;
+}
+
 void InstanceList::loadFTBInstances(QMap<QString, QString> &groupMap,
 									QList<InstancePtr> &tempList)
 {
-	auto records = discoverFTBInstances();
+	QSet<FTBRecord> records;
+	if (m_hasDiscoveredFTB)
+	{
+		records = m_discoveredFTB;
+		m_discoveredFTB.clear();
+		m_hasDiscoveredFTB = false;
+	}
+	else
+	{
+		records = discoverFTBInstances(MMC->settings()->get("FTBLauncherDataRoot").toString(),
+									   MMC->settings()->get("FTBRoot").toString());
+	}
 	if (!records.size())
 	{
 		QLOG_INFO() << "No FTB instances to load.";
@@ -448,6 +484,11 @@ void InstanceList::loadFTBInstances(QMap<QString, QString> &groupMap,
 
 InstanceList::InstListError InstanceList::loadList()
 {
+	// changes still waiting to be written would be lost otherwise
+	if (m_groupSaveTimer.isActive())
+	{
+		saveGroupList();
+	}
 	// load the instance groups
 	QMap<QString, QString> groupMap;
 	loadGroupList(groupMap);
@@ -474,19 +515,60 @@ InstanceList::InstListError InstanceList::loadList()
 	{
 		loadFTBInstances(groupMap, tempList);
 	}
-	beginResetModel();
-	m_instances.clear();
-	for(auto inst: tempList)
+	QHash<QString, InstancePtr> loaded;
+	for (auto inst : tempList)
 	{
-		inst->setParent(this);
-		connect(inst.get(), SIGNAL(propertiesChanged(BaseInstance *)), this,
-				SLOT(propertiesChanged(BaseInstance *)));
-		connect(inst.get(), SIGNAL(groupChanged()), this, SLOT(groupChanged()));
-		connect(inst.get(), SIGNAL(nuked(BaseInstance *)), this,
-				SLOT(instanceNuked(BaseInstance *)));
-		m_instances.append(inst);
+		loaded.insert(inst->instanceRoot(), inst);
+	}
+
+	// instances that are gone go, the others are swapped in their rows
+	for (int row = m_instances.size() - 1; row >= 0; row--)
+	{
+		InstancePtr old = m_instances[row];
+		auto iter = loaded.find(old->instanceRoot());
+		if (iter == loaded.end())
+		{
+			removeInstance(row);
+			continue;
+		}
+		InstancePtr inst = iter.value();
+		loaded.erase(iter);
+		if (old->isRunning())
+		{
+			// the launch holds on to this one
+			continue;
+		}
+		disconnect(old.get(), 0, this, 0);
+		connectInstance(inst);
+		m_instances[row] = inst;
+		emit dataChanged(index(row), index(row));
+	}
+
+	// and the new ones are added at the end, in the order they were found
+	QList<InstancePtr> added;
+	for (auto inst : tempList)
+	{
+		if (loaded.contains(inst->instanceRoot()))
+			added.append(inst);
+	}
+	if (!added.isEmpty())
+	{
+		int first = m_instances.size();
+		beginInsertRows(QModelIndex(), first, first + added.size() - 1);
+		for (auto inst : added)
+		{
+			connectInstance(inst);
+			m_instances.append(inst);
+		}
+		reindex(first);
+		endInsertRows();
+	}
+
+	m_groupMembers.clear();
+	for (auto inst : m_instances)
+	{
+		trackGroup(inst.get());
 	}
-	endResetModel();
 	emit dataIsInvalid();
 	return NoError;
 }
@@ -497,58 +579,120 @@ void InstanceList::clear()
 	beginResetModel();
 	saveGroupList();
 	m_instances.clear();
+	m_rowsById.clear();
+	m_groupMembers.clear();
 	endResetModel();
 	emit dataIsInvalid();
 }
 
 void InstanceList::on_InstFolderChanged(const Setting &setting, QVariant value)
 {
+	if (m_groupSaveTimer.isActive())
+	{
+		saveGroupList();
+	}
 	m_instDir = value.toString();
+	// the file in the new folder isn't known yet
+	m_savedGroupList.clear();
 	loadList();
 }
 
 /// Add an instance. Triggers notifications, returns the new index
 int InstanceList::add(InstancePtr t)
 {
-	beginInsertRows(QModelIndex(), m_instances.size(), m_instances.size());
+	int row = m_instances.size();
+	beginInsertRows(QModelIndex(), row, row);
 	m_instances.append(t);
-	t->setParent(this);
-	connect(t.get(), SIGNAL(propertiesChanged(BaseInstance *)), this,
-			SLOT(propertiesChanged(BaseInstance *)));
-	connect(t.get(), SIGNAL(groupChanged()), this, SLOT(groupChanged()));
-	connect(t.get(), SIGNAL(nuked(BaseInstance *)), this, SLOT(instanceNuked(BaseInstance *)));
+	connectInstance(t);
+	reindex(row);
 	endInsertRows();
-	return count() - 1;
+	if (!t->group().isEmpty())
+	{
+		trackGroup(t.get());
+		m_groupSaveTimer.start();
+	}
+	return row;
 }
 
-InstancePtr InstanceList::getInstanceById(QString instId) const
+void InstanceList::connectInstance(InstancePtr inst)
 {
-	if (m_instances.isEmpty())
+	inst->setParent(this);
+	connect(inst.get(), SIGNAL(propertiesChanged(BaseInstance *)), this,
+			SLOT(propertiesChanged(BaseInstance *)));
+	connect(inst.get(), SIGNAL(groupChanged()), this, SLOT(groupChanged()));
+	connect(inst.get(), SIGNAL(nuked(BaseInstance *)), this,
+			SLOT(instanceNuked(BaseInstance *)));
+}
+
+void InstanceList::reindex(int firstRow)
+{
+	// ids first seen before firstRow keep their rows
+	QSet<QString> seen;
+	for (int row = firstRow; row < m_instances.size(); row++)
 	{
-		return InstancePtr();
+		QString id = m_instances[row]->id();
+		auto iter = m_rowsById.find(id);
+		if (iter == m_rowsById.end())
+		{
+			m_rowsById.insert(id, row);
+		}
+		else if (*iter >= firstRow && !seen.contains(id))
+		{
+			*iter = row;
+		}
+		seen.insert(id);
 	}
+}
 
-	QListIterator<InstancePtr> iter(m_instances);
-	InstancePtr inst;
-	while (iter.hasNext())
+void InstanceList::removeInstance(int row)
+{
+	InstancePtr inst = m_instances[row];
+	const QString id = inst->id();
+	beginRemoveRows(QModelIndex(), row, row);
+	disconnect(inst.get(), 0, this, 0);
+	m_instances.removeAt(row);
+	if (m_rowsById.value(id, -1) == row)
 	{
-		inst = iter.next();
-		if (inst->id() == instId)
-			break;
+		m_rowsById.remove(id);
 	}
-	if (inst->id() != instId)
+	reindex(row);
+	endRemoveRows();
+
+	untrackGroup(id);
+	// another instance with the same id is still in its group
+	if (auto other = getInstanceById(id))
+	{
+		trackGroup(other.get());
+	}
+}
+
+InstancePtr InstanceList::getInstanceById(QString instId) const
+{
+	int row = m_rowsById.value(instId, -1);
+	if (row == -1)
+	{
 		return InstancePtr();
-	else
-		return iter.peekPrevious();
+	}
+	return m_instances.at(row);
 }
 
 QModelIndex InstanceList::getInstanceIndexById(const QString &id) const
 {
-	return index(getInstIndex(getInstanceById(id).get()));
+	return index(m_rowsById.value(id, -1));
 }
 
 int InstanceList::getInstIndex(BaseInstance *inst) const
 {
+	if (!inst)
+	{
+		return -1;
+	}
+	int row = m_rowsById.value(inst->id(), -1);
+	if (row != -1 && m_instances[row].get() == inst)
+	{
+		return row;
+	}
+	// not the first instance with its id, or not in the list at all
 	for (int i = 0; i < m_instances.count(); i++)
 	{
 		if (inst == m_instances[i].get())
@@ -601,9 +745,8 @@ void InstanceList::instanceNuked(BaseInstance *inst)
 	int i = getInstIndex(inst);
 	if (i != -1)
 	{
-		beginRemoveRows(QModelIndex(), i, i);
-		m_instances.removeAt(i);
-		endRemoveRows();
+		removeInstance(i);
+		m_groupSaveTimer.start();
 	}
 }
 
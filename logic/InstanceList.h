@@ -17,7 +17,9 @@
 
 #include <QObject>
 #include <QAbstractListModel>
+#include <QHash>
 #include <QSet>
+#include <QTimer>
 #include <gui/groupview/GroupedProxyModel.h>
 #include <QIcon>
 
@@ -52,13 +54,8 @@ class InstanceList : public QAbstractListModel
 	Q_OBJECT
 private:
 	void loadGroupList(QMap<QString, QString> &groupList);
-	QSet<FTBRecord> discoverFTBInstances();
 	void loadFTBInstances(QMap<QString, QString> &groupMap, QList<InstancePtr> & tempList);
 
-private
-slots:
-	void saveGroupList();
-
 public:
 	explicit InstanceList(const QString &instDir, QObject *parent = 0);
 	virtual ~InstanceList();
@@ -114,12 +111,20 @@ public:
 	/// Add an instance. Triggers notifications, returns the new index
 	int add(InstancePtr t);
 
-	/// Get an instance by ID
+	/// Get an instance by ID, the first one if two share it
 	InstancePtr getInstanceById(QString id) const;
 
 	QModelIndex getInstanceIndexById(const QString &id) const;
 
-	// FIXME: instead of iterating through all instances and forming a set, keep the set around
+	/*!
+	 * Finds the FTB packs installed by the FTB launcher. Only reads files, so it can run on any
+	 * thread.
+	 */
+	static QSet<FTBRecord> discoverFTBInstances(const QString &launcherDataRoot,
+												const QString &ftbRoot);
+	/// FTB packs found by discoverFTBInstances(), used by the next loadList() instead of looking again
+	void setDiscoveredFTBInstances(const QSet<FTBRecord> &records);
+
 	QStringList getGroups();
 signals:
 	void dataIsInvalid();
@@ -130,9 +135,14 @@ slots:
 
 	/*!
 	 * \brief Loads the instance list. Triggers notifications.
+	 *
+	 * Instances that were loaded before keep their rows, so views keep their state.
 	 */
 	InstListError loadList();
 
+	/// Writes instgroups.json now, if the groups changed since it was last written
+	void saveGroupList();
+
 private
 slots:
 	void propertiesChanged(BaseInstance *inst);
@@ -141,6 +151,13 @@ slots:
 
 private:
 	int getInstIndex(BaseInstance *inst) const;
+	void connectInstance(InstancePtr inst);
+	/// finds the rows of the ids from firstRow on again, after rows there moved
+	void reindex(int firstRow);
+	void removeInstance(int row);
+	void trackGroup(BaseInstance *inst);
+	void untrackGroup(const QString &id);
+	QByteArray groupListJson() const;
 
 	bool continueProcessInstance(InstancePtr instPtr, const int error, const QDir &dir,
 								 QMap<QString, QString> &groupMap);
@@ -148,7 +165,16 @@ private:
 protected:
 	QString m_instDir;
 	QList<InstancePtr> m_instances;
+	/// the row of each id, in step with m_instances
+	QHash<QString, int> m_rowsById;
 	QSet<QString> m_groups;
+	/// the ids in each group, as they go into instgroups.json
+	QMap<QString, QSet<QString>> m_groupMembers;
+	/// group changes come in bursts, they are written together
+	QTimer m_groupSaveTimer;
+	QByteArray m_savedGroupList;
+	QSet<FTBRecord> m_discoveredFTB;
+	bool m_hasDiscoveredFTB = false;
 };
 
 class InstanceProxyModel : public GroupedProxyModel
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <list>
+
+/*!
+ * Thread safe cache that keeps the most recently used values within a total cost.
+ *
+ * The keys are spread over shards with their own locks, so threads working on different keys
+ * rarely wait for each other. Each shard evicts on its own, within its share of the cost.
+ */
+template <typename K, typename V, int Shards = 8>
+class LRUCache
+{
+public:
+	explicit LRUCache(qint64 maxCost) : m_shardMaxCost(qMax<qint64>(1, maxCost / Shards))
+	{
+	}
+	void add(K key, V value, qint64 cost = 1)
+	{
+		auto &shard = shardFor(key);
+		QMutexLocker l(&shard.lock);
+		shard.remove(key);
+		shard.order.push_front(Node{key, value, cost});
+		shard.index.insert(key, shard.order.begin());
+		shard.cost += cost;
+		// always keep the newest value, even if it's too big on its own
+		while (shard.cost > m_shardMaxCost && shard.order.size() > 1)
+		{
+			shard.remove(shard.order.back().key);
+		}
+	}
+	bool get(K key, V &value)
+	{
+		auto &shard = shardFor(key);
+		QMutexLocker l(&shard.lock);
+		auto iter = shard.index.find(key);
+		if (iter == shard.index.end())
+			return false;
+		// move it to the front, it is the most recently used now
+		shard.order.splice(shard.order.begin(), shard.order, iter.value());
+		value = iter.value()->value;
+		return true;
+	}
+	bool has(K key)
+	{
+		auto &shard = shardFor(key);
+		QMutexLocker l(&shard.lock);
+		return shard.index.contains(key);
+	}
+	void remove(K key)
+	{
+		auto &shard = shardFor(key);
+		QMutexLocker l(&shard.lock);
+		shard.remove(key);
+	}
+	void clear()
+	{
+		for (auto &shard : m_shards)
+		{
+			QMutexLocker l(&shard.lock);
+			shard.order.clear();
+			shard.index.clear();
+			shard.cost = 0;
+		}
+	}
+	qint64 totalCost()
+	{
+		qint64 total = 0;
+		for (auto &shard : m_shards)
+		{
+			QMutexLocker l(&shard.lock);
+			total += shard.cost;
+		}
+		return total;
+	}
+
+private:
+	struct Node
+	{
+		K key;
+		V value;
+		qint64 cost;
+	};
+	struct Shard
+	{
+		QMutex lock;
+		std::list<Node> order;
+		QHash<K, typename std::list<Node>::iterator> index;
+		qint64 cost = 0;
+
+		// the lock must be held
+		void remove(const K &key)
+		{
+			auto iter = index.find(key);
+			if (iter == index.end())
+				return;
+			cost -= iter.value()->cost;
+			order.erase(iter.value());
+			index.erase(iter);
+		}
+	};
+	Shard &shardFor(const K &key)
+	{
+		return m_shards[qHash(key) % Shards];
+	}
+
+	const qint64 m_shardMaxCost;
+	Shard m_shards[Shards];
+};
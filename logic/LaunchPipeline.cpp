@@ -0,0 +1,178 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LaunchPipeline.h"
+#include "logger/QsLog.h"
+
+#include <QDir>
+
+LaunchPipeline::LaunchPipeline(InstancePtr instance, bool update, QObject *parent)
+	: Task(parent), m_instance(instance), m_update(update)
+{
+	m_lockTimer.setSingleShot(true);
+	m_lockTimer.setInterval(250);
+	connect(&m_lockTimer, SIGNAL(timeout()), SLOT(tryLockCaches()));
+}
+
+LaunchPipeline::~LaunchPipeline()
+{
+	releaseCaches();
+}
+
+void LaunchPipeline::executeTask()
+{
+	m_launchScript.clear();
+	m_updateFailed = false;
+	tryLockCaches();
+}
+
+void LaunchPipeline::tryLockCaches()
+{
+	if (!m_cacheLock)
+	{
+		// shared with the other MultiMCs running on the same data
+		QDir().mkpath("cache");
+		m_cacheLock.reset(new QLockFile(QDir("cache").absoluteFilePath("shared.lock")));
+		// held for as long as an update takes
+		m_cacheLock->setStaleLockTime(0);
+	}
+	if (!m_cacheLock->tryLock(0))
+	{
+		setStatus(tr("Waiting for another instance to finish updating..."));
+		m_lockTimer.start();
+		return;
+	}
+	if (m_update)
+	{
+		runUpdate();
+	}
+	else
+	{
+		prepareLocal();
+	}
+}
+
+void LaunchPipeline::releaseCaches()
+{
+	m_lockTimer.stop();
+	if (m_cacheLock)
+	{
+		m_cacheLock->unlock();
+		m_cacheLock.reset();
+	}
+}
+
+void LaunchPipeline::runUpdate()
+{
+	m_updateTask = m_instance->doLaunchUpdate();
+	if (!m_updateTask)
+	{
+		prepareLocal();
+		return;
+	}
+	m_updateTask->setTrace(m_trace);
+	connect(m_updateTask.get(), SIGNAL(succeeded()), SLOT(updateTaskSucceeded()));
+	connect(m_updateTask.get(), SIGNAL(failed(QString)), SLOT(updateTaskFailed(QString)));
+	connect(m_updateTask.get(), SIGNAL(status(QString)), SLOT(setStatus(QString)));
+	connect(m_updateTask.get(), SIGNAL(progress(qint64, qint64)),
+			SIGNAL(progress(qint64, qint64)));
+	m_updateTask->start();
+}
+
+void LaunchPipeline::updateTaskSucceeded()
+{
+	// nobody is going to launch with it
+	if (m_released)
+	{
+		emitSucceeded();
+		return;
+	}
+	prepareLocal();
+}
+
+void LaunchPipeline::updateTaskFailed(QString reason)
+{
+	m_updateFailed = true;
+	emitFailed(reason);
+}
+
+void LaunchPipeline::prepareLocal()
+{
+	setStatus(tr("Preparing %1 for launch...").arg(m_instance->name()));
+	int span = m_trace ? m_trace->begin(tr("Prepare local launch"), "launch") : -1;
+	bool prepared = m_instance->prepareLocalLaunch(m_launchScript);
+	if (m_trace)
+		m_trace->end(span);
+	if (!prepared)
+	{
+		emitFailed(tr("Failed to prepare the instance for launch."));
+		return;
+	}
+	QLOG_INFO() << m_instance->name() << ": local launch preparation done";
+	emitSucceeded();
+}
+
+void LaunchPipeline::release()
+{
+	m_released = true;
+	if (!isRunning())
+	{
+		deleteLater();
+		return;
+	}
+	// still waiting for the caches, nothing was started that has to finish
+	if (m_lockTimer.isActive())
+	{
+		emitFailed(tr("Cancelled."));
+	}
+}
+
+void LaunchPipeline::abort()
+{
+	if (!isRunning())
+	{
+		return;
+	}
+	if (m_lockTimer.isActive())
+	{
+		emitFailed(tr("Cancelled."));
+		return;
+	}
+	// the update fails, and the pipeline with it
+	if (m_updateTask && m_updateTask->isRunning())
+	{
+		m_updateTask->abort();
+	}
+}
+
+void LaunchPipeline::emitSucceeded()
+{
+	releaseCaches();
+	Task::emitSucceeded();
+	if (m_released)
+	{
+		deleteLater();
+	}
+}
+
+void LaunchPipeline::emitFailed(QString reason)
+{
+	releaseCaches();
+	Task::emitFailed(reason);
+	if (m_released)
+	{
+		deleteLater();
+	}
+}
@@ -0,0 +1,101 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <QLockFile>
+#include <QTimer>
+
+#include "logic/tasks/Task.h"
+#include "logic/BaseInstance.h"
+
+/*!
+ * Runs the account independent part of a launch: the instance update followed by the local
+ * launch preparation (icon, assets, class path).
+ *
+ * It is started before the account is validated, so both happen at the same time. The caller
+ * joins it once the account is ready and finishes the launch script with prepareForLaunch.
+ *
+ * The update and preparation write into the caches shared by all instances (libraries, assets,
+ * versions), so only one pipeline runs them at a time, in this or any other MultiMC running on
+ * the same data. The others wait for the lock file in the cache folder.
+ */
+class LaunchPipeline : public Task
+{
+	Q_OBJECT
+public:
+	/// without update, only the local launch preparation runs, as for offline launches
+	explicit LaunchPipeline(InstancePtr instance, bool update = true, QObject *parent = 0);
+	virtual ~LaunchPipeline();
+
+	InstancePtr instance() const
+	{
+		return m_instance;
+	}
+
+	/// the launch script prepared by the instance. valid after the pipeline succeeded.
+	QString launchScript() const
+	{
+		return m_launchScript;
+	}
+
+	/// true if the pipeline failed while updating, as opposed to while preparing the launch
+	bool updateFailed() const
+	{
+		return m_updateFailed;
+	}
+
+	/*!
+	 * Gives up on the result. The pipeline deletes itself as soon as it is done,
+	 * so any update that is in progress can finish safely. A pipeline that is still waiting
+	 * for the caches stops right away, and the local launch isn't prepared anymore.
+	 */
+	void release();
+
+public
+slots:
+	/// fails the pipeline right away. an update in progress is aborted and gives up the caches.
+	virtual void abort() override;
+
+protected:
+	virtual void executeTask();
+
+protected
+slots:
+	virtual void emitSucceeded();
+	virtual void emitFailed(QString reason);
+
+private
+slots:
+	void tryLockCaches();
+	void runUpdate();
+	void updateTaskSucceeded();
+	void updateTaskFailed(QString reason);
+
+private:
+	void prepareLocal();
+	void releaseCaches();
+
+private:
+	InstancePtr m_instance;
+	bool m_update = true;
+	std::unique_ptr<QLockFile> m_cacheLock;
+	QTimer m_lockTimer;
+	std::shared_ptr<Task> m_updateTask;
+	QString m_launchScript;
+	bool m_updateFailed = false;
+	bool m_released = false;
+};
@@ -124,7 +124,7 @@ std::shared_ptr<Task> LegacyInstance::doUpdate()
 	return std::shared_ptr<Task>(new LegacyUpdate(this, this));
 }
 
-bool LegacyInstance::prepareForLaunch(AuthSessionPtr account, QString &launchScript)
+bool LegacyInstance::prepareLocalLaunch(QString &launchScript)
 {
 	QIcon icon = MMC->icons()->getIcon(iconKey());
 	auto pixmap = icon.pixmap(128, 128);
@@ -143,8 +143,6 @@ bool LegacyInstance::prepareForLaunch(AuthSessionPtr account, QString &launchScr
 
 		QString lwjgl = QDir(MMC->settings()->get("LWJGLDir").toString() + "/" + lwjglVersion())
 							.absolutePath();
-		launchScript += "userName " + account->player_name + "\n";
-		launchScript += "sessionId " + account->session + "\n";
 		launchScript += "windowTitle " + windowTitle() + "\n";
 		launchScript += "windowParams " + windowParams + "\n";
 		launchScript += "lwjgl " + lwjgl + "\n";
@@ -153,6 +151,13 @@ bool LegacyInstance::prepareForLaunch(AuthSessionPtr account, QString &launchScr
 	return true;
 }
 
+bool LegacyInstance::prepareForLaunch(AuthSessionPtr account, QString &launchScript)
+{
+	launchScript += "userName " + account->player_name + "\n";
+	launchScript += "sessionId " + account->session + "\n";
+	return true;
+}
+
 void LegacyInstance::cleanupAfterRun()
 {
 	// FIXME: delete the launcher and icons and whatnot.
@@ -196,6 +201,11 @@ std::shared_ptr<ModList> LegacyInstance::loaderModList()
 	return loader_mod_list;
 }
 
+int LegacyInstance::loadedModCount()
+{
+	return int(loaderModList()->size() + coreModList()->size() + jarModList()->size());
+}
+
 std::shared_ptr<ModList> LegacyInstance::texturePackList()
 {
 	if (!texture_pack_list)
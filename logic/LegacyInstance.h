@@ -106,10 +106,13 @@ public:
 		return {"legacy-instance", "texturepacks"};
 	};
 
+	virtual int loadedModCount() override;
+
 	virtual bool shouldUpdate() const override;
 	virtual void setShouldUpdate(bool val) override;
 	virtual std::shared_ptr<Task> doUpdate() override;
 
+	virtual bool prepareLocalLaunch(QString & launchScript) override;
 	virtual bool prepareForLaunch(AuthSessionPtr account, QString & launchScript) override;
 	virtual void cleanupAfterRun() override;
 
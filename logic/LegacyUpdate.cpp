@@ -16,12 +16,11 @@
 #include <QStringList>
 
 #include <pathutils.h>
-#include <quazip.h>
-#include <quazipfile.h>
 #include <JlCompress.h>
 
 #include "logic/LegacyUpdate.h"
 #include "logic/LwjglVersionList.h"
+#include "logic/LwjglCache.h"
 #include "logic/minecraft/MinecraftVersionList.h"
 #include "logic/BaseInstance.h"
 #include "logic/LegacyInstance.h"
@@ -42,6 +41,27 @@ void LegacyUpdate::executeTask()
 	fmllibsStart();
 }
 
+void LegacyUpdate::abort()
+{
+	if (!isRunning())
+	{
+		return;
+	}
+	// whatever is still going on doesn't report back anymore
+	if (m_reply)
+	{
+		disconnect(MMC->qnam().get(), 0, this, 0);
+		m_reply->abort();
+		m_reply.reset();
+	}
+	if (legacyDownloadJob)
+	{
+		disconnect(legacyDownloadJob.get(), 0, this, 0);
+		legacyDownloadJob->abort();
+	}
+	emitFailed(tr("Aborted."));
+}
+
 void LegacyUpdate::fmllibsStart()
 {
 	// Get the mod list
@@ -122,6 +142,7 @@ void LegacyUpdate::fmllibsStart()
 	connect(dljob, SIGNAL(succeeded()), SLOT(fmllibsFinished()));
 	connect(dljob, SIGNAL(failed()), SLOT(fmllibsFailed()));
 	connect(dljob, SIGNAL(progress(qint64, qint64)), SIGNAL(progress(qint64, qint64)));
+	dljob->setTrace(m_trace);
 	legacyDownloadJob.reset(dljob);
 	legacyDownloadJob->start();
 }
@@ -168,17 +189,32 @@ void LegacyUpdate::lwjglStart()
 	LegacyInstance *inst = (LegacyInstance *)m_inst;
 
 	lwjglVersion = inst->lwjglVersion();
-	lwjglTargetPath = PathCombine(MMC->settings()->get("LWJGLDir").toString(), lwjglVersion);
-	lwjglNativesPath = PathCombine(lwjglTargetPath, "natives");
+	lwjglRoot = MMC->settings()->get("LWJGLDir").toString();
 
-	// if the 'done' file exists, we don't have to download this again
-	QFileInfo doneFile(PathCombine(lwjglTargetPath, "done"));
-	if (doneFile.exists())
+	// shared by all legacy instances, extracted once and checked by the stamps of its files
+	LwjglCache cache(lwjglRoot);
+	if (cache.isIntact(lwjglVersion))
 	{
 		jarStart();
 		return;
 	}
 
+	// something changed the files, take them from the archive of the last download again
+	QString archive = cache.archivePath(lwjglVersion);
+	if (!archive.isEmpty())
+	{
+		setStatus(tr("Repairing LWJGL..."));
+		QString error;
+		if (cache.extract(lwjglVersion, archive, &error))
+		{
+			QLOG_INFO() << "Repaired LWJGL" << lwjglVersion << ", wrote" << cache.writtenFiles()
+						<< "files";
+			jarStart();
+			return;
+		}
+		QLOG_WARN() << "Couldn't repair LWJGL" << lwjglVersion << ":" << error;
+	}
+
 	auto list = MMC->lwjgllist();
 	if (!list->isLoaded())
 	{
@@ -248,100 +284,23 @@ void LegacyUpdate::lwjglFinished(QNetworkReply *reply)
 		m_reply = std::shared_ptr<QNetworkReply>(rep);
 		return;
 	}
-	QFile saveMe("lwjgl.zip");
-	saveMe.open(QIODevice::WriteOnly);
-	saveMe.write(m_reply->readAll());
-	saveMe.close();
 	setStatus(tr("Installing new LWJGL..."));
-	extractLwjgl();
+	if (!extractLwjgl(m_reply->readAll()))
+		return;
 	jarStart();
 }
-void LegacyUpdate::extractLwjgl()
+bool LegacyUpdate::extractLwjgl(const QByteArray &data)
 {
-	// make sure the directories are there
-
-	bool success = ensureFolderPathExists(lwjglNativesPath);
-
-	if (!success)
-	{
-		emitFailed("Failed to extract the lwjgl libs - error when creating required folders.");
-		return;
-	}
-
-	QuaZip zip("lwjgl.zip");
-	if (!zip.open(QuaZip::mdUnzip))
-	{
-		emitFailed("Failed to extract the lwjgl libs - not a valid archive.");
-		return;
-	}
-
-	// and now we are going to access files inside it
-	QuaZipFile file(&zip);
-	const QString jarNames[] = {"jinput.jar", "lwjgl_util.jar", "lwjgl.jar"};
-	for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile())
+	m_reply.reset();
+	LwjglCache cache(lwjglRoot);
+	QString error;
+	QString archive = cache.storeArchive(data, &error);
+	if (archive.isEmpty() || !cache.extract(lwjglVersion, archive, &error))
 	{
-		if (!file.open(QIODevice::ReadOnly))
-		{
-			zip.close();
-			emitFailed("Failed to extract the lwjgl libs - error while reading archive.");
-			return;
-		}
-		QuaZipFileInfo info;
-		QString name = file.getActualFileName();
-		if (name.endsWith('/'))
-		{
-			file.close();
-			continue;
-		}
-		QString destFileName;
-		// Look for the jars
-		for (int i = 0; i < 3; i++)
-		{
-			if (name.endsWith(jarNames[i]))
-			{
-				destFileName = PathCombine(lwjglTargetPath, jarNames[i]);
-			}
-		}
-		// Not found? look for the natives
-		if (destFileName.isEmpty())
-		{
-#ifdef Q_OS_WIN32
-			QString nativesDir = "windows";
-#else
-#ifdef Q_OS_MAC
-			QString nativesDir = "macosx";
-#else
-			QString nativesDir = "linux";
-#endif
-#endif
-			if (name.contains(nativesDir))
-			{
-				int lastSlash = name.lastIndexOf('/');
-				int lastBackSlash = name.lastIndexOf('\\');
-				if (lastSlash != -1)
-					name = name.mid(lastSlash + 1);
-				else if (lastBackSlash != -1)
-					name = name.mid(lastBackSlash + 1);
-				destFileName = PathCombine(lwjglNativesPath, name);
-			}
-		}
-		// Now if destFileName is still empty, go to the next file.
-		if (!destFileName.isEmpty())
-		{
-			setStatus(tr("Installing new LWJGL - extracting ") + name + "...");
-			QFile output(destFileName);
-			output.open(QIODevice::WriteOnly);
-			output.write(file.readAll()); // FIXME: wste of memory!?
-			output.close();
-		}
-		file.close(); // do not forget to close!
+		emitFailed(error);
+		return false;
 	}
-	zip.close();
-	m_reply.reset();
-	QFile doneFile(PathCombine(lwjglTargetPath, "done"));
-	doneFile.open(QIODevice::WriteOnly);
-	doneFile.write("done.");
-	doneFile.close();
+	return true;
 }
 
 void LegacyUpdate::lwjglFailed()
@@ -382,6 +341,7 @@ void LegacyUpdate::jarStart()
 	connect(dljob, SIGNAL(succeeded()), SLOT(jarFinished()));
 	connect(dljob, SIGNAL(failed()), SLOT(jarFailed()));
 	connect(dljob, SIGNAL(progress(qint64, qint64)), SIGNAL(progress(qint64, qint64)));
+	dljob->setTrace(m_trace);
 	legacyDownloadJob.reset(dljob);
 	legacyDownloadJob->start();
 }
@@ -35,6 +35,11 @@ public:
 	explicit LegacyUpdate(BaseInstance *inst, QObject *parent = 0);
 	virtual void executeTask();
 
+public
+slots:
+	/// fails the update right away, the downloads in progress are aborted
+	virtual void abort() override;
+
 private
 slots:
 	void lwjglStart();
@@ -49,11 +54,11 @@ slots:
 	void fmllibsFinished();
 	void fmllibsFailed();
 
-	void extractLwjgl();
-
 	void ModTheJar();
 
 private:
+	/// stores the downloaded archive in the LWJGL cache and extracts it from there
+	bool extractLwjgl(const QByteArray &data);
 
 	std::shared_ptr<QNetworkReply> m_reply;
 
@@ -62,8 +67,7 @@ private:
 	QString lwjglURL;
 	QString lwjglVersion;
 
-	QString lwjglTargetPath;
-	QString lwjglNativesPath;
+	QString lwjglRoot;
 
 private:
 	NetJobPtr legacyDownloadJob;
@@ -0,0 +1,341 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LwjglCache.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QObject>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <pathutils.h>
+#include <quazip.h>
+#include <quazipfile.h>
+
+#include "logic/MMCJson.h"
+#include "logger/QsLog.h"
+
+namespace
+{
+const char *jarNames[] = {"jinput.jar", "lwjgl_util.jar", "lwjgl.jar"};
+
+qint64 modificationTime(const QFileInfo &info)
+{
+	return info.lastModified().toUTC().toMSecsSinceEpoch();
+}
+}
+
+LwjglCache::LwjglCache(const QString &root) : m_root(root)
+{
+}
+
+QString LwjglCache::versionPath(const QString &version) const
+{
+	return PathCombine(m_root, version);
+}
+
+QString LwjglCache::nativesPath(const QString &version) const
+{
+	return PathCombine(versionPath(version), "natives");
+}
+
+QString LwjglCache::platformNatives()
+{
+#ifdef Q_OS_WIN32
+	return "windows";
+#else
+#ifdef Q_OS_MAC
+	return "macosx";
+#else
+	return "linux";
+#endif
+#endif
+}
+
+bool LwjglCache::matches(const QString &path, const FileRecord &record) const
+{
+	QFileInfo info(path);
+	return info.isFile() && info.size() == record.size && modificationTime(info) == record.mtime;
+}
+
+bool LwjglCache::loadManifest(const QString &version, Manifest &manifest) const
+{
+	QString path = PathCombine(versionPath(version), "extracted.json");
+	if (!QFile::exists(path))
+	{
+		return false;
+	}
+	try
+	{
+		auto root = MMCJson::ensureObject(MMCJson::parseFile(path, "LWJGL manifest"));
+		manifest.archive = MMCJson::ensureString(root.value("archive"), "archive");
+		auto files = MMCJson::ensureObject(root.value("files"), "files");
+		for (auto iter = files.begin(); iter != files.end(); iter++)
+		{
+			auto obj = MMCJson::ensureObject(iter.value(), iter.key());
+			FileRecord record;
+			record.size = qint64(MMCJson::ensureDouble(obj.value("size"), "size"));
+			record.mtime = qint64(MMCJson::ensureDouble(obj.value("mtime"), "mtime"));
+			record.crc = quint32(MMCJson::ensureDouble(obj.value("crc"), "crc"));
+			manifest.files.insert(iter.key(), record);
+		}
+	}
+	catch (MMCError &e)
+	{
+		QLOG_WARN() << "Ignoring broken LWJGL manifest" << path << ":" << e.cause();
+		manifest = Manifest();
+		return false;
+	}
+	return !manifest.files.isEmpty();
+}
+
+bool LwjglCache::saveManifest(const QString &version, const Manifest &manifest) const
+{
+	QJsonObject files;
+	for (auto iter = manifest.files.begin(); iter != manifest.files.end(); iter++)
+	{
+		QJsonObject obj;
+		obj.insert("size", double(iter->size));
+		obj.insert("mtime", double(iter->mtime));
+		obj.insert("crc", double(iter->crc));
+		files.insert(iter.key(), obj);
+	}
+	QJsonObject root;
+	root.insert("archive", manifest.archive);
+	root.insert("files", files);
+
+	QSaveFile file(PathCombine(versionPath(version), "extracted.json"));
+	if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(root).toJson()) < 0 ||
+		!file.commit())
+	{
+		QLOG_ERROR() << "Couldn't save the LWJGL manifest of" << version << ":"
+					 << file.errorString();
+		return false;
+	}
+	return true;
+}
+
+bool LwjglCache::isIntact(const QString &version) const
+{
+	Manifest manifest;
+	if (loadManifest(version, manifest))
+	{
+		for (auto iter = manifest.files.begin(); iter != manifest.files.end(); iter++)
+		{
+			if (!matches(PathCombine(versionPath(version), iter.key()), *iter))
+			{
+				QLOG_INFO() << "LWJGL" << version << ":" << iter.key() << "changed";
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// extracted before there was a manifest. record what is there, so changes show from now on.
+	QDir dir(versionPath(version));
+	if (!dir.exists("done"))
+	{
+		return false;
+	}
+	for (auto jar : jarNames)
+	{
+		QFileInfo info(dir.absoluteFilePath(jar));
+		if (!info.isFile())
+		{
+			return false;
+		}
+		FileRecord record;
+		record.size = info.size();
+		record.mtime = modificationTime(info);
+		manifest.files.insert(jar, record);
+	}
+	for (auto info : QDir(nativesPath(version)).entryInfoList(QDir::Files))
+	{
+		FileRecord record;
+		record.size = info.size();
+		record.mtime = modificationTime(info);
+		manifest.files.insert("natives/" + info.fileName(), record);
+	}
+	QLOG_INFO() << "Recording the files of LWJGL" << version << "extracted by an older MultiMC";
+	saveManifest(version, manifest);
+	return true;
+}
+
+QString LwjglCache::archivePath(const QString &version) const
+{
+	Manifest manifest;
+	if (!loadManifest(version, manifest) || manifest.archive.isEmpty())
+	{
+		return QString();
+	}
+	QString path = PathCombine(m_root, "archives", manifest.archive + ".zip");
+	return QFile::exists(path) ? path : QString();
+}
+
+QString LwjglCache::storeArchive(const QByteArray &data, QString *error)
+{
+	QString sha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+	QString path = PathCombine(m_root, "archives", sha1 + ".zip");
+	QFileInfo info(path);
+	if (info.isFile() && info.size() == data.size())
+	{
+		return path;
+	}
+	QSaveFile file(path);
+	if (!ensureFilePathExists(path) || !file.open(QIODevice::WriteOnly) ||
+		file.write(data) != data.size() || !file.commit())
+	{
+		*error = QObject::tr("Failed to save the LWJGL archive %1: %2")
+					 .arg(path, file.errorString());
+		return QString();
+	}
+	return path;
+}
+
+bool LwjglCache::extract(const QString &version, const QString &archive, QString *error)
+{
+	m_written = 0;
+	const QString target = versionPath(version);
+	if (!ensureFolderPathExists(nativesPath(version)))
+	{
+		*error = QObject::tr("Failed to extract the lwjgl libs - error when creating required "
+							 "folders.");
+		return false;
+	}
+
+	Manifest previous;
+	loadManifest(version, previous);
+	Manifest manifest;
+	// named by its sha1 if it came from storeArchive()
+	if (QFileInfo(archive).dir() == QDir(PathCombine(m_root, "archives")))
+	{
+		manifest.archive = QFileInfo(archive).completeBaseName();
+	}
+
+	QuaZip zip(archive);
+	if (!zip.open(QuaZip::mdUnzip))
+	{
+		*error = QObject::tr("Failed to extract the lwjgl libs - not a valid archive.");
+		return false;
+	}
+	QuaZipFile file(&zip);
+	const QString platform = platformNatives();
+	for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile())
+	{
+		QString name = zip.getCurrentFileName();
+		if (name.endsWith('/'))
+		{
+			continue;
+		}
+		// the jars go into the version folder, the natives of this platform into natives/
+		QString relative;
+		for (auto jar : jarNames)
+		{
+			if (name.endsWith(jar))
+			{
+				relative = jar;
+			}
+		}
+		if (relative.isEmpty() && name.contains(platform))
+		{
+			int lastSeparator = qMax(name.lastIndexOf('/'), name.lastIndexOf('\\'));
+			relative = "natives/" + name.mid(lastSeparator + 1);
+		}
+		if (relative.isEmpty())
+		{
+			continue;
+		}
+
+		QuaZipFileInfo info;
+		if (!zip.getCurrentFileInfo(&info))
+		{
+			*error = QObject::tr("Failed to extract the lwjgl libs - error while reading archive.");
+			return false;
+		}
+		QString destination = PathCombine(target, relative);
+		auto old = previous.files.find(relative);
+		if (old != previous.files.end() && old->crc == info.crc &&
+			old->size == qint64(info.uncompressedSize) && matches(destination, *old))
+		{
+			manifest.files.insert(relative, *old);
+			continue;
+		}
+
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			*error = QObject::tr("Failed to extract the lwjgl libs - error while reading archive.");
+			return false;
+		}
+		QSaveFile output(destination);
+		if (!output.open(QIODevice::WriteOnly))
+		{
+			*error = QObject::tr("Failed to extract the lwjgl libs - can't write %1: %2")
+						 .arg(destination, output.errorString());
+			return false;
+		}
+		char buffer[65536];
+		qint64 len;
+		while ((len = file.read(buffer, sizeof(buffer))) > 0)
+		{
+			if (output.write(buffer, len) != len)
+			{
+				break;
+			}
+		}
+		file.close();
+		// closing checks the crc
+		if (len != 0 || file.getZipError() != UNZ_OK || !output.commit())
+		{
+			*error = QObject::tr("Failed to extract the lwjgl libs - error while extracting %1.")
+						 .arg(name);
+			return false;
+		}
+		m_written++;
+
+		QFileInfo written(destination);
+		FileRecord record;
+		record.size = written.size();
+		record.mtime = modificationTime(written);
+		record.crc = info.crc;
+		manifest.files.insert(relative, record);
+	}
+	zip.close();
+
+	if (manifest.files.isEmpty())
+	{
+		*error = QObject::tr("Failed to extract the lwjgl libs - the archive has none of them.");
+		return false;
+	}
+	if (manifest.files != previous.files || manifest.archive != previous.archive)
+	{
+		if (!saveManifest(version, manifest))
+		{
+			*error = QObject::tr("Failed to record the extracted lwjgl libs.");
+			return false;
+		}
+	}
+	// older versions of MultiMC only look for this
+	QFile doneFile(PathCombine(target, "done"));
+	if (!doneFile.exists() && doneFile.open(QIODevice::WriteOnly))
+	{
+		doneFile.write("done.");
+		doneFile.close();
+	}
+	return true;
+}
@@ -0,0 +1,91 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QMap>
+
+/*!
+ * The LWJGL versions extracted into the LWJGL folder, shared by all legacy instances.
+ *
+ * Every version folder gets a manifest, extracted.json, naming the archive it was extracted from
+ * by its sha1, and recording the size, modification time and crc32 of every file taken out of it.
+ * Checking a version only stats these few files.
+ *
+ * Downloaded archives are kept in archives/, named by their sha1. A damaged version is repaired
+ * from there without downloading it again, and only the files that differ are written.
+ */
+class LwjglCache
+{
+public:
+	/// root is the LWJGL folder
+	explicit LwjglCache(const QString &root);
+
+	QString versionPath(const QString &version) const;
+	QString nativesPath(const QString &version) const;
+
+	/*!
+	 * True if the version was extracted and its files are still as they were left.
+	 *
+	 * Versions extracted before the manifest existed only have a 'done' file. Their files are
+	 * taken as they are and recorded, once.
+	 */
+	bool isIntact(const QString &version) const;
+
+	/// the kept archive the version was extracted from, empty if there is none
+	QString archivePath(const QString &version) const;
+
+	/// keeps a downloaded archive under its sha1. returns its path, empty on errors.
+	QString storeArchive(const QByteArray &data, QString *error);
+
+	/// extracts the jars and the natives of this platform from archive, writing only what differs
+	bool extract(const QString &version, const QString &archive, QString *error);
+
+	/// how many files the last extract() wrote
+	int writtenFiles() const
+	{
+		return m_written;
+	}
+
+	/// the folder of the natives for this platform inside LWJGL archives
+	static QString platformNatives();
+
+private:
+	struct FileRecord
+	{
+		qint64 size = 0;
+		qint64 mtime = 0;
+		quint32 crc = 0;
+		bool operator==(const FileRecord &other) const
+		{
+			return size == other.size && mtime == other.mtime && crc == other.crc;
+		}
+	};
+	struct Manifest
+	{
+		QString archive;
+		/// paths relative to the version folder
+		QMap<QString, FileRecord> files;
+	};
+	bool loadManifest(const QString &version, Manifest &manifest) const;
+	bool saveManifest(const QString &version, const Manifest &manifest) const;
+	/// true if the file is there as the record says
+	bool matches(const QString &path, const FileRecord &record) const;
+
+	QString m_root;
+	int m_written = 0;
+};
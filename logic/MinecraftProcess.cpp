@@ -22,11 +22,14 @@
 #include <QDataStream>
 #include <QFile>
 #include <QDir>
+#include <QHash>
 #include <QProcessEnvironment>
 #include <QRegularExpression>
+#include <QSaveFile>
 #include <QStandardPaths>
 
 #include "BaseInstance.h"
+#include "logic/java/ClassDataSharing.h"
 
 #include "osutils.h"
 #include "pathutils.h"
@@ -34,6 +37,29 @@
 
 #define IBUS "@im=ibus"
 
+/// writes the class path into a file for the java command line, see javaArguments()
+static bool writeClassPathFile(const QString &path, const QStringList &classPath)
+{
+#ifdef Q_OS_WIN32
+	QString joined = classPath.join(';');
+#else
+	QString joined = classPath.join(':');
+#endif
+	// quoted, and backslashes are escapes within quotes
+	joined.replace("\\", "\\\\").replace("\"", "\\\"");
+	QSaveFile file(path);
+	// Java reads the file in the encoding of the system
+	QByteArray data = ("-cp \"" + joined + "\"\n").toLocal8Bit();
+	return file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit();
+}
+
+/// the maximum heaps of the games that are running, by process. an instance can run twice.
+static QHash<const MinecraftProcess *, int> &runningHeaps()
+{
+	static QHash<const MinecraftProcess *, int> heaps;
+	return heaps;
+}
+
 // constructor
 MinecraftProcess::MinecraftProcess(InstancePtr inst) : m_instance(inst)
 {
@@ -258,6 +284,7 @@ void MinecraftProcess::on_stdErr()
 	m_err_leftover = lines.takeLast();
 
 	logOutput(lines, MessageLevel::Error);
+	checkGameStarted(lines);
 }
 
 void MinecraftProcess::on_stdOut()
@@ -270,6 +297,7 @@ void MinecraftProcess::on_stdOut()
 	m_out_leftover = lines.takeLast();
 
 	logOutput(lines);
+	checkGameStarted(lines);
 }
 
 void MinecraftProcess::on_prepost_stdErr()
@@ -310,6 +338,12 @@ void MinecraftProcess::finish(int code, ExitStatus status)
 		logOutput(m_out_leftover);
 		m_out_leftover.clear();
 	}
+	// the game never got to start
+	if (m_trace)
+		finishTrace();
+	if (m_classDataSharing)
+		m_classDataSharing->release();
+	runningHeaps().remove(this);
 
 	if (!killed)
 	{
@@ -503,25 +537,57 @@ QStringList MinecraftProcess::javaArguments() const
 					"minecraft.exe.heapdump");
 #endif
 
-	args << QString("-Xms%1m").arg(m_instance->settings().get("MinMemAlloc").toInt());
-	args << QString("-Xmx%1m").arg(m_instance->settings().get("MaxMemAlloc").toInt());
+	if (m_heapChosen)
+	{
+		args << QString("-Xms%1m").arg(m_heap.minMb);
+		args << QString("-Xmx%1m").arg(m_heap.maxMb);
+		args.append(m_heap.gcArguments);
+	}
+	else
+	{
+		args << QString("-Xms%1m").arg(m_instance->settings().get("MinMemAlloc").toInt());
+		args << QString("-Xmx%1m").arg(m_instance->settings().get("MaxMemAlloc").toInt());
+	}
 	auto permgen = m_instance->settings().get("PermGen").toInt();
 	if (permgen != 64)
 	{
 		args << QString("-XX:PermSize=%1m").arg(permgen);
 	}
 	args << "-Duser.language=en";
-	if (!m_nativeFolder.isEmpty())
-		args << QString("-Djava.library.path=%1").arg(m_nativeFolder);
-	args << "-jar" << PathCombine(MMC->bin(), "jars", "NewLaunch.jar");
+	QString natives = m_nativeFolder;
+	for (auto line : launchScript.split('\n'))
+	{
+		if (natives.isEmpty() && line.startsWith("natives "))
+			natives = line.mid(8);
+	}
+	if (!natives.isEmpty())
+		args << QString("-Djava.library.path=%1").arg(natives);
+	args.append(m_classDataSharingArgs);
+
+	if (m_classPathFile.isEmpty())
+	{
+		args << "-jar" << PathCombine(MMC->bin(), "jars", "NewLaunch.jar");
+	}
+	else
+	{
+		// Java 9 and newer can't add to the class path once they run, and share only the
+		// classes of the class path they start with. from a file, a big modpack's class path
+		// doesn't fit on a Windows command line.
+		args << "@" + m_classPathFile << "org.multimc.EntryPoint";
+	}
 
 	return args;
 }
 
 void MinecraftProcess::arm()
 {
+	if (m_trace)
+		m_traceSpan = m_trace->begin(tr("Start the launcher"), "launch");
 	emit log("MultiMC version: " + BuildConfig.printableVersionString() + "\n\n");
 	emit log("Minecraft folder is:\n" + workingDirectory() + "\n\n");
+	auto notes = m_instance->takeLaunchNotes();
+	if (!notes.isEmpty())
+		emit log(notes.join('\n') + "\n\n");
 
 	if (!preLaunch())
 	{
@@ -531,9 +597,18 @@ void MinecraftProcess::arm()
 
 	m_instance->setLastLaunch();
 
+	QString JavaPath = m_instance->settings().get("JavaPath").toString();
+	// the version and architecture of the Java, for class data sharing and the heap
+	m_classDataSharing = new ClassDataSharing(QDir("cache/cds").absolutePath(), this);
+	m_classDataSharing->checkJava(JavaPath);
+	if (m_instance->settings().get("UseClassDataSharing").toBool())
+	{
+		prepareClassDataSharing(JavaPath);
+	}
+	chooseHeap();
+
 	QStringList args = javaArguments();
 
-	QString JavaPath = m_instance->settings().get("JavaPath").toString();
 	emit log("Java path is:\n" + JavaPath + "\n\n");
 	QString allArgs = args.join(", ");
 	emit log("Java Arguments:\n[" + censorPrivateInfo(allArgs) + "]\n\n");
@@ -552,6 +627,7 @@ void MinecraftProcess::arm()
 	{
 		//: Error message displayed if instace can't start
 		emit log(tr("Could not launch minecraft!"), MessageLevel::Error);
+		runningHeaps().remove(this);
 		m_instance->cleanupAfterRun();
 		emit launch_failed(m_instance);
 		// not running, failed
@@ -563,13 +639,153 @@ void MinecraftProcess::arm()
 	writeData(bytes.constData(), bytes.length());
 }
 
+void MinecraftProcess::prepareClassDataSharing(const QString &javaPath)
+{
+	m_classPathFile.clear();
+	m_classDataSharingArgs = m_classDataSharing->prepare(javaPath, classPath());
+	if (!m_classDataSharingArgs.isEmpty())
+	{
+		// one per archive, the archive is made for this class path
+		QString file = m_classDataSharing->archivePath() + ".cp";
+		if (writeClassPathFile(file, classPath()))
+		{
+			m_classPathFile = file;
+		}
+		else
+		{
+			QLOG_WARN() << "Couldn't write" << file << ", not sharing class data";
+			m_classDataSharing->release();
+			m_classDataSharingArgs.clear();
+			emit log(tr("Not sharing class data, the class path couldn't be saved for Java.\n\n"));
+			return;
+		}
+	}
+	switch (m_classDataSharing->mode())
+	{
+	case ClassDataSharing::Disabled:
+		emit log(tr("Not sharing class data. This needs Java 13 or newer, the version of a "
+					"Java MultiMC doesn't know yet is checked for the next launch.\n\n"));
+		break;
+	case ClassDataSharing::Create:
+		emit log(tr("Java will save the loaded classes to %1 when Minecraft exits.\n\n")
+					 .arg(m_classDataSharing->archivePath()));
+		break;
+	case ClassDataSharing::Use:
+		emit log(tr("Using the shared class archive %1.\n\n")
+					 .arg(m_classDataSharing->archivePath()));
+		break;
+	case ClassDataSharing::Busy:
+		emit log(tr("Not sharing class data, another running Minecraft is saving the same "
+					"archive.\n\n"));
+		break;
+	}
+}
+
+void MinecraftProcess::chooseHeap()
+{
+	auto &settings = m_instance->settings();
+	HeapSizing::Input input;
+	input.automatic = settings.get("AutoMemAlloc").toBool();
+	input.manualMinMb = settings.get("MinMemAlloc").toInt();
+	input.manualMaxMb = settings.get("MaxMemAlloc").toInt();
+	if (input.automatic)
+	{
+		input.memory = HeapSizing::systemMemory();
+		input.modCount = m_instance->loadedModCount();
+		input.assetsMb = m_instance->assetsSize() / (1024 * 1024);
+		auto &heaps = runningHeaps();
+		for (auto iter = heaps.begin(); iter != heaps.end(); iter++)
+		{
+			if (iter.key() != this)
+				input.otherHeapsMb += iter.value();
+		}
+		input.javaBits = m_classDataSharing->javaBits();
+		input.customGc = HeapSizing::selectsGc(m_instance->extraArguments());
+	}
+	m_heap = HeapSizing::choose(input);
+	m_heapChosen = true;
+	runningHeaps().insert(this, m_heap.maxMb);
+	for (auto reason : m_heap.reasons)
+	{
+		QLOG_INFO() << "Heap:" << reason;
+	}
+	emit log(m_heap.reasons.join('\n') + "\n\n");
+}
+
 void MinecraftProcess::launch()
 {
+	m_waitingForGame = true;
+	m_gameTimer.start();
+	if (m_trace)
+	{
+		m_trace->end(m_traceSpan);
+		m_traceSpan = m_trace->begin(tr("Start Minecraft"), "launch");
+	}
 	QString launchString("launch\n");
 	QByteArray bytes = launchString.toUtf8();
 	writeData(bytes.constData(), bytes.length());
 }
 
+QStringList MinecraftProcess::classPath() const
+{
+	// the launcher jar and everything the launch script puts on the class path
+	QStringList classPath;
+	classPath << PathCombine(MMC->bin(), "jars", "NewLaunch.jar");
+	for (auto line : launchScript.split('\n'))
+	{
+		if (line.startsWith("cp "))
+			classPath << line.mid(3);
+	}
+	return classPath;
+}
+
+void MinecraftProcess::checkGameStarted(const QStringList &lines)
+{
+	if (!m_waitingForGame)
+		return;
+	for (auto line : lines)
+	{
+		if (ClassDataSharing::isGameOutput(line))
+		{
+			gameStarted();
+			return;
+		}
+	}
+}
+
+void MinecraftProcess::gameStarted()
+{
+	m_waitingForGame = false;
+	if (m_classDataSharing)
+	{
+		QString comparison = m_classDataSharing->recordStartup(m_gameTimer.elapsed());
+		if (!comparison.isEmpty())
+			emit log(comparison + "\n\n");
+	}
+	if (m_trace)
+		finishTrace();
+}
+
+void MinecraftProcess::finishTrace()
+{
+	m_waitingForGame = false;
+	m_trace->end(m_traceSpan);
+	m_trace->mark(tr("Minecraft started"), "launch");
+
+	QString tracePath = PathCombine(m_instance->instanceRoot(), "launch-trace.json");
+	QString summary = m_trace->summary().join("\n");
+	if (m_trace->save(tracePath))
+	{
+		emit log(tr("Launch timing, the full trace is in %1:\n%2\n\n").arg(tracePath, summary));
+	}
+	else
+	{
+		QLOG_WARN() << "Couldn't save the launch trace to" << tracePath;
+		emit log(tr("Launch timing:\n%1\n\n").arg(summary));
+	}
+	m_trace.reset();
+}
+
 void MinecraftProcess::abort()
 {
 	QString launchString("abort\n");
@@ -17,9 +17,14 @@
 
 #pragma once
 
+#include <QElapsedTimer>
 #include <QProcess>
 #include <QString>
 #include "BaseInstance.h"
+#include "Trace.h"
+#include "java/HeapSizing.h"
+
+class ClassDataSharing;
 
 /**
  * @brief the MessageLevel Enum
@@ -98,6 +103,15 @@ public:
 		m_session = session;
 	}
 
+	/*!
+	 * Records the start of the game in the given trace. Once the game prints its first line,
+	 * the trace is saved to the instance folder and summarized in the log.
+	 */
+	void setTrace(TracePtr trace)
+	{
+		m_trace = trace;
+	}
+
 signals:
 	/**
 	 * @brief emitted when Minecraft immediately fails to run
@@ -135,8 +149,25 @@ protected:
 	AuthSessionPtr m_session;
 	QString launchScript;
 	QString m_nativeFolder;
+	TracePtr m_trace;
+	int m_traceSpan = -1;
+	bool m_waitingForGame = false;
+	QElapsedTimer m_gameTimer;
+	ClassDataSharing *m_classDataSharing = nullptr;
+	QStringList m_classDataSharingArgs;
+	/// the Java argument file with the class path, when class data sharing needs it
+	QString m_classPathFile;
+	/// valid once arm() chose it, the settings are used before that
+	bool m_heapChosen = false;
+	HeapSizing::Choice m_heap;
 
 	bool preLaunch();
+	QStringList classPath() const;
+	void checkGameStarted(const QStringList &lines);
+	void gameStarted();
+	void finishTrace();
+	void prepareClassDataSharing(const QString &javaPath);
+	void chooseHeap();
 	bool postLaunch();
 	bool waitForPrePost();
 	QMap<QString, QString> getVariables() const;
@@ -14,6 +14,7 @@
  */
 
 #include <QIcon>
+#include <QElapsedTimer>
 #include <pathutils.h>
 #include "logger/QsLog.h"
 #include "MultiMC.h"
@@ -23,6 +24,9 @@
 
 #include "logic/OneSixUpdate.h"
 #include "logic/minecraft/InstanceVersion.h"
+#include "logic/minecraft/MinecraftVersionList.h"
+#include "logic/minecraft/VerifiedState.h"
+#include "logic/minecraft/LaunchArtifacts.h"
 #include "minecraft/VersionBuildError.h"
 
 #include "logic/assets/AssetsUtils.h"
@@ -95,6 +99,41 @@ std::shared_ptr<Task> OneSixInstance::doUpdate()
 	return std::shared_ptr<Task>(new OneSixUpdate(this));
 }
 
+std::shared_ptr<Task> OneSixInstance::doLaunchUpdate()
+{
+	if (MMC->settings()->get("VerifyInstanceOnLaunch").toBool())
+	{
+		return doUpdate();
+	}
+	if (flags() & VersionBrokenFlag)
+	{
+		return doUpdate();
+	}
+	// a newer revision of the Minecraft version is available
+	if (!providesVersionFile())
+	{
+		auto mcversion = std::dynamic_pointer_cast<MinecraftVersion>(
+			MMC->minecraftlist()->findVersion(intendedVersionId()));
+		if (!mcversion || mcversion->needsUpdate())
+		{
+			return doUpdate();
+		}
+	}
+	// verify everything once a day anyway, to catch what the stamps can't see
+	auto verified = VerifiedState::load(this);
+	if (!verified.isValid() || verified.isExpired())
+	{
+		return doUpdate();
+	}
+	if (verified != VerifiedState::capture(this))
+	{
+		QLOG_INFO() << name() << ": files changed since the last update, updating";
+		return doUpdate();
+	}
+	QLOG_INFO() << name() << ": nothing changed since the last update, skipping it";
+	return nullptr;
+}
+
 QString replaceTokensIn(QString text, QMap<QString, QString> with)
 {
 	QString result;
@@ -119,7 +158,12 @@ QString replaceTokensIn(QString text, QMap<QString, QString> with)
 	return result;
 }
 
-QDir OneSixInstance::reconstructAssets(std::shared_ptr<InstanceVersion> version)
+QDir OneSixInstance::virtualAssetsRoot(std::shared_ptr<InstanceVersion> version)
+{
+	return QDir(PathCombine(PathCombine("assets/", "virtual"), version->assets));
+}
+
+bool OneSixInstance::reconstructAssets(std::shared_ptr<InstanceVersion> version)
 {
 	QDir assetsDir = QDir("assets/");
 	QDir indexDir = QDir(PathCombine(assetsDir.path(), "indexes"));
@@ -128,27 +172,31 @@ QDir OneSixInstance::reconstructAssets(std::shared_ptr<InstanceVersion> version)
 
 	QString indexPath = PathCombine(indexDir.path(), version->assets + ".json");
 	QFile indexFile(indexPath);
-	QDir virtualRoot(PathCombine(virtualDir.path(), version->assets));
+	QDir virtualRoot = virtualAssetsRoot(version);
 
 	if (!indexFile.exists())
 	{
 		QLOG_ERROR() << "No assets index file" << indexPath << "; can't reconstruct assets";
-		return virtualRoot;
+		return false;
 	}
 
 	QLOG_DEBUG() << "reconstructAssets" << assetsDir.path() << indexDir.path()
 				 << objectDir.path() << virtualDir.path() << virtualRoot.path();
 
 	AssetsIndex index;
+	bool complete = true;
 	bool loadAssetsIndex = AssetsUtils::loadAssetsIndexJson(indexPath, &index);
 
 	if (loadAssetsIndex && index.isVirtual)
 	{
 		QLOG_INFO() << "Reconstructing virtual assets folder at" << virtualRoot.path();
 
-		for (QString map : index.objects.keys())
+		// const, the index may share its records with the cache
+		const auto &records = index.records;
+		for (auto &record : records)
 		{
-			AssetObject asset_object = index.objects.value(map);
+			QString map = index.name(record);
+			AssetObject asset_object = index.object(record);
 			QString target_path = PathCombine(virtualRoot.path(), map);
 			QFile target(target_path);
 
@@ -158,7 +206,10 @@ QDir OneSixInstance::reconstructAssets(std::shared_ptr<InstanceVersion> version)
 				PathCombine(PathCombine(objectDir.path(), tlk), asset_object.hash);
 			QFile original(original_path);
 			if (!original.exists())
+			{
+				complete = false;
 				continue;
+			}
 			if (!target.exists())
 			{
 				QFileInfo info(target_path);
@@ -170,13 +221,14 @@ QDir OneSixInstance::reconstructAssets(std::shared_ptr<InstanceVersion> version)
 				bool couldCopy = original.copy(target_path);
 				QLOG_DEBUG() << " Copying" << original_path << "to" << target_path
 							 << QString::number(couldCopy); // << original.errorString();
+				complete &= couldCopy;
 			}
 		}
 
 		// TODO: Write last used time to virtualRoot/.lastused
 	}
 
-	return virtualRoot;
+	return loadAssetsIndex && complete;
 }
 
 QStringList OneSixInstance::processMinecraftArgs(AuthSessionPtr session)
@@ -202,7 +254,7 @@ QStringList OneSixInstance::processMinecraftArgs(AuthSessionPtr session)
 	QString absRootDir = QDir(minecraftRoot()).absolutePath();
 	token_mapping["game_directory"] = absRootDir;
 	QString absAssetsDir = QDir("assets/").absolutePath();
-	token_mapping["game_assets"] = reconstructAssets(version).absolutePath();
+	token_mapping["game_assets"] = virtualAssetsRoot(version).absolutePath();
 
 	token_mapping["user_properties"] = session->serializeUserProperties();
 	token_mapping["user_type"] = session->user_type;
@@ -218,15 +270,80 @@ QStringList OneSixInstance::processMinecraftArgs(AuthSessionPtr session)
 	return parts;
 }
 
-bool OneSixInstance::prepareForLaunch(AuthSessionPtr session, QString &launchScript)
+bool OneSixInstance::prepareLocalLaunch(QString &launchScript)
 {
+	if (!version)
+		return false;
 
-	QIcon icon = MMC->icons()->getIcon(iconKey());
-	auto pixmap = icon.pixmap(128, 128);
-	pixmap.save(PathCombine(minecraftRoot(), "icon.png"), "PNG");
+	// the icon and the virtual assets, unless they are still as the last launch left them
+	{
+		LaunchArtifacts artifacts(instanceRoot());
+		bool rebuild = MMC->settings()->get("RebuildLaunchArtifacts").toBool();
+		QStringList reused;
+		qint64 saved = 0;
+		QElapsedTimer timer;
+
+		QString iconPath = QFileInfo(PathCombine(minecraftRoot(), "icon.png")).absoluteFilePath();
+		QString iconInputs = MMC->icons()->getIconStamp(iconKey());
+		if (!iconInputs.isEmpty())
+			iconInputs = QString("%1|%2").arg(iconInputs, iconPath);
+		if (!rebuild && artifacts.isCurrent("icon", iconInputs))
+		{
+			reused << tr("the icon");
+			saved += artifacts.duration("icon");
+		}
+		else
+		{
+			timer.start();
+			QIcon icon = MMC->icons()->getIcon(iconKey());
+			auto pixmap = icon.pixmap(128, 128);
+			if (pixmap.save(iconPath, "PNG"))
+				artifacts.record("icon", iconInputs, iconPath, timer.elapsed());
+			else
+				artifacts.forget("icon");
+		}
 
-	if (!version)
-		return nullptr;
+		// virtual assets, referenced by the game_assets argument
+		QString assetsRoot = virtualAssetsRoot(version).absolutePath();
+		QString indexPath = PathCombine("assets/indexes", version->assets + ".json");
+		QString indexHash = LaunchArtifacts::hashFile(indexPath);
+		QString assetsInputs;
+		if (!indexHash.isEmpty())
+			assetsInputs = QString("%1|%2").arg(indexHash, assetsRoot);
+		if (!rebuild && artifacts.isCurrent("virtualAssets", assetsInputs))
+		{
+			reused << tr("the virtual assets");
+			saved += artifacts.duration("virtualAssets");
+		}
+		else
+		{
+			timer.start();
+			// with assets missing, the next launch has to try again
+			if (reconstructAssets(version))
+			{
+				// assets that aren't virtual have no folder, there only the index can change
+				QString output = QFileInfo(assetsRoot).exists() ? assetsRoot : indexPath;
+				artifacts.record("virtualAssets", assetsInputs, output, timer.elapsed());
+			}
+			else
+				artifacts.forget("virtualAssets");
+		}
+
+		artifacts.save();
+		if (!reused.isEmpty())
+		{
+			QString note = tr("Reused %1 of the last launch, nothing they are made from changed. "
+							  "That saved about %2 ms.")
+							   .arg(reused.join(tr(" and ")))
+							   .arg(saved);
+			QLOG_INFO() << name() << ":" << note;
+			m_launchNotes << note;
+		}
+		else if (rebuild)
+		{
+			m_launchNotes << tr("Rebuilt the icon and the virtual assets, as the settings ask for.");
+		}
+	}
 
 	// libraries and class path.
 	{
@@ -254,12 +371,6 @@ bool OneSixInstance::prepareForLaunch(AuthSessionPtr session, QString &launchScr
 		launchScript += "appletClass " + version->appletClass + "\n";
 	}
 
-	// generic minecraft params
-	for (auto param : processMinecraftArgs(session))
-	{
-		launchScript += "param " + param + "\n";
-	}
-
 	// window size, title and state, legacy
 	{
 		QString windowParams;
@@ -273,12 +384,6 @@ bool OneSixInstance::prepareForLaunch(AuthSessionPtr session, QString &launchScr
 		launchScript += "windowParams " + windowParams + "\n";
 	}
 
-	// legacy auth
-	{
-		launchScript += "userName " + session->player_name + "\n";
-		launchScript += "sessionId " + session->session + "\n";
-	}
-
 	// native libraries (mostly LWJGL)
 	{
 		QDir natives_dir(PathCombine(instanceRoot(), "natives/"));
@@ -299,6 +404,25 @@ bool OneSixInstance::prepareForLaunch(AuthSessionPtr session, QString &launchScr
 	return true;
 }
 
+bool OneSixInstance::prepareForLaunch(AuthSessionPtr session, QString &launchScript)
+{
+	if (!version)
+		return false;
+
+	// generic minecraft params
+	for (auto param : processMinecraftArgs(session))
+	{
+		launchScript += "param " + param + "\n";
+	}
+
+	// legacy auth
+	{
+		launchScript += "userName " + session->player_name + "\n";
+		launchScript += "sessionId " + session->session + "\n";
+	}
+	return true;
+}
+
 void OneSixInstance::cleanupAfterRun()
 {
 	QString target_dir = PathCombine(instanceRoot(), "natives/");
@@ -346,9 +470,35 @@ std::shared_ptr<ModList> OneSixInstance::texturePackList()
 	return texture_pack_list;
 }
 
+int OneSixInstance::loadedModCount()
+{
+	return int(loaderModList()->size() + coreModList()->size());
+}
+
+qint64 OneSixInstance::assetsSize()
+{
+	auto version = getFullVersion();
+	if (!version || version->assets.isEmpty())
+		return 0;
+	AssetsIndex index;
+	if (!AssetsUtils::loadAssetsIndexJson(PathCombine("assets/indexes", version->assets + ".json"),
+										  &index))
+	{
+		return 0;
+	}
+	qint64 total = 0;
+	const auto &records = index.records;
+	for (auto &record : records)
+	{
+		total += record.size;
+	}
+	return total;
+}
+
 bool OneSixInstance::setIntendedVersionId(QString version)
 {
 	settings().set("IntendedVersion", version);
+	VerifiedState::invalidate(this);
 	QFile::remove(PathCombine(instanceRoot(), "version.json"));
 	clearVersion();
 	return true;
@@ -43,6 +43,9 @@ public:
 
 	virtual QSet<QString> traits();
 
+	virtual int loadedModCount() override;
+	virtual qint64 assetsSize() override;
+
 	////// Directories and files //////
 	QString jarModsDir() const;
 	QString resourcePacksDir() const;
@@ -53,6 +56,8 @@ public:
 	virtual QString instanceConfigFolder() const override;
 
 	virtual std::shared_ptr<Task> doUpdate() override;
+	virtual std::shared_ptr<Task> doLaunchUpdate() override;
+	virtual bool prepareLocalLaunch(QString & launchScript) override;
 	virtual bool prepareForLaunch(AuthSessionPtr account, QString & launchScript) override;
 
 	virtual void cleanupAfterRun() override;
@@ -103,7 +108,9 @@ signals:
 
 private:
 	QStringList processMinecraftArgs(AuthSessionPtr account);
-	QDir reconstructAssets(std::shared_ptr<InstanceVersion> version);
+	QDir virtualAssetsRoot(std::shared_ptr<InstanceVersion> version);
+	/// returns true if the virtual assets are complete, or the assets aren't virtual
+	bool reconstructAssets(std::shared_ptr<InstanceVersion> version);
 
 protected:
 	std::shared_ptr<InstanceVersion> version;
@@ -24,23 +24,35 @@
 #include <QDataStream>
 #include <pathutils.h>
 #include <JlCompress.h>
+#include <QtConcurrentMap>
+#include <QSet>
 
 #include "logic/BaseInstance.h"
 #include "logic/minecraft/MinecraftVersionList.h"
 #include "logic/minecraft/InstanceVersion.h"
 #include "logic/minecraft/OneSixLibrary.h"
+#include "logic/minecraft/VerifiedState.h"
 #include "logic/OneSixInstance.h"
 #include "logic/forge/ForgeMirrors.h"
 #include "logic/net/URLConstants.h"
-#include "logic/assets/AssetsUtils.h"
+#include "logic/assets/AssetObjectStore.h"
+#include "logic/assets/AssetObjectDownload.h"
 #include "JarUtils.h"
 
 OneSixUpdate::OneSixUpdate(OneSixInstance *inst, QObject *parent) : Task(parent), m_inst(inst)
 {
+	connect(&assetsCheckWatcher, SIGNAL(progressValueChanged(int)),
+			SLOT(assetsCheckProgress(int)));
+	connect(&assetsCheckWatcher, SIGNAL(finished()), SLOT(assetsChecked()));
 }
 
 void OneSixUpdate::executeTask()
 {
+	// whatever was verified before doesn't count until this update succeeds. the assets check
+	// still needs to know what changed since.
+	m_verifiedBefore = VerifiedState::load(m_inst);
+	VerifiedState::invalidate(m_inst);
+
 	// Make directories
 	QDir mcDir(m_inst->minecraftRoot());
 	if (!mcDir.exists() && !mcDir.mkpath("."))
@@ -71,6 +83,7 @@ void OneSixUpdate::executeTask()
 		jarlibStart();
 		return;
 	}
+	versionUpdateTask->setTrace(m_trace);
 	connect(versionUpdateTask.get(), SIGNAL(succeeded()), SLOT(jarlibStart()));
 	connect(versionUpdateTask.get(), SIGNAL(failed(QString)), SLOT(versionUpdateFailed(QString)));
 	connect(versionUpdateTask.get(), SIGNAL(progress(qint64, qint64)),
@@ -79,6 +92,30 @@ void OneSixUpdate::executeTask()
 	versionUpdateTask->start();
 }
 
+void OneSixUpdate::abort()
+{
+	if (!isRunning())
+	{
+		return;
+	}
+	// whatever is still going on doesn't report back anymore
+	if (versionUpdateTask)
+	{
+		disconnect(versionUpdateTask.get(), 0, this, 0);
+		versionUpdateTask->abort();
+	}
+	for (auto job : {jarlibDownloadJob, legacyDownloadJob})
+	{
+		if (job)
+		{
+			disconnect(job.get(), 0, this, 0);
+			job->abort();
+		}
+	}
+	assetsCheckWatcher.cancel();
+	emitFailed(tr("Aborted."));
+}
+
 void OneSixUpdate::versionUpdateFailed(QString reason)
 {
 	emitFailed(reason);
@@ -97,6 +134,7 @@ void OneSixUpdate::assetIndexStart()
 	auto metacache = MMC->metacache();
 	auto entry = metacache->resolveEntry("asset_indexes", localPath);
 	job->addNetAction(CacheDownload::make(indexUrl, entry));
+	job->setTrace(m_trace);
 	jarlibDownloadJob.reset(job);
 
 	connect(jarlibDownloadJob.get(), SIGNAL(succeeded()), SLOT(assetIndexFinished()));
@@ -119,28 +157,93 @@ void OneSixUpdate::assetIndexFinished()
 	if (!AssetsUtils::loadAssetsIndexJson(asset_fname, &index))
 	{
 		emitFailed(tr("Failed to read the assets index!"));
+		return;
 	}
 
-	QList<Md5EtagDownloadPtr> dls;
-	for (auto object : index.objects.values())
+	// objects the store knows about are there, unless their folder changed since the last
+	// update. everything is checked when we were told to, and by the daily verification.
+	auto store = MMC->assetStore();
+	bool deep = MMC->settings()->get("VerifyInstanceOnLaunch").toBool() ||
+				!m_verifiedBefore.isValid() || m_verifiedBefore.isExpired();
+	QSet<QString> changedFolders;
+	if (!deep)
 	{
-		QString objectName = object.hash.left(2) + "/" + object.hash;
-		QFileInfo objectFile("assets/objects/" + objectName);
-		if ((!objectFile.isFile()) || (objectFile.size() != object.size))
+		for (auto key : VerifiedState::capture(m_inst).changedStamps(m_verifiedBefore))
 		{
-			auto objectDL = MD5EtagDownload::make(
-				QUrl("http://" + URLConstants::RESOURCE_BASE + objectName),
-				objectFile.filePath());
-			objectDL->m_total_progress = object.size;
-			dls.append(objectDL);
+			if (key.startsWith("assets:"))
+				changedFolders.insert(key.mid(7));
 		}
 	}
+	QSet<QString> seen;
+	QList<AssetObject> unknown;
+	// through a const reference, so the records shared with the cache aren't detached
+	const auto &records = index.records;
+	for (auto &record : records)
+	{
+		auto object = index.object(record);
+		if (seen.contains(object.hash))
+			continue;
+		seen.insert(object.hash);
+		if (!deep && store->contains(object) && !changedFolders.contains(object.hash.left(2)))
+			continue;
+		unknown.append(object);
+	}
+	QLOG_INFO() << m_inst->name() << ":" << seen.size() << "asset objects," << unknown.size()
+				<< "need checking";
+	if (unknown.isEmpty())
+	{
+		assetsFinished();
+		return;
+	}
+	setStatus(tr("Checking the assets files..."));
+	if (m_trace)
+	{
+		m_assetsCheckSpan = m_trace->begin(tr("Check assets of %1").arg(m_inst->name()), "io");
+		m_trace->addCacheResults(m_assetsCheckSpan, seen.size() - unknown.size(), 0);
+	}
+	assetsCheckWatcher.setFuture(QtConcurrent::mapped(unknown, &AssetsUtils::checkObject));
+}
+
+void OneSixUpdate::assetsCheckProgress(int current)
+{
+	emit progress(current, assetsCheckWatcher.progressMaximum());
+}
+
+void OneSixUpdate::assetsChecked()
+{
+	if (assetsCheckWatcher.isCanceled())
+	{
+		return;
+	}
+	auto store = MMC->assetStore();
+	QList<AssetObjectDownloadPtr> dls;
+	int valid = 0;
+	for (auto check : assetsCheckWatcher.future().results())
+	{
+		if (check.valid)
+		{
+			store->add(check.object);
+			valid++;
+			continue;
+		}
+		store->remove(check.object.hash);
+		QString objectName = check.object.hash.left(2) + "/" + check.object.hash;
+		dls.append(AssetObjectDownload::make(
+			QUrl("http://" + URLConstants::RESOURCE_BASE + objectName), check.object));
+	}
+	if (m_trace)
+	{
+		// objects that were checked and found intact still count as cached
+		m_trace->addCacheResults(m_assetsCheckSpan, valid, dls.size());
+		m_trace->end(m_assetsCheckSpan);
+	}
 	if (dls.size())
 	{
 		setStatus(tr("Getting the assets files from Mojang..."));
-		auto job = new NetJob(tr("Assets for %1").arg(inst->name()));
+		auto job = new NetJob(tr("Assets for %1").arg(m_inst->name()));
 		for (auto dl : dls)
 			job->addNetAction(dl);
+		job->setTrace(m_trace);
 		jarlibDownloadJob.reset(job);
 		connect(jarlibDownloadJob.get(), SIGNAL(succeeded()), SLOT(assetsFinished()));
 		connect(jarlibDownloadJob.get(), SIGNAL(failed()), SLOT(assetsFailed()));
@@ -159,6 +262,8 @@ void OneSixUpdate::assetIndexFailed()
 
 void OneSixUpdate::assetsFinished()
 {
+	// remember what we verified, so the next launch can skip all this if nothing changes
+	VerifiedState::capture(m_inst).save(m_inst);
 	emitSucceeded();
 }
 
@@ -202,6 +307,7 @@ void OneSixUpdate::jarlibStart()
 		job->addNetAction(CacheDownload::make(QUrl(urlstr), entry));
 		jarHashOnEntry = entry->md5sum;
 
+		job->setTrace(m_trace);
 		jarlibDownloadJob.reset(job);
 	}
 
@@ -405,6 +511,7 @@ void OneSixUpdate::fmllibsStart()
 	connect(dljob, SIGNAL(succeeded()), SLOT(fmllibsFinished()));
 	connect(dljob, SIGNAL(failed()), SLOT(fmllibsFailed()));
 	connect(dljob, SIGNAL(progress(qint64, qint64)), SIGNAL(progress(qint64, qint64)));
+	dljob->setTrace(m_trace);
 	legacyDownloadJob.reset(dljob);
 	legacyDownloadJob->start();
 }
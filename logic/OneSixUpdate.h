@@ -18,10 +18,13 @@
 #include <QObject>
 #include <QList>
 #include <QUrl>
+#include <QFutureWatcher>
 
 #include "logic/net/NetJob.h"
 #include "logic/tasks/Task.h"
 #include "logic/VersionFilterData.h"
+#include "logic/assets/AssetsUtils.h"
+#include "logic/minecraft/VerifiedState.h"
 #include <quazip.h>
 
 class MinecraftVersion;
@@ -34,6 +37,11 @@ public:
 	explicit OneSixUpdate(OneSixInstance *inst, QObject *parent = 0);
 	virtual void executeTask();
 
+public
+slots:
+	/// fails the update right away, the downloads in progress are aborted
+	virtual void abort() override;
+
 private
 slots:
 	void versionUpdateFailed(QString reason);
@@ -50,6 +58,8 @@ slots:
 	void assetIndexFinished();
 	void assetIndexFailed();
 
+	void assetsCheckProgress(int current);
+	void assetsChecked();
 	void assetsFinished();
 	void assetsFailed();
 
@@ -65,4 +75,9 @@ private:
 	OneSixInstance *m_inst = nullptr;
 	QString jarHashOnEntry;
 	QList<FMLlib> fmlLibsToProcess;
+	/// what the last successful update verified, if anything
+	VerifiedState m_verifiedBefore;
+	/// the objects not known to the asset object store, checked on the thread pool
+	QFutureWatcher<AssetObjectCheck> assetsCheckWatcher;
+	int m_assetsCheckSpan = -1;
 };
@@ -1,15 +1,27 @@
 #include "RecursiveFileSystemWatcher.h"
 
-#include <QRegularExpression>
-#include <QDebug>
+#include <algorithm>
+#include <functional>
+
+#include "logger/QsLog.h"
+
+// how long to wait for a burst of changes to end before reading directories again
+static const int debounceInterval = 250;
 
 RecursiveFileSystemWatcher::RecursiveFileSystemWatcher(QObject *parent)
 	: QObject(parent), m_exp(".*"), m_watcher(new QFileSystemWatcher(this))
 {
-	connect(m_watcher, &QFileSystemWatcher::fileChanged, this,
-			&RecursiveFileSystemWatcher::fileChange);
 	connect(m_watcher, &QFileSystemWatcher::directoryChanged, this,
 			&RecursiveFileSystemWatcher::directoryChange);
+	connect(m_watcher, &QFileSystemWatcher::fileChanged, this,
+			&RecursiveFileSystemWatcher::fileChange);
+	m_debounce.setSingleShot(true);
+	m_debounce.setInterval(debounceInterval);
+	connect(&m_debounce, &QTimer::timeout, this, &RecursiveFileSystemWatcher::processChanges);
+}
+
+RecursiveFileSystemWatcher::~RecursiveFileSystemWatcher()
+{
 }
 
 void RecursiveFileSystemWatcher::setRootDir(const QDir &root)
@@ -17,23 +29,36 @@ void RecursiveFileSystemWatcher::setRootDir(const QDir &root)
 	bool wasEnabled = m_isEnabled;
 	disable();
 	m_root = root;
-	setFiles(scanRecursive(m_root));
+
+	Delta delta;
+	delta.removed = m_files.toList();
+	m_files.clear();
+	m_tree.reset(new Node);
+	rescan(m_tree.get(), QString(), true, delta);
+	apply(delta);
+
 	if (wasEnabled)
 	{
 		enable();
 	}
 }
-void RecursiveFileSystemWatcher::setWatchFiles(const bool watchFiles)
+
+void RecursiveFileSystemWatcher::setFileExpression(const QString &exp)
 {
-	bool wasEnabled = m_isEnabled;
-	disable();
-	m_watchFiles = watchFiles;
-	if (wasEnabled)
+	m_exp = QRegularExpression(exp);
+	if (m_tree)
 	{
-		enable();
+		setRootDir(m_root);
 	}
 }
 
+QStringList RecursiveFileSystemWatcher::files() const
+{
+	QStringList sorted = m_files.toList();
+	std::sort(sorted.begin(), sorted.end());
+	return sorted;
+}
+
 void RecursiveFileSystemWatcher::enable()
 {
 	if (m_isEnabled)
@@ -41,8 +66,16 @@ void RecursiveFileSystemWatcher::enable()
 		return;
 	}
 	Q_ASSERT(m_root != QDir::root());
-	addFilesToWatcherRecursive(m_root);
+	if (!m_tree)
+	{
+		m_tree.reset(new Node);
+	}
 	m_isEnabled = true;
+	// nothing was watched while disabled, so catch up before relying on the watches
+	Delta delta;
+	rescan(m_tree.get(), QString(), true, delta);
+	apply(delta);
+	watchRecursive(m_tree.get(), QString());
 }
 void RecursiveFileSystemWatcher::disable()
 {
@@ -51,57 +84,303 @@ void RecursiveFileSystemWatcher::disable()
 		return;
 	}
 	m_isEnabled = false;
-	m_watcher->removePaths(m_watcher->files());
-	m_watcher->removePaths(m_watcher->directories());
+	m_debounce.stop();
+	m_dirtyDirs.clear();
+	if (!m_watcher->directories().isEmpty())
+	{
+		m_watcher->removePaths(m_watcher->directories());
+	}
+	if (!m_watcher->files().isEmpty())
+	{
+		m_watcher->removePaths(m_watcher->files());
+	}
+	m_watchCount = 0;
+	std::function<void(Node *)> forget = [&forget](Node *node)
+	{
+		node->watched = false;
+		node->watchedFiles.clear();
+		for (auto &dir : node->dirs)
+			forget(dir.second.get());
+	};
+	if (m_tree)
+	{
+		forget(m_tree.get());
+	}
 }
 
-void RecursiveFileSystemWatcher::setFiles(const QStringList &files)
+RecursiveFileSystemWatcher::Node *
+RecursiveFileSystemWatcher::findNode(const QString &relativePath) const
 {
-	if (files != m_files)
+	Node *node = m_tree.get();
+	if (relativePath.isEmpty() || relativePath == ".")
 	{
-		m_files = files;
-		emit filesChanged();
+		return node;
 	}
+	for (const QString &part : relativePath.split('/', QString::SkipEmptyParts))
+	{
+		if (!node)
+		{
+			return nullptr;
+		}
+		auto iter = node->dirs.find(part);
+		if (iter == node->dirs.end())
+		{
+			return nullptr;
+		}
+		node = iter->second.get();
+	}
+	return node;
 }
 
-void RecursiveFileSystemWatcher::addFilesToWatcherRecursive(const QDir &dir)
+void RecursiveFileSystemWatcher::rescan(Node *node, const QString &relativePath, bool recursive,
+										Delta &delta)
 {
-	m_watcher->addPath(dir.absolutePath());
-	for (const QString &directory : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+	QString prefix = relativePath.isEmpty() ? QString() : relativePath + "/";
+	QDir dir(m_root.absoluteFilePath(relativePath));
+	QSet<QString> seenFiles;
+	QSet<QString> seenDirs;
+	for (const QFileInfo &info :
+		 dir.entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot))
 	{
-		addFilesToWatcherRecursive(dir.absoluteFilePath(directory));
+		const QString name = info.fileName();
+		if (info.isDir())
+		{
+			seenDirs.insert(name);
+			auto iter = node->dirs.find(name);
+			if (iter == node->dirs.end())
+			{
+				// new directories are always read completely
+				std::unique_ptr<Node> child(new Node);
+				rescan(child.get(), prefix + name, true, delta);
+				if (m_isEnabled)
+				{
+					watchRecursive(child.get(), prefix + name);
+				}
+				node->dirs[name] = std::move(child);
+			}
+			else if (recursive)
+			{
+				rescan(iter->second.get(), prefix + name, true, delta);
+			}
+			continue;
+		}
+		if (!m_exp.match(name).hasMatch())
+		{
+			continue;
+		}
+		seenFiles.insert(name);
+		FileStamp stamp{info.size(), info.lastModified()};
+		auto known = node->files.find(name);
+		if (known == node->files.end())
+		{
+			node->files.insert(name, stamp);
+			delta.added.append(prefix + name);
+			if (node->watched)
+			{
+				watchFile(node, relativePath, name);
+			}
+		}
+		else if (known->size != stamp.size || known->modified != stamp.modified)
+		{
+			*known = stamp;
+			delta.changed.append(prefix + name);
+			// a file replaced by a rename loses its watch
+			if (node->watchedFiles.contains(name) &&
+				!m_watcher->files().contains(m_root.absoluteFilePath(prefix + name)))
+			{
+				node->watchedFiles.remove(name);
+				m_watchCount--;
+				watchFile(node, relativePath, name);
+			}
+		}
 	}
-	if (m_watchFiles)
+	for (auto iter = node->files.begin(); iter != node->files.end();)
 	{
-		for (const QFileInfo &info : dir.entryInfoList(QDir::Files))
+		if (seenFiles.contains(iter.key()))
 		{
-			m_watcher->addPath(info.absoluteFilePath());
+			++iter;
+			continue;
 		}
+		delta.removed.append(prefix + iter.key());
+		unwatchFile(node, relativePath, iter.key());
+		iter = node->files.erase(iter);
 	}
+	for (auto iter = node->dirs.begin(); iter != node->dirs.end();)
+	{
+		if (seenDirs.contains(iter->first))
+		{
+			++iter;
+			continue;
+		}
+		removeTree(iter->second.get(), prefix + iter->first, delta);
+		iter = node->dirs.erase(iter);
+	}
+}
+
+void RecursiveFileSystemWatcher::removeTree(Node *node, const QString &relativePath,
+											Delta &delta)
+{
+	for (auto &dir : node->dirs)
+	{
+		removeTree(dir.second.get(), relativePath + "/" + dir.first, delta);
+	}
+	for (auto iter = node->files.begin(); iter != node->files.end(); ++iter)
+	{
+		delta.removed.append(relativePath + "/" + iter.key());
+		unwatchFile(node, relativePath, iter.key());
+	}
+	unwatch(node, relativePath);
 }
-QStringList RecursiveFileSystemWatcher::scanRecursive(const QDir &directory)
+
+bool RecursiveFileSystemWatcher::reserveWatch()
 {
-	QStringList ret;
-	QRegularExpression exp(m_exp);
-	for (const QString &dir : directory.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+	if (m_watchCount < m_maxWatches)
+	{
+		return true;
+	}
+	if (!m_warnedAboutCap)
 	{
-		ret.append(scanRecursive(directory.absoluteFilePath(dir)));
+		QLOG_WARN() << "Not watching more than" << m_maxWatches << "paths under"
+					<< m_root.absolutePath() << ", some changes will be missed";
+		m_warnedAboutCap = true;
 	}
-	for (const QString &file : directory.entryList(QDir::Files))
+	return false;
+}
+
+void RecursiveFileSystemWatcher::watch(Node *node, const QString &relativePath)
+{
+	if (node->watched || !reserveWatch())
 	{
-		if (exp.match(file).hasMatch())
+		return;
+	}
+	if (m_watcher->addPath(m_root.absoluteFilePath(relativePath)))
+	{
+		node->watched = true;
+		m_watchCount++;
+	}
+}
+
+void RecursiveFileSystemWatcher::watchFile(Node *node, const QString &relativePath,
+										   const QString &name)
+{
+	if (node->watchedFiles.contains(name) || !reserveWatch())
+	{
+		return;
+	}
+	QString prefix = relativePath.isEmpty() ? QString() : relativePath + "/";
+	if (m_watcher->addPath(m_root.absoluteFilePath(prefix + name)))
+	{
+		node->watchedFiles.insert(name);
+		m_watchCount++;
+	}
+}
+
+void RecursiveFileSystemWatcher::unwatchFile(Node *node, const QString &relativePath,
+											 const QString &name)
+{
+	if (!node->watchedFiles.remove(name))
+	{
+		return;
+	}
+	// as with directories, the watch of a deleted file may be gone already
+	QString prefix = relativePath.isEmpty() ? QString() : relativePath + "/";
+	m_watcher->removePath(m_root.absoluteFilePath(prefix + name));
+	m_watchCount--;
+}
+
+void RecursiveFileSystemWatcher::watchRecursive(Node *node, const QString &relativePath)
+{
+	// breadth first, so the cap leaves the deepest directories out
+	QList<QPair<Node *, QString>> order;
+	order.append(qMakePair(node, relativePath));
+	for (int i = 0; i < order.size(); i++)
+	{
+		auto current = order[i];
+		watch(current.first, current.second);
+		QString prefix = current.second.isEmpty() ? QString() : current.second + "/";
+		for (auto &dir : current.first->dirs)
 		{
-			ret.append(m_root.relativeFilePath(directory.absoluteFilePath(file)));
+			order.append(qMakePair(dir.second.get(), prefix + dir.first));
+		}
+	}
+	// then the files, which only matter for changes made in place
+	for (auto &current : order)
+	{
+		if (!current.first->watched)
+		{
+			continue;
+		}
+		for (auto iter = current.first->files.begin(); iter != current.first->files.end(); ++iter)
+		{
+			watchFile(current.first, current.second, iter.key());
 		}
 	}
-	return ret;
 }
 
-void RecursiveFileSystemWatcher::fileChange(const QString &path)
+void RecursiveFileSystemWatcher::unwatch(Node *node, const QString &relativePath)
 {
-	emit fileChanged(path);
+	if (!node->watched)
+	{
+		return;
+	}
+	// inotify drops the watch of a deleted directory by itself, this may fail
+	m_watcher->removePath(m_root.absoluteFilePath(relativePath));
+	node->watched = false;
+	m_watchCount--;
 }
+
+void RecursiveFileSystemWatcher::apply(const Delta &delta)
+{
+	if (delta.added.isEmpty() && delta.removed.isEmpty() && delta.changed.isEmpty())
+	{
+		return;
+	}
+	for (const QString &file : delta.removed)
+	{
+		m_files.remove(file);
+	}
+	for (const QString &file : delta.added)
+	{
+		m_files.insert(file);
+	}
+	emit filesChanged(delta.added, delta.removed, delta.changed);
+}
+
 void RecursiveFileSystemWatcher::directoryChange(const QString &path)
 {
-	setFiles(scanRecursive(m_root));
+	m_dirtyDirs.insert(m_root.relativeFilePath(path));
+	m_debounce.start();
+}
+
+void RecursiveFileSystemWatcher::fileChange(const QString &path)
+{
+	// reading the directory compares the stamp of the file
+	m_dirtyDirs.insert(m_root.relativeFilePath(QFileInfo(path).absolutePath()));
+	m_debounce.start();
+}
+
+void RecursiveFileSystemWatcher::processChanges()
+{
+	if (!m_isEnabled || !m_tree)
+	{
+		return;
+	}
+	// parents first: a removed directory takes its dirty children with it
+	QStringList dirty = m_dirtyDirs.toList();
+	m_dirtyDirs.clear();
+	std::sort(dirty.begin(), dirty.end(), [](const QString &a, const QString &b)
+	{
+		return a.count('/') < b.count('/');
+	});
+	Delta delta;
+	for (const QString &dir : dirty)
+	{
+		QString relativePath = dir == "." ? QString() : dir;
+		Node *node = findNode(relativePath);
+		if (node)
+		{
+			rescan(node, relativePath, false, delta);
+		}
+	}
+	apply(delta);
 }
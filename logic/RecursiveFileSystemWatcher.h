@@ -1,49 +1,105 @@
 #pragma once
 
 #include <QFileSystemWatcher>
+#include <QDateTime>
 #include <QDir>
+#include <QHash>
+#include <QRegularExpression>
+#include <QSet>
+#include <QTimer>
+#include <map>
+#include <memory>
 
+/*!
+ * Keeps track of the files under a directory that match an expression.
+ *
+ * Every directory in the tree and every matching file gets one watch (up to a cap, see
+ * setMaxWatches; directories go first). When one of them changes, only that directory is
+ * read again, and the differences are reported as added, removed and changed files. Bursts
+ * of changes are collected for a moment first.
+ */
 class RecursiveFileSystemWatcher : public QObject
 {
 	Q_OBJECT
 public:
 	RecursiveFileSystemWatcher(QObject *parent);
+	virtual ~RecursiveFileSystemWatcher();
 
 	void setRootDir(const QDir &root);
 	QDir rootDir() const { return m_root; }
 
-	// WARNING: setting this to true may be bad for performance
-	void setWatchFiles(const bool watchFiles);
-	bool watchFiles() const { return m_watchFiles; }
+	void setFileExpression(const QString &exp);
+	QString fileExpression() const { return m_exp.pattern(); }
 
-	void setFileExpression(const QString &exp) { m_exp = exp; }
-	QString fileExpression() const { return m_exp; }
+	/// directories and files beyond this many aren't watched, to leave some inotify watches for
+	/// others
+	void setMaxWatches(int maxWatches) { m_maxWatches = maxWatches; }
+	int maxWatches() const { return m_maxWatches; }
 
-	QStringList files() const { return m_files; }
+	/// matching files, relative to the root, sorted
+	QStringList files() const;
 
 signals:
-	void filesChanged();
-	void fileChanged(const QString &path);
+	/*!
+	 * Files appeared, disappeared or changed (in size or modification time), relative to the
+	 * root. Files written in place are only reported while they are watched; past the cap, a
+	 * change shows up once something is added, removed or renamed in their directory.
+	 */
+	void filesChanged(const QStringList &added, const QStringList &removed,
+					  const QStringList &changed);
 
 public slots:
 	void enable();
 	void disable();
 
 private:
+	struct FileStamp
+	{
+		qint64 size;
+		QDateTime modified;
+	};
+	/// a directory of the tree
+	struct Node
+	{
+		QHash<QString, FileStamp> files;
+		std::map<QString, std::unique_ptr<Node>> dirs;
+		QSet<QString> watchedFiles;
+		bool watched = false;
+	};
+	struct Delta
+	{
+		QStringList added;
+		QStringList removed;
+		QStringList changed;
+	};
+
 	QDir m_root;
-	bool m_watchFiles = false;
 	bool m_isEnabled = false;
-	QString m_exp;
+	QRegularExpression m_exp;
+	int m_maxWatches = 1024;
+	int m_watchCount = 0;
+	bool m_warnedAboutCap = false;
 
 	QFileSystemWatcher *m_watcher;
+	QTimer m_debounce;
+	QSet<QString> m_dirtyDirs;
 
-	QStringList m_files;
-	void setFiles(const QStringList &files);
+	std::unique_ptr<Node> m_tree;
+	QSet<QString> m_files;
 
-	void addFilesToWatcherRecursive(const QDir &dir);
-	QStringList scanRecursive(const QDir &dir);
+	Node *findNode(const QString &relativePath) const;
+	void rescan(Node *node, const QString &relativePath, bool recursive, Delta &delta);
+	void removeTree(Node *node, const QString &relativePath, Delta &delta);
+	bool reserveWatch();
+	void watch(Node *node, const QString &relativePath);
+	void watchFile(Node *node, const QString &relativePath, const QString &name);
+	void unwatchFile(Node *node, const QString &relativePath, const QString &name);
+	void watchRecursive(Node *node, const QString &relativePath);
+	void unwatch(Node *node, const QString &relativePath);
+	void apply(const Delta &delta);
 
 private slots:
-	void fileChange(const QString &path);
 	void directoryChange(const QString &path);
+	void fileChange(const QString &path);
+	void processChanges();
 };
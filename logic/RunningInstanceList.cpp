@@ -0,0 +1,226 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RunningInstanceList.h"
+
+#include <QFile>
+
+#include "logic/MinecraftProcess.h"
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+RunningInstanceList::RunningInstanceList(QObject *parent) : QAbstractTableModel(parent)
+{
+	m_clock.start();
+	m_sampleTimer.setInterval(2000);
+	connect(&m_sampleTimer, SIGNAL(timeout()), SLOT(sample()));
+}
+
+void RunningInstanceList::addProcess(MinecraftProcess *process)
+{
+	Entry entry;
+	entry.process = process;
+	entry.name = process->instance()->name();
+
+	beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
+	m_entries.append(entry);
+	endInsertRows();
+
+	connect(process, SIGNAL(ended(InstancePtr, int, QProcess::ExitStatus)),
+			SLOT(processEnded()));
+	connect(process, SIGNAL(prelaunch_failed(InstancePtr, int, QProcess::ExitStatus)),
+			SLOT(processEnded()));
+	connect(process, SIGNAL(launch_failed(InstancePtr)), SLOT(processEnded()));
+	connect(process, SIGNAL(destroyed(QObject *)), SLOT(removeProcess(QObject *)));
+
+	if (!m_sampleTimer.isActive())
+	{
+		m_sampleTimer.start();
+	}
+}
+
+void RunningInstanceList::processEnded()
+{
+	removeProcess(sender());
+}
+
+void RunningInstanceList::removeProcess(QObject *process)
+{
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		if (m_entries[i].process == process)
+		{
+			disconnect(process, 0, this, 0);
+			beginRemoveRows(QModelIndex(), i, i);
+			m_entries.removeAt(i);
+			endRemoveRows();
+			break;
+		}
+	}
+	if (m_entries.isEmpty())
+	{
+		m_sampleTimer.stop();
+	}
+}
+
+MinecraftProcess *RunningInstanceList::processFor(InstancePtr instance) const
+{
+	for (auto &entry : m_entries)
+	{
+		if (entry.process->instance() == instance)
+		{
+			return entry.process;
+		}
+	}
+	return nullptr;
+}
+
+QList<MinecraftProcess *> RunningInstanceList::processes() const
+{
+	QList<MinecraftProcess *> out;
+	for (auto &entry : m_entries)
+	{
+		out.append(entry.process);
+	}
+	return out;
+}
+
+qint64 RunningInstanceList::residentMemory(MinecraftProcess *process) const
+{
+	for (auto &entry : m_entries)
+	{
+		if (entry.process == process)
+		{
+			return entry.rss;
+		}
+	}
+	return 0;
+}
+
+void RunningInstanceList::sample()
+{
+#ifdef Q_OS_LINUX
+	static const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+	qint64 now = m_clock.elapsed();
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		auto &entry = m_entries[i];
+		entry.pid = entry.process->pid();
+		if (entry.pid <= 0)
+		{
+			continue;
+		}
+
+		// utime and stime are the 14th and 15th fields. the 2nd can contain spaces, so skip it.
+		QFile statFile(QString("/proc/%1/stat").arg(entry.pid));
+		if (statFile.open(QIODevice::ReadOnly))
+		{
+			QByteArray stat = statFile.readAll();
+			auto fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+			if (fields.size() > 12)
+			{
+				quint64 ticks = fields[11].toULongLong() + fields[12].toULongLong();
+				if (entry.lastSampleTime >= 0 && now > entry.lastSampleTime)
+				{
+					double seconds = double(ticks - entry.lastTicks) / ticksPerSecond;
+					entry.cpu = 100.0 * seconds * 1000.0 / double(now - entry.lastSampleTime);
+				}
+				entry.lastTicks = ticks;
+				entry.lastSampleTime = now;
+			}
+		}
+
+		QFile statusFile(QString("/proc/%1/status").arg(entry.pid));
+		if (statusFile.open(QIODevice::ReadOnly))
+		{
+			for (auto line : statusFile.readAll().split('\n'))
+			{
+				if (line.startsWith("VmRSS:"))
+				{
+					entry.rss = line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+					break;
+				}
+			}
+		}
+	}
+	if (!m_entries.isEmpty())
+	{
+		emit dataChanged(index(0, PidColumn), index(m_entries.size() - 1, MemoryColumn));
+	}
+#endif
+}
+
+QVariant RunningInstanceList::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() >= m_entries.size())
+	{
+		return QVariant();
+	}
+	auto &entry = m_entries[index.row()];
+	if (role == ProcessPointerRole)
+	{
+		return QVariant::fromValue<void *>(entry.process);
+	}
+	if (role != Qt::DisplayRole)
+	{
+		return QVariant();
+	}
+	switch (index.column())
+	{
+	case NameColumn:
+		return entry.name;
+	case PidColumn:
+		return entry.pid > 0 ? QString::number(entry.pid) : QString("-");
+	case CpuColumn:
+		return entry.cpu >= 0 ? QString("%1%").arg(entry.cpu, 0, 'f', 1) : QString("-");
+	case MemoryColumn:
+		return entry.rss > 0 ? QString("%1 MiB").arg(entry.rss / (1024 * 1024)) : QString("-");
+	default:
+		return QVariant();
+	}
+}
+
+QVariant RunningInstanceList::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+	{
+		return QVariant();
+	}
+	switch (section)
+	{
+	case NameColumn:
+		return tr("Instance");
+	case PidColumn:
+		return tr("PID");
+	case CpuColumn:
+		return tr("CPU");
+	case MemoryColumn:
+		return tr("Memory");
+	default:
+		return QVariant();
+	}
+}
+
+int RunningInstanceList::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : m_entries.size();
+}
+
+int RunningInstanceList::columnCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : ColumnCount;
+}
@@ -0,0 +1,88 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QList>
+
+#include "logic/BaseInstance.h"
+
+class MinecraftProcess;
+
+/*!
+ * The Minecraft processes MultiMC is currently running, with their CPU usage and resident
+ * memory. Those are sampled from /proc every few seconds, so only Linux has them.
+ */
+class RunningInstanceList : public QAbstractTableModel
+{
+	Q_OBJECT
+public:
+	enum Column
+	{
+		NameColumn,
+		PidColumn,
+		CpuColumn,
+		MemoryColumn,
+		ColumnCount
+	};
+	enum Roles
+	{
+		ProcessPointerRole = Qt::UserRole
+	};
+
+	explicit RunningInstanceList(QObject *parent = 0);
+	virtual ~RunningInstanceList() {};
+
+	virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	virtual QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+	virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
+
+	/// start tracking the process. it is dropped from the list once it ends.
+	void addProcess(MinecraftProcess *process);
+
+	/// the process running the instance, if any
+	MinecraftProcess *processFor(InstancePtr instance) const;
+
+	/// all the tracked processes
+	QList<MinecraftProcess *> processes() const;
+
+	/// the resident memory of the process in bytes, or 0 if it isn't known
+	qint64 residentMemory(MinecraftProcess *process) const;
+
+private
+slots:
+	void processEnded();
+	void removeProcess(QObject *process);
+	void sample();
+
+private:
+	struct Entry
+	{
+		MinecraftProcess *process = nullptr;
+		QString name;
+		qint64 pid = 0;
+		quint64 lastTicks = 0;
+		qint64 lastSampleTime = -1;
+		double cpu = -1;
+		qint64 rss = 0;
+	};
+	QList<Entry> m_entries;
+	QTimer m_sampleTimer;
+	QElapsedTimer m_clock;
+};
@@ -0,0 +1,252 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StartupGraph.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSet>
+#include <QThreadPool>
+
+#include "MMCError.h"
+#include "logger/QsLog.h"
+
+class StartupGraph::Runnable : public QRunnable
+{
+public:
+	Runnable(StartupGraph *graph, Phase *phase) : m_graph(graph), m_phase(phase)
+	{
+	}
+	void run() override
+	{
+		m_graph->execute(*m_phase);
+	}
+
+private:
+	StartupGraph *m_graph;
+	Phase *m_phase;
+};
+
+StartupGraph::StartupGraph(TracePtr trace) : m_trace(trace)
+{
+}
+
+StartupGraph::~StartupGraph()
+{
+	QMutexLocker locker(&m_lock);
+	while (m_running > 0)
+	{
+		m_finished.wait(&m_lock);
+	}
+}
+
+void StartupGraph::add(const QString &name, Thread thread, std::function<void()> work,
+					   const QStringList &after)
+{
+	Q_ASSERT_X(!m_index.contains(name), "StartupGraph::add", "phase names must be unique");
+	Phase phase;
+	phase.name = name;
+	phase.thread = thread;
+	phase.work = work;
+	phase.after = after;
+	m_index.insert(name, m_phases.size());
+	m_phases.append(phase);
+}
+
+bool StartupGraph::collect(const QString &name, QStringList &needed, QStringList &visiting) const
+{
+	if (needed.contains(name))
+	{
+		return true;
+	}
+	if (visiting.contains(name))
+	{
+		QLOG_ERROR() << "Startup phases need each other:" << visiting.join(" -> ") << "->" << name;
+		return false;
+	}
+	auto iter = m_index.find(name);
+	if (iter == m_index.end())
+	{
+		QLOG_ERROR() << "Unknown startup phase" << name
+					 << (visiting.isEmpty() ? QString() : "needed by " + visiting.last());
+		return false;
+	}
+	visiting.append(name);
+	for (auto dependency : m_phases[*iter].after)
+	{
+		if (!collect(dependency, needed, visiting))
+		{
+			return false;
+		}
+	}
+	visiting.removeLast();
+	needed.append(name);
+	return true;
+}
+
+bool StartupGraph::isReady(const Phase &phase) const
+{
+	for (auto dependency : phase.after)
+	{
+		if (!m_phases[m_index[dependency]].done)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void StartupGraph::execute(Phase &phase)
+{
+	const bool background = phase.thread == Background && !m_serial;
+	int span = m_trace ? m_trace->begin(phase.name, "startup") : -1;
+	QElapsedTimer timer;
+	timer.start();
+	if (background)
+	{
+		// nobody would catch it on a pool thread, and the phases after it still have to run
+		try
+		{
+			phase.work();
+		}
+		catch (MMCError &e)
+		{
+			QLOG_ERROR() << "Startup phase" << phase.name << "failed:" << e.cause();
+		}
+		catch (std::exception &e)
+		{
+			QLOG_ERROR() << "Startup phase" << phase.name << "failed:" << e.what();
+		}
+	}
+	else
+	{
+		phase.work();
+	}
+	qint64 ms = timer.elapsed();
+	if (m_trace)
+	{
+		m_trace->end(span);
+	}
+
+	QMutexLocker locker(&m_lock);
+	phase.ms = ms;
+	phase.done = true;
+	if (background)
+	{
+		m_running--;
+		m_finished.wakeAll();
+	}
+}
+
+bool StartupGraph::run(const QStringList &targets)
+{
+	QStringList needed;
+	QStringList visiting;
+	for (auto target : targets.isEmpty() ? phases() : targets)
+	{
+		if (!collect(target, needed, visiting))
+		{
+			return false;
+		}
+	}
+	const QSet<QString> neededSet = needed.toSet();
+
+	QMutexLocker locker(&m_lock);
+	while (true)
+	{
+		bool allDone = true;
+		Phase *next = nullptr;
+		for (auto &phase : m_phases)
+		{
+			if (!neededSet.contains(phase.name))
+				continue;
+			if (!phase.done)
+				allDone = false;
+			if (phase.started || !isReady(phase))
+				continue;
+			if (phase.thread == Background && !m_serial)
+			{
+				phase.started = true;
+				m_running++;
+				QThreadPool::globalInstance()->start(new Runnable(this, &phase));
+			}
+			else if (!next)
+			{
+				next = &phase;
+			}
+		}
+		if (allDone)
+		{
+			return true;
+		}
+		if (next)
+		{
+			next->started = true;
+			locker.unlock();
+			execute(*next);
+			locker.relock();
+			continue;
+		}
+		if (m_running == 0)
+		{
+			// a phase before this run failed, what needs it can't run
+			QLOG_ERROR() << "Startup phases can't run, a phase they need failed";
+			return false;
+		}
+		// what is left waits for the background
+		m_finished.wait(&m_lock);
+	}
+}
+
+bool StartupGraph::isDone(const QString &name) const
+{
+	QMutexLocker locker(&m_lock);
+	auto iter = m_index.find(name);
+	return iter != m_index.end() && m_phases[*iter].done;
+}
+
+qint64 StartupGraph::duration(const QString &name) const
+{
+	QMutexLocker locker(&m_lock);
+	auto iter = m_index.find(name);
+	return iter == m_index.end() ? -1 : m_phases[*iter].ms;
+}
+
+QStringList StartupGraph::phases() const
+{
+	QStringList names;
+	for (auto &phase : m_phases)
+	{
+		names.append(phase.name);
+	}
+	return names;
+}
+
+QStringList StartupGraph::summary() const
+{
+	QMutexLocker locker(&m_lock);
+	QStringList lines;
+	for (auto &phase : m_phases)
+	{
+		if (!phase.done)
+			continue;
+		lines.append(QString("%1: %2 ms%3")
+						 .arg(phase.name)
+						 .arg(phase.ms)
+						 .arg(phase.thread == Background && !m_serial ? " (background)" : ""));
+	}
+	return lines;
+}
@@ -0,0 +1,102 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QWaitCondition>
+#include <functional>
+
+#include "logic/Trace.h"
+
+/*!
+ * Runs work that depends on other work as soon as it can, like the startup of MultiMC.
+ *
+ * Every phase names the phases it needs. Background phases go to the global thread pool, the
+ * others run on the thread that calls run(), in the order they were added. A background phase
+ * may only use what its dependencies produced: reading and parsing files is fine, the settings
+ * and anything that is part of the GUI are not.
+ *
+ * Phases are timed, and recorded as spans of the trace if there is one.
+ */
+class StartupGraph
+{
+public:
+	enum Thread
+	{
+		MainThread,
+		Background
+	};
+
+	explicit StartupGraph(TracePtr trace = TracePtr());
+	~StartupGraph();
+
+	void add(const QString &name, Thread thread, std::function<void()> work,
+			 const QStringList &after = QStringList());
+
+	/*!
+	 * Runs the named phases and what they need, or all phases if none are named, and returns
+	 * once they are done. Phases that already ran don't run again.
+	 *
+	 * Returns false, without running anything, if a phase needs one that doesn't exist or the
+	 * phases need each other in a circle.
+	 */
+	bool run(const QStringList &targets = QStringList());
+
+	/// run every phase on the calling thread, one after the other. for comparisons.
+	void setSerial(bool serial)
+	{
+		m_serial = serial;
+	}
+
+	bool isDone(const QString &name) const;
+	/// how long a phase took in milliseconds, -1 if it didn't run yet
+	qint64 duration(const QString &name) const;
+	/// the phases, in the order they were added
+	QStringList phases() const;
+	/// one line per phase that ran: its duration and where it ran
+	QStringList summary() const;
+
+private:
+	struct Phase
+	{
+		QString name;
+		Thread thread;
+		std::function<void()> work;
+		QStringList after;
+		bool started = false;
+		bool done = false;
+		qint64 ms = -1;
+	};
+	class Runnable;
+
+	/// adds name and everything it needs to needed. false if something is missing or circular.
+	bool collect(const QString &name, QStringList &needed, QStringList &visiting) const;
+	bool isReady(const Phase &phase) const;
+	void execute(Phase &phase);
+
+	TracePtr m_trace;
+	bool m_serial = false;
+	QList<Phase> m_phases;
+	QMap<QString, int> m_index;
+	/// guards the state of the phases and the number of running background phases
+	mutable QMutex m_lock;
+	QWaitCondition m_finished;
+	int m_running = 0;
+};
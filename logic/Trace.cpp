@@ -0,0 +1,184 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Trace.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+
+Trace::Trace(const QString &name) : m_name(name)
+{
+	m_clock.start();
+}
+
+qint64 Trace::now() const
+{
+	// microseconds, which is what the Chrome trace format uses
+	return m_clock.nsecsElapsed() / 1000;
+}
+
+qint64 Trace::elapsed() const
+{
+	return m_clock.elapsed();
+}
+
+int Trace::threadId()
+{
+	auto handle = QThread::currentThreadId();
+	auto iter = m_threads.find(handle);
+	if (iter == m_threads.end())
+	{
+		iter = m_threads.insert(handle, m_threads.size() + 1);
+	}
+	return iter.value();
+}
+
+int Trace::begin(const QString &name, const QString &category)
+{
+	QMutexLocker locker(&m_lock);
+	qint64 time = now();
+	m_spans.append(Span{name, category, time, -1, threadId(), 0, 0, 0, false});
+	return m_spans.size() - 1;
+}
+
+void Trace::end(int span)
+{
+	QMutexLocker locker(&m_lock);
+	if (span < 0 || span >= m_spans.size())
+		return;
+	m_spans[span].end = now();
+}
+
+void Trace::addBytes(int span, qint64 bytes)
+{
+	QMutexLocker locker(&m_lock);
+	if (span < 0 || span >= m_spans.size())
+		return;
+	m_spans[span].bytes += bytes;
+}
+
+void Trace::addCacheResults(int span, int hits, int misses)
+{
+	QMutexLocker locker(&m_lock);
+	if (span < 0 || span >= m_spans.size())
+		return;
+	m_spans[span].cacheHits += hits;
+	m_spans[span].cacheMisses += misses;
+}
+
+void Trace::mark(const QString &name, const QString &category)
+{
+	QMutexLocker locker(&m_lock);
+	qint64 time = now();
+	m_spans.append(Span{name, category, time, time, threadId(), 0, 0, 0, true});
+}
+
+QByteArray Trace::toChromeTrace() const
+{
+	QMutexLocker locker(&m_lock);
+	qint64 time = now();
+	QJsonArray events;
+
+	QJsonObject processName;
+	processName.insert("name", QString("process_name"));
+	processName.insert("ph", QString("M"));
+	processName.insert("pid", 1);
+	QJsonObject processArgs;
+	processArgs.insert("name", m_name);
+	processName.insert("args", processArgs);
+	events.append(processName);
+
+	for (auto &span : m_spans)
+	{
+		QJsonObject event;
+		event.insert("name", span.name);
+		event.insert("cat", span.category);
+		event.insert("pid", 1);
+		event.insert("tid", span.thread);
+		event.insert("ts", double(span.begin));
+		if (span.instant)
+		{
+			event.insert("ph", QString("i"));
+			event.insert("s", QString("g"));
+		}
+		else
+		{
+			// spans that are still open end now
+			qint64 end = span.end < 0 ? time : span.end;
+			event.insert("ph", QString("X"));
+			event.insert("dur", double(end - span.begin));
+			QJsonObject args;
+			if (span.bytes)
+				args.insert("bytes", double(span.bytes));
+			if (span.cacheHits || span.cacheMisses)
+			{
+				args.insert("cache_hits", span.cacheHits);
+				args.insert("cache_misses", span.cacheMisses);
+			}
+			if (span.end < 0)
+				args.insert("unfinished", true);
+			event.insert("args", args);
+		}
+		events.append(event);
+	}
+	QJsonObject root;
+	root.insert("traceEvents", events);
+	root.insert("displayTimeUnit", QString("ms"));
+	return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QStringList Trace::summary() const
+{
+	QMutexLocker locker(&m_lock);
+	QStringList lines;
+	for (auto &span : m_spans)
+	{
+		QString line;
+		if (span.instant)
+		{
+			line = QString("%1 ms: %2").arg(span.begin / 1000, 7).arg(span.name);
+		}
+		else if (span.end < 0)
+		{
+			line = QString("%1 ms: %2 (unfinished)").arg(span.begin / 1000, 7).arg(span.name);
+		}
+		else
+		{
+			line = QString("%1 ms: %2 took %3 ms")
+					   .arg(span.begin / 1000, 7)
+					   .arg(span.name)
+					   .arg((span.end - span.begin) / 1000);
+			if (span.bytes)
+				line += QString(", %1 KiB").arg(span.bytes / 1024);
+			if (span.cacheHits || span.cacheMisses)
+				line += QString(", %1 cached, %2 fetched").arg(span.cacheHits).arg(span.cacheMisses);
+		}
+		lines.append(line);
+	}
+	return lines;
+}
+
+bool Trace::save(const QString &path) const
+{
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+	file.write(toChromeTrace());
+	return file.commit();
+}
@@ -0,0 +1,79 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+class Trace;
+typedef std::shared_ptr<Trace> TracePtr;
+
+/*!
+ * Records how long the stages of something took, as nested time spans.
+ *
+ * Spans carry the number of bytes they moved and how many cached files they could use.
+ * The result can be saved in the Chrome trace format (chrome://tracing, Perfetto) or
+ * summarized as text. Spans can be recorded from any thread.
+ */
+class Trace
+{
+public:
+	explicit Trace(const QString &name);
+
+	/// starts a span and returns its id
+	int begin(const QString &name, const QString &category);
+	void end(int span);
+
+	void addBytes(int span, qint64 bytes);
+	void addCacheResults(int span, int hits, int misses);
+
+	/// records a point in time, like the first line of output
+	void mark(const QString &name, const QString &category);
+
+	/// milliseconds since the trace was created
+	qint64 elapsed() const;
+
+	QByteArray toChromeTrace() const;
+	QStringList summary() const;
+	bool save(const QString &path) const;
+
+private:
+	struct Span
+	{
+		QString name;
+		QString category;
+		qint64 begin;
+		qint64 end;
+		int thread;
+		qint64 bytes;
+		int cacheHits;
+		int cacheMisses;
+		bool instant;
+	};
+	int threadId();
+	qint64 now() const;
+
+	QString m_name;
+	QElapsedTimer m_clock;
+	mutable QMutex m_lock;
+	QList<Span> m_spans;
+	QHash<Qt::HANDLE, int> m_threads;
+};
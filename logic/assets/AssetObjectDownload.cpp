@@ -0,0 +1,125 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MultiMC.h"
+#include "AssetObjectDownload.h"
+#include "AssetObjectStore.h"
+#include <pathutils.h>
+
+#include "logger/QsLog.h"
+
+AssetObjectDownload::AssetObjectDownload(QUrl url, AssetObject object)
+	: NetAction(), sha1sum(QCryptographicHash::Sha1)
+{
+	m_url = url;
+	m_object = object;
+	m_target_path = AssetsUtils::objectPath(object.hash);
+	m_total_progress = object.size;
+	m_status = Job_NotStarted;
+}
+
+void AssetObjectDownload::start()
+{
+	m_status = Job_InProgress;
+	sha1sum.reset();
+	m_output_file.reset(new QSaveFile(m_target_path));
+	if (!ensureFilePathExists(m_target_path))
+	{
+		QLOG_ERROR() << "Could not create folder for " + m_target_path;
+		m_status = Job_Failed;
+		emit failed(m_index_within_job);
+		return;
+	}
+	if (!m_output_file->open(QIODevice::WriteOnly))
+	{
+		QLOG_ERROR() << "Could not open " + m_target_path + " for writing";
+		m_status = Job_Failed;
+		emit failed(m_index_within_job);
+		return;
+	}
+
+	QLOG_INFO() << "Downloading " << m_url.toString();
+	QNetworkRequest request(m_url);
+	request.setHeader(QNetworkRequest::UserAgentHeader, "MultiMC/5.0 (Uncached)");
+
+	auto worker = MMC->qnam();
+	QNetworkReply *rep = worker->get(request);
+
+	m_reply = std::shared_ptr<QNetworkReply>(rep);
+	connect(rep, SIGNAL(downloadProgress(qint64, qint64)),
+			SLOT(downloadProgress(qint64, qint64)));
+	connect(rep, SIGNAL(finished()), SLOT(downloadFinished()));
+	connect(rep, SIGNAL(error(QNetworkReply::NetworkError)),
+			SLOT(downloadError(QNetworkReply::NetworkError)));
+	connect(rep, SIGNAL(readyRead()), SLOT(downloadReadyRead()));
+}
+
+void AssetObjectDownload::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
+{
+	m_total_progress = bytesTotal;
+	m_progress = bytesReceived;
+	emit progress(m_index_within_job, bytesReceived, bytesTotal);
+}
+
+void AssetObjectDownload::downloadError(QNetworkReply::NetworkError error)
+{
+	QLOG_ERROR() << "Failed " << m_url.toString() << " with reason " << error;
+	m_status = Job_Failed;
+}
+
+void AssetObjectDownload::downloadFinished()
+{
+	if (m_status != Job_Failed)
+	{
+		QString sha1 = sha1sum.result().toHex().constData();
+		if (sha1 != m_object.hash)
+		{
+			QLOG_ERROR() << "Downloaded object" << m_url.toString() << "has SHA-1" << sha1;
+			m_status = Job_Failed;
+		}
+		else if (!m_output_file->commit())
+		{
+			QLOG_ERROR() << "Failed to commit changes to " << m_target_path;
+			m_status = Job_Failed;
+		}
+	}
+
+	if (m_status == Job_Failed)
+	{
+		m_output_file->cancelWriting();
+		m_output_file.reset();
+		m_reply.reset();
+		emit failed(m_index_within_job);
+		return;
+	}
+
+	m_status = Job_Finished;
+	m_output_file.reset();
+	m_reply.reset();
+	MMC->assetStore()->add(m_object);
+	emit succeeded(m_index_within_job);
+}
+
+void AssetObjectDownload::downloadReadyRead()
+{
+	QByteArray ba = m_reply->readAll();
+	sha1sum.addData(ba);
+	if (m_output_file->write(ba) != ba.size())
+	{
+		QLOG_ERROR() << "Failed writing into " + m_target_path;
+		m_status = Job_Failed;
+		m_reply->abort();
+	}
+}
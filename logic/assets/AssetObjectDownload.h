@@ -0,0 +1,59 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "logic/net/NetAction.h"
+#include "AssetsUtils.h"
+#include <QCryptographicHash>
+#include <QSaveFile>
+
+typedef std::shared_ptr<class AssetObjectDownload> AssetObjectDownloadPtr;
+/*!
+ * Downloads an object into the asset object store.
+ *
+ * The data is hashed as it arrives and only replaces the file if its SHA-1 matches the object
+ * name. The object is then added to the object store index.
+ */
+class AssetObjectDownload : public NetAction
+{
+	Q_OBJECT
+private:
+	AssetObject m_object;
+	/// the object path inside the store
+	QString m_target_path;
+	/// this is the output file
+	std::shared_ptr<QSaveFile> m_output_file;
+	/// the hash-as-you-download
+	QCryptographicHash sha1sum;
+
+public:
+	explicit AssetObjectDownload(QUrl url, AssetObject object);
+	static AssetObjectDownloadPtr make(QUrl url, AssetObject object)
+	{
+		return AssetObjectDownloadPtr(new AssetObjectDownload(url, object));
+	}
+	virtual ~AssetObjectDownload(){};
+protected
+slots:
+	virtual void downloadProgress(qint64 bytesReceived, qint64 bytesTotal);
+	virtual void downloadError(QNetworkReply::NetworkError error);
+	virtual void downloadFinished();
+	virtual void downloadReadyRead();
+
+public
+slots:
+	virtual void start();
+};
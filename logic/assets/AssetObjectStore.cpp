@@ -0,0 +1,117 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AssetObjectStore.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "logger/QsLog.h"
+
+AssetObjectStore::AssetObjectStore(QString objectsPath) : QObject()
+{
+	m_index_file = objectsPath + "/index.json";
+	saveBatchingTimer.setSingleShot(true);
+	saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
+	connect(&saveBatchingTimer, SIGNAL(timeout()), SLOT(SaveNow()));
+}
+
+AssetObjectStore::~AssetObjectStore()
+{
+	if (saveBatchingTimer.isActive())
+	{
+		saveBatchingTimer.stop();
+		SaveNow();
+	}
+}
+
+bool AssetObjectStore::contains(const AssetObject &object) const
+{
+	auto iter = m_objects.find(object.hash);
+	return iter != m_objects.end() && iter.value() == object.size;
+}
+
+void AssetObjectStore::add(const AssetObject &object)
+{
+	m_objects.insert(object.hash, object.size);
+	SaveEventually();
+}
+
+void AssetObjectStore::remove(const QString &hash)
+{
+	if (m_objects.remove(hash))
+	{
+		SaveEventually();
+	}
+}
+
+int AssetObjectStore::count() const
+{
+	return m_objects.size();
+}
+
+void AssetObjectStore::Load()
+{
+	QFile index(m_index_file);
+	if (!index.open(QIODevice::ReadOnly))
+		return;
+
+	QJsonDocument json = QJsonDocument::fromJson(index.readAll());
+	if (!json.isObject())
+		return;
+	auto root = json.object();
+	if (root.value("version").toString() != "1")
+		return;
+
+	auto objects = root.value("objects").toObject();
+	m_objects.reserve(objects.size());
+	for (auto iter = objects.begin(); iter != objects.end(); ++iter)
+	{
+		m_objects.insert(iter.key(), iter.value().toDouble());
+	}
+	QLOG_INFO() << "Asset object store knows" << m_objects.size() << "objects";
+}
+
+void AssetObjectStore::SaveEventually()
+{
+	// reset the save timer
+	saveBatchingTimer.stop();
+	saveBatchingTimer.start(30000);
+}
+
+void AssetObjectStore::SaveNow()
+{
+	QSaveFile tfile(m_index_file);
+	if (!tfile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return;
+	QJsonObject objects;
+	for (auto iter = m_objects.begin(); iter != m_objects.end(); ++iter)
+	{
+		objects.insert(iter.key(), double(iter.value()));
+	}
+	QJsonObject toplevel;
+	toplevel.insert("version", QString("1"));
+	toplevel.insert("objects", objects);
+	QJsonDocument doc(toplevel);
+	QByteArray jsonData = doc.toJson(QJsonDocument::Compact);
+	if (tfile.write(jsonData) != jsonData.size())
+	{
+		tfile.cancelWriting();
+		return;
+	}
+	tfile.commit();
+}
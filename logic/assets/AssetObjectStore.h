@@ -0,0 +1,63 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QTimer>
+#include <memory>
+
+#include "AssetsUtils.h"
+
+/*!
+ * Index of the shared asset object store (assets/objects), so the updater can tell which
+ * objects are missing without looking at every file.
+ *
+ * Objects are named by their SHA-1 and never change, so an object is added once its content
+ * was checked against its name and stays valid until somebody removes it by hand. A deep
+ * verification (see AssetsUtils::checkObject) catches that.
+ */
+class AssetObjectStore : public QObject
+{
+	Q_OBJECT
+public:
+	// supply path to the object store. the index is kept inside it.
+	AssetObjectStore(QString objectsPath);
+	~AssetObjectStore();
+
+	/// true if the object is known to be in the store with the right size
+	bool contains(const AssetObject &object) const;
+
+	/// record a verified object
+	void add(const AssetObject &object);
+
+	/// forget about an object, because it's missing or broken
+	void remove(const QString &hash);
+
+	int count() const;
+
+	// (re)start a timer that calls SaveNow later.
+	void SaveEventually();
+	void Load();
+public
+slots:
+	void SaveNow();
+
+private:
+	QHash<QString, qint64> m_objects;
+	QString m_index_file;
+	QTimer saveBatchingTimer;
+};
@@ -14,14 +14,389 @@
  */
 
 #include <QDir>
+#include <QFile>
 #include <QDirIterator>
 #include <QCryptographicHash>
-#include <QJsonParseError>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <cctype>
+#include <cstring>
 
 #include "AssetsUtils.h"
 #include "MultiMC.h"
+#include "logic/LRUCache.h"
+
+namespace
+{
+/// parsed indexes by the MD5 of the file they came from
+typedef LRUCache<QByteArray, AssetsIndex> AssetsIndexCache;
+
+AssetsIndexCache &indexCache()
+{
+	// the index of a recent version is around 2 MB in memory
+	static AssetsIndexCache cache(16 * 1024 * 1024);
+	return cache;
+}
+
+/*!
+ * Reads an assets index straight from the JSON text into the flat records.
+ *
+ * Only the parts of JSON an index uses are interpreted. Anything else is checked for syntax
+ * and skipped.
+ */
+class IndexParser
+{
+public:
+	IndexParser(const QByteArray &data, AssetsIndex *index)
+		: m_pos(data.constData()), m_end(data.constData() + data.size()), m_index(index)
+	{
+		// a typical entry takes about 110 bytes of JSON and 40 bytes of name
+		m_index->records.reserve(data.size() / 100);
+		m_index->names.reserve(data.size() / 3);
+	}
+
+	bool parse()
+	{
+		if (!expect('{'))
+			return false;
+		if (peek() == '}')
+		{
+			m_pos++;
+			return atEnd();
+		}
+		while (true)
+		{
+			QByteArray key;
+			if (!parseString(key) || !expect(':'))
+				return false;
+			bool ok;
+			if (key == "objects")
+				ok = parseObjects();
+			else if (key == "virtual")
+				ok = parseVirtual();
+			else
+				ok = skipValue(0);
+			bool done;
+			if (!ok || !nextMember('}', done))
+				return false;
+			if (done)
+				return atEnd();
+		}
+	}
+
+	QString error() const
+	{
+		return m_error;
+	}
+
+private:
+	bool fail(const QString &what)
+	{
+		if (m_error.isEmpty())
+			m_error = what;
+		return false;
+	}
+
+	char peek()
+	{
+		while (m_pos < m_end &&
+			   (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t'))
+			m_pos++;
+		return m_pos < m_end ? *m_pos : 0;
+	}
+
+	bool expect(char c)
+	{
+		if (peek() != c)
+			return fail(QString("expected '%1'").arg(c));
+		m_pos++;
+		return true;
+	}
+
+	bool atEnd()
+	{
+		if (peek() != 0 || m_pos != m_end)
+			return fail("garbage after the index");
+		return true;
+	}
+
+	/// after a member or element: true and done set if the container is closed
+	bool nextMember(char close, bool &done)
+	{
+		char c = peek();
+		done = c == close;
+		if (c == ',' || c == close)
+		{
+			m_pos++;
+			return true;
+		}
+		return fail(QString("expected ',' or '%1'").arg(close));
+	}
+
+	bool parseString(QByteArray &out)
+	{
+		if (!expect('"'))
+			return false;
+		while (true)
+		{
+			// copy the plain runs in one go
+			const char *run = m_pos;
+			while (m_pos < m_end && *m_pos != '"' && *m_pos != '\\')
+				m_pos++;
+			out.append(run, m_pos - run);
+			if (m_pos == m_end)
+				return fail("unterminated string");
+			if (*m_pos++ == '"')
+				return true;
+			if (m_pos == m_end)
+				return fail("unterminated string");
+			switch (*m_pos++)
+			{
+			case '"':
+				out.append('"');
+				break;
+			case '\\':
+				out.append('\\');
+				break;
+			case '/':
+				out.append('/');
+				break;
+			case 'b':
+				out.append('\b');
+				break;
+			case 'f':
+				out.append('\f');
+				break;
+			case 'n':
+				out.append('\n');
+				break;
+			case 'r':
+				out.append('\r');
+				break;
+			case 't':
+				out.append('\t');
+				break;
+			case 'u':
+			{
+				uint code;
+				if (!parseHex4(code))
+					return false;
+				// surrogate pairs encode one character outside the BMP
+				if (code >= 0xD800 && code < 0xDC00 && m_end - m_pos >= 6 && m_pos[0] == '\\' &&
+					m_pos[1] == 'u')
+				{
+					m_pos += 2;
+					uint low;
+					if (!parseHex4(low))
+						return false;
+					if (low < 0xDC00 || low > 0xDFFF)
+						return fail("invalid surrogate pair");
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+				}
+				appendUtf8(out, code);
+				break;
+			}
+			default:
+				return fail("invalid escape sequence");
+			}
+		}
+	}
+
+	bool parseHex4(uint &code)
+	{
+		if (m_end - m_pos < 4)
+			return fail("truncated \\u escape");
+		bool ok;
+		code = QByteArray::fromRawData(m_pos, 4).toUInt(&ok, 16);
+		m_pos += 4;
+		if (!ok)
+			return fail("invalid \\u escape");
+		return true;
+	}
+
+	static void appendUtf8(QByteArray &out, uint code)
+	{
+		if (code < 0x80)
+		{
+			out.append(char(code));
+		}
+		else if (code < 0x800)
+		{
+			out.append(char(0xC0 | (code >> 6)));
+			out.append(char(0x80 | (code & 0x3F)));
+		}
+		else if (code < 0x10000)
+		{
+			out.append(char(0xE0 | (code >> 12)));
+			out.append(char(0x80 | ((code >> 6) & 0x3F)));
+			out.append(char(0x80 | (code & 0x3F)));
+		}
+		else
+		{
+			out.append(char(0xF0 | (code >> 18)));
+			out.append(char(0x80 | ((code >> 12) & 0x3F)));
+			out.append(char(0x80 | ((code >> 6) & 0x3F)));
+			out.append(char(0x80 | (code & 0x3F)));
+		}
+	}
+
+	bool parseNumber(double &out)
+	{
+		peek();
+		const char *start = m_pos;
+		while (m_pos < m_end && (isdigit(*m_pos) || *m_pos == '-' || *m_pos == '+' ||
+								 *m_pos == '.' || *m_pos == 'e' || *m_pos == 'E'))
+			m_pos++;
+		bool ok;
+		out = QByteArray::fromRawData(start, m_pos - start).toDouble(&ok);
+		if (!ok)
+			return fail("invalid number");
+		return true;
+	}
+
+	bool parseLiteral(const char *literal)
+	{
+		int length = strlen(literal);
+		if (m_end - m_pos < length || memcmp(m_pos, literal, length) != 0)
+			return fail("invalid literal");
+		m_pos += length;
+		return true;
+	}
+
+	bool parseVirtual()
+	{
+		char c = peek();
+		if (c == 't')
+		{
+			m_index->isVirtual = true;
+			return parseLiteral("true");
+		}
+		// anything else means no, like QJsonValue::toBool(false) did
+		m_index->isVirtual = false;
+		return skipValue(0);
+	}
+
+	bool skipValue(int depth)
+	{
+		if (depth > 64)
+			return fail("nested too deep");
+		char c = peek();
+		if (c == '"')
+		{
+			QByteArray ignored;
+			return parseString(ignored);
+		}
+		if (c == '{' || c == '[')
+		{
+			char close = c == '{' ? '}' : ']';
+			m_pos++;
+			if (peek() == close)
+			{
+				m_pos++;
+				return true;
+			}
+			bool done = false;
+			while (!done)
+			{
+				if (c == '{')
+				{
+					QByteArray ignored;
+					if (!parseString(ignored) || !expect(':'))
+						return false;
+				}
+				if (!skipValue(depth + 1) || !nextMember(close, done))
+					return false;
+			}
+			return true;
+		}
+		if (c == 't')
+			return parseLiteral("true");
+		if (c == 'f')
+			return parseLiteral("false");
+		if (c == 'n')
+			return parseLiteral("null");
+		double ignored;
+		return parseNumber(ignored);
+	}
+
+	bool parseObjects()
+	{
+		if (!expect('{'))
+			return false;
+		if (peek() == '}')
+		{
+			m_pos++;
+			return true;
+		}
+		auto &names = m_index->names;
+		bool done = false;
+		while (!done)
+		{
+			AssetRecord record;
+			record.nameOffset = names.size();
+			if (!parseString(names))
+				return false;
+			record.nameLength = names.size() - record.nameOffset;
+			if (!expect(':') || !parseObject(record))
+				return false;
+			m_index->records.append(record);
+			if (!nextMember('}', done))
+				return false;
+		}
+		return true;
+	}
+
+	bool parseObject(AssetRecord &record)
+	{
+		record.size = 0;
+		bool haveHash = false;
+		if (!expect('{'))
+			return false;
+		if (peek() == '}')
+		{
+			m_pos++;
+			return fail("asset object without a hash");
+		}
+		bool done = false;
+		while (!done)
+		{
+			QByteArray key;
+			if (!parseString(key) || !expect(':'))
+				return false;
+			if (key == "hash")
+			{
+				QByteArray hex;
+				if (!parseString(hex))
+					return false;
+				auto raw = QByteArray::fromHex(hex);
+				if (hex.size() != 40 || raw.size() != 20)
+					return fail("invalid asset object hash " + QString::fromLatin1(hex));
+				memcpy(record.sha1, raw.constData(), 20);
+				haveHash = true;
+			}
+			else if (key == "size")
+			{
+				double size;
+				if (!parseNumber(size))
+					return false;
+				record.size = size;
+			}
+			else if (!skipValue(0))
+			{
+				return false;
+			}
+			if (!nextMember('}', done))
+				return false;
+		}
+		if (!haveHash)
+			return fail("asset object without a hash");
+		return true;
+	}
+
+	const char *m_pos;
+	const char *m_end;
+	AssetsIndex *m_index;
+	QString m_error;
+};
+}
 
 namespace AssetsUtils
 {
@@ -58,10 +433,41 @@ int findLegacyAssets()
 	return found;
 }
 
-/*
- * Returns true on success, with index populated
- * index is undefined otherwise
- */
+QString objectPath(const QString &hash)
+{
+	return "assets/objects/" + hash.left(2) + "/" + hash;
+}
+
+AssetObjectCheck checkObject(const AssetObject &object)
+{
+	AssetObjectCheck check;
+	check.object = object;
+
+	QFile file(objectPath(object.hash));
+	if (file.size() != object.size || !file.open(QIODevice::ReadOnly))
+	{
+		return check;
+	}
+	QCryptographicHash sha1(QCryptographicHash::Sha1);
+	if (!sha1.addData(&file))
+	{
+		return check;
+	}
+	check.valid = sha1.result().toHex() == object.hash.toLatin1();
+	return check;
+}
+
+bool parseAssetsIndexJson(const QByteArray &data, AssetsIndex *index, QString *error)
+{
+	*index = AssetsIndex();
+	IndexParser parser(data, index);
+	if (parser.parse())
+		return true;
+	if (error)
+		*error = parser.error();
+	return false;
+}
+
 bool loadAssetsIndexJson(QString path, AssetsIndex *index)
 {
 	/*
@@ -91,64 +497,23 @@ bool loadAssetsIndexJson(QString path, AssetsIndex *index)
 	QByteArray jsonData = file.readAll();
 	file.close();
 
-	QJsonParseError parseError;
-	QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
-
-	// Fail if the JSON is invalid.
-	if (parseError.error != QJsonParseError::NoError)
+	// hashing is a lot cheaper than parsing, and the index rarely changes between launches
+	auto key = QCryptographicHash::hash(jsonData, QCryptographicHash::Md5);
+	auto &cache = indexCache();
+	if (cache.get(key, *index))
 	{
-		QLOG_ERROR() << "Failed to parse assets index file:" << parseError.errorString()
-					 << "at offset " << QString::number(parseError.offset);
-		return false;
+		return true;
 	}
 
-	// Make sure the root is an object.
-	if (!jsonDoc.isObject())
+	AssetsIndex parsed;
+	QString error;
+	if (!parseAssetsIndexJson(jsonData, &parsed, &error))
 	{
-		QLOG_ERROR() << "Invalid assets index JSON: Root should be an array.";
+		QLOG_ERROR() << "Failed to parse assets index file" << path << ":" << error;
 		return false;
 	}
-
-	QJsonObject root = jsonDoc.object();
-
-	QJsonValue isVirtual = root.value("virtual");
-	if (!isVirtual.isUndefined())
-	{
-		index->isVirtual = isVirtual.toBool(false);
-	}
-
-	QJsonValue objects = root.value("objects");
-	QVariantMap map = objects.toVariant().toMap();
-
-	for (QVariantMap::const_iterator iter = map.begin(); iter != map.end(); ++iter)
-	{
-		// QLOG_DEBUG() << iter.key();
-
-		QVariant variant = iter.value();
-		QVariantMap nested_objects = variant.toMap();
-
-		AssetObject object;
-
-		for (QVariantMap::const_iterator nested_iter = nested_objects.begin();
-			 nested_iter != nested_objects.end(); ++nested_iter)
-		{
-			// QLOG_DEBUG() << nested_iter.key() << nested_iter.value().toString();
-			QString key = nested_iter.key();
-			QVariant value = nested_iter.value();
-
-			if (key == "hash")
-			{
-				object.hash = value.toString();
-			}
-			else if (key == "size")
-			{
-				object.size = value.toDouble();
-			}
-		}
-
-		index->objects.insert(iter.key(), object);
-	}
-
+	cache.add(key, parsed, parsed.records.size() * sizeof(AssetRecord) + parsed.names.size());
+	*index = parsed;
 	return true;
 }
 }
@@ -16,7 +16,8 @@
 #pragma once
 
 #include <QString>
-#include <QMap>
+#include <QByteArray>
+#include <QVector>
 
 struct AssetObject
 {
@@ -24,14 +25,68 @@ struct AssetObject
 	qint64 size;
 };
 
+/// the outcome of checking an object on disk
+struct AssetObjectCheck
+{
+	AssetObject object;
+	bool valid = false;
+};
+
+/// one object of an assets index, as it is kept in memory
+struct AssetRecord
+{
+	/// where the name starts in the index's name pool, and how long it is (UTF-8)
+	quint32 nameOffset;
+	quint32 nameLength;
+	/// the raw SHA-1, not the hex string
+	quint8 sha1[20];
+	qint64 size;
+};
+
+/*!
+ * A parsed assets index.
+ *
+ * The records are flat and all the names are kept back to back in one buffer. Both are
+ * implicitly shared, so copies of an index are cheap.
+ */
 struct AssetsIndex
 {
-	QMap<QString, AssetObject> objects;
+	QVector<AssetRecord> records;
+	QByteArray names;
 	bool isVirtual = false;
+
+	QString name(const AssetRecord &record) const
+	{
+		return QString::fromUtf8(names.constData() + record.nameOffset, record.nameLength);
+	}
+	AssetObject object(const AssetRecord &record) const
+	{
+		AssetObject object;
+		object.hash = QString::fromLatin1(
+			QByteArray::fromRawData((const char *)record.sha1, sizeof(record.sha1)).toHex());
+		object.size = record.size;
+		return object;
+	}
 };
 
 namespace AssetsUtils
 {
+/*
+ * Parses the index, or takes it from the cache if a file with the same content was parsed
+ * before. Returns true on success, with index populated.
+ */
 bool loadAssetsIndexJson(QString file, AssetsIndex* index);
+
+/// parses the JSON text of an index, without the cache. error says what was wrong with it
+bool parseAssetsIndexJson(const QByteArray &data, AssetsIndex *index, QString *error = nullptr);
 int findLegacyAssets();
+
+/// where the object is kept in the object store
+QString objectPath(const QString &hash);
+
+/*
+ * Checks that the object exists, has the right size and that its SHA-1 matches its name.
+ * Doesn't touch any shared state, so it can run on any thread.
+ */
+AssetObjectCheck checkObject(const AssetObject &object);
 }
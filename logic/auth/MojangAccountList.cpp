@@ -265,7 +265,11 @@ bool MojangAccountList::loadList(const QString &filePath)
 		QLOG_ERROR() << "Can't load Mojang account list. No file path given and no default set.";
 		return false;
 	}
+	return loadDocument(readListFile(path), path);
+}
 
+QJsonDocument MojangAccountList::readListFile(const QString &path)
+{
 	QFile file(path);
 
 	// Try to open the file and fail if we can't.
@@ -273,7 +277,7 @@ bool MojangAccountList::loadList(const QString &filePath)
 	if (!file.open(QIODevice::ReadOnly))
 	{
 		QLOG_ERROR() << QString("Failed to read the account list file (%1).").arg(path).toUtf8();
-		return false;
+		return QJsonDocument();
 	}
 
 	// Read the file and close it.
@@ -289,6 +293,16 @@ bool MojangAccountList::loadList(const QString &filePath)
 		QLOG_ERROR() << QString("Failed to parse account list file: %1 at offset %2")
 							.arg(parseError.errorString(), QString::number(parseError.offset))
 							.toUtf8();
+		return QJsonDocument();
+	}
+	return jsonDoc;
+}
+
+bool MojangAccountList::loadDocument(const QJsonDocument &jsonDoc, const QString &path)
+{
+	// read or parsing failed, that was logged already
+	if (jsonDoc.isNull())
+	{
 		return false;
 	}
 
@@ -309,7 +323,7 @@ bool MojangAccountList::loadList(const QString &filePath)
 					<< newName;
 
 		// Attempt to rename the old version.
-		file.rename(newName);
+		QFile::rename(path, newName);
 		return false;
 	}
 
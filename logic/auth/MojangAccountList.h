@@ -19,6 +19,7 @@
 #include <QVariant>
 #include <QAbstractListModel>
 #include <QSharedPointer>
+#include <QJsonDocument>
 
 #include "logic/auth/MojangAccount.h"
 
@@ -106,6 +107,20 @@ public:
 	 */
 	virtual bool loadList(const QString &file = "");
 
+	/*!
+	 * \brief Reads and parses an account list file, without loading it.
+	 * Safe to call from any thread, so the file can be read while other things happen.
+	 * \return The document, or a null document if the file can't be read or parsed.
+	 */
+	static QJsonDocument readListFile(const QString &file);
+
+	/*!
+	 * \brief Loads the account list from a document read by readListFile().
+	 * \param file The file the document was read from, renamed if its format is too old.
+	 * \return True if successful, otherwise false.
+	 */
+	virtual bool loadDocument(const QJsonDocument &document, const QString &file);
+
 	/*!
 	 * \brief Saves the account list to the given file.
 	 * If the given file is an empty string (default), will save from the default account list file.
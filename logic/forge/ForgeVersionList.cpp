@@ -22,6 +22,9 @@
 #include <QtNetwork>
 #include <QtXml>
 #include <QRegExp>
+#include <QSaveFile>
+#include <QtConcurrentRun>
+#include <pathutils.h>
 
 #include "logger/QsLog.h"
 
@@ -155,6 +158,7 @@ void ForgeVersionList::sort()
 ForgeListLoadTask::ForgeListLoadTask(ForgeVersionList *vlist) : Task()
 {
 	m_list = vlist;
+	connect(&parseWatcher, SIGNAL(finished()), SLOT(listParsed()));
 }
 
 void ForgeListLoadTask::executeTask()
@@ -162,17 +166,17 @@ void ForgeListLoadTask::executeTask()
 	setStatus(tr("Fetching Forge version lists..."));
 	auto job = new NetJob("Version index");
 	// we do not care if the version is stale or not.
-	auto forgeListEntry = MMC->metacache()->resolveEntry("minecraftforge", "list.json");
-	auto gradleForgeListEntry = MMC->metacache()->resolveEntry("minecraftforge", "json");
+	listEntry = MMC->metacache()->resolveEntry("minecraftforge", "list.json");
+	gradleListEntry = MMC->metacache()->resolveEntry("minecraftforge", "json");
 
 	// verify by poking the server.
-	forgeListEntry->stale = true;
-	gradleForgeListEntry->stale = true;
+	listEntry->stale = true;
+	gradleListEntry->stale = true;
 
 	job->addNetAction(listDownload = CacheDownload::make(QUrl(URLConstants::FORGE_LEGACY_URL),
-														 forgeListEntry));
+														 listEntry));
 	job->addNetAction(gradleListDownload = CacheDownload::make(
-						  QUrl(URLConstants::FORGE_GRADLE_URL), gradleForgeListEntry));
+						  QUrl(URLConstants::FORGE_GRADLE_URL), gradleListEntry));
 
 	connect(listDownload.get(), SIGNAL(failed(int)), SLOT(listFailed()));
 	connect(gradleListDownload.get(), SIGNAL(failed(int)), SLOT(gradleListFailed()));
@@ -183,33 +187,21 @@ void ForgeListLoadTask::executeTask()
 	listJob->start();
 }
 
-bool ForgeListLoadTask::parseForgeList(QList<BaseVersionPtr> &out)
+bool ForgeListLoadTask::parseForgeList(const QByteArray &data, QList<BaseVersionPtr> &out,
+									   QString &error)
 {
-	QByteArray data;
-	{
-		auto dlJob = listDownload;
-		auto filename = std::dynamic_pointer_cast<CacheDownload>(dlJob)->getTargetFilepath();
-		QFile listFile(filename);
-		if (!listFile.open(QIODevice::ReadOnly))
-		{
-			return false;
-		}
-		data = listFile.readAll();
-		dlJob.reset();
-	}
-
 	QJsonParseError jsonError;
 	QJsonDocument jsonDoc = QJsonDocument::fromJson(data, &jsonError);
 
 	if (jsonError.error != QJsonParseError::NoError)
 	{
-		emitFailed("Error parsing version list JSON:" + jsonError.errorString());
+		error = "Error parsing version list JSON:" + jsonError.errorString();
 		return false;
 	}
 
 	if (!jsonDoc.isObject())
 	{
-		emitFailed("Error parsing version list JSON: JSON root is not an object");
+		error = "Error parsing version list JSON: JSON root is not an object";
 		return false;
 	}
 
@@ -218,8 +210,7 @@ bool ForgeListLoadTask::parseForgeList(QList<BaseVersionPtr> &out)
 	// Now, get the array of versions.
 	if (!root.value("builds").isArray())
 	{
-		emitFailed(
-			"Error parsing version list JSON: version list object is missing 'builds' array");
+		error = "Error parsing version list JSON: version list object is missing 'builds' array";
 		return false;
 	}
 	QJsonArray builds = root.value("builds").toArray();
@@ -294,33 +285,21 @@ bool ForgeListLoadTask::parseForgeList(QList<BaseVersionPtr> &out)
 	return true;
 }
 
-bool ForgeListLoadTask::parseForgeGradleList(QList<BaseVersionPtr> &out)
+bool ForgeListLoadTask::parseForgeGradleList(const QByteArray &data, QList<BaseVersionPtr> &out,
+											 QString &error)
 {
-	QByteArray data;
-	{
-		auto dlJob = gradleListDownload;
-		auto filename = std::dynamic_pointer_cast<CacheDownload>(dlJob)->getTargetFilepath();
-		QFile listFile(filename);
-		if (!listFile.open(QIODevice::ReadOnly))
-		{
-			return false;
-		}
-		data = listFile.readAll();
-		dlJob.reset();
-	}
-
 	QJsonParseError jsonError;
 	QJsonDocument jsonDoc = QJsonDocument::fromJson(data, &jsonError);
 
 	if (jsonError.error != QJsonParseError::NoError)
 	{
-		emitFailed("Error parsing gradle version list JSON:" + jsonError.errorString());
+		error = "Error parsing gradle version list JSON:" + jsonError.errorString();
 		return false;
 	}
 
 	if (!jsonDoc.isObject())
 	{
-		emitFailed("Error parsing gradle version list JSON: JSON root is not an object");
+		error = "Error parsing gradle version list JSON: JSON root is not an object";
 		return false;
 	}
 
@@ -336,10 +315,6 @@ bool ForgeListLoadTask::parseForgeGradleList(QList<BaseVersionPtr> &out)
 		QJsonObject number = it.value().toObject();
 		std::shared_ptr<ForgeVersion> fVersion(new ForgeVersion());
 		fVersion->m_buildnr = number.value("build").toDouble();
-		if(fVersion->m_buildnr >= 953 && fVersion->m_buildnr <= 965)
-		{
-			QLOG_DEBUG() << fVersion->m_buildnr;
-		}
 		fVersion->jobbuildver = number.value("version").toString();
 		fVersion->branch = number.value("branch").toString("");
 		fVersion->mcver = number.value("mcversion").toString();
@@ -406,30 +381,140 @@ bool ForgeListLoadTask::parseForgeGradleList(QList<BaseVersionPtr> &out)
 	return true;
 }
 
-void ForgeListLoadTask::listDownloaded()
+bool ForgeListLoadTask::loadSnapshot(QString path, QString sourceHash,
+									 QList<BaseVersionPtr> &out)
 {
-	QList<BaseVersionPtr> list;
-	bool ret = true;
-	if (!parseForgeList(list))
+	QFile snapshot(path);
+	if (!snapshot.open(QIODevice::ReadOnly))
 	{
-		ret = false;
+		return false;
 	}
-	if (!parseForgeGradleList(list))
+	QJsonDocument doc = QJsonDocument::fromBinaryData(snapshot.readAll());
+	QJsonObject root = doc.object();
+	if (root.value("source").toString() != sourceHash)
 	{
-		ret = false;
+		return false;
 	}
+	for (auto value : root.value("versions").toArray())
+	{
+		QJsonObject obj = value.toObject();
+		std::shared_ptr<ForgeVersion> fVersion(new ForgeVersion());
+		fVersion->type = obj.value("gradle").toBool() ? ForgeVersion::Gradle : ForgeVersion::Legacy;
+		fVersion->m_buildnr = obj.value("build").toDouble();
+		fVersion->branch = obj.value("branch").toString();
+		fVersion->universal_url = obj.value("universal_url").toString();
+		fVersion->changelog_url = obj.value("changelog_url").toString();
+		fVersion->installer_url = obj.value("installer_url").toString();
+		fVersion->jobbuildver = obj.value("jobbuildver").toString();
+		fVersion->mcver = obj.value("mcver").toString();
+		fVersion->mcver_sane = obj.value("mcver_sane").toString();
+		fVersion->universal_filename = obj.value("universal_filename").toString();
+		fVersion->installer_filename = obj.value("installer_filename").toString();
+		out.append(fVersion);
+	}
+	return true;
+}
+
+void ForgeListLoadTask::saveSnapshot(QString path, QString sourceHash,
+									 const QList<BaseVersionPtr> &list)
+{
+	QJsonArray versions;
+	for (auto version : list)
+	{
+		auto fVersion = std::dynamic_pointer_cast<ForgeVersion>(version);
+		QJsonObject obj;
+		obj.insert("gradle", fVersion->type == ForgeVersion::Gradle);
+		obj.insert("build", fVersion->m_buildnr);
+		obj.insert("branch", fVersion->branch);
+		obj.insert("universal_url", fVersion->universal_url);
+		obj.insert("changelog_url", fVersion->changelog_url);
+		obj.insert("installer_url", fVersion->installer_url);
+		obj.insert("jobbuildver", fVersion->jobbuildver);
+		obj.insert("mcver", fVersion->mcver);
+		obj.insert("mcver_sane", fVersion->mcver_sane);
+		obj.insert("universal_filename", fVersion->universal_filename);
+		obj.insert("installer_filename", fVersion->installer_filename);
+		versions.append(obj);
+	}
+	QJsonObject root;
+	root.insert("source", sourceHash);
+	root.insert("versions", versions);
 
-	if (!ret)
+	QSaveFile snapshot(path);
+	if (!snapshot.open(QIODevice::WriteOnly))
 	{
 		return;
 	}
-	std::sort(list.begin(), list.end(), [](const BaseVersionPtr & l, const BaseVersionPtr & r)
+	QByteArray data = QJsonDocument(root).toBinaryData();
+	if (snapshot.write(data) == data.size())
+	{
+		snapshot.commit();
+	}
+}
+
+ForgeListLoadTask::ParseResult ForgeListLoadTask::parseLists(QString listPath,
+															 QString gradleListPath,
+															 QString snapshotPath,
+															 QString sourceHash)
+{
+	ParseResult result;
+	if (loadSnapshot(snapshotPath, sourceHash, result.versions))
+	{
+		QLOG_INFO() << "Loaded" << result.versions.size() << "Forge versions from the snapshot";
+		return result;
+	}
+	result.versions.clear();
+
+	QFile listFile(listPath);
+	QFile gradleListFile(gradleListPath);
+	if (!listFile.open(QIODevice::ReadOnly) || !gradleListFile.open(QIODevice::ReadOnly))
+	{
+		result.error = "Failed to open the Forge version lists.";
+		return result;
+	}
+	if (!parseForgeList(listFile.readAll(), result.versions, result.error) ||
+		!parseForgeGradleList(gradleListFile.readAll(), result.versions, result.error))
+	{
+		return result;
+	}
+
+	std::sort(result.versions.begin(), result.versions.end(),
+			  [](const BaseVersionPtr & l, const BaseVersionPtr & r)
 	{ return (*l > *r); });
 
-	m_list->updateListData(list);
+	saveSnapshot(snapshotPath, sourceHash, result.versions);
+	return result;
+}
 
+void ForgeListLoadTask::listDownloaded()
+{
+	m_sourceHash = listEntry->md5sum + ":" + gradleListEntry->md5sum;
+	if (m_list->isLoaded() && m_list->m_sourceHash == m_sourceHash)
+	{
+		QLOG_INFO() << "Forge version lists didn't change.";
+		emitSucceeded();
+		return;
+	}
+
+	setStatus(tr("Reading Forge version lists..."));
+	QString snapshotPath =
+		PathCombine(MMC->metacache()->getBasePath("minecraftforge"), "versions.dat");
+	parseWatcher.setFuture(QtConcurrent::run(
+		&ForgeListLoadTask::parseLists, listDownload->getTargetFilepath(),
+		gradleListDownload->getTargetFilepath(), snapshotPath, m_sourceHash));
+}
+
+void ForgeListLoadTask::listParsed()
+{
+	auto result = parseWatcher.result();
+	if (!result.error.isEmpty())
+	{
+		emitFailed(result.error);
+		return;
+	}
+	m_list->updateListData(result.versions);
+	m_list->m_sourceHash = m_sourceHash;
 	emitSucceeded();
-	return;
 }
 
 void ForgeListLoadTask::listFailed()
@@ -19,6 +19,7 @@
 #include <QAbstractListModel>
 #include <QUrl>
 #include <QNetworkReply>
+#include <QFutureWatcher>
 
 #include "logic/BaseVersionList.h"
 #include "logic/tasks/Task.h"
@@ -51,6 +52,8 @@ protected:
 	QList<BaseVersionPtr> m_vlist;
 
 	bool m_loaded = false;
+	/// MD5s of the downloaded lists m_vlist was read from
+	QString m_sourceHash;
 
 protected
 slots:
@@ -66,9 +69,17 @@ public:
 
 	virtual void executeTask();
 
+	/// what the worker thread made of the lists
+	struct ParseResult
+	{
+		QList<BaseVersionPtr> versions;
+		QString error;
+	};
+
 protected
 slots:
 	void listDownloaded();
+	void listParsed();
 	void listFailed();
 	void gradleListFailed();
 
@@ -76,10 +87,24 @@ protected:
 	NetJobPtr listJob;
 	ForgeVersionList *m_list;
 
+	MetaEntryPtr listEntry;
+	MetaEntryPtr gradleListEntry;
 	CacheDownloadPtr listDownload;
 	CacheDownloadPtr gradleListDownload;
+	QFutureWatcher<ParseResult> parseWatcher;
+	QString m_sourceHash;
 
 private:
-	bool parseForgeList(QList<BaseVersionPtr> &out);
-	bool parseForgeGradleList(QList<BaseVersionPtr> &out);
+	/*
+	 * Runs on a worker thread. Reads the snapshot if it was made from the same lists,
+	 * otherwise parses the lists and makes a new snapshot.
+	 */
+	static ParseResult parseLists(QString listPath, QString gradleListPath,
+								  QString snapshotPath, QString sourceHash);
+	static bool parseForgeList(const QByteArray &data, QList<BaseVersionPtr> &out,
+							   QString &error);
+	static bool parseForgeGradleList(const QByteArray &data, QList<BaseVersionPtr> &out,
+									 QString &error);
+	static bool loadSnapshot(QString path, QString sourceHash, QList<BaseVersionPtr> &out);
+	static void saveSnapshot(QString path, QString sourceHash, const QList<BaseVersionPtr> &list);
 };
@@ -23,6 +23,19 @@
 #include <QDir>
 #include "logger/QsLog.h"
 
+#include "unpack200.h"
+
+/// shared, so every Forge library unpacks in the memory the one before it used
+static unpack200::Context &unpackContext()
+{
+	static unpack200::Context context;
+	// a broken pack fails instead of taking all the memory there is
+	context.setMemoryLimit(size_t(1) << 30);
+	return context;
+}
+/// downloads with a request out, the memory of the unpacker is kept only while there are some
+static int runningDownloads = 0;
+
 ForgeXzDownload::ForgeXzDownload(QString relative_path, MetaEntryPtr entry) : NetAction()
 {
 	m_entry = entry;
@@ -45,6 +58,7 @@ void ForgeXzDownload::start()
 	if (!m_entry->stale)
 	{
 		m_status = Job_Finished;
+		m_cacheHit = true;
 		emit succeeded(m_index_within_job);
 		return;
 	}
@@ -69,6 +83,7 @@ void ForgeXzDownload::start()
 
 	auto worker = MMC->qnam();
 	QNetworkReply *rep = worker->get(request);
+	runningDownloads++;
 
 	m_reply = std::shared_ptr<QNetworkReply>(rep);
 	connect(rep, SIGNAL(downloadProgress(qint64, qint64)),
@@ -118,6 +133,16 @@ void ForgeXzDownload::updateUrl()
 }
 
 void ForgeXzDownload::downloadFinished()
+{
+	finishDownload();
+	// a failed download may have been started again already
+	if (--runningDownloads == 0)
+	{
+		unpackContext().releaseMemory();
+	}
+}
+
+void ForgeXzDownload::finishDownload()
 {
 	//TEST: defer to other possible mirrors (autofail the first one)
 	/*
@@ -186,7 +211,7 @@ void ForgeXzDownload::downloadReadyRead()
 }
 
 #include "xz.h"
-#include "unpack200.h"
+#include <QBuffer>
 #include <stdexcept>
 
 const size_t buffer_size = 8196;
@@ -195,9 +220,8 @@ void ForgeXzDownload::decompressAndInstall()
 {
 	// rewind the downloaded temp file
 	m_pack200_xz_file.seek(0);
-	// de-xz'd file
-	QTemporaryFile pack200_file("./dl_temp.XXXXXX");
-	pack200_file.open();
+	// de-xz'd pack, the unpacker reads it from memory
+	QByteArray pack200;
 
 	bool xz_success = false;
 	// first, de-xz
@@ -234,14 +258,7 @@ void ForgeXzDownload::decompressAndInstall()
 
 			if (b.out_pos == sizeof(out))
 			{
-				if (pack200_file.write((char *)out, b.out_pos) != b.out_pos)
-				{
-					// msg = "Write error\n";
-					xz_dec_end(s);
-					failAndTryNextMirror();
-					return;
-				}
-
+				pack200.append((char *)out, b.out_pos);
 				b.out_pos = 0;
 			}
 
@@ -254,13 +271,7 @@ void ForgeXzDownload::decompressAndInstall()
 				continue;
 			}
 
-			if (pack200_file.write((char *)out, b.out_pos) != b.out_pos)
-			{
-				// write error
-				pack200_file.close();
-				xz_dec_end(s);
-				return;
-			}
+			pack200.append((char *)out, b.out_pos);
 
 			switch (ret)
 			{
@@ -310,72 +321,37 @@ void ForgeXzDownload::decompressAndInstall()
 	}
 	m_pack200_xz_file.remove();
 
-	// revert pack200
-	pack200_file.seek(0);
-	int handle_in = pack200_file.handle();
-	// FIXME: dispose of file handles, pointers and the like. Ideally wrap in objects.
-	if(handle_in == -1)
-	{
-		QLOG_ERROR() << "Error reopening " << pack200_file.fileName();
-		failAndTryNextMirror();
-		return;
-	}
-	FILE * file_in = fdopen(handle_in,"r");
-	if(!file_in)
-	{
-		QLOG_ERROR() << "Error reopening " << pack200_file.fileName();
-		failAndTryNextMirror();
-		return;
-	}
-	QFile qfile_out(m_target_path);
-	if(!qfile_out.open(QIODevice::WriteOnly))
+	// revert pack200, from memory into memory
+	QByteArray jar;
 	{
-		QLOG_ERROR() << "Error opening " << qfile_out.fileName();
-		failAndTryNextMirror();
-		return;
-	}
-	int handle_out = qfile_out.handle();
-	if(handle_out == -1)
-	{
-		QLOG_ERROR() << "Error opening " << qfile_out.fileName();
-		failAndTryNextMirror();
-		return;
-	}
-	FILE * file_out = fdopen(handle_out,"w");
-	if(!file_out)
-	{
-		QLOG_ERROR() << "Error opening " << qfile_out.fileName();
-		failAndTryNextMirror();
-		return;
-	}
-	try
-	{
-		unpack_200(file_in, file_out);
-	}
-	catch (std::runtime_error &err)
-	{
-		m_status = Job_Failed;
-		QLOG_ERROR() << "Error unpacking " << pack200_file.fileName() << " : " << err.what();
-		QFile f(m_target_path);
-		if (f.exists())
-			f.remove();
-		failAndTryNextMirror();
-		return;
+		QBuffer jar_buffer(&jar);
+		jar_buffer.open(QIODevice::WriteOnly);
+		unpack200::MemoryInput in(pack200.constData(), pack200.size());
+		unpack200::QIODeviceOutput out(&jar_buffer);
+		try
+		{
+			unpackContext().unpack(in, out);
+		}
+		catch (std::runtime_error &err)
+		{
+			m_status = Job_Failed;
+			QLOG_ERROR() << "Error unpacking " << m_target_path << " : " << err.what();
+			failAndTryNextMirror();
+			return;
+		}
 	}
-	pack200_file.remove();
+	pack200.clear();
 
 	QFile jar_file(m_target_path);
-
-	if (!jar_file.open(QIODevice::ReadOnly))
+	if (!jar_file.open(QIODevice::WriteOnly) || jar_file.write(jar) != jar.size())
 	{
+		QLOG_ERROR() << "Error writing " << jar_file.fileName();
 		jar_file.remove();
 		failAndTryNextMirror();
 		return;
 	}
-	m_entry->md5sum = QCryptographicHash::hash(jar_file.readAll(), QCryptographicHash::Md5)
-						  .toHex()
-						  .constData();
 	jar_file.close();
+	m_entry->md5sum = QCryptographicHash::hash(jar, QCryptographicHash::Md5).toHex().constData();
 
 	QFileInfo output_file_info(m_target_path);
 	m_entry->etag = m_reply->rawHeader("ETag").constData();
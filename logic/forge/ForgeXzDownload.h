@@ -60,6 +60,7 @@ slots:
 	virtual void start();
 
 private:
+	void finishDownload();
 	void decompressAndInstall();
 	void failAndTryNextMirror();
 	void updateUrl();
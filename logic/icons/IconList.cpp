@@ -21,12 +21,14 @@
 #include <QMimeData>
 #include <QUrl>
 #include <QFileSystemWatcher>
+#include <QImageReader>
 #include <MultiMC.h>
 #include <logic/settings/Setting.h>
 
 #define MAX_SIZE 1024
 
-IconList::IconList(QObject *parent) : QAbstractListModel(parent)
+IconList::IconList(const QHash<QString, QImage> &images, QObject *parent)
+	: QAbstractListModel(parent), m_preloaded(images)
 {
 	// add builtin icons
 	QDir instance_icons(":/icons/instances/");
@@ -48,6 +50,26 @@ IconList::IconList(QObject *parent) : QAbstractListModel(parent)
 	connect(setting.get(), SIGNAL(SettingChanged(const Setting &, QVariant)),
 			SLOT(SettingChanged(const Setting &, QVariant)));
 	directoryChanged(path);
+	m_preloaded.clear();
+}
+
+QHash<QString, QImage> IconList::readIcons(const QString &path)
+{
+	QHash<QString, QImage> images;
+	QDir dir(path);
+	for (auto name : dir.entryList(QDir::Files, QDir::Name))
+	{
+		// the same path directoryChanged() makes
+		QString file = dir.filePath(name);
+		QImageReader reader(file);
+		// icons with several sizes are left to QIcon, which reads all of them
+		if (reader.imageCount() > 1)
+			continue;
+		QImage image = reader.read();
+		if (!image.isNull())
+			images.insert(file, image);
+	}
+	return images;
 }
 
 void IconList::directoryChanged(const QString &path)
@@ -139,6 +161,7 @@ void IconList::fileChanged(const QString &path)
 		return;
 
 	icons[idx].m_images[MMCIcon::FileBased].icon = icon;
+	icons[idx].m_images[MMCIcon::FileBased].changed = QFileInfo(path).lastModified();
 	dataChanged(index(idx), index(idx));
 	emit iconUpdated(key);
 }
@@ -282,7 +305,17 @@ bool IconList::deleteIcon(QString key)
 bool IconList::addIcon(QString key, QString name, QString path, MMCIcon::Type type)
 {
 	// replace the icon even? is the input valid?
-	QIcon icon(path);
+	QIcon icon;
+	auto preloaded = m_preloaded.find(path);
+	if (preloaded != m_preloaded.end())
+	{
+		icon = QIcon(QPixmap::fromImage(*preloaded));
+		m_preloaded.erase(preloaded);
+	}
+	else
+	{
+		icon = QIcon(path);
+	}
 	if (!icon.availableSizes().size())
 		return false;
 	auto iter = name_index.find(key);
@@ -353,6 +386,25 @@ QIcon IconList::getBigIcon(QString key)
 	return QIcon(bigone);
 }
 
+QString IconList::getIconStamp(QString key)
+{
+	int icon_index = getIconIndex(key);
+	if (icon_index == -1)
+		icon_index = getIconIndex("infinity");
+	if (icon_index == -1)
+		return QString();
+
+	auto &icon = icons[icon_index];
+	if (icon.type() == MMCIcon::ToBeDeleted)
+		return QString();
+	auto &image = icon.m_images[icon.type()];
+	return QString("%1:%2:%3:%4")
+		.arg(icon.m_key)
+		.arg(icon.type())
+		.arg(image.filename)
+		.arg(image.changed.toMSecsSinceEpoch());
+}
+
 int IconList::getIconIndex(QString key)
 {
 	if (key == "default")
@@ -19,7 +19,9 @@
 #include <QAbstractListModel>
 #include <QFile>
 #include <QDir>
+#include <QHash>
 #include <QtGui/QIcon>
+#include <QtGui/QImage>
 #include <memory>
 #include "MMCIcon.h"
 #include "logic/settings/Setting.h"
@@ -30,17 +32,28 @@ class IconList : public QAbstractListModel
 {
 	Q_OBJECT
 public:
-	explicit IconList(QObject *parent = 0);
+	/*!
+	 * images are icons of the icons folder that were already read, by their path. Reading the
+	 * images is most of the work of setting up the list, and unlike QIcon, QImage can be made
+	 * on any thread.
+	 */
+	explicit IconList(const QHash<QString, QImage> &images = QHash<QString, QImage>(),
+					  QObject *parent = 0);
 	virtual ~IconList() {};
 
 	QIcon getIcon(QString key);
 	QIcon getBigIcon(QString key);
 	int getIconIndex(QString key);
+	/// identifies the image getIcon(key) returns: where it comes from and when it changed
+	QString getIconStamp(QString key);
 
 	virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
 	virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
 
 	bool addIcon(QString key, QString name, QString path, MMCIcon::Type type);
+
+	/// reads the images of an icons folder for the constructor. safe to use on any thread.
+	static QHash<QString, QImage> readIcons(const QString &path);
 	bool deleteIcon(QString key);
 
 	virtual QStringList mimeTypes() const;
@@ -75,4 +88,6 @@ private:
 	QMap<QString, int> name_index;
 	QVector<MMCIcon> icons;
 	QDir m_dir;
+	/// read before the list was made, used once by addIcon()
+	QHash<QString, QImage> m_preloaded;
 };
@@ -0,0 +1,287 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ClassDataSharing.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "logger/QsLog.h"
+
+namespace
+{
+/// dynamic archives (-XX:ArchiveClassesAtExit) appeared in Java 13
+const int firstDynamicArchiveVersion = 13;
+/// -XX:+AutoCreateSharedArchive appeared in Java 19
+const int firstAutoArchiveVersion = 19;
+
+QString startupKey(ClassDataSharing::Mode mode)
+{
+	return mode == ClassDataSharing::Use ? "with" : "without";
+}
+}
+
+ClassDataSharing::ClassDataSharing(const QString &cacheDir, QObject *parent)
+	: QObject(parent), m_cacheDir(cacheDir)
+{
+}
+
+int ClassDataSharing::majorVersion(const QString &javaVersion)
+{
+	QStringList parts = javaVersion.split('.');
+	// 1.8.0_45 and older put the major version second
+	if (parts.size() > 1 && parts[0] == "1")
+	{
+		parts.removeFirst();
+	}
+	// 17-ea, 11+28
+	QString major = parts.value(0);
+	int digits = 0;
+	while (digits < major.size() && major[digits].isDigit())
+	{
+		digits++;
+	}
+	return major.left(digits).toInt();
+}
+
+QStringList ClassDataSharing::arguments(int majorVersion, Mode mode, const QString &archivePath)
+{
+	if ((mode != Create && mode != Use) || majorVersion < firstDynamicArchiveVersion)
+	{
+		return {};
+	}
+	QStringList args;
+	if (majorVersion >= firstAutoArchiveVersion)
+	{
+		// writes the archive again by itself when it doesn't match anymore
+		args << "-XX:+AutoCreateSharedArchive" << "-XX:SharedArchiveFile=" + archivePath;
+	}
+	else if (mode == Create)
+	{
+		args << "-XX:ArchiveClassesAtExit=" + archivePath;
+	}
+	else
+	{
+		args << "-XX:SharedArchiveFile=" + archivePath;
+	}
+	// a rejected archive means loading classes as usual, without telling the game log why
+	args << "-Xshare:auto" << "-Xlog:cds=off,cds+dynamic=off";
+	return args;
+}
+
+QString ClassDataSharing::javaKey(const QString &javaPath)
+{
+	QString resolved = QDir::isAbsolutePath(javaPath) ? javaPath
+													  : QStandardPaths::findExecutable(javaPath);
+	QFileInfo info(resolved);
+	if (resolved.isEmpty() || !info.exists())
+	{
+		return QString();
+	}
+	return QString("%1:%2:%3")
+		.arg(info.canonicalFilePath())
+		.arg(info.size())
+		.arg(info.lastModified().toUTC().toMSecsSinceEpoch());
+}
+
+void ClassDataSharing::checkJava(const QString &javaPath)
+{
+	m_javaPath = javaPath;
+	m_javaKey = javaKey(javaPath);
+	m_javaVersion.clear();
+	m_javaBits = 0;
+	if (m_javaKey.isEmpty())
+	{
+		return;
+	}
+	QJsonObject manifest = loadManifest();
+	m_javaVersion = manifest.value("javas").toObject().value(m_javaKey).toString();
+	m_javaBits = manifest.value("javaBits").toObject().value(m_javaKey).toInt();
+	if ((!m_javaVersion.isEmpty() && m_javaBits) || m_checker)
+	{
+		return;
+	}
+	m_checker.reset(new JavaChecker());
+	connect(m_checker.get(), SIGNAL(checkFinished(JavaCheckResult)),
+			SLOT(javaChecked(JavaCheckResult)));
+	m_checker->path = javaPath;
+	m_checker->performCheck();
+}
+
+QStringList ClassDataSharing::prepare(const QString &javaPath, const QStringList &classPath)
+{
+	m_mode = Disabled;
+	m_lock.reset();
+	m_key.clear();
+	m_archivePath.clear();
+	if (m_javaKey.isEmpty() || m_javaPath != javaPath)
+	{
+		checkJava(javaPath);
+	}
+	// an unknown version means this launch goes without, the next one will know
+	QString javaVersion = m_javaVersion;
+	if (m_javaKey.isEmpty() || javaVersion.isEmpty())
+	{
+		return {};
+	}
+	int major = majorVersion(javaVersion);
+	if (major < firstDynamicArchiveVersion)
+	{
+		return {};
+	}
+
+	// the JVM rejects an archive when a jar changed, so changed jars get a new one
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(m_javaKey.toUtf8());
+	hash.addData(javaVersion.toUtf8());
+	for (auto entry : classPath)
+	{
+		QFileInfo info(entry);
+		hash.addData(QString("%1:%2:%3\n")
+						 .arg(info.absoluteFilePath())
+						 .arg(info.size())
+						 .arg(info.lastModified().toUTC().toMSecsSinceEpoch())
+						 .toUtf8());
+	}
+	m_key = hash.result().toHex();
+	if (!QDir().mkpath(m_cacheDir))
+	{
+		QLOG_WARN() << "Couldn't create" << m_cacheDir << ", not sharing class data";
+		m_key.clear();
+		return {};
+	}
+	m_archivePath = QDir(m_cacheDir).absoluteFilePath(m_key + ".jsa");
+	m_mode = QFileInfo(m_archivePath).exists() ? Use : Create;
+
+	// newer JVMs write the archive again by themselves whenever it doesn't match
+	if (m_mode == Create || major >= firstAutoArchiveVersion)
+	{
+		m_lock.reset(new QLockFile(m_archivePath + ".lock"));
+		// held for as long as the game runs
+		m_lock->setStaleLockTime(0);
+		if (!m_lock->tryLock(0))
+		{
+			QLOG_INFO() << "Another launch is writing" << m_archivePath;
+			m_lock.reset();
+			m_mode = Busy;
+			return {};
+		}
+	}
+	return arguments(major, m_mode, m_archivePath);
+}
+
+QString ClassDataSharing::recordStartup(qint64 msecs)
+{
+	if (m_mode != Create && m_mode != Use)
+	{
+		return QString();
+	}
+	QJsonObject manifest = loadManifest();
+	QJsonObject archives = manifest.value("archives").toObject();
+	QJsonObject archive = archives.value(m_key).toObject();
+
+	QJsonObject current = archive.value(startupKey(m_mode)).toObject();
+	current.insert("count", current.value("count").toDouble() + 1);
+	current.insert("total", current.value("total").toDouble() + msecs);
+	archive.insert(startupKey(m_mode), current);
+	archives.insert(m_key, archive);
+	manifest.insert("archives", archives);
+	saveManifest(manifest);
+
+	auto average = [&archive](Mode mode) -> QString
+	{
+		QJsonObject startups = archive.value(startupKey(mode)).toObject();
+		int count = startups.value("count").toInt();
+		if (count == 0)
+		{
+			return tr("no launches");
+		}
+		return tr("%1 ms on average over %n launch(es)", "", count)
+			.arg(qint64(startups.value("total").toDouble() / count));
+	};
+	if (m_mode == Use)
+	{
+		return tr("Minecraft started in %1 ms with the shared class archive (%2; without it: %3).")
+			.arg(msecs)
+			.arg(average(Use), average(Create));
+	}
+	return tr("Minecraft started in %1 ms, the shared class archive will be used from the next "
+			  "launch on.").arg(msecs);
+}
+
+void ClassDataSharing::release()
+{
+	m_lock.reset();
+}
+
+bool ClassDataSharing::isGameOutput(const QString &line)
+{
+	// "[12:34:56] [Client thread/INFO]: ..." from log4j in 1.7 and newer
+	static const QRegularExpression logger("^\\[\\d\\d:\\d\\d:\\d\\d\\] \\[[^\\]]+/[A-Z]+\\]");
+	return logger.match(line).hasMatch() || line.contains("Setting user: ") ||
+		   line.startsWith("LWJGL Version: ");
+}
+
+void ClassDataSharing::javaChecked(JavaCheckResult result)
+{
+	// deleted later, this is called from its signal
+	m_checker.reset();
+	if (!result.valid)
+	{
+		return;
+	}
+	QJsonObject manifest = loadManifest();
+	QJsonObject javas = manifest.value("javas").toObject();
+	javas.insert(javaKey(result.path), result.javaVersion);
+	manifest.insert("javas", javas);
+	QJsonObject javaBits = manifest.value("javaBits").toObject();
+	javaBits.insert(javaKey(result.path), result.is_64bit ? 64 : 32);
+	manifest.insert("javaBits", javaBits);
+	saveManifest(manifest);
+}
+
+QString ClassDataSharing::manifestPath() const
+{
+	return QDir(m_cacheDir).absoluteFilePath("cds.json");
+}
+
+QJsonObject ClassDataSharing::loadManifest() const
+{
+	// read again every time, other launches may have changed it
+	QFile file(manifestPath());
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return QJsonObject();
+	}
+	return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+void ClassDataSharing::saveManifest(const QJsonObject &manifest) const
+{
+	QDir().mkpath(m_cacheDir);
+	QSaveFile file(manifestPath());
+	if (!file.open(QIODevice::WriteOnly) ||
+		file.write(QJsonDocument(manifest).toJson()) < 0 || !file.commit())
+	{
+		QLOG_WARN() << "Couldn't save" << manifestPath();
+	}
+}
@@ -0,0 +1,127 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QJsonObject>
+#include <QLockFile>
+#include <QStringList>
+#include <memory>
+
+#include "JavaChecker.h"
+#include "logic/QObjectPtr.h"
+
+/*!
+ * Keeps a class data sharing archive (AppCDS) for each class path and Java version.
+ *
+ * The first launch with a class path makes the JVM write the classes it loaded into an
+ * archive when it exits. Later launches with the same class path and Java map the archive
+ * instead of loading and verifying those classes again.
+ *
+ * This needs Java 13 or newer. For older or unknown versions no arguments are added, and the
+ * version of an unknown Java is checked in the background, so the next launch knows it.
+ * The JVM itself ignores an archive it can't use.
+ *
+ * The archives and what is known about them live in one directory, see manifestPath(). So do
+ * the version and architecture of every Java that was checked, which the heap sizing uses too.
+ * A launch that makes the JVM write an archive holds a lock on it until the game exits, so
+ * concurrent launches of the same class path don't write the same file.
+ */
+class ClassDataSharing : public QObject
+{
+	Q_OBJECT
+public:
+	enum Mode
+	{
+		/// no archive is used or written
+		Disabled,
+		/// the JVM writes the archive when it exits
+		Create,
+		/// the JVM maps the existing archive
+		Use,
+		/// another launch is writing the archive, none is used or written
+		Busy
+	};
+
+	explicit ClassDataSharing(const QString &cacheDir, QObject *parent = 0);
+
+	/*!
+	 * Looks up what is known about the Java at javaPath. If its version or architecture isn't
+	 * known, it is checked in the background, for the next launch.
+	 */
+	void checkJava(const QString &javaPath);
+	/// 32 or 64 for the Java of the last checkJava(), 0 if it isn't known yet
+	int javaBits() const
+	{
+		return m_javaBits;
+	}
+
+	/*!
+	 * Decides what to do for a launch of javaPath with the given class path, in order.
+	 * Returns the arguments for the JVM, empty when sharing isn't possible.
+	 */
+	QStringList prepare(const QString &javaPath, const QStringList &classPath);
+
+	Mode mode() const
+	{
+		return m_mode;
+	}
+	QString archivePath() const
+	{
+		return m_archivePath;
+	}
+
+	/*!
+	 * Records how long the game took from launch until it started, and returns a line
+	 * comparing it to the startups of the same class path with or without the archive.
+	 */
+	QString recordStartup(qint64 msecs);
+
+	/// the game exited, other launches may write the archive again
+	void release();
+
+	/*!
+	 * True for a line of output the game itself writes once it runs: its logger, or LWJGL and
+	 * the user being set up by older versions. What the launcher prints before doesn't count.
+	 */
+	static bool isGameOutput(const QString &line);
+
+	/// 8 for "1.8.0_45", 17 for "17.0.2", 0 if it can't be parsed
+	static int majorVersion(const QString &javaVersion);
+	/// the JVM arguments for a Java major version, in the given mode
+	static QStringList arguments(int majorVersion, Mode mode, const QString &archivePath);
+
+private
+slots:
+	void javaChecked(JavaCheckResult result);
+
+private:
+	QString manifestPath() const;
+	QJsonObject loadManifest() const;
+	void saveManifest(const QJsonObject &manifest) const;
+	static QString javaKey(const QString &javaPath);
+
+	QString m_cacheDir;
+	Mode m_mode = Disabled;
+	QString m_key;
+	QString m_archivePath;
+	QString m_javaPath;
+	QString m_javaKey;
+	QString m_javaVersion;
+	int m_javaBits = 0;
+	QObjectPtr<JavaChecker> m_checker;
+	std::shared_ptr<QLockFile> m_lock;
+};
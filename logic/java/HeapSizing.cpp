@@ -0,0 +1,194 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HeapSizing.h"
+
+#include <QFile>
+#include <QObject>
+
+namespace
+{
+/// what vanilla Minecraft is comfortable with
+const qint64 baseMb = 1024;
+/// mods mostly add blocks, items and their textures
+const qint64 perModMb = 24;
+/// loaded sounds and textures, only part of the assets is in memory at a time
+const qint64 assetsDivisor = 8;
+const qint64 assetsCapMb = 512;
+/// bigger heaps only make the collector's work longer
+const qint64 ceilingMb = 8192;
+/// the most a 32-bit JVM can reliably reserve in one piece, on Windows in particular
+const qint64 ceiling32BitMb = 1024;
+const qint64 floorMb = 512;
+/// left to the system and other programs, at least this or an eighth of the memory
+const qint64 minimumReserveMb = 1024;
+/// kept free of what is available right now
+const qint64 availableMarginMb = 256;
+/// from here on, a collector made for big heaps pays off
+const qint64 g1FromMb = 2048;
+/// heap sizes are rounded down to this
+const qint64 granularityMb = 64;
+
+qint64 roundDown(qint64 mb)
+{
+	return mb / granularityMb * granularityMb;
+}
+}
+
+namespace HeapSizing
+{
+MemoryInfo parseMeminfo(const QByteArray &meminfo)
+{
+	MemoryInfo info;
+	for (auto line : meminfo.split('\n'))
+	{
+		// "MemTotal:       16314428 kB"
+		int colon = line.indexOf(':');
+		if (colon < 0)
+			continue;
+		QByteArray key = line.left(colon);
+		QList<QByteArray> value = line.mid(colon + 1).simplified().split(' ');
+		bool ok = false;
+		qint64 amount = value.value(0).toLongLong(&ok);
+		if (!ok)
+			continue;
+		if (value.value(1) == "kB")
+			amount /= 1024;
+		if (key == "MemTotal")
+			info.totalMb = amount;
+		else if (key == "MemAvailable")
+			info.availableMb = amount;
+	}
+	return info;
+}
+
+MemoryInfo systemMemory()
+{
+	QFile file("/proc/meminfo");
+	if (!file.open(QIODevice::ReadOnly))
+		return MemoryInfo();
+	// a procfs file has no size, read until the end
+	return parseMeminfo(file.readAll());
+}
+
+Choice choose(const Input &input)
+{
+	Choice choice;
+	choice.minMb = input.manualMinMb;
+	choice.maxMb = input.manualMaxMb;
+	if (!input.automatic)
+	{
+		choice.reasons << QObject::tr("Using the memory set in the settings.");
+		return choice;
+	}
+	if (!input.memory.isValid())
+	{
+		choice.reasons << QObject::tr("The memory of this computer is unknown, using the memory "
+									  "set in the settings.");
+		return choice;
+	}
+
+	qint64 wanted = baseMb + perModMb * input.modCount +
+					qMin(assetsCapMb, input.assetsMb / assetsDivisor);
+	choice.reasons << QObject::tr("%1 mods and %2 MiB of assets call for %3 MiB.")
+						  .arg(input.modCount)
+						  .arg(input.assetsMb)
+						  .arg(wanted);
+	if (wanted > ceilingMb)
+	{
+		wanted = ceilingMb;
+		choice.reasons << QObject::tr("More than %1 MiB only makes garbage collection slower.")
+							  .arg(ceilingMb);
+	}
+	if (input.javaBits != 64 && wanted > ceiling32BitMb)
+	{
+		wanted = ceiling32BitMb;
+		if (input.javaBits == 32)
+		{
+			choice.reasons << QObject::tr("A 32-bit Java can't reserve more than about %1 MiB.")
+								  .arg(ceiling32BitMb);
+		}
+		else
+		{
+			choice.reasons << QObject::tr("It isn't known yet whether this Java is 32 or 64-bit, "
+										  "using at most %1 MiB.").arg(ceiling32BitMb);
+		}
+	}
+
+	const qint64 reserve = qMax(minimumReserveMb, input.memory.totalMb / 8);
+	qint64 budget = input.memory.totalMb - reserve - input.otherHeapsMb;
+	QString budgetReason = QObject::tr(
+		"%1 MiB of memory, minus %2 MiB for the system and %3 MiB for other running games, "
+		"leaves %4 MiB.")
+							   .arg(input.memory.totalMb)
+							   .arg(reserve)
+							   .arg(input.otherHeapsMb)
+							   .arg(budget);
+	const qint64 available = input.memory.availableMb - availableMarginMb;
+	if (available < budget)
+	{
+		budget = available;
+		budgetReason = QObject::tr("Only %1 MiB of memory are available right now, %2 MiB of "
+								   "that can be used.")
+						   .arg(input.memory.availableMb)
+						   .arg(budget);
+	}
+	choice.reasons << budgetReason;
+
+	qint64 maxMb = qMin(wanted, budget);
+	if (maxMb < floorMb)
+	{
+		maxMb = floorMb;
+		choice.reasons << QObject::tr("That is too little, using %1 MiB anyway. Close other "
+									  "programs if the game runs out of memory.")
+							  .arg(floorMb);
+	}
+	maxMb = qMax(floorMb, roundDown(maxMb));
+	// start at half, so memory that is never needed isn't taken from others
+	qint64 minMb = qMin(maxMb, qMax(floorMb, roundDown(maxMb / 2)));
+	choice.maxMb = maxMb;
+	choice.minMb = minMb;
+	choice.reasons << QObject::tr("Using a heap of %1 to %2 MiB.").arg(minMb).arg(maxMb);
+
+	if (input.customGc)
+	{
+		choice.reasons << QObject::tr("The JVM arguments choose the garbage collector.");
+	}
+	else if (maxMb >= g1FromMb)
+	{
+		// short pauses instead of the stutter of the default throughput collector
+		choice.gcArguments << "-XX:+UseG1GC"
+						   << "-XX:MaxGCPauseMillis=50"
+						   << "-XX:+DisableExplicitGC";
+		choice.reasons << QObject::tr("Using the G1 garbage collector for a heap this big.");
+	}
+	else
+	{
+		choice.reasons << QObject::tr("Using the default garbage collector for a heap this small.");
+	}
+	return choice;
+}
+
+bool selectsGc(const QStringList &jvmArguments)
+{
+	for (auto arg : jvmArguments)
+	{
+		// -XX:+UseG1GC, -XX:+UseConcMarkSweepGC, ... and the old shorthand for CMS
+		if ((arg.startsWith("-XX:+Use") && arg.endsWith("GC")) || arg == "-Xincgc")
+			return true;
+	}
+	return false;
+}
+}
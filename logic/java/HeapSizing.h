@@ -0,0 +1,80 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QStringList>
+
+/*!
+ * Picks the heap size and garbage collector of a launch.
+ *
+ * choose() is a pure function of what was measured, so it can be tested without a machine
+ * with the right amount of memory. Gathering the input is left to the caller.
+ */
+namespace HeapSizing
+{
+struct MemoryInfo
+{
+	/// in MiB, 0 if unknown
+	qint64 totalMb = 0;
+	qint64 availableMb = 0;
+
+	bool isValid() const
+	{
+		return totalMb > 0 && availableMb > 0;
+	}
+};
+
+/// reads MemTotal and MemAvailable from the contents of /proc/meminfo
+MemoryInfo parseMeminfo(const QByteArray &meminfo);
+/// the memory of this machine, invalid where /proc/meminfo doesn't exist
+MemoryInfo systemMemory();
+
+struct Input
+{
+	/// false to use the manual values as they are
+	bool automatic = false;
+	int manualMinMb = 512;
+	int manualMaxMb = 1024;
+
+	MemoryInfo memory;
+	/// mods the instance loads, from the mod folders
+	int modCount = 0;
+	/// what the assets of the instance's version add up to
+	qint64 assetsMb = 0;
+	/// the maximum heaps of the other games that are running
+	qint64 otherHeapsMb = 0;
+	/// the custom JVM arguments already pick a garbage collector
+	bool customGc = false;
+	/// 32 or 64 for the Java that runs the game. 0 if it wasn't checked yet, sized like 32
+	int javaBits = 64;
+};
+
+struct Choice
+{
+	int minMb = 0;
+	int maxMb = 0;
+	/// garbage collector arguments, empty for the default of the JVM
+	QStringList gcArguments;
+	/// why, one sentence per decision, for the launch log
+	QStringList reasons;
+};
+
+Choice choose(const Input &input);
+
+/// true if the JVM arguments select a garbage collector
+bool selectsGc(const QStringList &jvmArguments);
+}
@@ -29,6 +29,9 @@
 #include <QtAlgorithms>
 
 #include <QtNetwork>
+#include <QSaveFile>
+#include <QtConcurrentRun>
+#include <pathutils.h>
 
 LiteLoaderVersionList::LiteLoaderVersionList(QObject *parent) : BaseVersionList(parent)
 {
@@ -93,6 +96,7 @@ void LiteLoaderVersionList::updateListData(QList<BaseVersionPtr> versions)
 LLListLoadTask::LLListLoadTask(LiteLoaderVersionList *vlist)
 {
 	m_list = vlist;
+	connect(&parseWatcher, SIGNAL(finished()), SLOT(listParsed()));
 }
 
 LLListLoadTask::~LLListLoadTask()
@@ -104,13 +108,13 @@ void LLListLoadTask::executeTask()
 	setStatus(tr("Loading LiteLoader version list..."));
 	auto job = new NetJob("Version index");
 	// we do not care if the version is stale or not.
-	auto liteloaderEntry = MMC->metacache()->resolveEntry("liteloader", "versions.json");
+	listEntry = MMC->metacache()->resolveEntry("liteloader", "versions.json");
 
 	// verify by poking the server.
-	liteloaderEntry->stale = true;
+	listEntry->stale = true;
 
 	job->addNetAction(listDownload = CacheDownload::make(QUrl(URLConstants::LITELOADER_URL),
-														 liteloaderEntry));
+														 listEntry));
 
 	connect(listDownload.get(), SIGNAL(failed(int)), SLOT(listFailed()));
 
@@ -128,19 +132,139 @@ void LLListLoadTask::listFailed()
 
 void LLListLoadTask::listDownloaded()
 {
+	if (m_list->isLoaded() && m_list->m_sourceHash == listEntry->md5sum)
+	{
+		QLOG_INFO() << "LiteLoader version list didn't change.";
+		emitSucceeded();
+		return;
+	}
+
+	QString snapshotPath =
+		PathCombine(MMC->metacache()->getBasePath("liteloader"), "versions.dat");
+	parseWatcher.setFuture(QtConcurrent::run(&LLListLoadTask::parseList,
+											 listDownload->getTargetFilepath(), snapshotPath,
+											 listEntry->md5sum));
+}
+
+void LLListLoadTask::listParsed()
+{
+	auto result = parseWatcher.result();
+	if (!result.error.isEmpty())
+	{
+		emitFailed(result.error);
+		return;
+	}
+	m_list->updateListData(result.versions);
+	m_list->m_sourceHash = listEntry->md5sum;
+	emitSucceeded();
+}
+
+bool LLListLoadTask::loadSnapshot(QString path, QString sourceHash, QList<BaseVersionPtr> &out)
+{
+	QFile snapshot(path);
+	if (!snapshot.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+	QJsonDocument doc = QJsonDocument::fromBinaryData(snapshot.readAll());
+	QJsonObject root = doc.object();
+	if (root.value("source").toString() != sourceHash)
+	{
+		return false;
+	}
+	for (auto value : root.value("versions").toArray())
+	{
+		QJsonObject obj = value.toObject();
+		LiteLoaderVersionPtr version(new LiteLoaderVersion());
+		version->version = obj.value("version").toString();
+		version->file = obj.value("file").toString();
+		version->mcVersion = obj.value("mcVersion").toString();
+		version->md5 = obj.value("md5").toString();
+		version->timestamp = obj.value("timestamp").toDouble();
+		version->isLatest = obj.value("isLatest").toBool();
+		version->tweakClass = obj.value("tweakClass").toString();
+		version->defaultUrl = obj.value("defaultUrl").toString();
+		version->description = obj.value("description").toString();
+		version->authors = obj.value("authors").toString();
+		for (auto lib : obj.value("libraries").toArray())
+		{
+			try
+			{
+				version->libraries.append(RawLibrary::fromJson(lib.toObject(), "versions.dat"));
+			}
+			catch (MMCError &e)
+			{
+				return false;
+			}
+		}
+		out.append(version);
+	}
+	return true;
+}
+
+void LLListLoadTask::saveSnapshot(QString path, QString sourceHash,
+								  const QList<BaseVersionPtr> &list)
+{
+	QJsonArray versions;
+	for (auto item : list)
+	{
+		auto version = std::dynamic_pointer_cast<LiteLoaderVersion>(item);
+		QJsonObject obj;
+		obj.insert("version", version->version);
+		obj.insert("file", version->file);
+		obj.insert("mcVersion", version->mcVersion);
+		obj.insert("md5", version->md5);
+		obj.insert("timestamp", version->timestamp);
+		obj.insert("isLatest", version->isLatest);
+		obj.insert("tweakClass", version->tweakClass);
+		obj.insert("defaultUrl", version->defaultUrl);
+		obj.insert("description", version->description);
+		obj.insert("authors", version->authors);
+		QJsonArray libraries;
+		for (auto lib : version->libraries)
+		{
+			libraries.append(lib->toJson());
+		}
+		obj.insert("libraries", libraries);
+		versions.append(obj);
+	}
+	QJsonObject root;
+	root.insert("source", sourceHash);
+	root.insert("versions", versions);
+
+	QSaveFile snapshot(path);
+	if (!snapshot.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+	QByteArray data = QJsonDocument(root).toBinaryData();
+	if (snapshot.write(data) == data.size())
+	{
+		snapshot.commit();
+	}
+}
+
+LLListLoadTask::ParseResult LLListLoadTask::parseList(QString listPath, QString snapshotPath,
+													  QString sourceHash)
+{
+	ParseResult result;
+	if (loadSnapshot(snapshotPath, sourceHash, result.versions))
+	{
+		QLOG_INFO() << "Loaded" << result.versions.size()
+					<< "LiteLoader versions from the snapshot";
+		return result;
+	}
+	result.versions.clear();
+
 	QByteArray data;
 	{
-		auto dlJob = listDownload;
-		auto filename = std::dynamic_pointer_cast<CacheDownload>(dlJob)->getTargetFilepath();
-		QFile listFile(filename);
+		QFile listFile(listPath);
 		if (!listFile.open(QIODevice::ReadOnly))
 		{
-			emitFailed("Failed to open the LiteLoader version list.");
-			return;
+			result.error = "Failed to open the LiteLoader version list.";
+			return result;
 		}
 		data = listFile.readAll();
-		listFile.close();
-		dlJob.reset();
 	}
 
 	QJsonParseError jsonError;
@@ -148,14 +272,14 @@ void LLListLoadTask::listDownloaded()
 
 	if (jsonError.error != QJsonParseError::NoError)
 	{
-		emitFailed("Error parsing version list JSON:" + jsonError.errorString());
-		return;
+		result.error = "Error parsing version list JSON:" + jsonError.errorString();
+		return result;
 	}
 
 	if (!jsonDoc.isObject())
 	{
-		emitFailed("Error parsing version list JSON: jsonDoc is not an object");
-		return;
+		result.error = "Error parsing version list JSON: jsonDoc is not an object";
+		return result;
 	}
 
 	const QJsonObject root = jsonDoc.object();
@@ -163,8 +287,8 @@ void LLListLoadTask::listDownloaded()
 	// Now, get the array of versions.
 	if (!root.value("versions").isObject())
 	{
-		emitFailed("Error parsing version list JSON: missing 'versions' object");
-		return;
+		result.error = "Error parsing version list JSON: missing 'versions' object";
+		return result;
 	}
 
 	auto meta = root.value("meta").toObject();
@@ -173,7 +297,7 @@ void LLListLoadTask::listDownloaded()
 	QString authors = meta.value("authors").toString("Mumfrey");
 	auto versions = root.value("versions").toObject();
 
-	QList<BaseVersionPtr> tempList;
+	QList<BaseVersionPtr> &tempList = result.versions;
 	for (auto vIt = versions.begin(); vIt != versions.end(); ++vIt)
 	{
 		const QString mcVersion = vIt.key();
@@ -233,7 +357,7 @@ void LLListLoadTask::listDownloaded()
 		}
 		tempList.append(perMcVersionList);
 	}
-	m_list->updateListData(tempList);
 
-	emitSucceeded();
+	saveSnapshot(snapshotPath, sourceHash, tempList);
+	return result;
 }
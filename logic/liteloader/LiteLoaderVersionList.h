@@ -19,6 +19,7 @@
 
 #include <QString>
 #include <QStringList>
+#include <QFutureWatcher>
 #include "logic/BaseVersion.h"
 #include "logic/BaseVersionList.h"
 #include "logic/tasks/Task.h"
@@ -85,6 +86,8 @@ protected:
 	QList<BaseVersionPtr> m_vlist;
 
 	bool m_loaded = false;
+	/// MD5 of the downloaded list m_vlist was read from
+	QString m_sourceHash;
 
 protected
 slots:
@@ -101,15 +104,34 @@ public:
 
 	virtual void executeTask();
 
+	/// what the worker thread made of the list
+	struct ParseResult
+	{
+		QList<BaseVersionPtr> versions;
+		QString error;
+	};
+
 protected
 slots:
 	void listDownloaded();
+	void listParsed();
 	void listFailed();
 
 protected:
 	NetJobPtr listJob;
+	MetaEntryPtr listEntry;
 	CacheDownloadPtr listDownload;
 	LiteLoaderVersionList *m_list;
+	QFutureWatcher<ParseResult> parseWatcher;
+
+private:
+	/*
+	 * Runs on a worker thread. Reads the snapshot if it was made from the same list,
+	 * otherwise parses the list and makes a new snapshot.
+	 */
+	static ParseResult parseList(QString listPath, QString snapshotPath, QString sourceHash);
+	static bool loadSnapshot(QString path, QString sourceHash, QList<BaseVersionPtr> &out);
+	static void saveSnapshot(QString path, QString sourceHash, const QList<BaseVersionPtr> &list);
 };
 
 Q_DECLARE_METATYPE(LiteLoaderVersionPtr)
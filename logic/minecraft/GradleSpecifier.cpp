@@ -0,0 +1,77 @@
+#include "GradleSpecifier.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+
+/// there are only so many libraries, so the pool is never emptied
+static QString intern(const QString &value)
+{
+	static QMutex lock;
+	static QSet<QString> pool;
+	QMutexLocker locker(&lock);
+	auto iter = pool.constFind(value);
+	if (iter != pool.constEnd())
+		return *iter;
+	pool.insert(value);
+	return value;
+}
+
+void GradleSpecifier::parse(const QString &value)
+{
+	m_groupId.clear();
+	m_artifactId.clear();
+	m_version.clear();
+	m_classifier.clear();
+	m_extension = DefaultVariable<QString>("jar");
+	m_nameKey.clear();
+	m_valid = false;
+
+	// one pass to find the separators: two or three ':' and an optional '@' after them
+	int colons[3];
+	int colonCount = 0;
+	int at = -1;
+	for (int i = 0; i < value.size(); i++)
+	{
+		const QChar c = value.at(i);
+		if (c == ':')
+		{
+			if (at != -1 || colonCount == 3)
+				return;
+			colons[colonCount++] = i;
+		}
+		else if (c == '@')
+		{
+			if (at != -1)
+				return;
+			at = i;
+		}
+	}
+	if (colonCount < 2)
+		return;
+	const int end = at == -1 ? value.size() : at;
+	int starts[4] = {0, colons[0] + 1, colons[1] + 1, colonCount == 3 ? colons[2] + 1 : 0};
+	int ends[4] = {colons[0], colons[1], colonCount == 3 ? colons[2] : end, end};
+	const int parts = colonCount + 1;
+	for (int i = 0; i < parts; i++)
+	{
+		if (starts[i] == ends[i])
+			return;
+	}
+	if (at != -1 && at == value.size() - 1)
+		return;
+
+	m_groupId = value.mid(starts[0], ends[0] - starts[0]);
+	m_artifactId = value.mid(starts[1], ends[1] - starts[1]);
+	m_version = value.mid(starts[2], ends[2] - starts[2]);
+	if (parts == 4)
+	{
+		m_classifier = value.mid(starts[3], ends[3] - starts[3]);
+	}
+	if (at != -1)
+	{
+		m_extension = value.mid(at + 1);
+	}
+	m_nameKey = intern(m_groupId + ":" + m_artifactId);
+	m_valid = true;
+}
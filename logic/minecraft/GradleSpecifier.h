@@ -2,6 +2,7 @@
 
 #include <QString>
 #include <QStringList>
+#include <QHash>
 #include "logic/DefaultVariable.h"
 
 struct GradleSpecifier
@@ -18,26 +19,10 @@ struct GradleSpecifier
 	{
 		/*
 		org.gradle.test.classifiers : service : 1.0 : jdk15 @ jar
-		DEBUG   0 "org.gradle.test.classifiers:service:1.0:jdk15@jar" 
-		DEBUG   1 "org.gradle.test.classifiers" 
-		DEBUG   2 "service" 
-		DEBUG   3 "1.0" 
-		DEBUG   4 ":jdk15" 
-		DEBUG   5 "jdk15" 
-		DEBUG   6 "@jar" 
-		DEBUG   7 "jar"
+		group                         artifact  version classifier (optional) extension (optional)
+		None of the parts may be empty or contain ':' or '@'.
 		*/
-		QRegExp matcher("([^:@]+):([^:@]+):([^:@]+)" "(:([^:@]+))?" "(@([^:@]+))?");
-		m_valid = matcher.exactMatch(value);
-		auto elements = matcher.capturedTexts();
-		m_groupId = elements[1];
-		m_artifactId = elements[2];
-		m_version = elements[3];
-		m_classifier = elements[5];
-		if(!elements[7].isEmpty())
-		{
-			m_extension = elements[7];
-		}
+		parse(value);
 		return *this;
 	}
 	operator QString() const
@@ -101,9 +86,15 @@ struct GradleSpecifier
 	{
 		return m_groupId + ":" + m_artifactId;
 	}
+	/// group:artifact, interned, so specifiers naming the same library share the string
+	inline QString nameKey() const
+	{
+		return m_nameKey;
+	}
 	bool matchName(const GradleSpecifier & other) const
 	{
-		return other.artifactId() == artifactId() && other.groupId() == groupId();
+		// interned strings compare by pointer first
+		return other.m_nameKey == m_nameKey;
 	}
 	bool operator==(const GradleSpecifier & other) const
 	{
@@ -120,10 +111,20 @@ struct GradleSpecifier
 		return true;
 	}
 private:
+	void parse(const QString &value);
+
 	QString m_groupId;
 	QString m_artifactId;
 	QString m_version;
 	QString m_classifier;
 	DefaultVariable<QString> m_extension = DefaultVariable<QString>("jar");
+	QString m_nameKey;
 	bool m_valid = false;
 };
+
+inline uint qHash(const GradleSpecifier &spec, uint seed = 0)
+{
+	// same fields as operator==
+	return qHash(spec.nameKey(), seed) ^ qHash(spec.version(), seed + 1) ^
+		   qHash(spec.classifier(), seed + 2) ^ qHash(spec.extension(), seed + 3);
+}
@@ -260,17 +260,19 @@ bool InstanceVersion::removeDeprecatedVersionFiles()
 QList<std::shared_ptr<OneSixLibrary> > InstanceVersion::getActiveNormalLibs()
 {
 	QList<std::shared_ptr<OneSixLibrary> > output;
+	QSet<GradleSpecifier> seen;
 	for (auto lib : libraries)
 	{
 		if (lib->isActive() && !lib->isNative())
 		{
-			for (auto other : output)
+			if (seen.contains(lib->rawName()))
 			{
-				if (other->rawName() == lib->rawName())
-				{
-					QLOG_WARN() << "Multiple libraries with name" << lib->rawName() << "in library list!";
-					continue;
-				}
+				// duplicates are still used, as they always were
+				QLOG_WARN() << "Multiple libraries with name" << lib->rawName() << "in library list!";
+			}
+			else
+			{
+				seen.insert(lib->rawName());
 			}
 			output.append(lib);
 		}
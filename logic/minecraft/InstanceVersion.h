@@ -22,6 +22,7 @@
 #include <memory>
 
 #include "OneSixLibrary.h"
+#include "LibraryTable.h"
 #include "VersionFile.h"
 #include "JarMod.h"
 
@@ -140,7 +141,7 @@ public:
 	QString appletClass;
 	
 	/// the list of libs - both active and inactive, native and java
-	QList<OneSixLibraryPtr> libraries;
+	LibraryTable libraries;
 
 	/// same, but only vanilla.
 	QList<OneSixLibraryPtr> vanillaLibraries;
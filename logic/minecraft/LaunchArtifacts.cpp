@@ -0,0 +1,170 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LaunchArtifacts.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <pathutils.h>
+
+#include "logic/MMCJson.h"
+#include "logger/QsLog.h"
+
+namespace
+{
+/*!
+ * Size and modification time of a file. For a folder, the number of files in the whole tree,
+ * their total size and a hash of every file's path, size and modification time, so a file
+ * deleted or replaced deep inside counts as a change.
+ */
+QString stampOutput(const QString &path)
+{
+	QFileInfo info(path);
+	if (!info.exists())
+	{
+		return QString();
+	}
+	if (!info.isDir())
+	{
+		return QString("%1:%2").arg(info.size()).arg(
+			info.lastModified().toUTC().toMSecsSinceEpoch());
+	}
+	QDir root(path);
+	QStringList lines;
+	qint64 totalSize = 0;
+	QDirIterator iter(path, QDir::Files | QDir::Hidden | QDir::System,
+					  QDirIterator::Subdirectories);
+	while (iter.hasNext())
+	{
+		iter.next();
+		QFileInfo file = iter.fileInfo();
+		totalSize += file.size();
+		lines.append(QString("%1:%2:%3")
+						 .arg(root.relativeFilePath(file.filePath()))
+						 .arg(file.size())
+						 .arg(file.lastModified().toUTC().toMSecsSinceEpoch()));
+	}
+	// the order of the iterator depends on the file system
+	lines.sort();
+	QByteArray hash =
+		QCryptographicHash::hash(lines.join('\n').toUtf8(), QCryptographicHash::Sha1).toHex();
+	return QString("%1:%2:%3").arg(lines.size()).arg(totalSize).arg(QString::fromLatin1(hash));
+}
+}
+
+LaunchArtifacts::LaunchArtifacts(const QString &instanceRoot)
+	: m_path(PathCombine(instanceRoot, "launch-artifacts.json"))
+{
+	if (!QFile::exists(m_path))
+	{
+		return;
+	}
+	try
+	{
+		auto root = MMCJson::ensureObject(MMCJson::parseFile(m_path, "launch artifacts"));
+		for (auto iter = root.begin(); iter != root.end(); iter++)
+		{
+			auto obj = MMCJson::ensureObject(iter.value(), iter.key());
+			Entry entry;
+			entry.inputs = MMCJson::ensureString(obj.value("inputs"), "inputs");
+			entry.output = MMCJson::ensureString(obj.value("output"), "output");
+			entry.outputStamp = MMCJson::ensureString(obj.value("outputStamp"), "outputStamp");
+			entry.ms = MMCJson::ensureInteger(obj.value("ms"), "ms", 0);
+			m_entries.insert(iter.key(), entry);
+		}
+	}
+	catch (MMCError &e)
+	{
+		QLOG_WARN() << "Ignoring broken launch artifacts" << m_path << ":" << e.cause();
+		m_entries.clear();
+	}
+}
+
+bool LaunchArtifacts::isCurrent(const QString &step, const QString &inputs) const
+{
+	auto iter = m_entries.find(step);
+	if (iter == m_entries.end() || inputs.isEmpty() || iter->inputs != inputs)
+	{
+		return false;
+	}
+	QString stamp = stampOutput(iter->output);
+	return !stamp.isEmpty() && stamp == iter->outputStamp;
+}
+
+qint64 LaunchArtifacts::duration(const QString &step) const
+{
+	return m_entries.value(step).ms;
+}
+
+void LaunchArtifacts::record(const QString &step, const QString &inputs, const QString &output,
+							 qint64 ms)
+{
+	Entry entry;
+	entry.inputs = inputs;
+	entry.output = QFileInfo(output).absoluteFilePath();
+	entry.outputStamp = stampOutput(entry.output);
+	entry.ms = ms;
+	m_entries.insert(step, entry);
+}
+
+void LaunchArtifacts::forget(const QString &step)
+{
+	m_entries.remove(step);
+}
+
+bool LaunchArtifacts::save() const
+{
+	QJsonObject root;
+	for (auto iter = m_entries.begin(); iter != m_entries.end(); iter++)
+	{
+		QJsonObject obj;
+		obj.insert("inputs", iter->inputs);
+		obj.insert("output", iter->output);
+		obj.insert("outputStamp", iter->outputStamp);
+		obj.insert("ms", double(iter->ms));
+		root.insert(iter.key(), obj);
+	}
+	QSaveFile file(m_path);
+	if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(root).toJson()) < 0 ||
+		!file.commit())
+	{
+		QLOG_ERROR() << "Couldn't save the launch artifacts" << m_path << ":"
+					 << file.errorString();
+		return false;
+	}
+	return true;
+}
+
+QString LaunchArtifacts::hashFile(const QString &path)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return QString();
+	}
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	if (!hash.addData(&file))
+	{
+		return QString();
+	}
+	return hash.result().toHex();
+}
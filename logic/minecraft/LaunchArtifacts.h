@@ -0,0 +1,63 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QMap>
+
+/*!
+ * What the local launch preparation of an instance produced, and from what.
+ *
+ * Every step (the exported icon, the virtual assets folder) is recorded with its inputs, a
+ * stamp of its output and how long it took. If a later launch has the same inputs and finds the
+ * output as it was left, the step can be skipped.
+ *
+ * The manifest lives in the instance folder as launch-artifacts.json.
+ */
+class LaunchArtifacts
+{
+public:
+	/// loads the manifest of the instance in instanceRoot. a missing or broken one is empty.
+	explicit LaunchArtifacts(const QString &instanceRoot);
+
+	/// true if the step last ran with these inputs and its output wasn't touched since
+	bool isCurrent(const QString &step, const QString &inputs) const;
+
+	/// how long the step took when it last ran, in milliseconds
+	qint64 duration(const QString &step) const;
+
+	/// the step ran with these inputs and produced output (a file or folder) in ms milliseconds
+	void record(const QString &step, const QString &inputs, const QString &output, qint64 ms);
+
+	/// the step failed or was left incomplete, run it again next time
+	void forget(const QString &step);
+
+	bool save() const;
+
+	/// sha1 of the contents of a file, empty if it can't be read
+	static QString hashFile(const QString &path);
+
+private:
+	struct Entry
+	{
+		QString inputs;
+		QString output;
+		QString outputStamp;
+		qint64 ms = 0;
+	};
+	QString m_path;
+	QMap<QString, Entry> m_entries;
+};
@@ -0,0 +1,71 @@
+#include "LibraryTable.h"
+
+void LibraryTable::clear()
+{
+	m_front = m_back = firstSlot;
+	m_slots.clear();
+	m_byName.clear();
+}
+
+void LibraryTable::assign(const QList<OneSixLibraryPtr> &libraries)
+{
+	clear();
+	for (auto library : libraries)
+	{
+		append(library);
+	}
+}
+
+LibraryTable::Slot LibraryTable::find(const GradleSpecifier &name) const
+{
+	auto iter = m_byName.constFind(name.nameKey());
+	// only one is allowed.
+	if (iter == m_byName.constEnd() || iter->size() != 1)
+	{
+		return -1;
+	}
+	return iter->first();
+}
+
+void LibraryTable::append(OneSixLibraryPtr library)
+{
+	insert(m_back++, library);
+}
+
+void LibraryTable::prepend(OneSixLibraryPtr library)
+{
+	insert(--m_front, library);
+}
+
+void LibraryTable::replace(LibraryTable::Slot slot, OneSixLibraryPtr library)
+{
+	if (!m_slots.contains(slot))
+	{
+		return;
+	}
+	remove(slot);
+	insert(slot, library);
+}
+
+void LibraryTable::remove(LibraryTable::Slot slot)
+{
+	auto iter = m_slots.find(slot);
+	if (iter == m_slots.end())
+	{
+		return;
+	}
+	auto name = iter.value()->rawName().nameKey();
+	m_slots.erase(iter);
+	auto &named = m_byName[name];
+	named.removeOne(slot);
+	if (named.isEmpty())
+	{
+		m_byName.remove(name);
+	}
+}
+
+void LibraryTable::insert(LibraryTable::Slot slot, OneSixLibraryPtr library)
+{
+	m_slots.insert(slot, library);
+	m_byName[library->rawName().nameKey()].append(slot);
+}
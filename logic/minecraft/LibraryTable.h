@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+
+#include "OneSixLibrary.h"
+
+/*!
+ * The libraries of a version, in order, indexed by group:artifact.
+ *
+ * Every library sits in a slot. Slots keep their order while libraries are added at either
+ * end or removed, so looking a library up by name doesn't need a scan of the whole list.
+ */
+class LibraryTable
+{
+public:
+	typedef qint64 Slot;
+	typedef QMap<Slot, OneSixLibraryPtr>::const_iterator const_iterator;
+
+	void clear();
+	void assign(const QList<OneSixLibraryPtr> &libraries);
+
+	/// the slot of the only library with the same group and artifact, or -1
+	Slot find(const GradleSpecifier &name) const;
+	OneSixLibraryPtr at(Slot slot) const
+	{
+		return m_slots.value(slot);
+	}
+
+	void append(OneSixLibraryPtr library);
+	void prepend(OneSixLibraryPtr library);
+	void replace(Slot slot, OneSixLibraryPtr library);
+	void remove(Slot slot);
+
+	int size() const
+	{
+		return m_slots.size();
+	}
+	bool isEmpty() const
+	{
+		return m_slots.isEmpty();
+	}
+	QList<OneSixLibraryPtr> toList() const
+	{
+		return m_slots.values();
+	}
+
+	const_iterator begin() const
+	{
+		return m_slots.constBegin();
+	}
+	const_iterator end() const
+	{
+		return m_slots.constEnd();
+	}
+
+private:
+	void insert(Slot slot, OneSixLibraryPtr library);
+
+	// start in the middle, so there is room to prepend
+	static const Slot firstSlot = Slot(1) << 32;
+	Slot m_front = firstSlot;
+	Slot m_back = firstSlot;
+	QMap<Slot, OneSixLibraryPtr> m_slots;
+	QHash<QString, QList<Slot>> m_byName;
+};
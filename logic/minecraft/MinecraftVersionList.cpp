@@ -348,33 +348,75 @@ inline QDomElement getDomElementByTagName(QDomElement parent, QString tagname)
 		return QDomElement();
 }
 
+static QUrl remoteListUrl()
+{
+	return QUrl("http://" + URLConstants::AWS_DOWNLOAD_VERSIONS + "versions.json");
+}
+
 MCVListLoadTask::MCVListLoadTask(MinecraftVersionList *vlist)
 {
 	m_list = vlist;
 	m_currentStable = NULL;
-	vlistReply = nullptr;
+	m_url = remoteListUrl();
 }
 
 void MCVListLoadTask::executeTask()
 {
 	setStatus(tr("Loading instance version list..."));
-	auto worker = MMC->qnam();
-	vlistReply = worker->get(QNetworkRequest(
-		QUrl("http://" + URLConstants::AWS_DOWNLOAD_VERSIONS + "versions.json")));
-	connect(vlistReply, SIGNAL(finished()), this, SLOT(list_downloaded()));
+	QUrl url = m_url;
+
+	// the first time, use the list read last time while the server is asked for a newer one
+	if (m_list->m_remoteListHash.isEmpty())
+	{
+		QByteArray data;
+		QString dataHash;
+		QString error;
+		if (ByteArrayDownload::readParsedCopy(url, data, dataHash) &&
+			loadList(data, dataHash, &error))
+		{
+			QLOG_INFO() << "Loaded the version list read last time.";
+		}
+	}
+
+	auto job = new NetJob("Minecraft version list");
+	job->addNetAction(ByteArrayDownload::makeCached(url));
+	listDownloadJob.reset(job);
+	connect(job, SIGNAL(succeeded()), SLOT(list_downloaded()));
+	connect(job, SIGNAL(failed()), SLOT(list_failed()));
+	job->start();
+}
+
+void MCVListLoadTask::list_failed()
+{
+	listDownloadJob.reset();
+	emitFailed(tr("Failed to load Minecraft main version list: the download failed."));
 }
 
 void MCVListLoadTask::list_downloaded()
 {
-	if (vlistReply->error() != QNetworkReply::NoError)
+	auto dl = std::dynamic_pointer_cast<ByteArrayDownload>(listDownloadJob->first());
+	auto data = dl->m_data;
+	auto dataHash = dl->m_md5;
+	listDownloadJob.reset();
+
+	// the list didn't change since it was loaded last
+	if (m_list->m_loaded && dataHash == m_list->m_remoteListHash)
+	{
+		QLOG_INFO() << "Remote version list didn't change.";
+		emitSucceeded();
+		return;
+	}
+	QString error;
+	if (!loadList(data, dataHash, &error))
 	{
-		vlistReply->deleteLater();
-		emitFailed("Failed to load Minecraft main version list" + vlistReply->errorString());
+		emitFailed(error);
 		return;
 	}
+	emitSucceeded();
+}
 
-	auto data = vlistReply->readAll();
-	vlistReply->deleteLater();
+bool MCVListLoadTask::loadList(const QByteArray &data, const QString &dataHash, QString *error)
+{
 	try
 	{
 		QJsonParseError jsonError;
@@ -385,15 +427,15 @@ void MCVListLoadTask::list_downloaded()
 				tr("Error parsing version list JSON: %1").arg(jsonError.errorString()));
 		}
 		m_list->loadMojangList(jsonDoc, Remote);
+		m_list->m_remoteListHash = dataHash;
 	}
 	catch (MMCError &e)
 	{
-		emitFailed(e.cause());
-		return;
+		*error = e.cause();
+		return false;
 	}
-
-	emitSucceeded();
-	return;
+	ByteArrayDownload::markParsed(m_url, dataHash);
+	return true;
 }
 
 MCVListVersionUpdateTask::MCVListVersionUpdateTask(MinecraftVersionList *vlist,
@@ -409,7 +451,7 @@ void MCVListVersionUpdateTask::executeTask()
 	QString urlstr = "http://" + URLConstants::AWS_DOWNLOAD_VERSIONS + versionToUpdate + "/" +
 					 versionToUpdate + ".json";
 	auto job = new NetJob("Version index");
-	job->addNetAction(ByteArrayDownload::make(QUrl(urlstr)));
+	job->addNetAction(ByteArrayDownload::makeCached(QUrl(urlstr)));
 	specificVersionDownloadJob.reset(job);
 	connect(specificVersionDownloadJob.get(), SIGNAL(succeeded()), SLOT(json_downloaded()));
 	connect(specificVersionDownloadJob.get(), SIGNAL(failed(QString)), SIGNAL(failed(QString)));
@@ -418,6 +460,21 @@ void MCVListVersionUpdateTask::executeTask()
 	specificVersionDownloadJob->start();
 }
 
+void MCVListVersionUpdateTask::abort()
+{
+	if (!isRunning())
+	{
+		return;
+	}
+	if (specificVersionDownloadJob)
+	{
+		disconnect(specificVersionDownloadJob.get(), 0, this, 0);
+		specificVersionDownloadJob->abort();
+		specificVersionDownloadJob.reset();
+	}
+	emitFailed(tr("Aborted."));
+}
+
 void MCVListVersionUpdateTask::json_downloaded()
 {
 	NetActionPtr DlJob = specificVersionDownloadJob->first();
@@ -18,6 +18,7 @@
 #include <QObject>
 #include <QList>
 #include <QSet>
+#include <QUrl>
 
 #include "logic/BaseVersionList.h"
 #include "logic/tasks/Task.h"
@@ -60,6 +61,8 @@ protected:
 
 	bool m_loaded = false;
 	bool m_hasLocalIndex = false;
+	/// MD5 of the remote list that was loaded last
+	QString m_remoteListHash;
 	QString m_latestReleaseID = "INVALID";
 	QString m_latestSnapshotID = "INVALID";
 
@@ -81,9 +84,15 @@ public:
 protected
 slots:
 	void list_downloaded();
+	void list_failed();
 
 protected:
-	QNetworkReply *vlistReply;
+	/// loads the remote list into m_list, and remembers it as parsed for the next start
+	bool loadList(const QByteArray &data, const QString &dataHash, QString *error);
+
+	NetJobPtr listDownloadJob;
+	/// where the remote list is downloaded from
+	QUrl m_url;
 	MinecraftVersionList *m_list;
 	MinecraftVersion *m_currentStable;
 };
@@ -97,6 +106,10 @@ public:
 	virtual ~MCVListVersionUpdateTask() override{};
 	virtual void executeTask() override;
 
+public
+slots:
+	virtual void abort() override;
+
 protected
 slots:
 	void json_downloaded();
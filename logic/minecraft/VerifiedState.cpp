@@ -0,0 +1,238 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VerifiedState.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <pathutils.h>
+
+#include "MultiMC.h"
+#include "logic/OneSixInstance.h"
+#include "logic/minecraft/InstanceVersion.h"
+#include "logic/net/HttpMetaCache.h"
+#include "logic/MMCJson.h"
+#include "logger/QsLog.h"
+
+namespace
+{
+/// size, modification time and the md5 from the cache, if any
+QString stampFile(const QString &path, const QString &md5 = QString())
+{
+	QFileInfo info(path);
+	if (!info.exists())
+	{
+		return "missing";
+	}
+	return QString("%1:%2:%3")
+		.arg(info.size())
+		.arg(info.lastModified().toUTC().toMSecsSinceEpoch())
+		.arg(md5);
+}
+
+/// stamp a file tracked by the metacache
+QString stampCached(const QString &base, const QString &path)
+{
+	auto metacache = MMC->metacache();
+	auto entry = metacache->getEntry(base, path);
+	QString fullPath = PathCombine(metacache->getBasePath(base), path);
+	return stampFile(fullPath, entry ? entry->md5sum : QString());
+}
+}
+
+QString VerifiedState::statePath(OneSixInstance *instance)
+{
+	return PathCombine(instance->instanceRoot(), "verified.json");
+}
+
+VerifiedState VerifiedState::capture(OneSixInstance *instance)
+{
+	VerifiedState state;
+	state.m_timestamp = QDateTime::currentDateTimeUtc();
+
+	auto version = instance->getFullVersion();
+	if (!version || version->id.isEmpty())
+	{
+		return state;
+	}
+
+	// the resolved version
+	{
+		QStringList traits = version->traits.toList();
+		traits.sort();
+		QCryptographicHash hash(QCryptographicHash::Sha1);
+		hash.addData(instance->intendedVersionId().toUtf8());
+		hash.addData(version->id.toUtf8());
+		hash.addData(version->mainClass.toUtf8());
+		hash.addData(version->assets.toUtf8());
+		hash.addData(traits.join(',').toUtf8());
+		state.m_versionHash = hash.result().toHex();
+	}
+
+	auto &stamps = state.m_stamps;
+
+	// files the version is built from
+	QDir root(instance->instanceRoot());
+	for (auto file : {"version.json", "custom.json", "order.json", "patches"})
+	{
+		stamps.insert(file, stampFile(root.absoluteFilePath(file)));
+	}
+	for (auto info : QDir(root.absoluteFilePath("patches")).entryInfoList(QStringList() << "*.json", QDir::Files))
+	{
+		stamps.insert("patches/" + info.fileName(), stampFile(info.absoluteFilePath()));
+	}
+	for (auto patch : instance->externalPatches())
+	{
+		stamps.insert("external:" + patch, stampFile(patch));
+	}
+
+	// the game jar, jar mods and FML libraries
+	QString jarPath = version->id + "/" + version->id + ".jar";
+	stamps.insert("versions:" + jarPath, stampCached("versions", jarPath));
+	if (version->hasJarMods())
+	{
+		stamps.insert("temp.jar", stampFile(root.absoluteFilePath("temp.jar")));
+		for (auto jarmod : version->jarMods)
+		{
+			stamps.insert("jarmods:" + jarmod->name,
+						  stampFile(instance->jarmodsPath().absoluteFilePath(jarmod->name)));
+		}
+	}
+	stamps.insert("fmllibs", stampFile(instance->libDir()));
+
+	// libraries
+	auto libs = version->getActiveNativeLibs();
+	libs.append(version->getActiveNormalLibs());
+	for (auto lib : libs)
+	{
+		QString storage = lib->storagePath();
+		QStringList storages;
+		if (storage.contains("${arch}"))
+		{
+			storages << QString(storage).replace("${arch}", "32")
+					 << QString(storage).replace("${arch}", "64");
+		}
+		else
+		{
+			storages << storage;
+		}
+		for (auto path : storages)
+		{
+			if (lib->hint() == "local")
+			{
+				stamps.insert("local:" + path,
+							  stampFile(instance->librariesPath().absoluteFilePath(path)));
+			}
+			else
+			{
+				stamps.insert("libraries:" + path, stampCached("libraries", path));
+			}
+		}
+	}
+
+	// assets index and the object folders. adding or removing an object changes the mtime of its
+	// folder, so this catches missing assets without looking at each of them.
+	QString indexPath = version->assets + ".json";
+	stamps.insert("asset_indexes:" + indexPath, stampCached("asset_indexes", indexPath));
+	QDir objects("assets/objects");
+	for (auto dir : objects.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+	{
+		stamps.insert("assets:" + dir.fileName(), stampFile(dir.absoluteFilePath()));
+	}
+	return state;
+}
+
+VerifiedState VerifiedState::load(OneSixInstance *instance)
+{
+	VerifiedState state;
+	QFile file(statePath(instance));
+	if (!file.exists())
+	{
+		return state;
+	}
+	try
+	{
+		auto root = MMCJson::ensureObject(MMCJson::parseFile(file.fileName(), "verified state"));
+		auto stamps = MMCJson::ensureObject(root.value("stamps"), "stamps");
+		for (auto iter = stamps.begin(); iter != stamps.end(); iter++)
+		{
+			state.m_stamps.insert(iter.key(), MMCJson::ensureString(iter.value(), iter.key()));
+		}
+		state.m_timestamp = QDateTime::fromString(
+			MMCJson::ensureString(root.value("timestamp"), "timestamp"), Qt::ISODate);
+		state.m_versionHash = MMCJson::ensureString(root.value("version"), "version");
+	}
+	catch (MMCError &e)
+	{
+		QLOG_WARN() << "Ignoring broken verified state of" << instance->name() << ":" << e.cause();
+		return VerifiedState();
+	}
+	return state;
+}
+
+bool VerifiedState::save(OneSixInstance *instance) const
+{
+	QJsonObject stamps;
+	for (auto iter = m_stamps.begin(); iter != m_stamps.end(); iter++)
+	{
+		stamps.insert(iter.key(), iter.value());
+	}
+	QJsonObject root;
+	root.insert("version", m_versionHash);
+	root.insert("timestamp", m_timestamp.toString(Qt::ISODate));
+	root.insert("stamps", stamps);
+
+	// a crash while writing leaves the old state, not half of a new one
+	QSaveFile file(statePath(instance));
+	QByteArray data = QJsonDocument(root).toJson();
+	if (!file.open(QFile::WriteOnly) || file.write(data) != data.size() || !file.commit())
+	{
+		QLOG_ERROR() << "Couldn't save the verified state of" << instance->name() << ":"
+					 << file.errorString();
+		return false;
+	}
+	return true;
+}
+
+void VerifiedState::invalidate(OneSixInstance *instance)
+{
+	QFile::remove(statePath(instance));
+}
+
+QStringList VerifiedState::changedStamps(const VerifiedState &other) const
+{
+	QStringList changed;
+	for (auto iter = m_stamps.begin(); iter != m_stamps.end(); iter++)
+	{
+		if (other.m_stamps.value(iter.key()) != iter.value())
+			changed.append(iter.key());
+	}
+	for (auto iter = other.m_stamps.begin(); iter != other.m_stamps.end(); iter++)
+	{
+		if (!m_stamps.contains(iter.key()))
+			changed.append(iter.key());
+	}
+	return changed;
+}
+
+bool VerifiedState::operator==(const VerifiedState &other) const
+{
+	return m_versionHash == other.m_versionHash && m_stamps == other.m_stamps;
+}
@@ -0,0 +1,81 @@
+/* Copyright 2013-2015 MultiMC Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QMap>
+#include <QStringList>
+#include <QDateTime>
+
+class OneSixInstance;
+
+/*!
+ * What a full update of a OneSix instance verified: the resolved version, the cache entries of
+ * the libraries and the game jar, and the assets index. Every file is recorded with a cheap
+ * stamp (size, modification time and the md5 the cache knows about), and the assets objects
+ * with the modification times of their folders.
+ *
+ * If the state captured before a launch matches the recorded one, nothing changed and the update
+ * can be skipped.
+ */
+class VerifiedState
+{
+public:
+	/// capture the current state of the instance. this only stats files, it doesn't read them.
+	static VerifiedState capture(OneSixInstance *instance);
+
+	/// load the state recorded for the instance. returns an invalid state if there is none.
+	static VerifiedState load(OneSixInstance *instance);
+
+	/// record this state for the instance
+	bool save(OneSixInstance *instance) const;
+
+	/// forget the recorded state of the instance. the next launch does a full update.
+	static void invalidate(OneSixInstance *instance);
+
+	bool isValid() const
+	{
+		return !m_versionHash.isEmpty();
+	}
+
+	/// when this state was captured
+	QDateTime timestamp() const
+	{
+		return m_timestamp;
+	}
+
+	/// older than a day. everything is verified once a day, to catch what the stamps can't see.
+	bool isExpired() const
+	{
+		return m_timestamp.secsTo(QDateTime::currentDateTimeUtc()) > 24 * 3600;
+	}
+
+	/// the stamps that differ between the two states, or are only in one of them
+	QStringList changedStamps(const VerifiedState &other) const;
+
+	bool operator==(const VerifiedState &other) const;
+	bool operator!=(const VerifiedState &other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+	static QString statePath(OneSixInstance *instance);
+
+	QString m_versionHash;
+	QMap<QString, QString> m_stamps;
+	QDateTime m_timestamp;
+};
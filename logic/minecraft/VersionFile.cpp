@@ -17,22 +17,6 @@ using namespace MMCJson;
 
 #define CURRENT_MINIMUM_LAUNCHER_VERSION 14
 
-int findLibraryByName(QList<OneSixLibraryPtr> haystack, const GradleSpecifier &needle)
-{
-	int retval = -1;
-	for (int i = 0; i < haystack.size(); ++i)
-	{
-		if (haystack.at(i)->rawName().matchName(needle))
-		{
-			// only one is allowed.
-			if (retval != -1)
-				return -1;
-			retval = i;
-		}
-	}
-	return retval;
-}
-
 VersionFilePtr VersionFile::fromJson(const QJsonDocument &doc, const QString &filename,
 									 const bool requireOrder, const bool isFTB)
 {
@@ -278,8 +262,11 @@ void VersionFile::applyTo(InstanceVersion *version)
 
 	if (!version->id.isNull() && !mcVersion.isNull())
 	{
-		if (QRegExp(mcVersion, Qt::CaseInsensitive, QRegExp::Wildcard).indexIn(version->id) ==
-			-1)
+		if (m_mcVersionMatcher.pattern() != mcVersion)
+		{
+			m_mcVersionMatcher = QRegExp(mcVersion, Qt::CaseInsensitive, QRegExp::Wildcard);
+		}
+		if (m_mcVersionMatcher.indexIn(version->id) == -1)
 		{
 			throw MinecraftVersionMismatch(fileId, mcVersion, version->id);
 		}
@@ -372,7 +359,7 @@ void VersionFile::applyTo(InstanceVersion *version)
 		{
 			version->vanillaLibraries = libs;
 		}
-		version->libraries = libs;
+		version->libraries.assign(libs);
 	}
 	for (auto addedLibrary : addLibs)
 	{
@@ -381,10 +368,10 @@ void VersionFile::applyTo(InstanceVersion *version)
 		case RawLibrary::Apply:
 		{
 			// QLOG_INFO() << "Applying lib " << lib->name;
-			int index = findLibraryByName(version->libraries, addedLibrary->rawName());
-			if (index >= 0)
+			auto slot = version->libraries.find(addedLibrary->rawName());
+			if (slot >= 0)
 			{
-				auto existingLibrary = version->libraries[index];
+				auto existingLibrary = version->libraries.at(slot);
 				if (!addedLibrary->m_base_url.isNull())
 				{
 					existingLibrary->setBaseUrl(addedLibrary->m_base_url);
@@ -420,9 +407,9 @@ void VersionFile::applyTo(InstanceVersion *version)
 		case RawLibrary::Prepend:
 		{
 			// find the library by name.
-			const int index = findLibraryByName(version->libraries, addedLibrary->rawName());
+			const auto slot = version->libraries.find(addedLibrary->rawName());
 			// library not found? just add it.
-			if (index < 0)
+			if (slot < 0)
 			{
 				if (addedLibrary->insertType == RawLibrary::Append)
 				{
@@ -436,7 +423,7 @@ void VersionFile::applyTo(InstanceVersion *version)
 			}
 
 			// otherwise apply differences, if allowed
-			auto existingLibrary = version->libraries.at(index);
+			auto existingLibrary = version->libraries.at(slot);
 			const Util::Version addedVersion = addedLibrary->version();
 			const Util::Version existingVersion = existingLibrary->version();
 			// if the existing version is a hard dependency we can either use it or
@@ -464,7 +451,7 @@ void VersionFile::applyTo(InstanceVersion *version)
 				if (addedVersion > existingVersion)
 				{
 					auto library = OneSixLibrary::fromRawLibrary(addedLibrary);
-					version->libraries.replace(index, library);
+					version->libraries.replace(slot, library);
 				}
 				else
 				{
@@ -493,10 +480,10 @@ void VersionFile::applyTo(InstanceVersion *version)
 				toReplace = addedLibrary->insertData;
 			}
 			// QLOG_INFO() << "Replacing lib " << toReplace << " with " << lib->name;
-			int index = findLibraryByName(version->libraries, toReplace);
-			if (index >= 0)
+			auto slot = version->libraries.find(toReplace);
+			if (slot >= 0)
 			{
-				version->libraries.replace(index, OneSixLibrary::fromRawLibrary(addedLibrary));
+				version->libraries.replace(slot, OneSixLibrary::fromRawLibrary(addedLibrary));
 			}
 			else
 			{
@@ -508,11 +495,11 @@ void VersionFile::applyTo(InstanceVersion *version)
 	}
 	for (auto lib : removeLibs)
 	{
-		int index = findLibraryByName(version->libraries, lib);
-		if (index >= 0)
+		auto slot = version->libraries.find(lib);
+		if (slot >= 0)
 		{
 			// QLOG_INFO() << "Removing lib " << lib;
-			version->libraries.removeAt(index);
+			version->libraries.remove(slot);
 		}
 		else
 		{
@@ -3,6 +3,7 @@
 #include <QString>
 #include <QStringList>
 #include <QDateTime>
+#include <QRegExp>
 #include <memory>
 #include "logic/minecraft/OpSys.h"
 #include "logic/minecraft/OneSixRule.h"
@@ -107,6 +108,10 @@ public: /* data */
 	QSet<QString> traits;
 
 	QList<JarmodPtr> jarMods;
+
+private:
+	/// mcVersion as a wildcard, compiled again only when mcVersion changes
+	QRegExp m_mcVersionMatcher;
 };
 
 
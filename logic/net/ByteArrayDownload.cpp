@@ -16,10 +16,17 @@
 #include "ByteArrayDownload.h"
 #include "MultiMC.h"
 #include "logger/QsLog.h"
+#include <pathutils.h>
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
 
 ByteArrayDownload::ByteArrayDownload(QUrl url) : NetAction()
 {
 	m_url = url;
+	m_cacheUrl = url;
 	m_status = Job_NotStarted;
 }
 
@@ -27,7 +34,24 @@ void ByteArrayDownload::start()
 {
 	QLOG_INFO() << "Downloading " << m_url.toString();
 	QNetworkRequest request(m_url);
-	request.setHeader(QNetworkRequest::UserAgentHeader, "MultiMC/5.0 (Uncached)");
+	if (m_cached)
+	{
+		m_entry = cacheEntry(m_cacheUrl);
+		if (!m_entry->stale)
+		{
+			if (m_entry->remote_changed_timestamp.size())
+				request.setRawHeader(QString("If-Modified-Since").toLatin1(),
+									 m_entry->remote_changed_timestamp.toLatin1());
+			if (m_entry->etag.size())
+				request.setRawHeader(QString("If-None-Match").toLatin1(),
+									 m_entry->etag.toLatin1());
+		}
+		request.setHeader(QNetworkRequest::UserAgentHeader, "MultiMC/5.0 (Cached)");
+	}
+	else
+	{
+		request.setHeader(QNetworkRequest::UserAgentHeader, "MultiMC/5.0 (Uncached)");
+	}
 	auto worker = MMC->qnam();
 	QNetworkReply *rep = worker->get(request);
 
@@ -73,7 +97,7 @@ void ByteArrayDownload::downloadFinished()
 	}
 	if (!redirectURL.isEmpty())
 	{
-		m_url = QUrl(redirect.toString());
+		m_url = QUrl(redirectURL);
 		QLOG_INFO() << "Following redirect to " << m_url.toString();
 		start();
 		return;
@@ -83,9 +107,28 @@ void ByteArrayDownload::downloadFinished()
 	if (m_status != Job_Failed)
 	{
 		// nothing went wrong...
-		m_status = Job_Finished;
-		m_data = m_reply->readAll();
 		m_content_type = m_reply->header(QNetworkRequest::ContentTypeHeader).toString();
+		int httpStatus = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+		if (m_cached && httpStatus == 304)
+		{
+			m_cacheHit = true;
+			if (!readCachedCopy())
+			{
+				m_status = Job_Failed;
+				m_reply.reset();
+				emit failed(m_index_within_job);
+				return;
+			}
+		}
+		else
+		{
+			m_data = m_reply->readAll();
+			if (m_cached)
+			{
+				storeCachedCopy();
+			}
+		}
+		m_status = Job_Finished;
 		m_reply.reset();
 		emit succeeded(m_index_within_job);
 		return;
@@ -103,3 +146,81 @@ void ByteArrayDownload::downloadReadyRead()
 {
 	// ~_~
 }
+
+MetaEntryPtr ByteArrayDownload::cacheEntry(QUrl url)
+{
+	// cached copies are named after the URL they came from
+	QString path =
+		QCryptographicHash::hash(url.toString().toUtf8(), QCryptographicHash::Sha1).toHex();
+	return MMC->metacache()->resolveEntry("http", path);
+}
+
+bool ByteArrayDownload::readParsedCopy(QUrl url, QByteArray &data, QString &md5)
+{
+	auto entry = cacheEntry(url);
+	if (entry->stale || entry->parsed_md5sum.isEmpty() || entry->parsed_md5sum != entry->md5sum)
+	{
+		return false;
+	}
+	QFile cachedCopy(entry->getFullPath());
+	if (!cachedCopy.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+	data = cachedCopy.readAll();
+	md5 = entry->md5sum;
+	return true;
+}
+
+void ByteArrayDownload::markParsed(QUrl url, const QString &md5)
+{
+	auto entry = cacheEntry(url);
+	if (entry->stale || entry->md5sum != md5 || entry->parsed_md5sum == md5)
+	{
+		return;
+	}
+	entry->parsed_md5sum = md5;
+	MMC->metacache()->updateEntry(entry);
+}
+
+bool ByteArrayDownload::readCachedCopy()
+{
+	QFile cachedCopy(m_entry->getFullPath());
+	if (!cachedCopy.open(QIODevice::ReadOnly))
+	{
+		QLOG_ERROR() << "Server says" << m_url.toString()
+					 << "didn't change, but the cached copy can't be read";
+		return false;
+	}
+	QLOG_INFO() << m_url.toString() << "didn't change, using the cached copy";
+	m_data = cachedCopy.readAll();
+	m_md5 = m_entry->md5sum;
+	return true;
+}
+
+void ByteArrayDownload::storeCachedCopy()
+{
+	m_md5 = QCryptographicHash::hash(m_data, QCryptographicHash::Md5).toHex().constData();
+
+	QString path = m_entry->getFullPath();
+	if (!ensureFilePathExists(path))
+	{
+		QLOG_ERROR() << "Could not create folder for " + path;
+		return;
+	}
+	QSaveFile cachedCopy(path);
+	if (!cachedCopy.open(QIODevice::WriteOnly) ||
+		cachedCopy.write(m_data) != m_data.size() || !cachedCopy.commit())
+	{
+		QLOG_ERROR() << "Failed to store the cached copy of " << m_url.toString();
+		return;
+	}
+
+	m_entry->md5sum = m_md5;
+	m_entry->etag = m_reply->rawHeader("ETag").constData();
+	m_entry->remote_changed_timestamp = m_reply->rawHeader("Last-Modified").constData();
+	m_entry->local_changed_timestamp =
+		QFileInfo(path).lastModified().toUTC().toMSecsSinceEpoch();
+	m_entry->stale = false;
+	MMC->metacache()->updateEntry(m_entry);
+}
@@ -15,6 +15,7 @@
 
 #pragma once
 #include "NetAction.h"
+#include "HttpMetaCache.h"
 
 typedef std::shared_ptr<class ByteArrayDownload> ByteArrayDownloadPtr;
 class ByteArrayDownload : public NetAction
@@ -26,11 +27,32 @@ public:
 	{
 		return ByteArrayDownloadPtr(new ByteArrayDownload(url));
 	}
+	/*!
+	 * Like make(), but keeps a copy of the response in the metacache. The request is
+	 * conditional on that copy, and when the server says it didn't change, the copy is used.
+	 */
+	static ByteArrayDownloadPtr makeCached(QUrl url)
+	{
+		auto dl = ByteArrayDownloadPtr(new ByteArrayDownload(url));
+		dl->m_cached = true;
+		return dl;
+	}
+	/*!
+	 * Reads the cached copy of url, if it is the one last marked with markParsed().
+	 * Lets the users show what they had before the server answers, and skip parsing the
+	 * same data again when it does.
+	 */
+	static bool readParsedCopy(QUrl url, QByteArray &data, QString &md5);
+	/// marks the cached copy of url with the given md5 as parsed successfully
+	static void markParsed(QUrl url, const QString &md5);
     virtual ~ByteArrayDownload() {};
 public:
 	/// if not saving to file, downloaded data is placed here
 	QByteArray m_data;
 
+	/// md5 of m_data. only for cached downloads, so users can skip parsing data they already have
+	QString m_md5;
+
 	QString m_errorString;
 
 public
@@ -43,4 +65,15 @@ slots:
 	void downloadError(QNetworkReply::NetworkError error);
 	void downloadFinished();
 	void downloadReadyRead();
+
+private:
+	static MetaEntryPtr cacheEntry(QUrl url);
+	bool readCachedCopy();
+	void storeCachedCopy();
+
+private:
+	bool m_cached = false;
+	/// the URL the download was made with. redirects don't change it, so the cache keeps matching it
+	QUrl m_cacheUrl;
+	MetaEntryPtr m_entry;
 };
@@ -37,6 +37,7 @@ void CacheDownload::start()
 	if (!m_entry->stale)
 	{
 		m_status = Job_Finished;
+		m_cacheHit = true;
 		emit succeeded(m_index_within_job);
 		return;
 	}
@@ -152,7 +153,9 @@ void CacheDownload::downloadFinished()
 	}
 	else
 	{
+		// not modified, the local copy is still good
 		m_status = Job_Finished;
+		m_cacheHit = true;
 	}
 
 	// then get rid of the save file
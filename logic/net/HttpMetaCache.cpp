@@ -203,6 +203,7 @@ void HttpMetaCache::Load()
 		foo->local_changed_timestamp = element_obj.value("last_changed_timestamp").toDouble();
 		foo->remote_changed_timestamp =
 			element_obj.value("remote_changed_timestamp").toString();
+		foo->parsed_md5sum = element_obj.value("parsed_md5sum").toString();
 		// presumed innocent until closer examination
 		foo->stale = false;
 		entrymap.entry_list[path] = MetaEntryPtr(foo);
@@ -238,6 +239,8 @@ void HttpMetaCache::SaveNow()
 			if (!entry->remote_changed_timestamp.isEmpty())
 				entryObj.insert("remote_changed_timestamp",
 								QJsonValue(entry->remote_changed_timestamp));
+			if (!entry->parsed_md5sum.isEmpty())
+				entryObj.insert("parsed_md5sum", QJsonValue(entry->parsed_md5sum));
 			entriesArr.append(entryObj);
 		}
 	}
@@ -26,6 +26,8 @@ struct MetaEntry
 	QString etag;
 	qint64 local_changed_timestamp = 0;
 	QString remote_changed_timestamp; // QString for now, RFC 2822 encoded time
+	/// md5 of the copy its user parsed successfully last, see ByteArrayDownload::markParsed
+	QString parsed_md5sum;
 	bool stale = true;
 	QString getFullPath();
 };
@@ -46,6 +46,7 @@ void MD5EtagDownload::start()
 			if(m_local_md5 == m_expected_md5)
 			{
 				QLOG_INFO() << "Skipping " << m_url.toString() << ": md5 match.";
+				m_cacheHit = true;
 				emit succeeded(m_index_within_job);
 				return;
 			}
@@ -78,6 +78,9 @@ public:
 	/// number of failures up to this point
 	int m_failures = 0;
 
+	/// true if the result came from the local copy instead of the network
+	bool m_cacheHit = false;
+
 signals:
 	void started(int index);
 	void progress(int index, qint64 current, qint64 total);
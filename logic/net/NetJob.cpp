@@ -30,6 +30,13 @@ void NetJob::partSucceeded(int index)
 
 	m_doing.remove(index);
 	m_done.insert(index);
+	if (m_trace)
+	{
+		bool hit = downloads[index]->m_cacheHit;
+		m_trace->addCacheResults(m_traceSpan, hit ? 1 : 0, hit ? 0 : 1);
+		if (!hit)
+			m_trace->addBytes(m_traceSpan, qMax<qint64>(0, slot.total_progress));
+	}
 	disconnect(downloads[index].get(), 0, this, 0);
 	startMoreParts();
 }
@@ -38,7 +45,7 @@ void NetJob::partFailed(int index)
 {
 	m_doing.remove(index);
 	auto &slot = parts_progress[index];
-	if (slot.failures == 3)
+	if (slot.failures == 3 || m_aborted)
 	{
 		m_failed.insert(index);
 	}
@@ -69,6 +76,8 @@ void NetJob::start()
 {
 	QLOG_INFO() << m_job_name.toLocal8Bit() << " started.";
 	m_running = true;
+	if (m_trace)
+		m_traceSpan = m_trace->begin(m_job_name, "net");
 	for (int i = 0; i < downloads.size(); i++)
 	{
 		m_todo.enqueue(i);
@@ -76,6 +85,31 @@ void NetJob::start()
 	startMoreParts();
 }
 
+void NetJob::abort()
+{
+	// not started or already done
+	if (!m_running || m_aborted || (m_todo.isEmpty() && m_doing.isEmpty()))
+		return;
+	QLOG_INFO() << m_job_name.toLocal8Bit() << "aborted.";
+	m_aborted = true;
+	while (!m_todo.isEmpty())
+	{
+		m_failed.insert(m_todo.dequeue());
+	}
+	if (m_doing.isEmpty())
+	{
+		startMoreParts();
+		return;
+	}
+	// the parts fail as their replies finish, the last one fails the job
+	for (auto index : m_doing.toList())
+	{
+		auto reply = downloads[index]->m_reply;
+		if (reply)
+			reply->abort();
+	}
+}
+
 void NetJob::startMoreParts()
 {
 	// check for final conditions if there's nothing in the queue
@@ -83,6 +117,8 @@ void NetJob::startMoreParts()
 	{
 		if(!m_doing.size())
 		{
+			if (m_trace)
+				m_trace->end(m_traceSpan);
 			if(!m_failed.size())
 			{
 				QLOG_INFO() << m_job_name.toLocal8Bit() << "succeeded.";
@@ -23,6 +23,7 @@
 #include "HttpMetaCache.h"
 #include "logic/tasks/ProgressProvider.h"
 #include "logic/QObjectPtr.h"
+#include "logic/Trace.h"
 
 class NetJob;
 typedef QObjectPtr<NetJob> NetJobPtr;
@@ -83,6 +84,12 @@ public:
 	}
 	QStringList getFailedFiles();
 
+	/// records the time, bytes and cache use of the job in the given trace
+	void setTrace(TracePtr trace)
+	{
+		m_trace = trace;
+	}
+
 private:
 	void startMoreParts();
 
@@ -94,8 +101,8 @@ signals:
 
 public slots:
 	virtual void start();
-	// FIXME: implement
-	virtual void abort() {};
+	/// fails the job: what didn't start yet doesn't, what is running has its reply aborted
+	virtual void abort();
 
 private slots:
 	void partProgress(int index, qint64 bytesReceived, qint64 bytesTotal);
@@ -118,5 +125,8 @@ private:
 	QSet<int> m_failed;
 	qint64 current_progress = 0;
 	qint64 total_progress = 0;
+	TracePtr m_trace;
+	int m_traceSpan = -1;
 	bool m_running = false;
+	bool m_aborted = false;
 };
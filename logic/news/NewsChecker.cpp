@@ -36,8 +36,22 @@ void NewsChecker::reloadNews()
 	
 	QLOG_INFO() << "Reloading news.";
 
+	// the first time, show the feed read last time while the server is asked for a newer one
+	if (m_newsDataHash.isEmpty())
+	{
+		QByteArray data;
+		QString dataHash;
+		QString errorMsg;
+		if (ByteArrayDownload::readParsedCopy(m_feedUrl, data, dataHash) &&
+			loadFeed(data, dataHash, &errorMsg))
+		{
+			QLOG_DEBUG() << "Loaded the RSS feed read last time.";
+			emit newsLoaded();
+		}
+	}
+
 	NetJob* job = new NetJob("News RSS Feed");
-	job->addNetAction(ByteArrayDownload::make(m_feedUrl));
+	job->addNetAction(ByteArrayDownload::makeCached(m_feedUrl));
 	QObject::connect(job, &NetJob::succeeded, this, &NewsChecker::rssDownloadFinished);
 	QObject::connect(job, &NetJob::failed, this, &NewsChecker::rssDownloadFailed);
 	m_newsNetJob.reset(job);
@@ -50,25 +64,46 @@ void NewsChecker::rssDownloadFinished()
 	QLOG_DEBUG() << "Finished loading RSS feed.";
 
 	QByteArray data;
+	QString dataHash;
 	{
 		ByteArrayDownloadPtr dl = std::dynamic_pointer_cast<ByteArrayDownload>(m_newsNetJob->first());
 		data = dl->m_data;
+		dataHash = dl->m_md5;
 		m_newsNetJob.reset();
 	}
 
+	// same feed as last time, the entries we have are still good
+	if (!m_newsEntries.isEmpty() && dataHash == m_newsDataHash)
+	{
+		QLOG_DEBUG() << "RSS feed didn't change.";
+		succeed();
+		return;
+	}
+	QString errorMsg;
+	if (!loadFeed(data, dataHash, &errorMsg))
+	{
+		fail(errorMsg);
+		return;
+	}
+	succeed();
+}
+
+bool NewsChecker::loadFeed(const QByteArray &data, const QString &dataHash, QString *errorMsg)
+{
+	m_newsDataHash.clear();
+
 	QDomDocument doc;
 	{
 		// Stuff to store error info in.
-		QString errorMsg = "Unknown error.";
+		QString parseError = "Unknown error.";
 		int errorLine = -1;
 		int errorCol = -1;
 
 		// Parse the XML.
-		if (!doc.setContent(data, false, &errorMsg, &errorLine, &errorCol))
+		if (!doc.setContent(data, false, &parseError, &errorLine, &errorCol))
 		{
-			QString fullErrorMsg = QString("Error parsing RSS feed XML. %s at %d:%d.").arg(errorMsg, errorLine, errorCol);
-			fail(fullErrorMsg);
-			return;
+			*errorMsg = QString("Error parsing RSS feed XML. %s at %d:%d.").arg(parseError, errorLine, errorCol);
+			return false;
 		}
 	}
 
@@ -80,19 +115,21 @@ void NewsChecker::rssDownloadFinished()
 		QDomElement element = items.at(i).toElement();
 		NewsEntryPtr entry;
 		entry.reset(new NewsEntry());
-		QString errorMsg = "An unknown error occurred.";
-		if (NewsEntry::fromXmlElement(element, entry.get(), &errorMsg))
+		QString entryError = "An unknown error occurred.";
+		if (NewsEntry::fromXmlElement(element, entry.get(), &entryError))
 		{
 			QLOG_DEBUG() << "Loaded news entry" << entry->title;
 			m_newsEntries.append(entry);
 		}
 		else
 		{
-			QLOG_WARN() << "Failed to load news entry at index" << i << ":" << errorMsg;
+			QLOG_WARN() << "Failed to load news entry at index" << i << ":" << entryError;
 		}
 	}
 
-	succeed();
+	m_newsDataHash = dataHash;
+	ByteArrayDownload::markParsed(m_feedUrl, dataHash);
+	return true;
 }
 
 void NewsChecker::rssDownloadFailed()
@@ -73,12 +73,21 @@ protected slots:
 	void rssDownloadFailed();
 
 protected:
+	/*!
+	 * Reads the news entries from the feed, and remembers the feed as parsed, so the next start
+	 * can show it right away.
+	 */
+	bool loadFeed(const QByteArray &data, const QString &dataHash, QString *errorMsg);
+
 	//! The URL for the RSS feed to fetch.
 	QString m_feedUrl;
 
 	//! List of news entries.
 	QList<NewsEntryPtr> m_newsEntries;
 
+	//! MD5 of the feed the news entries were read from.
+	QString m_newsDataHash;
+
 	//! The network job to use to load the news.
 	NetJobPtr m_newsNetJob;
 
@@ -43,8 +43,22 @@ void StatusChecker::reloadStatus()
 	
 	// QLOG_INFO() << "Reloading status.";
 
+	// the first time, show the status read last time while the server is asked again
+	if (m_statusDataHash.isEmpty())
+	{
+		QByteArray data;
+		QString dataHash;
+		QString errorMsg;
+		if (ByteArrayDownload::readParsedCopy(URLConstants::MOJANG_STATUS_URL, data, dataHash) &&
+			loadStatus(data, dataHash, &errorMsg) && m_prevEntries != m_statusEntries)
+		{
+			emit statusChanged(m_statusEntries);
+			m_prevEntries = m_statusEntries;
+		}
+	}
+
 	NetJob* job = new NetJob("Status JSON");
-	job->addNetAction(ByteArrayDownload::make(URLConstants::MOJANG_STATUS_URL));
+	job->addNetAction(ByteArrayDownload::makeCached(URLConstants::MOJANG_STATUS_URL));
 	QObject::connect(job, &NetJob::succeeded, this, &StatusChecker::statusDownloadFinished);
 	QObject::connect(job, &NetJob::failed, this, &StatusChecker::statusDownloadFailed);
 	m_statusNetJob.reset(job);
@@ -55,27 +69,49 @@ void StatusChecker::reloadStatus()
 void StatusChecker::statusDownloadFinished()
 {
 	QLOG_DEBUG() << "Finished loading status JSON.";
-	m_statusEntries.clear();
 	QByteArray data;
+	QString dataHash;
 	{
 		ByteArrayDownloadPtr dl = std::dynamic_pointer_cast<ByteArrayDownload>(m_statusNetJob->first());
 		data = dl->m_data;
+		dataHash = dl->m_md5;
 		m_statusNetJob.reset();
 	}
 
+	// same status as last time, nothing to parse
+	if (!m_statusEntries.isEmpty() && dataHash == m_statusDataHash)
+	{
+		succeed();
+		return;
+	}
+	QString errorMsg;
+	if (!loadStatus(data, dataHash, &errorMsg))
+	{
+		fail(errorMsg);
+		return;
+	}
+	succeed();
+}
+
+bool StatusChecker::loadStatus(const QByteArray &data, const QString &dataHash,
+							   QString *errorMsg)
+{
+	m_statusEntries.clear();
+	m_statusDataHash.clear();
+
 	QJsonParseError jsonError;
 	QJsonDocument jsonDoc = QJsonDocument::fromJson(data, &jsonError);
 
 	if (jsonError.error != QJsonParseError::NoError)
 	{
-		fail("Error parsing status JSON:" + jsonError.errorString());
-		return;
+		*errorMsg = "Error parsing status JSON:" + jsonError.errorString();
+		return false;
 	}
 
 	if (!jsonDoc.isArray())
 	{
-		fail("Error parsing status JSON: JSON root is not an array");
-		return;
+		*errorMsg = "Error parsing status JSON: JSON root is not an array";
+		return false;
 	}
 
 	QJsonArray root = jsonDoc.array();
@@ -96,13 +132,15 @@ void StatusChecker::statusDownloadFinished()
 			}
 			else
 			{
-				fail("Malformed status JSON: expected status type to be a string.");
-				return;
+				*errorMsg = "Malformed status JSON: expected status type to be a string.";
+				return false;
 			}
 		}
 	}
 
-	succeed();
+	m_statusDataHash = dataHash;
+	ByteArrayDownload::markParsed(URLConstants::MOJANG_STATUS_URL, dataHash);
+	return true;
 }
 
 void StatusChecker::statusDownloadFailed()
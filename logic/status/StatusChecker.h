@@ -47,8 +47,13 @@ protected slots:
 	void statusDownloadFailed();
 
 protected:
+	/// reads the status entries, and remembers the JSON as parsed for the next start
+	bool loadStatus(const QByteArray &data, const QString &dataHash, QString *errorMsg);
+
 	QMap<QString, QString> m_prevEntries;
 	QMap<QString, QString> m_statusEntries;
+	/// MD5 of the status JSON m_statusEntries was read from
+	QString m_statusDataHash;
 	NetJobPtr m_statusNetJob;
 	QString m_lastLoadError;
 
@@ -33,6 +33,8 @@ void Task::setProgress(int new_progress)
 void Task::start()
 {
 	m_running = true;
+	if (m_trace)
+		m_traceSpan = m_trace->begin(metaObject()->className(), "task");
 	emit started();
 	executeTask();
 }
@@ -42,6 +44,8 @@ void Task::emitFailed(QString reason)
 	m_running = false;
 	m_succeeded = false;
 	m_failReason = reason;
+	if (m_trace)
+		m_trace->end(m_traceSpan);
 	QLOG_ERROR() << "Task failed: " << reason;
 	emit failed(reason);
 }
@@ -51,6 +55,8 @@ void Task::emitSucceeded()
 	if (!m_running) { return; } // Don't succeed twice.
 	m_running = false;
 	m_succeeded = true;
+	if (m_trace)
+		m_trace->end(m_traceSpan);
 	QLOG_INFO() << "Task succeeded";
 	emit succeeded();
 }
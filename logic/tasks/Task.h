@@ -18,6 +18,7 @@
 #include <QObject>
 #include <QString>
 #include "ProgressProvider.h"
+#include "logic/Trace.h"
 
 class Task : public ProgressProvider
 {
@@ -40,6 +41,16 @@ public:
 	 */
 	virtual QString failReason() const;
 
+	/// records the time the task runs for in the given trace
+	void setTrace(TracePtr trace)
+	{
+		m_trace = trace;
+	}
+	TracePtr trace() const
+	{
+		return m_trace;
+	}
+
 public
 slots:
 	virtual void start();
@@ -61,5 +72,7 @@ protected:
 	bool m_running = false;
 	bool m_succeeded = false;
 	QString m_failReason = "";
+	TracePtr m_trace;
+	int m_traceSpan = -1;
 };
 
@@ -13,13 +13,19 @@ class BaseProfiler : public BaseExternalTool
 public:
 	explicit BaseProfiler(InstancePtr instance, QObject *parent = 0);
 
+	/// whether the user needs a chance to set up the profiler before the game starts
+	virtual bool isInteractive() const
+	{
+		return true;
+	}
+
 public
 slots:
 	void beginProfiling(MinecraftProcess *process);
 	void abortProfiling();
 
 protected:
-	QProcess *m_profilerProcess;
+	QProcess *m_profilerProcess = nullptr;
 
 	virtual void beginProfilingImpl(MinecraftProcess *process) = 0;
 	virtual void abortProfilingImpl();
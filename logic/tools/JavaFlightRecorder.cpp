@@ -0,0 +1,238 @@
+#include "JavaFlightRecorder.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMap>
+#include <QStandardPaths>
+
+#include "logic/settings/SettingsObject.h"
+#include "logic/BaseInstance.h"
+#include "MultiMC.h"
+
+// how often the heap and threads are sampled while the game runs
+static const int SAMPLE_INTERVAL_MS = 10000;
+
+JavaFlightRecorder::JavaFlightRecorder(InstancePtr instance, QObject *parent)
+	: BaseProfiler(instance, parent)
+{
+	m_sampleTimer.setInterval(SAMPLE_INTERVAL_MS);
+	connect(&m_sampleTimer, SIGNAL(timeout()), SLOT(sample()));
+}
+
+QProcess *JavaFlightRecorder::runJcmd(const QStringList &command)
+{
+	QProcess *jcmd = new QProcess(this);
+	jcmd->setProcessChannelMode(QProcess::MergedChannels);
+	jcmd->setProgram(MMC->settings()->get("JcmdPath").toString());
+	jcmd->setArguments(QStringList() << QString::number(m_pid) << command);
+	return jcmd;
+}
+
+void JavaFlightRecorder::beginProfilingImpl(MinecraftProcess *process)
+{
+	m_pid = pid(process);
+	connect(this, &JavaFlightRecorder::log, process, &MinecraftProcess::log);
+	connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), SLOT(gameEnded()));
+
+	QString fileName = QString("recording-%1.jfr")
+						   .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd_HH-mm-ss"));
+	m_recordingPath = QDir(m_instance->instanceRoot()).absoluteFilePath(fileName);
+
+	// Oracle Java 7 and 8 refuse JFR.start until the commercial features are unlocked.
+	// Newer JVMs don't need this and answer with a warning or an error, which is ignored.
+	QProcess *jcmd = runJcmd(QStringList() << "VM.unlock_commercial_features");
+	connect(jcmd, SIGNAL(finished(int, QProcess::ExitStatus)),
+			SLOT(commercialFeaturesUnlocked()));
+	m_profilerProcess = jcmd;
+	jcmd->start();
+}
+
+void JavaFlightRecorder::commercialFeaturesUnlocked()
+{
+	if (!m_profilerProcess)
+	{
+		// aborted
+		return;
+	}
+	m_profilerProcess->deleteLater();
+	m_profilerProcess = 0;
+
+	// the JVM writes the recording itself when it exits, so nothing is lost if it crashes
+	QProcess *jcmd = runJcmd(QStringList() << "JFR.start"
+										   << "name=MultiMC"
+										   << "settings=profile"
+										   << "dumponexit=true"
+										   << QString("filename=\"%1\"").arg(m_recordingPath));
+	connect(jcmd, SIGNAL(finished(int, QProcess::ExitStatus)),
+			SLOT(recordingStarted(int, QProcess::ExitStatus)));
+	m_profilerProcess = jcmd;
+	jcmd->start();
+}
+
+void JavaFlightRecorder::recordingStarted(int exit, QProcess::ExitStatus status)
+{
+	if (!m_profilerProcess)
+	{
+		// aborted
+		return;
+	}
+	QString output = QString::fromLocal8Bit(m_profilerProcess->readAll()).trimmed();
+	m_profilerProcess->deleteLater();
+	m_profilerProcess = 0;
+
+	// jcmd reports failed commands on its output, with a successful exit code
+	// e.g. "Java Flight Recorder not enabled. Use VM.unlock_commercial_features to enable."
+	if (output.contains("unlock_commercial_features") ||
+		output.contains("UnlockCommercialFeatures"))
+	{
+		emit abortLaunch(tr("Couldn't start the flight recording: this Java requires the "
+							"commercial features to be unlocked, and unlocking them failed. "
+							"Add -XX:+UnlockCommercialFeatures to the JVM arguments of the "
+							"instance and try again."));
+		return;
+	}
+	if (exit != 0 || status == QProcess::CrashExit || !output.contains("Started recording"))
+	{
+		emit abortLaunch(tr("Couldn't start the flight recording:\n%1").arg(output));
+		return;
+	}
+	emit log(tr("Flight recording started, it will be saved to %1").arg(m_recordingPath),
+			 MessageLevel::MultiMC);
+	m_sampleTimer.start();
+	emit readyToLaunch(tr("Flight recording started"));
+}
+
+void JavaFlightRecorder::sample()
+{
+	// the last sample is still running, the JVM is probably busy
+	if (m_sampleProcess)
+		return;
+
+	m_sampleProcess = runJcmd(QStringList() << "GC.heap_info");
+	connect(m_sampleProcess, SIGNAL(finished(int, QProcess::ExitStatus)),
+			SLOT(heapSampled(int, QProcess::ExitStatus)));
+	m_sampleProcess->start();
+}
+
+void JavaFlightRecorder::heapSampled(int exit, QProcess::ExitStatus status)
+{
+	QString output = QString::fromLocal8Bit(m_sampleProcess->readAll());
+	m_sampleProcess->deleteLater();
+	m_sampleProcess = nullptr;
+	if (exit != 0 || status == QProcess::CrashExit)
+	{
+		emit log(tr("Heap sample failed: %1").arg(output.trimmed()), MessageLevel::Warning);
+		return;
+	}
+
+	// only the summary lines of each heap area, e.g. "Metaspace used 12345K, ..."
+	for (auto line : output.split('\n'))
+	{
+		line = line.simplified();
+		if (line.contains("used"))
+			emit log("JFR heap: " + line, MessageLevel::Info);
+	}
+
+	m_sampleProcess = runJcmd(QStringList() << "Thread.print");
+	connect(m_sampleProcess, SIGNAL(finished(int, QProcess::ExitStatus)),
+			SLOT(threadsSampled(int, QProcess::ExitStatus)));
+	m_sampleProcess->start();
+}
+
+void JavaFlightRecorder::threadsSampled(int exit, QProcess::ExitStatus status)
+{
+	QString output = QString::fromLocal8Bit(m_sampleProcess->readAll());
+	m_sampleProcess->deleteLater();
+	m_sampleProcess = nullptr;
+	if (exit != 0 || status == QProcess::CrashExit)
+	{
+		emit log(tr("Thread sample failed: %1").arg(output.trimmed()), MessageLevel::Warning);
+		return;
+	}
+
+	// the full dump is far too long for the console, count the threads per state instead
+	const QString stateMarker = "java.lang.Thread.State: ";
+	int total = 0;
+	QMap<QString, int> states;
+	for (auto line : output.split('\n'))
+	{
+		if (line.startsWith('"'))
+		{
+			total++;
+			continue;
+		}
+		int index = line.indexOf(stateMarker);
+		if (index != -1)
+		{
+			QString state = line.mid(index + stateMarker.size()).section(' ', 0, 0).trimmed();
+			states[state]++;
+		}
+	}
+	QString summary = QString("JFR threads: total=%1").arg(total);
+	for (auto it = states.constBegin(); it != states.constEnd(); ++it)
+	{
+		summary += QString(" %1=%2").arg(it.key()).arg(it.value());
+	}
+	emit log(summary, MessageLevel::Info);
+}
+
+void JavaFlightRecorder::gameEnded()
+{
+	m_sampleTimer.stop();
+	if (QFileInfo(m_recordingPath).exists())
+	{
+		emit log(tr("Flight recording saved to %1").arg(m_recordingPath), MessageLevel::MultiMC);
+	}
+	else
+	{
+		emit log(tr("The game didn't write the flight recording to %1").arg(m_recordingPath),
+				 MessageLevel::Warning);
+	}
+	deleteLater();
+}
+
+void JavaFlightRecorderFactory::registerSettings(std::shared_ptr<SettingsObject> settings)
+{
+	QString defaultValue = QStandardPaths::findExecutable("jcmd");
+	if (defaultValue.isNull())
+	{
+		// jcmd comes with the JDK, next to java itself
+		QFileInfo java(settings->get("JavaPath").toString());
+		QString sibling = java.absoluteDir().absoluteFilePath("jcmd");
+#ifdef Q_OS_WIN
+		sibling += ".exe";
+#endif
+		if (java.isAbsolute() && QFileInfo(sibling).isExecutable())
+		{
+			defaultValue = sibling;
+		}
+	}
+	settings->registerSetting("JcmdPath", defaultValue);
+}
+
+BaseExternalTool *JavaFlightRecorderFactory::createTool(InstancePtr instance, QObject *parent)
+{
+	return new JavaFlightRecorder(instance, parent);
+}
+
+bool JavaFlightRecorderFactory::check(QString *error)
+{
+	return check(MMC->settings()->get("JcmdPath").toString(), error);
+}
+
+bool JavaFlightRecorderFactory::check(const QString &path, QString *error)
+{
+	if (path.isEmpty())
+	{
+		*error = QObject::tr("Empty path");
+		return false;
+	}
+	QFileInfo info(path);
+	if (!QDir::isAbsolutePath(path) || !info.isExecutable() || !info.fileName().startsWith("jcmd"))
+	{
+		*error = QObject::tr("Invalid path to jcmd");
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "BaseProfiler.h"
+#include "logic/MinecraftProcess.h"
+
+#include <QTimer>
+
+/*!
+ * Records the game with the JDK's own Flight Recorder, driven by jcmd.
+ *
+ * While the game runs, the heap and thread states are sampled and written to the console.
+ * The recording itself is written into the instance folder when the game exits.
+ */
+class JavaFlightRecorder : public BaseProfiler
+{
+	Q_OBJECT
+public:
+	JavaFlightRecorder(InstancePtr instance, QObject *parent = 0);
+
+	bool isInteractive() const override
+	{
+		return false;
+	}
+
+signals:
+	void log(QString text, MessageLevel::Enum level);
+
+protected:
+	void beginProfilingImpl(MinecraftProcess *process);
+
+private
+slots:
+	void commercialFeaturesUnlocked();
+	void recordingStarted(int exit, QProcess::ExitStatus status);
+	void sample();
+	void heapSampled(int exit, QProcess::ExitStatus status);
+	void threadsSampled(int exit, QProcess::ExitStatus status);
+	void gameEnded();
+
+private:
+	QProcess *runJcmd(const QStringList &command);
+
+	qint64 m_pid = 0;
+	QString m_recordingPath;
+	QTimer m_sampleTimer;
+	QProcess *m_sampleProcess = nullptr;
+};
+
+class JavaFlightRecorderFactory : public BaseProfilerFactory
+{
+public:
+	QString name() const override { return "Java Flight Recorder"; }
+	void registerSettings(std::shared_ptr<SettingsObject> settings) override;
+	BaseExternalTool *createTool(InstancePtr instance, QObject *parent = 0) override;
+	bool check(QString *error) override;
+	bool check(const QString &path, QString *error) override;
+};
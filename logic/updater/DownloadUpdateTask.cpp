@@ -246,6 +246,15 @@ bool DownloadUpdateTask::parseVersionInfo(const QByteArray &data, VersionFileLis
 			}
 		}
 
+		QJsonArray deltaArray = fileObj.value("Deltas").toArray();
+		for (QJsonValue val : deltaArray)
+		{
+			QJsonObject deltaObj = val.toObject();
+			file.deltas.append(FileDelta{deltaObj.value("BaseMD5").toString(),
+										 deltaObj.value("Url").toString(),
+										 deltaObj.value("MD5").toString()});
+		}
+
 		QLOG_DEBUG() << "Loaded info for" << file.path;
 
 		list->append(file);
@@ -391,50 +400,80 @@ DownloadUpdateTask::processFileLists(NetJob *job,
 		// if it's the updater we want to treat it separately
 		bool isUpdater = entry.path.endsWith("updater") || entry.path.endsWith("updater.exe");
 
-		// Go through the sources list and find one to use.
-		// TODO: Make a NetAction that takes a source list and tries each of them until one
-		// works. For now, we'll just use the first http one.
-		for (FileSource source : entry.sources)
+		// If there's a delta from exactly the file we have, fetch that instead of the whole
+		// file. The updater applies it to the installed file.
+		if (!isUpdater && !fileMD5.isEmpty())
 		{
-			if (source.type == "http")
+			bool patched = false;
+			for (FileDelta delta : entry.deltas)
 			{
-				QLOG_DEBUG() << "Will download" << entry.path << "from" << source.url;
+				if (delta.baseMd5 != fileMD5)
+					continue;
+				QLOG_DEBUG() << "Will download delta for" << entry.path << "from" << delta.url;
+				QString dlPath = PathCombine(m_updateFilesDir.path(),
+											 QString(entry.path).replace("/", "_") + ".delta");
+				auto download = MD5EtagDownload::make(delta.url, dlPath);
+				download->m_expected_md5 = delta.md5;
+				job->addNetAction(download);
+				ops.append(UpdateOperation::PatchOp(dlPath, entry.path, entry.mode));
+				m_pendingDeltas.insert(dlPath, PendingDelta{entry, delta});
+				patched = true;
+				break;
+			}
+			if (patched)
+				continue;
+		}
 
-				// Download it to updatedir/<filepath>-<md5> where filepath is the file's
-				// path with slashes replaced by underscores.
-				QString dlPath =
-					PathCombine(m_updateFilesDir.path(), QString(entry.path).replace("/", "_"));
+		addFileDownload(job, entry, isUpdater, ops);
+	}
+	return true;
+}
 
-				if (isUpdater)
+void DownloadUpdateTask::addFileDownload(NetJob *job, const VersionFileEntry &entry,
+										 bool isUpdater, UpdateOperationList &ops)
+{
+	// Go through the sources list and find one to use.
+	// TODO: Make a NetAction that takes a source list and tries each of them until one
+	// works. For now, we'll just use the first http one.
+	for (FileSource source : entry.sources)
+	{
+		if (source.type == "http")
+		{
+			QLOG_DEBUG() << "Will download" << entry.path << "from" << source.url;
+
+			// Download it to updatedir/<filepath>-<md5> where filepath is the file's
+			// path with slashes replaced by underscores.
+			QString dlPath =
+				PathCombine(m_updateFilesDir.path(), QString(entry.path).replace("/", "_"));
+
+			if (isUpdater)
+			{
+				if(BuildConfig.UPDATER_FORCE_LOCAL)
 				{
-					if(BuildConfig.UPDATER_FORCE_LOCAL)
-					{
-						QLOG_DEBUG() << "Skipping updater download and using local version.";
-					}
-					else
-					{
-						auto cache_entry = MMC->metacache()->resolveEntry("root", entry.path);
-						QLOG_DEBUG() << "Updater will be in " << cache_entry->getFullPath();
-						// force check.
-						cache_entry->stale = true;
-
-						auto download = CacheDownload::make(QUrl(source.url), cache_entry);
-						job->addNetAction(download);
-					}
+					QLOG_DEBUG() << "Skipping updater download and using local version.";
 				}
 				else
 				{
-					// We need to download the file to the updatefiles folder and add a task
-					// to copy it to its install path.
-					auto download = MD5EtagDownload::make(source.url, dlPath);
-					download->m_expected_md5 = entry.md5;
+					auto cache_entry = MMC->metacache()->resolveEntry("root", entry.path);
+					QLOG_DEBUG() << "Updater will be in " << cache_entry->getFullPath();
+					// force check.
+					cache_entry->stale = true;
+
+					auto download = CacheDownload::make(QUrl(source.url), cache_entry);
 					job->addNetAction(download);
-					ops.append(UpdateOperation::CopyOp(dlPath, entry.path, entry.mode));
 				}
 			}
+			else
+			{
+				// We need to download the file to the updatefiles folder and add a task
+				// to copy it to its install path.
+				auto download = MD5EtagDownload::make(source.url, dlPath);
+				download->m_expected_md5 = entry.md5;
+				job->addNetAction(download);
+				ops.append(UpdateOperation::CopyOp(dlPath, entry.path, entry.mode));
+			}
 		}
 	}
-	return true;
 }
 
 bool DownloadUpdateTask::writeInstallScript(UpdateOperationList &opsList, QString scriptFile)
@@ -478,6 +517,23 @@ bool DownloadUpdateTask::writeInstallScript(UpdateOperationList &opsList, QStrin
 		}
 		break;
 
+		case UpdateOperation::OP_PATCH:
+		{
+			// Patch the installed file.
+			QDomElement patch = doc.createElement("patch");
+			QDomElement path = doc.createElement("dest");
+			QDomElement mode = doc.createElement("mode");
+			patch.appendChild(doc.createTextNode(op.file));
+			path.appendChild(doc.createTextNode(op.dest));
+			mode.appendChild(doc.createTextNode("0" + QString::number(op.mode, 8)));
+			file.appendChild(patch);
+			file.appendChild(path);
+			file.appendChild(mode);
+			installFiles.appendChild(file);
+			QLOG_DEBUG() << "Will patch file " << op.dest << " with " << op.file;
+		}
+		break;
+
 		case UpdateOperation::OP_DELETE:
 		{
 			// Delete the file.
@@ -527,14 +583,91 @@ bool DownloadUpdateTask::fixPathForOSX(QString &path)
 
 void DownloadUpdateTask::fileDownloadFinished()
 {
-	emitSucceeded();
+	checkDeltas();
 }
 
 void DownloadUpdateTask::fileDownloadFailed()
 {
-	// TODO: Give more info about the failure.
-	QLOG_ERROR() << "Failed to download update files.";
-	emitFailed(tr("Failed to download update files."));
+	// deltas that failed to download are replaced by the whole files
+	auto job = qobject_cast<NetJob *>(sender());
+	for (auto url : job->getFailedFiles())
+	{
+		bool isDelta = false;
+		for (auto pending : m_pendingDeltas)
+		{
+			if (QUrl(pending.delta.url).toString() == url)
+			{
+				isDelta = true;
+				break;
+			}
+		}
+		if (!isDelta)
+		{
+			// TODO: Give more info about the failure.
+			QLOG_ERROR() << "Failed to download update files.";
+			emitFailed(tr("Failed to download update files."));
+			return;
+		}
+	}
+	checkDeltas();
+}
+
+void DownloadUpdateTask::checkDeltas()
+{
+	NetJob *fallbackJob = nullptr;
+	for (auto iter = m_pendingDeltas.begin(); iter != m_pendingDeltas.end(); iter++)
+	{
+		QString md5;
+		QFile deltaFile(iter.key());
+		if (deltaFile.open(QFile::ReadOnly))
+		{
+			md5 = QCryptographicHash::hash(deltaFile.readAll(), QCryptographicHash::Md5).toHex();
+			deltaFile.close();
+		}
+		if (md5 == iter->delta.md5)
+		{
+			continue;
+		}
+		QLOG_WARN() << "The delta" << iter->delta.url << "didn't download or doesn't match its"
+					<< "checksum. Downloading all of" << iter->entry.path << "instead.";
+		deltaFile.remove();
+		for (int i = 0; i < m_operationList.size(); i++)
+		{
+			auto &op = m_operationList[i];
+			if (op.type == UpdateOperation::OP_PATCH && op.file == iter.key())
+			{
+				m_operationList.removeAt(i);
+				break;
+			}
+		}
+		if (!fallbackJob)
+		{
+			fallbackJob = new NetJob("Update Files");
+		}
+		addFileDownload(fallbackJob, iter->entry, false, m_operationList);
+	}
+	m_pendingDeltas.clear();
+
+	if (!fallbackJob)
+	{
+		emitSucceeded();
+		return;
+	}
+	if (!writeInstallScript(m_operationList,
+							PathCombine(m_updateFilesDir.path(), "file_list.xml")))
+	{
+		delete fallbackJob;
+		return;
+	}
+	QObject::connect(fallbackJob, &NetJob::succeeded, this,
+					 &DownloadUpdateTask::fileDownloadFinished);
+	QObject::connect(fallbackJob, &NetJob::progress, this,
+					 &DownloadUpdateTask::fileDownloadProgressChanged);
+	QObject::connect(fallbackJob, &NetJob::failed, this,
+					 &DownloadUpdateTask::fileDownloadFailed);
+	setStatus(tr("Downloading %1 update files.").arg(QString::number(fallbackJob->size())));
+	m_fallbackNetJob.reset(fallbackJob);
+	fallbackJob->start();
 }
 
 void DownloadUpdateTask::fileDownloadProgressChanged(qint64 current, qint64 total)
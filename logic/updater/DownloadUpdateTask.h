@@ -56,6 +56,18 @@ public:
 	};
 	typedef QList<FileSource> FileSourceList;
 
+	/*!
+	 * Struct that describes an entry in a VersionFileEntry's `Deltas` list.
+	 * A delta turns the file with the given MD5 sum into the new version of the file.
+	 */
+	struct FileDelta
+	{
+		QString baseMd5;
+		QString url;
+		QString md5;
+	};
+	typedef QList<FileDelta> FileDeltaList;
+
 	/*!
 	 * Structure that describes an entry in a GoUpdate version's `Files` list.
 	 */
@@ -65,6 +77,7 @@ public:
 		int mode;
 		FileSourceList sources;
 		QString md5;
+		FileDeltaList deltas;
 	};
 	typedef QList<VersionFileEntry> VersionFileList;
 
@@ -77,6 +90,7 @@ public:
 		static UpdateOperation MoveOp(QString fsource, QString fdest, int fmode=0644) { return UpdateOperation{OP_MOVE, fsource, fdest, fmode}; }
 		static UpdateOperation DeleteOp(QString file) { return UpdateOperation{OP_DELETE, file, "", 0644}; }
 		static UpdateOperation ChmodOp(QString file, int fmode) { return UpdateOperation{OP_CHMOD, file, "", fmode}; }
+		static UpdateOperation PatchOp(QString fpatch, QString fdest, int fmode=0644) { return UpdateOperation{OP_PATCH, fpatch, fdest, fmode}; }
 
 		//! Specifies the type of operation that this is.
 		enum Type
@@ -85,9 +99,11 @@ public:
 			OP_DELETE,
 			OP_MOVE,
 			OP_CHMOD,
+			OP_PATCH,
 		} type;
 
 		//! The file to operate on. If this is a DELETE or CHMOD operation, this is the file that will be modified.
+		//! If this is a PATCH operation, this is the delta to apply to the destination file.
 		QString file;
 
 		//! The destination file. If this is a DELETE or CHMOD operation, this field will be ignored.
@@ -158,6 +174,17 @@ protected:
 	 */
 	virtual bool processFileLists(NetJob *job, const VersionFileList &currentVersion, const VersionFileList &newVersion, UpdateOperationList &ops);
 
+	/*!
+	 * Adds the download of the whole file to the job, and the operation that installs it.
+	 */
+	void addFileDownload(NetJob *job, const VersionFileEntry &entry, bool isUpdater, UpdateOperationList &ops);
+
+	/*!
+	 * Checks the downloaded deltas against their MD5 sums. The files of deltas that failed
+	 * to download or don't match are downloaded whole instead, then the task succeeds.
+	 */
+	void checkDeltas();
+
 	/*!
 	 * Calls \see processFileLists to populate the \see m_operationList and a NetJob, and then executes
 	 * the NetJob to fetch all needed files
@@ -180,6 +207,18 @@ protected:
 	//! Network job for downloading update files.
 	NetJobPtr m_filesNetJob;
 
+	//! Network job for downloading the whole files of deltas that turned out bad.
+	NetJobPtr m_fallbackNetJob;
+
+	//! A delta that is downloaded, and the file to download instead if it turns out bad.
+	struct PendingDelta
+	{
+		VersionFileEntry entry;
+		FileDelta delta;
+	};
+	//! The deltas being downloaded, by where they are downloaded to.
+	QMap<QString, PendingDelta> m_pendingDeltas;
+
 	// Version ID and repo URL for the new version.
 	int m_nVersionId;
 	QString m_nRepoUrl;
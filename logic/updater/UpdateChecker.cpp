@@ -93,7 +93,7 @@ void UpdateChecker::checkForUpdate(bool notifyNoUpdate)
 	QUrl indexUrl = QUrl(m_repoUrl).resolved(QUrl("index.json"));
 
 	auto job = new NetJob("GoUpdate Repository Index");
-	job->addNetAction(ByteArrayDownload::make(indexUrl));
+	job->addNetAction(ByteArrayDownload::makeCached(indexUrl));
 	connect(job, &NetJob::succeeded, [this, notifyNoUpdate]()
 	{ updateCheckFinished(notifyNoUpdate); });
 	connect(job, SIGNAL(failed()), SLOT(updateCheckFailed()));
@@ -184,7 +184,7 @@ void UpdateChecker::updateChanList(bool notifyNoUpdate)
 
 	m_chanListLoading = true;
 	NetJob *job = new NetJob("Update System Channel List");
-	job->addNetAction(ByteArrayDownload::make(QUrl(m_channelListUrl)));
+	job->addNetAction(ByteArrayDownload::makeCached(QUrl(m_channelListUrl)));
 	connect(job, &NetJob::succeeded, [this, notifyNoUpdate]()
 	{ chanListDownloadFinished(notifyNoUpdate); });
 	QObject::connect(job, &NetJob::failed, this, &UpdateChecker::chanListDownloadFailed);
@@ -9,6 +9,7 @@ int main_gui(MultiMC &app)
 	mainWin.restoreState(QByteArray::fromBase64(MMC->settings()->get("MainWindowState").toByteArray()));
 	mainWin.restoreGeometry(QByteArray::fromBase64(MMC->settings()->get("MainWindowGeometry").toByteArray()));
 	mainWin.show();
+	app.finishStartup();
 	mainWin.checkMigrateLegacyAssets();
 	mainWin.checkSetDefaultJava();
 	mainWin.checkInstancePathForProblems();
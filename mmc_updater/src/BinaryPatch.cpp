@@ -0,0 +1,229 @@
+#include "BinaryPatch.h"
+
+#include <stdint.h>
+#include <xz.h>
+
+static const char PATCH_MAGIC[] = "MMCDIFF1";
+static const size_t PATCH_MAGIC_LENGTH = 8;
+static const uint64_t CONTROL_ENTRY_LENGTH = 24;
+
+namespace
+{
+	class PatchReader
+	{
+		public:
+			explicit PatchReader(const std::string& data)
+			: m_data(data)
+			, m_pos(0)
+			{}
+
+			uint64_t readUInt(int bytes) throw (std::string)
+			{
+				const unsigned char* data = take(static_cast<size_t>(bytes));
+				uint64_t value = 0;
+				for (int i = bytes - 1; i >= 0; i--)
+				{
+					value = (value << 8) | data[i];
+				}
+				return value;
+			}
+
+			int64_t readInt64() throw (std::string)
+			{
+				return static_cast<int64_t>(readUInt(8));
+			}
+
+			const unsigned char* take(size_t length) throw (std::string)
+			{
+				if (length > m_data.size() - m_pos)
+				{
+					throw std::string("Patch is truncated");
+				}
+				const unsigned char* data = reinterpret_cast<const unsigned char*>(m_data.data()) + m_pos;
+				m_pos += length;
+				return data;
+			}
+
+			bool atEnd() const
+			{
+				return m_pos == m_data.size();
+			}
+
+			size_t remaining() const
+			{
+				return m_data.size() - m_pos;
+			}
+
+		private:
+			const std::string& m_data;
+			size_t m_pos;
+	};
+
+	/** Decompresses one xz compressed block of the delta.
+	  * Throws if it is broken or would become larger than @p limit.
+	  */
+	std::string decompress(const unsigned char* data, size_t length, uint64_t limit,
+	                       const std::string& name) throw (std::string)
+	{
+		static bool crcReady = false;
+		if (!crcReady)
+		{
+			xz_crc32_init();
+			xz_crc64_init();
+			crcReady = true;
+		}
+		xz_dec* decoder = xz_dec_init(XZ_DYNALLOC,1 << 26);
+		if (!decoder)
+		{
+			throw std::string("Out of memory while reading the patch");
+		}
+
+		std::string result;
+		unsigned char out[65536];
+		xz_buf buffer;
+		buffer.in = data;
+		buffer.in_pos = 0;
+		buffer.in_size = length;
+		buffer.out = out;
+		buffer.out_size = sizeof(out);
+		xz_ret ret;
+		while (true)
+		{
+			buffer.out_pos = 0;
+			ret = xz_dec_run(decoder,&buffer);
+			result.append(reinterpret_cast<const char*>(out),buffer.out_pos);
+			if (result.size() > limit)
+			{
+				xz_dec_end(decoder);
+				throw "The " + name + " block of the patch is too large";
+			}
+			// only a warning, decoding goes on without checking
+			if (ret == XZ_UNSUPPORTED_CHECK)
+			{
+				continue;
+			}
+			// the stream ended, failed, or needs more input than there is
+			if (ret != XZ_OK || (buffer.in_pos == buffer.in_size && buffer.out_pos < buffer.out_size))
+			{
+				break;
+			}
+		}
+		xz_dec_end(decoder);
+
+		if (ret != XZ_STREAM_END || buffer.in_pos != buffer.in_size)
+		{
+			throw "The " + name + " block of the patch is broken";
+		}
+		return result;
+	}
+}
+
+unsigned int BinaryPatch::crc32(const std::string& data)
+{
+	static uint32_t table[256];
+	static bool tableReady = false;
+	if (!tableReady)
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++)
+			{
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			}
+			table[i] = c;
+		}
+		tableReady = true;
+	}
+	uint32_t crc = 0xFFFFFFFFu;
+	for (size_t i = 0; i < data.size(); i++)
+	{
+		crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+	}
+	return crc ^ 0xFFFFFFFFu;
+}
+
+std::string BinaryPatch::apply(const std::string& base, const std::string& patch) throw (std::string)
+{
+	PatchReader reader(patch);
+	if (std::string(reinterpret_cast<const char*>(reader.take(PATCH_MAGIC_LENGTH)),PATCH_MAGIC_LENGTH) != PATCH_MAGIC)
+	{
+		throw std::string("Not a binary patch");
+	}
+	uint64_t baseSize = reader.readUInt(8);
+	uint64_t newSize = reader.readUInt(8);
+	uint32_t baseCrc = static_cast<uint32_t>(reader.readUInt(4));
+	uint32_t newCrc = static_cast<uint32_t>(reader.readUInt(4));
+	uint64_t controlLength = reader.readUInt(8);
+	uint64_t diffLength = reader.readUInt(8);
+
+	if (baseSize != base.size() || baseCrc != crc32(base))
+	{
+		throw std::string("Patch does not apply to this version of the file");
+	}
+
+	// the compressed blocks follow the header, the extra block takes the rest of the patch
+	const unsigned char* compressedControl = reader.take(static_cast<size_t>(controlLength));
+	const unsigned char* compressedDiff = reader.take(static_cast<size_t>(diffLength));
+	size_t extraLength = reader.remaining();
+	const unsigned char* compressedExtra = reader.take(extraLength);
+
+	// every new byte comes from the diff or the extra block, so they bound what is decompressed.
+	// a control entry adds at least one byte, except for the last one.
+	std::string control = decompress(compressedControl,static_cast<size_t>(controlLength),
+	                                 (newSize + 1) * CONTROL_ENTRY_LENGTH,"control");
+	std::string diff = decompress(compressedDiff,static_cast<size_t>(diffLength),newSize,"diff");
+	std::string extra = decompress(compressedExtra,extraLength,newSize - diff.size(),"extra");
+	if (diff.size() + extra.size() != newSize)
+	{
+		throw std::string("Patch does not produce the announced amount of data");
+	}
+
+	PatchReader controlReader(control);
+	PatchReader diffReader(diff);
+	PatchReader extraReader(extra);
+	std::string result(static_cast<size_t>(newSize),'\0');
+	uint64_t resultPos = 0;
+	int64_t basePos = 0;
+	while (resultPos < newSize)
+	{
+		uint64_t diffBlock = controlReader.readUInt(8);
+		uint64_t extraBlock = controlReader.readUInt(8);
+		int64_t seek = controlReader.readInt64();
+		if (diffBlock > newSize - resultPos ||
+		    extraBlock > newSize - resultPos - diffBlock)
+		{
+			throw std::string("Patch produces more data than announced");
+		}
+
+		// add the diff block to the old data
+		const unsigned char* diffBytes = diffReader.take(static_cast<size_t>(diffBlock));
+		if (basePos < 0 || static_cast<uint64_t>(basePos) + diffBlock > base.size())
+		{
+			throw std::string("Patch reads outside of the old file");
+		}
+		const unsigned char* old = reinterpret_cast<const unsigned char*>(base.data()) + basePos;
+		for (uint64_t i = 0; i < diffBlock; i++)
+		{
+			result[static_cast<size_t>(resultPos + i)] = static_cast<char>(old[i] + diffBytes[i]);
+		}
+		resultPos += diffBlock;
+
+		// the extra block is copied verbatim
+		const unsigned char* extraBytes = extraReader.take(static_cast<size_t>(extraBlock));
+		result.replace(static_cast<size_t>(resultPos),static_cast<size_t>(extraBlock),
+		               reinterpret_cast<const char*>(extraBytes),static_cast<size_t>(extraBlock));
+		resultPos += extraBlock;
+
+		basePos += static_cast<int64_t>(diffBlock) + seek;
+	}
+	if (!controlReader.atEnd())
+	{
+		throw std::string("Unexpected data at the end of the patch");
+	}
+	if (crc32(result) != newCrc)
+	{
+		throw std::string("Patched file has the wrong checksum");
+	}
+	return result;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+
+/** Applies binary deltas between two versions of a file.
+  *
+  * The delta format follows bsdiff.  A control block lists entries, each of which
+  * adds a block of bytes from the diff block to the old file, appends a block of
+  * new bytes from the extra block and then moves the position in the old file.
+  * The three blocks are xz compressed.  The diff block is mostly zeros for
+  * small changes, so it compresses well.
+  * All integers are 64 bit little endian, CRCs are 32 bit little endian:
+  *
+  *  "MMCDIFF1" | old size | new size | old CRC32 | new CRC32
+  *  | compressed control length | compressed diff length
+  *  | control block | diff block | extra block (the rest of the delta)
+  *
+  * The control block holds, until the new file is complete:
+  *  diff length | extra length | old seek
+  */
+class BinaryPatch
+{
+	public:
+		/** Returns the result of applying the delta @p patch to @p base.
+		  *
+		  * Throws a std::string if the delta doesn't belong to @p base, is broken,
+		  * or the result doesn't match the checksum in the delta.
+		  */
+		static std::string apply(const std::string& base, const std::string& patch) throw (std::string);
+
+		static unsigned int crc32(const std::string& data);
+};
@@ -23,6 +23,10 @@
 #include <errno.h>
 #endif
 
+#ifdef PLATFORM_LINUX
+#include <sys/syscall.h>
+#endif
+
 FileUtils::IOException::IOException(const std::string& error)
 {
 	init(errno,error);
@@ -468,6 +472,111 @@ void FileUtils::copyFile(const char* src, const char* dest) throw (IOException)
 #endif
 }
 
+#ifdef PLATFORM_LINUX
+// copy the whole of @p src to @p dest without moving the data through user space.
+// returns false if the kernel cannot do this for these files, so the caller can fall back.
+static bool copyFileRange(const char* src, const char* dest, int mode)
+{
+#ifdef SYS_copy_file_range
+	int srcFd = open(src,O_RDONLY);
+	if (srcFd < 0)
+	{
+		return false;
+	}
+	struct stat fileInfo;
+	if (fstat(srcFd,&fileInfo) != 0)
+	{
+		close(srcFd);
+		return false;
+	}
+	int destFd = open(dest,O_WRONLY | O_CREAT | O_TRUNC,static_cast<mode_t>(mode & 07777));
+	if (destFd < 0)
+	{
+		close(srcFd);
+		return false;
+	}
+	off_t remaining = fileInfo.st_size;
+	bool ok = true;
+	while (remaining > 0)
+	{
+		// copy_file_range may share extents (reflink) on file systems supporting it
+		ssize_t copied = syscall(SYS_copy_file_range,srcFd,nullptr,destFd,nullptr,
+		                         static_cast<size_t>(remaining),0u);
+		if (copied <= 0)
+		{
+			ok = false;
+			break;
+		}
+		remaining -= copied;
+	}
+	close(srcFd);
+	if (close(destFd) != 0)
+	{
+		ok = false;
+	}
+	if (!ok)
+	{
+		unlink(dest);
+	}
+	return ok;
+#else
+	(void)src;
+	(void)dest;
+	(void)mode;
+	return false;
+#endif
+}
+#endif
+
+void FileUtils::linkOrCopyFile(const char* src, const char* dest) throw (IOException)
+{
+#ifdef PLATFORM_UNIX
+	if (link(src,dest) == 0)
+	{
+		return;
+	}
+	if (errno != EXDEV && errno != EPERM && errno != EMLINK && errno != ENOTSUP)
+	{
+		throw IOException("Unable to link " + std::string(src) + " to " + std::string(dest));
+	}
+#ifdef PLATFORM_LINUX
+	if (copyFileRange(src,dest,fileMode(src)))
+	{
+		return;
+	}
+#endif
+#else
+	if (CreateHardLink(dest,src,NULL))
+	{
+		return;
+	}
+#endif
+	copyFile(src,dest);
+}
+
+void FileUtils::syncFileSystem(const char* path) throw (IOException)
+{
+#ifdef PLATFORM_LINUX
+	int fd = open(path,O_RDONLY);
+	if (fd < 0)
+	{
+		throw IOException("Unable to open " + std::string(path));
+	}
+	int result = syncfs(fd);
+	close(fd);
+	if (result != 0)
+	{
+		throw IOException("Unable to flush the file system containing " + std::string(path));
+	}
+#elif defined(PLATFORM_UNIX)
+	(void)path;
+	sync();
+#else
+	// not implemented for Windows
+	(void)path;
+#endif
+}
+
 std::string FileUtils::makeAbsolute(const char* path, const char* basePath)
 {
 	if (isRelative(path))
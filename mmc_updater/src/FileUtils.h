@@ -85,6 +85,19 @@ class FileUtils
 		static void touch(const char* path) throw (IOException);
 		static void copyFile(const char* src, const char* dest) throw (IOException);
 
+		/** Make the contents of @p src available at @p dest, which must not exist yet.
+		  *
+		  * If both are on the same file system, @p dest becomes a hard link to @p src
+		  * and no data is copied.  Otherwise the data is copied inside the kernel where
+		  * the platform allows it, falling back to copyFile().
+		  */
+		static void linkOrCopyFile(const char* src, const char* dest) throw (IOException);
+
+		/** Flush all pending writes on the file system containing @p path to disk.
+		  * On platforms without a per file system flush, all file systems are flushed.
+		  */
+		static void syncFileSystem(const char* path) throw (IOException);
+
 		/** Create all the directories in @p path which do not yet exist.
 		  * @p path may be relative or absolute.
 		  */
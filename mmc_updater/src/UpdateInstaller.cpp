@@ -1,11 +1,37 @@
 #include "UpdateInstaller.h"
 
 #include "AppInfo.h"
+#include "BinaryPatch.h"
 #include "FileUtils.h"
 #include "Log.h"
 #include "ProcessUtils.h"
 #include "UpdateObserver.h"
 
+/** Writes the result of applying the delta at @p patchPath to the file at @p basePath
+  * to @p destPath.
+  */
+static void patchFile(const std::string& basePath, const std::string& patchPath, const std::string& destPath)
+{
+	if (!FileUtils::fileExists(basePath.c_str()))
+	{
+		throw "Patched file does not exist: " + basePath;
+	}
+	if (!FileUtils::fileExists(patchPath.c_str()))
+	{
+		throw "Patch does not exist: " + patchPath;
+	}
+	std::string result;
+	try
+	{
+		result = BinaryPatch::apply(FileUtils::readFile(basePath.c_str()),FileUtils::readFile(patchPath.c_str()));
+	}
+	catch (const std::string& error)
+	{
+		throw error + " (" + patchPath + " for " + basePath + ")";
+	}
+	FileUtils::writeFile(destPath.c_str(),result.data(),static_cast<int>(result.size()));
+}
+
 void UpdateInstaller::setWaitPid(PLATFORM_PID pid)
 {
 	m_waitPid = pid;
@@ -193,12 +219,23 @@ void UpdateInstaller::run() throw ()
 
 		try
 		{
+			// put the new files next to their destinations first, so that
+			// the installation itself only consists of renames
+			LOG(Info,"Staging new and updated files");
+			stageFiles();
+
 			LOG(Info,"Installing new and updated files");
 			installFiles();
 
 			LOG(Info,"Uninstalling removed files");
 			uninstallFiles();
 
+			// make sure the new files are on disk before the backups are gone
+			if (!m_dryRun)
+			{
+				FileUtils::syncFileSystem(m_installDir.c_str());
+			}
+
 			LOG(Info,"Removing backups");
 			removeBackups();
 
@@ -260,6 +297,16 @@ void UpdateInstaller::cleanup()
 void UpdateInstaller::revert()
 {
 	LOG(Info,"Reverting installation!");
+	std::list<std::pair<std::string,std::string> >::const_iterator stagedIter = m_staged.begin();
+	for (;stagedIter != m_staged.end();stagedIter++)
+	{
+		const std::string& stagedFile = stagedIter->second;
+		if (!m_dryRun && FileUtils::fileExists(stagedFile.c_str()))
+		{
+			LOG(Info,"Removing staged file " + stagedFile);
+			FileUtils::removeFile(stagedFile.c_str());
+		}
+	}
 	std::map<std::string,std::string>::const_iterator iter = m_backups.begin();
 	for (;iter != m_backups.end();iter++)
 	{
@@ -277,16 +324,22 @@ void UpdateInstaller::revert()
 	}
 }
 
-void UpdateInstaller::installFile(const UpdateScriptFile& file)
+void UpdateInstaller::stageFile(const UpdateScriptFile& file)
 {
 	std::string sourceFile = file.source;
 	std::string destPath = file.dest;
 	std::string absDestPath = FileUtils::makeAbsolute(destPath.c_str(), m_installDir.c_str());
+	// staged in the destination directory, so it can be renamed into place later
+	std::string stagedPath = absDestPath + ".new";
 
-	LOG(Info,"Installing file " + sourceFile + " to " + absDestPath);
-
-	// backup the existing file if any
-	backupFile(absDestPath);
+	if (file.patch.empty())
+	{
+		LOG(Info,"Staging file " + sourceFile + " as " + stagedPath);
+	}
+	else
+	{
+		LOG(Info,"Staging patched file " + absDestPath + " as " + stagedPath);
+	}
 
 	// create the target directory if it does not exist
 	std::string destDir = FileUtils::dirname(absDestPath.c_str());
@@ -299,37 +352,69 @@ void UpdateInstaller::installFile(const UpdateScriptFile& file)
 		}
 	}
 
-	if (!FileUtils::fileExists(sourceFile.c_str()))
+	if (file.patch.empty() && !FileUtils::fileExists(sourceFile.c_str()))
 	{
 		throw "Source file does not exist: " + sourceFile;
 	}
+	m_staged.push_back(std::make_pair(absDestPath,stagedPath));
 	if(!m_dryRun)
 	{
-		FileUtils::copyFile(sourceFile.c_str(),absDestPath.c_str());
+		// left over from an earlier, interrupted update
+		FileUtils::removeFile(stagedPath.c_str());
+
+		if (file.patch.empty())
+		{
+			FileUtils::linkOrCopyFile(sourceFile.c_str(),stagedPath.c_str());
+		}
+		else
+		{
+			// the installed file is still in place at this point
+			patchFile(absDestPath,file.patch,stagedPath);
+		}
 
 		// set the permissions on the newly extracted file
-		FileUtils::chmod(absDestPath.c_str(),file.permissions);
+		FileUtils::chmod(stagedPath.c_str(),file.permissions);
 	}
 }
 
-void UpdateInstaller::installFiles()
+void UpdateInstaller::stageFiles()
 {
-	LOG(Info,"Installing files.");
+	LOG(Info,"Staging files.");
 	std::vector<UpdateScriptFile>::const_iterator iter = m_script->filesToInstall().begin();
-	int filesInstalled = 0;
+	int filesStaged = 0;
 	for (;iter != m_script->filesToInstall().end();iter++)
 	{
-		installFile(*iter);
-		++filesInstalled;
+		stageFile(*iter);
+		++filesStaged;
 		if (m_observer)
 		{
 			int toInstallCount = static_cast<int>(m_script->filesToInstall().size());
-			double percentage = ((1.0 * filesInstalled) / toInstallCount) * 100.0;
+			double percentage = ((1.0 * filesStaged) / toInstallCount) * 100.0;
 			m_observer->updateProgress(static_cast<int>(percentage));
 		}
 	}
 }
 
+void UpdateInstaller::installFiles()
+{
+	LOG(Info,"Installing files.");
+	std::list<std::pair<std::string,std::string> >::const_iterator iter = m_staged.begin();
+	for (;iter != m_staged.end();iter++)
+	{
+		const std::string& absDestPath = iter->first;
+		const std::string& stagedPath = iter->second;
+		LOG(Info,"Installing file " + stagedPath + " to " + absDestPath);
+
+		// backup the existing file if any
+		backupFile(absDestPath);
+
+		if(!m_dryRun)
+		{
+			FileUtils::moveFile(stagedPath.c_str(),absDestPath.c_str());
+		}
+	}
+}
+
 void UpdateInstaller::uninstallFiles()
 {
 	LOG(Info,"Uninstalling files.");
@@ -48,9 +48,10 @@ class UpdateInstaller
 		void removeBackups();
 		bool checkAccess();
 
+		void stageFiles();
+		void stageFile(const UpdateScriptFile& file);
 		void installFiles();
 		void uninstallFiles();
-		void installFile(const UpdateScriptFile& file);
 		void backupFile(const std::string& path);
 		void reportError(const std::string& error);
 		void postInstallUpdate();
@@ -68,6 +69,8 @@ class UpdateInstaller
 		UpdateScript* m_script = nullptr;
 		UpdateObserver* m_observer = nullptr;
 		std::map<std::string,std::string> m_backups;
+		// installed path -> staged copy next to it, in script order
+		std::list<std::pair<std::string,std::string> > m_staged;
 		bool m_forceElevated = false;
 		bool m_autoClose = false;
 		bool m_dryRun = false;
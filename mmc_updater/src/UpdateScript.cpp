@@ -75,6 +75,8 @@ UpdateScriptFile UpdateScript::parseFile(const TiXmlElement* element)
 	file.source = elementText(element->FirstChildElement("source"));
 	// The path to install to.
 	file.dest = elementText(element->FirstChildElement("dest"));
+	// The delta to apply to the installed file, instead of copying a source.
+	file.patch = elementText(element->FirstChildElement("patch"));
 
 	std::string modeString = elementText(element->FirstChildElement("mode"));
 	sscanf(modeString.c_str(),"%i",&file.permissions);
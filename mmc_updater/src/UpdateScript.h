@@ -41,6 +41,10 @@ class UpdateScriptFile
 		std::string source;
 		/// The path to copy to.
 		std::string dest;
+		/** Path to a binary delta which turns the installed file at
+		  * dest into the new one.  If set, source is not used.
+		  */
+		std::string patch;
 
 		/** The permissions for this file, specified
 		  * using the standard Unix mode_t values.
@@ -51,6 +55,7 @@ class UpdateScriptFile
 		{
 			return source == other.source &&
 			       dest == other.dest &&
+			       patch == other.patch &&
 			       permissions == other.permissions;
 		}
 };
@@ -0,0 +1,255 @@
+#include "TestBinaryPatch.h"
+
+#include "BinaryPatch.h"
+#include "TestUtils.h"
+
+#include <stdint.h>
+#include <vector>
+
+static void appendUInt(std::string& out, uint64_t value, int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+	{
+		out += static_cast<char>((value >> (8 * i)) & 0xFF);
+	}
+}
+
+static void appendVarInt(std::string& out, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		out += static_cast<char>((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	out += static_cast<char>(value);
+}
+
+static void padToFour(std::string& out, size_t start)
+{
+	while ((out.size() - start) % 4)
+	{
+		out += '\0';
+	}
+}
+
+/** An xz stream holding @p data in uncompressed LZMA2 chunks.
+  * Structurally valid, so the hand-built patches below don't need an encoder.
+  */
+static std::string xzStore(const std::string& data)
+{
+	std::string flags("\0\1",2);
+	std::string out("\xFD" "7zXZ\0",6);
+	out += flags;
+	appendUInt(out,BinaryPatch::crc32(flags),4);
+
+	std::string records;
+	if (!data.empty())
+	{
+		// block header: its size, no sizes given, one filter: LZMA2 with the smallest dictionary
+		std::string header("\x02\x00\x21\x01\x00\x00\x00\x00",8);
+		appendUInt(header,BinaryPatch::crc32(header),4);
+		size_t blockStart = out.size();
+		out += header;
+		for (size_t pos = 0; pos < data.size(); pos += 65536)
+		{
+			std::string chunk = data.substr(pos,65536);
+			out += static_cast<char>(pos == 0 ? 1 : 2);
+			out += static_cast<char>(((chunk.size() - 1) >> 8) & 0xFF);
+			out += static_cast<char>((chunk.size() - 1) & 0xFF);
+			out += chunk;
+		}
+		out += '\0';
+		uint64_t unpaddedSize = out.size() - blockStart + 4;
+		padToFour(out,blockStart);
+		appendUInt(out,BinaryPatch::crc32(data),4);
+		appendVarInt(records,unpaddedSize);
+		appendVarInt(records,data.size());
+	}
+
+	std::string index(1,'\0');
+	appendVarInt(index,data.empty() ? 0 : 1);
+	index += records;
+	padToFour(index,0);
+	appendUInt(index,BinaryPatch::crc32(index),4);
+	out += index;
+
+	std::string backward;
+	appendUInt(backward,index.size() / 4 - 1,4);
+	backward += flags;
+	appendUInt(out,BinaryPatch::crc32(backward),4);
+	out += backward;
+	out += "YZ";
+	return out;
+}
+
+struct ControlEntry
+{
+	uint64_t diffLength;
+	uint64_t extraLength;
+	int64_t seek;
+};
+
+static std::string buildPatch(const std::string& base, const std::string& result,
+                              const std::vector<ControlEntry>& entries,
+                              const std::string& diff, const std::string& extra)
+{
+	std::string control;
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		appendUInt(control,entries[i].diffLength,8);
+		appendUInt(control,entries[i].extraLength,8);
+		appendUInt(control,static_cast<uint64_t>(entries[i].seek),8);
+	}
+	std::string compressedControl = xzStore(control);
+	std::string compressedDiff = xzStore(diff);
+
+	std::string patch = "MMCDIFF1";
+	appendUInt(patch,base.size(),8);
+	appendUInt(patch,result.size(),8);
+	appendUInt(patch,BinaryPatch::crc32(base),4);
+	appendUInt(patch,BinaryPatch::crc32(result),4);
+	appendUInt(patch,compressedControl.size(),8);
+	appendUInt(patch,compressedDiff.size(),8);
+	return patch + compressedControl + compressedDiff + xzStore(extra);
+}
+
+// "Hello old world" -> "Hello NEW world!"
+static std::string testPatch(const std::string& base, const std::string& result)
+{
+	std::vector<ControlEntry> entries;
+	// "Hello " unchanged, then skip "old" in the base
+	ControlEntry first = {6,3,3};
+	entries.push_back(first);
+	// " world" unchanged, then the new "!"
+	ControlEntry second = {6,1,0};
+	entries.push_back(second);
+	return buildPatch(base,result,entries,std::string(12,'\0'),"NEW!");
+}
+
+/** Pseudo random, incompressible contents for a file of @p size bytes. */
+static std::string randomFile(size_t size)
+{
+	std::string data(size,'\0');
+	uint32_t x = 42;
+	for (size_t i = 0; i < size; i++)
+	{
+		x = x * 1103515245u + 12345u;
+		data[i] = static_cast<char>((x >> 16) & 0xFF);
+	}
+	return data;
+}
+
+/** A delta made with bsdiff's layout and xz (python's lzma module, default preset):
+  * from randomFile(65536) to the same file with "MultiMC!" at offset 30000 and "v2" appended.
+  */
+static const unsigned char SMALL_CHANGE_PATCH[] = {
+	0x4d, 0x4d, 0x43, 0x44, 0x49, 0x46, 0x46, 0x31, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbd, 0x61, 0xc9, 0x98, 0x7b, 0x7a, 0xfe, 0x30,
+	0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x98, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0xfd, 0x37, 0x7a, 0x58, 0x5a, 0x00, 0x00, 0x01, 0x69, 0x22, 0xde, 0x36, 0x02, 0x00, 0x21, 0x01,
+	0x16, 0x00, 0x00, 0x00, 0x74, 0x2f, 0xe5, 0xa3, 0xe0, 0x00, 0x17, 0x00, 0x0c, 0x5d, 0x00, 0x00,
+	0x60, 0x02, 0x82, 0x09, 0x26, 0xd9, 0x4b, 0x59, 0x6f, 0x60, 0x00, 0x00, 0x83, 0x8b, 0x49, 0x33,
+	0x00, 0x01, 0x24, 0x18, 0xdb, 0xcc, 0x02, 0xc2, 0x90, 0x42, 0x99, 0x0d, 0x01, 0x00, 0x00, 0x00,
+	0x00, 0x01, 0x59, 0x5a, 0xfd, 0x37, 0x7a, 0x58, 0x5a, 0x00, 0x00, 0x01, 0x69, 0x22, 0xde, 0x36,
+	0x02, 0x00, 0x21, 0x01, 0x16, 0x00, 0x00, 0x00, 0x74, 0x2f, 0xe5, 0xa3, 0xe0, 0xff, 0xff, 0x00,
+	0x59, 0x5d, 0x00, 0x00, 0x6f, 0xfd, 0xff, 0xff, 0xa3, 0xb7, 0xff, 0x47, 0x3e, 0x48, 0x15, 0x72,
+	0x39, 0x61, 0x51, 0xb8, 0x92, 0x28, 0xe6, 0xa3, 0x86, 0x07, 0xf9, 0xee, 0xe4, 0x1e, 0x82, 0xd3,
+	0x2f, 0xc5, 0x3a, 0x3c, 0x01, 0x4b, 0xb1, 0x7e, 0xc9, 0x8a, 0x8a, 0x4d, 0x2f, 0xa3, 0x0d, 0xd9,
+	0x7f, 0xa6, 0xe3, 0x8c, 0x23, 0x11, 0x53, 0xe0, 0x59, 0x18, 0xc5, 0x75, 0x8a, 0xe2, 0x67, 0xf7,
+	0x5d, 0x72, 0xf4, 0x37, 0x05, 0x17, 0xda, 0xcf, 0x7a, 0x4a, 0x6e, 0x1e, 0xb9, 0x46, 0x28, 0xe8,
+	0xe3, 0xd4, 0xf8, 0x62, 0xfd, 0xcd, 0xfe, 0x26, 0x87, 0x4c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x4b, 0xae, 0x74, 0xec, 0x00, 0x01, 0x71, 0x80, 0x80, 0x04, 0x00, 0x00, 0xcc, 0xa4, 0x9d, 0x58,
+	0x3e, 0x30, 0x0d, 0x8b, 0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0x59, 0x5a, 0xfd, 0x37, 0x7a, 0x58,
+	0x5a, 0x00, 0x00, 0x01, 0x69, 0x22, 0xde, 0x36, 0x02, 0x00, 0x21, 0x01, 0x16, 0x00, 0x00, 0x00,
+	0x74, 0x2f, 0xe5, 0xa3, 0x01, 0x00, 0x01, 0x76, 0x32, 0x00, 0x00, 0x00, 0x0f, 0x9d, 0x6b, 0xf0,
+	0x00, 0x01, 0x16, 0x02, 0xd0, 0x61, 0x10, 0xd2, 0x90, 0x42, 0x99, 0x0d, 0x01, 0x00, 0x00, 0x00,
+	0x00, 0x01, 0x59, 0x5a,
+};
+
+void TestBinaryPatch::testApply()
+{
+	std::string base = "Hello old world";
+	std::string result = "Hello NEW world!";
+	TEST_COMPARE(BinaryPatch::apply(base,testPatch(base,result)),result);
+
+	// a patch with a non-zero diff block and no extra block
+	std::vector<ControlEntry> entries;
+	ControlEntry entry = {3,0,0};
+	entries.push_back(entry);
+	std::string patch = buildPatch("abc","bcd",entries,std::string(3,'\1'),std::string());
+	TEST_COMPARE(BinaryPatch::apply("abc",patch),std::string("bcd"));
+}
+
+void TestBinaryPatch::testSmallChange()
+{
+	std::string base = randomFile(65536);
+	std::string result = base;
+	result.replace(30000,8,"MultiMC!");
+	result += "v2";
+
+	std::string patch(reinterpret_cast<const char*>(SMALL_CHANGE_PATCH),sizeof(SMALL_CHANGE_PATCH));
+	TEST_COMPARE(BinaryPatch::apply(base,patch),result);
+	// the point of deltas: a small change makes a small download
+	TEST_COMPARE(patch.size() * 100 < result.size(),true);
+}
+
+void TestBinaryPatch::testWrongBase()
+{
+	std::string result = "Hello NEW world!";
+	std::string patch = testPatch("Hello old world",result);
+	bool failed = false;
+	try
+	{
+		BinaryPatch::apply("Hello odl world",patch);
+	}
+	catch (const std::string&)
+	{
+		failed = true;
+	}
+	TEST_COMPARE(failed,true);
+}
+
+void TestBinaryPatch::testTruncated()
+{
+	std::string base = "Hello old world";
+	std::string patch = testPatch(base,"Hello NEW world!");
+	bool failed = false;
+	try
+	{
+		BinaryPatch::apply(base,patch.substr(0,patch.size() - 4));
+	}
+	catch (const std::string&)
+	{
+		failed = true;
+	}
+	TEST_COMPARE(failed,true);
+}
+
+void TestBinaryPatch::testBrokenBlock()
+{
+	std::string base = "Hello old world";
+	std::string patch = testPatch(base,"Hello NEW world!");
+	// the stored "NEW!" in the extra block no longer matches its checksum
+	patch[patch.rfind("NEW!")] ^= 0x20;
+	bool failed = false;
+	try
+	{
+		BinaryPatch::apply(base,patch);
+	}
+	catch (const std::string&)
+	{
+		failed = true;
+	}
+	TEST_COMPARE(failed,true);
+}
+
+int main(int,char**)
+{
+	TestList<TestBinaryPatch> tests;
+	tests.addTest(&TestBinaryPatch::testApply);
+	tests.addTest(&TestBinaryPatch::testSmallChange);
+	tests.addTest(&TestBinaryPatch::testWrongBase);
+	tests.addTest(&TestBinaryPatch::testTruncated);
+	tests.addTest(&TestBinaryPatch::testBrokenBlock);
+	return TestUtils::runTest(tests);
+}
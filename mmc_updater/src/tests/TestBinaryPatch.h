@@ -0,0 +1,11 @@
+#pragma once
+
+class TestBinaryPatch
+{
+	public:
+		void testApply();
+		void testSmallChange();
+		void testWrongBase();
+		void testTruncated();
+		void testBrokenBlock();
+};
@@ -68,6 +68,28 @@ void TestFileUtils::testStandardDirs()
 	TEST_COMPARE(FileUtils::fileExists(tmpDir.data()), true);
 }
 
+void TestFileUtils::testLinkOrCopyFile()
+{
+	const char* source = "link-or-copy-source";
+	const char* linked = "link-or-copy-dest";
+	std::string copiedPath = FileUtils::tempPath() + "/link-or-copy-dest";
+	FileUtils::removeFile(linked);
+	FileUtils::removeFile(copiedPath.c_str());
+	FileUtils::writeFile(source, "contents", 8);
+
+	// same directory, always on the same file system
+	FileUtils::linkOrCopyFile(source, linked);
+	TEST_COMPARE(FileUtils::readFile(linked), std::string("contents"));
+
+	// possibly on another file system
+	FileUtils::linkOrCopyFile(source, copiedPath.c_str());
+	TEST_COMPARE(FileUtils::readFile(copiedPath.c_str()), std::string("contents"));
+
+	FileUtils::removeFile(source);
+	FileUtils::removeFile(linked);
+	FileUtils::removeFile(copiedPath.c_str());
+}
+
 int main(int,char**)
 {
 	TestList<TestFileUtils> tests;
@@ -75,5 +97,6 @@ int main(int,char**)
 	tests.addTest(&TestFileUtils::testIsRelative);
 	tests.addTest(&TestFileUtils::testSymlinkFileExists);
 	tests.addTest(&TestFileUtils::testStandardDirs);
+	tests.addTest(&TestFileUtils::testLinkOrCopyFile);
 	return TestUtils::runTest(tests);
 }
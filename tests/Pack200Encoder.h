@@ -0,0 +1,147 @@
+#pragma once
+
+#include <QByteArray>
+#include <QPair>
+#include <QVector>
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "depends/pack200/src/defines.h"
+#include "depends/pack200/src/bytes.h"
+#include "depends/pack200/src/utils.h"
+#include "depends/pack200/src/coding.h"
+#include "depends/pack200/src/constants.h"
+
+/*!
+ * The encoding half of the pack200 (B,H) codings, for the tests and benchmarks of the decoder.
+ *
+ * There is no pack200 encoder in the tree, so bands are made from values here, and so are
+ * whole segments as long as they only hold resource files.
+ */
+namespace Pack200Encoder
+{
+/// appends the bytes of the unsigned value uval in the (B,H) coding
+inline void appendBH(QByteArray &out, uint32_t uval, int B, int H)
+{
+	const uint32_t L = 256 - H;
+	for (int i = 1; i < B && uval >= L; i++)
+	{
+		out.append(char(L + (uval - L) % H));
+		uval = (uval - L) / H;
+	}
+	out.append(char(uval));
+}
+
+/*!
+ * count unsigned values for the coding c, as bands have them: shortPercent of them fit a
+ * single byte, the others are anywhere in the range of the coding. Same seed, same values.
+ */
+inline QVector<uint32_t> sample(coding *c, int count, int shortPercent, uint32_t seed)
+{
+	const uint32_t L = c->L();
+	const uint32_t umax = c->isFullRange ? 0xFFFFFFFFu : (uint32_t)c->umax;
+	uint32_t x = seed ? seed : 1;
+	auto next = [&x]()
+	{
+		// xorshift, so the values don't depend on the platform's rand()
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		return x;
+	};
+	QVector<uint32_t> values;
+	values.reserve(count);
+	for (int i = 0; i < count; i++)
+	{
+		uint32_t r = next();
+		if (L > 0 && int(r % 100) < shortPercent)
+			values.append(r % L);
+		else if (umax == 0xFFFFFFFFu)
+			values.append(next());
+		else
+			values.append(next() % (umax + 1));
+	}
+	return values;
+}
+
+/// the band of the values, followed by the zero padding the decoder expects
+inline QByteArray band(coding *c, const QVector<uint32_t> &values, int *length = nullptr)
+{
+	QByteArray out;
+	for (auto value : values)
+	{
+		appendBH(out, value, c->B(), c->H());
+	}
+	if (length)
+		*length = out.size();
+	out.append(QByteArray(C_SLOP, 0));
+	return out;
+}
+
+/*!
+ * appends a band of unsigned values in the (B,H) coding, behind an escape to the default
+ * coding where the first value would look like a coding change
+ */
+inline void appendBand(QByteArray &out, const QVector<uint32_t> &values, int B, int H)
+{
+	const uint32_t L = 256 - H;
+	if (!values.isEmpty() && values[0] >= L && values[0] < L + 256)
+		appendBH(out, L + _meta_default, B, H);
+	for (auto value : values)
+	{
+		appendBH(out, value, B, H);
+	}
+}
+
+typedef QList<QPair<QByteArray, QByteArray>> Files;
+
+/*!
+ * One segment with the given files, stored in that order. Names are plain ASCII and
+ * segments can be concatenated into a pack with several of them.
+ */
+inline QByteArray resourceSegment(const Files &files)
+{
+	// the first Utf8 entry is the empty string, the names follow. None of them share a
+	// prefix, so the DELTA5 band of prefix lengths is all zeroes
+	QVector<uint32_t> prefixes(qMax(0, files.size() - 1), 0);
+	QVector<uint32_t> suffixes, chars, names, sizes;
+	for (int i = 0; i < files.size(); i++)
+	{
+		const QByteArray &name = files[i].first;
+		suffixes.append(name.size());
+		for (char ch : name)
+			chars.append(uchar(ch));
+		names.append(i + 1);
+		sizes.append(files[i].second.size());
+	}
+
+	QByteArray body;
+	appendBH(body, 0, 5, 64); // archive_next_count
+	appendBH(body, 0, 5, 64); // archive_modtime
+	appendBH(body, files.size(), 5, 64);
+	// Utf8, String, Class, Signature, NameandType, Fieldref, Methodref, IMethodref
+	appendBH(body, files.size() + 1, 5, 64);
+	for (int i = 0; i < 7; i++)
+		appendBH(body, 0, 5, 64);
+	for (int i = 0; i < 4; i++)
+		appendBH(body, 0, 5, 64); // ic_count, class minver and majver, class_count
+
+	appendBand(body, prefixes, 5, 64);
+	appendBand(body, suffixes, 5, 64);
+	appendBand(body, chars, 3, 128);
+	// everything about classes is empty, up to the file bands
+	appendBand(body, names, 5, 64);
+	appendBand(body, sizes, 5, 64);
+	for (auto file : files)
+		body.append(file.second);
+
+	QByteArray segment("\xCA\xFE\xD0\x0D", 4);
+	appendBH(segment, JAVA5_PACKAGE_MINOR_VERSION, 5, 64);
+	appendBH(segment, JAVA5_PACKAGE_MAJOR_VERSION, 5, 64);
+	appendBH(segment, AO_HAVE_FILE_HEADERS, 5, 64);
+	appendBH(segment, 0, 5, 64); // archive_size_hi
+	appendBH(segment, body.size(), 5, 64);
+	return segment + body;
+}
+}
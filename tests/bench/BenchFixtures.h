@@ -0,0 +1,187 @@
+#pragma once
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+
+#include <quazip.h>
+#include <quazipfile.h>
+
+/*!
+ * Synthetic fixtures for the benchmarks.
+ *
+ * Everything is generated from the index, so two runs of the same build see identical inputs
+ * and the numbers can be compared between builds.
+ */
+namespace BenchFixtures
+{
+inline QByteArray fakeHash(const QString &seed, QCryptographicHash::Algorithm algo)
+{
+	return QCryptographicHash::hash(seed.toUtf8(), algo).toHex();
+}
+
+inline bool writeFile(const QString &path, const QByteArray &data)
+{
+	QFileInfo info(path);
+	if (!QDir().mkpath(info.absolutePath()))
+		return false;
+	QFile f(path);
+	if (!f.open(QFile::WriteOnly | QFile::Truncate))
+		return false;
+	return f.write(data) == data.size();
+}
+
+inline QByteArray versionJson(int libraries)
+{
+	QJsonObject root;
+	root.insert("id", QString("1.7.10"));
+	root.insert("mainClass", QString("net.minecraft.client.main.Main"));
+	root.insert("minecraftArguments",
+				QString("--username ${auth_player_name} --version ${profile_name}"));
+	root.insert("assets", QString("1.7.10"));
+	root.insert("type", QString("release"));
+	QJsonArray libs;
+	for (int i = 0; i < libraries; i++)
+	{
+		QJsonObject lib;
+		lib.insert("name", QString("org.bench.group%1:library%2:1.%3").arg(i % 7).arg(i).arg(i % 10));
+		libs.append(lib);
+	}
+	root.insert("libraries", libs);
+	return QJsonDocument(root).toJson();
+}
+
+/// creates OneSix instances with a custom.json each, so they load without a version list
+inline void createInstanceTree(const QString &root, int count, int libraries = 20)
+{
+	auto json = versionJson(libraries);
+	for (int i = 0; i < count; i++)
+	{
+		QString dir = QDir(root).absoluteFilePath(QString("instance%1").arg(i));
+		writeFile(dir + "/instance.cfg", QString("InstanceType=OneSix\n"
+												 "name=Bench instance %1\n"
+												 "IntendedVersion=1.7.10\n"
+												 "iconKey=default\n")
+											 .arg(i)
+											 .toUtf8());
+		writeFile(dir + "/custom.json", json);
+	}
+}
+
+/// a mod jar with a mcmod.info and a few class files
+inline bool createModJar(const QString &path, const QString &modid, int classes)
+{
+	QDir().mkpath(QFileInfo(path).absolutePath());
+	QuaZip zip(path);
+	if (!zip.open(QuaZip::mdCreate))
+		return false;
+	QuaZipFile entry(&zip);
+	QJsonObject info;
+	info.insert("modid", modid);
+	info.insert("name", "Bench mod " + modid);
+	info.insert("version", QString("1.0.0"));
+	info.insert("description", QString("Generated for benchmarking"));
+	QJsonArray infoArray;
+	infoArray.append(info);
+	if (!entry.open(QIODevice::WriteOnly, QuaZipNewInfo("mcmod.info")))
+		return false;
+	entry.write(QJsonDocument(infoArray).toJson());
+	entry.close();
+	for (int i = 0; i < classes; i++)
+	{
+		QString name = QString("org/bench/%1/Class%2.class").arg(modid).arg(i);
+		if (!entry.open(QIODevice::WriteOnly, QuaZipNewInfo(name)))
+			return false;
+		// class files are mostly incompressible, hashes are close enough
+		QByteArray body("\xCA\xFE\xBA\xBE", 4);
+		for (int j = 0; j < 64; j++)
+			body += fakeHash(name + QString::number(j), QCryptographicHash::Sha1);
+		entry.write(body);
+		entry.close();
+	}
+	zip.close();
+	return zip.getZipError() == 0;
+}
+
+inline void createModFolder(const QString &dir, int count, int classes = 10)
+{
+	for (int i = 0; i < count; i++)
+	{
+		createModJar(QDir(dir).absoluteFilePath(QString("mod%1.jar").arg(i)),
+					 QString("benchmod%1").arg(i), classes);
+	}
+}
+
+inline bool createAssetsIndex(const QString &path, int count)
+{
+	QJsonObject objects;
+	for (int i = 0; i < count; i++)
+	{
+		QString name = QString("minecraft/sounds/bench/group%1/sound%2.ogg").arg(i % 50).arg(i);
+		QJsonObject object;
+		object.insert("hash", QString::fromLatin1(fakeHash(name, QCryptographicHash::Sha1)));
+		object.insert("size", double(1000 + i * 7 % 50000));
+		objects.insert(name, object);
+	}
+	QJsonObject root;
+	root.insert("objects", objects);
+	return writeFile(path, QJsonDocument(root).toJson());
+}
+
+/// a HttpMetaCache index with entries spread over the given bases
+inline bool createCacheIndex(const QString &path, const QStringList &bases, int count)
+{
+	QJsonArray entries;
+	for (int i = 0; i < count; i++)
+	{
+		QJsonObject entry;
+		QString resource = QString("org/bench/library%1/1.0/library%1-1.0.jar").arg(i);
+		entry.insert("base", bases[i % bases.size()]);
+		entry.insert("path", resource);
+		entry.insert("md5sum", QString::fromLatin1(fakeHash(resource, QCryptographicHash::Md5)));
+		entry.insert("etag", "\"" + QString::fromLatin1(fakeHash(resource, QCryptographicHash::Sha1)) + "\"");
+		entry.insert("last_changed_timestamp", double(1420070400000LL + i));
+		entry.insert("remote_changed_timestamp", QString("Thu, 01 Jan 2015 00:00:00 GMT"));
+		entries.append(entry);
+	}
+	QJsonObject root;
+	root.insert("version", QString("1"));
+	root.insert("entries", entries);
+	return writeFile(path, QJsonDocument(root).toJson());
+}
+
+/// game output with the usual mix of plain, levelled and prefixed lines
+inline QStringList createLog(int lines, const QString &secret = QString())
+{
+	QStringList out;
+	out.reserve(lines);
+	for (int i = 0; i < lines; i++)
+	{
+		switch (i % 4)
+		{
+		case 0:
+			out.append(QString("[12:%1:%2] [Client thread/INFO]: Loading chunk %3")
+						   .arg(i / 60 % 60, 2, 10, QChar('0'))
+						   .arg(i % 60, 2, 10, QChar('0'))
+						   .arg(i));
+			break;
+		case 1:
+			out.append(QString("[12:00:00] [Server thread/WARN]: Can't keep up! Running %1ms behind")
+						   .arg(i));
+			break;
+		case 2:
+			out.append(QString("!![DEBUG]!Setting user: %1 with session %2").arg(i).arg(secret));
+			break;
+		default:
+			out.append(QString("\tat net.minecraft.bench.Frame%1.run(Frame%1.java:%2)").arg(i % 13).arg(i));
+			break;
+		}
+	}
+	return out;
+}
+}
@@ -0,0 +1,58 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+#include "BenchFixtures.h"
+
+#include "logic/assets/AssetsUtils.h"
+
+class AssetsUtilsBench : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void parseAssetsIndexJson_data()
+	{
+		QTest::addColumn<int>("objects");
+		QTest::newRow("1000") << 1000;
+		QTest::newRow("10000") << 10000;
+	}
+	void parseAssetsIndexJson()
+	{
+		QFETCH(int, objects);
+		QTemporaryDir root;
+		QString path = QDir(root.path()).absoluteFilePath("indexes/bench.json");
+		QVERIFY(BenchFixtures::createAssetsIndex(path, objects));
+		QByteArray data = TestsInternal::readFile(path);
+
+		QBENCHMARK
+		{
+			AssetsIndex index;
+			QVERIFY(AssetsUtils::parseAssetsIndexJson(data, &index));
+			QCOMPARE(index.records.size(), objects);
+		}
+	}
+
+	void loadAssetsIndexJson_data()
+	{
+		parseAssetsIndexJson_data();
+	}
+	// after the first iteration, this is the launch case of an unchanged index
+	void loadAssetsIndexJson()
+	{
+		QFETCH(int, objects);
+		QTemporaryDir root;
+		QString path = QDir(root.path()).absoluteFilePath("indexes/bench.json");
+		QVERIFY(BenchFixtures::createAssetsIndex(path, objects));
+
+		QBENCHMARK
+		{
+			AssetsIndex index;
+			QVERIFY(AssetsUtils::loadAssetsIndexJson(path, &index));
+			QCOMPARE(index.records.size(), objects);
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(AssetsUtilsBench)
+
+#include "bench_AssetsUtils.moc"
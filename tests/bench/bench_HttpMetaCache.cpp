@@ -0,0 +1,67 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+#include "BenchFixtures.h"
+
+#include "logic/net/HttpMetaCache.h"
+
+class HttpMetaCacheBench : public QObject
+{
+	Q_OBJECT
+private:
+	QStringList m_bases = {"libraries", "assets", "versions", "skins", "liteloader"};
+
+	void addBases(HttpMetaCache &cache, const QString &root)
+	{
+		for (auto base : m_bases)
+			cache.addBase(base, QDir(root).absoluteFilePath(base));
+	}
+
+private
+slots:
+	void load_data()
+	{
+		QTest::addColumn<int>("entries");
+		QTest::newRow("1000") << 1000;
+		QTest::newRow("10000") << 10000;
+	}
+	void load()
+	{
+		QFETCH(int, entries);
+		QTemporaryDir root;
+		QString index = QDir(root.path()).absoluteFilePath("metacache");
+		BenchFixtures::createCacheIndex(index, m_bases, entries);
+
+		HttpMetaCache cache(index);
+		addBases(cache, root.path());
+		QBENCHMARK
+		{
+			cache.Load();
+		}
+		QVERIFY(!cache.getEntry("libraries", "org/bench/library0/1.0/library0-1.0.jar")->stale);
+	}
+
+	void saveNow_data()
+	{
+		load_data();
+	}
+	void saveNow()
+	{
+		QFETCH(int, entries);
+		QTemporaryDir root;
+		QString index = QDir(root.path()).absoluteFilePath("metacache");
+		BenchFixtures::createCacheIndex(index, m_bases, entries);
+
+		HttpMetaCache cache(index);
+		addBases(cache, root.path());
+		cache.Load();
+		QBENCHMARK
+		{
+			cache.SaveNow();
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(HttpMetaCacheBench)
+
+#include "bench_HttpMetaCache.moc"
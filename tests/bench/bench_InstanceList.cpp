@@ -0,0 +1,37 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+#include "BenchFixtures.h"
+
+#include "logic/InstanceList.h"
+
+class InstanceListBench : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void loadList_data()
+	{
+		QTest::addColumn<int>("instances");
+		QTest::newRow("10") << 10;
+		QTest::newRow("100") << 100;
+		QTest::newRow("500") << 500;
+	}
+	void loadList()
+	{
+		QFETCH(int, instances);
+		QTemporaryDir root;
+		BenchFixtures::createInstanceTree(root.path(), instances);
+
+		InstanceList list(root.path());
+		QBENCHMARK
+		{
+			list.loadList();
+		}
+		QCOMPARE(list.count(), instances);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(InstanceListBench)
+
+#include "bench_InstanceList.moc"
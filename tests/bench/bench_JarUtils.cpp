@@ -0,0 +1,46 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+#include "BenchFixtures.h"
+
+#include "logic/JarUtils.h"
+#include "logic/Mod.h"
+
+class JarUtilsBench : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void createModdedJar_data()
+	{
+		QTest::addColumn<int>("mods");
+		QTest::addColumn<int>("classes");
+		QTest::newRow("1 mod") << 1 << 500;
+		QTest::newRow("10 mods") << 10 << 100;
+		QTest::newRow("50 mods") << 50 << 20;
+	}
+	void createModdedJar()
+	{
+		QFETCH(int, mods);
+		QFETCH(int, classes);
+		QTemporaryDir root;
+		QDir dir(root.path());
+		QString source = dir.absoluteFilePath("minecraft.jar");
+		QString target = dir.absoluteFilePath("modded.jar");
+		QVERIFY(BenchFixtures::createModJar(source, "minecraft", 2000));
+		BenchFixtures::createModFolder(dir.absoluteFilePath("jarmods"), mods, classes);
+
+		QList<Mod> modList;
+		for (auto info : QDir(dir.absoluteFilePath("jarmods")).entryInfoList(QDir::Files))
+			modList.append(Mod(info));
+
+		QBENCHMARK
+		{
+			QVERIFY(JarUtils::createModdedJar(source, target, modList));
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(JarUtilsBench)
+
+#include "bench_JarUtils.moc"
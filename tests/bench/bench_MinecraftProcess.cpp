@@ -0,0 +1,69 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+#include "BenchFixtures.h"
+
+#include "logic/InstanceFactory.h"
+#include "logic/MinecraftProcess.h"
+#include "logic/auth/AuthSession.h"
+
+/// exposes the log processing without starting a game
+class LogOnlyProcess : public MinecraftProcess
+{
+public:
+	LogOnlyProcess(InstancePtr inst) : MinecraftProcess(inst)
+	{
+	}
+	void feed(const QStringList &lines)
+	{
+		logOutput(lines, MessageLevel::Message);
+	}
+};
+
+class MinecraftProcessBench : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void logOutput_data()
+	{
+		QTest::addColumn<int>("lines");
+		QTest::addColumn<bool>("censor");
+		QTest::newRow("10000 lines") << 10000 << false;
+		QTest::newRow("10000 lines, logged in") << 10000 << true;
+	}
+	void logOutput()
+	{
+		QFETCH(int, lines);
+		QFETCH(bool, censor);
+		QTemporaryDir root;
+		BenchFixtures::createInstanceTree(root.path(), 1);
+		InstancePtr inst;
+		InstanceFactory::get().loadInstance(inst, QDir(root.path()).absoluteFilePath("instance0"));
+		QVERIFY(inst);
+
+		LogOnlyProcess process(inst);
+		QString secret;
+		if (censor)
+		{
+			auto session = std::make_shared<AuthSession>();
+			session->session = "token:0123456789abcdef:fedcba9876543210";
+			session->access_token = "0123456789abcdef";
+			session->client_token = "fedcba9876543210";
+			session->uuid = "fedcba9876543210fedcba9876543210";
+			session->player_name = "BenchPlayer";
+			session->u.properties.insert("twitch_access_token", "abcdefabcdef");
+			process.setLogin(session);
+			secret = session->access_token;
+		}
+		auto log = BenchFixtures::createLog(lines, secret);
+		QBENCHMARK
+		{
+			process.feed(log);
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(MinecraftProcessBench)
+
+#include "bench_MinecraftProcess.moc"
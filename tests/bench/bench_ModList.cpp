@@ -0,0 +1,37 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+#include "BenchFixtures.h"
+
+#include "logic/ModList.h"
+
+class ModListBench : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void update_data()
+	{
+		QTest::addColumn<int>("mods");
+		QTest::newRow("10") << 10;
+		QTest::newRow("100") << 100;
+		QTest::newRow("500") << 500;
+	}
+	void update()
+	{
+		QFETCH(int, mods);
+		QTemporaryDir root;
+		BenchFixtures::createModFolder(root.path(), mods);
+
+		ModList list(root.path());
+		QBENCHMARK
+		{
+			list.update();
+		}
+		QCOMPARE(int(list.size()), mods);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(ModListBench)
+
+#include "bench_ModList.moc"
@@ -0,0 +1,169 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QImage>
+#include <QPixmap>
+#include <QIcon>
+#include <QTranslator>
+#include <QLibraryInfo>
+#include "TestUtil.h"
+#include "BenchFixtures.h"
+
+#include "logic/StartupGraph.h"
+#include "logic/InstanceList.h"
+#include "logic/auth/MojangAccountList.h"
+#include "logic/icons/IconList.h"
+
+/*!
+ * The startup of MultiMC without a window: accounts, icons, translations, FTB packs and
+ * instances, read from a data folder of a heavy user. Runs the phases one after the other and
+ * as the application does.
+ *
+ * QTest macros only return from the phase they are in, so the phases keep what they found and
+ * it is checked once the graph is done.
+ */
+class StartupBench : public QObject
+{
+	Q_OBJECT
+private:
+	QTemporaryDir m_root;
+
+	QString path(const QString &name) const
+	{
+		return QDir(m_root.path()).absoluteFilePath(name);
+	}
+
+	static QByteArray accountList(int count)
+	{
+		QJsonArray accounts;
+		for (int i = 0; i < count; i++)
+		{
+			QJsonObject profile;
+			profile.insert("id", QString::fromLatin1(
+									 BenchFixtures::fakeHash(QString::number(i), QCryptographicHash::Md5)));
+			profile.insert("name", QString("Player%1").arg(i));
+			QJsonObject account;
+			account.insert("username", QString("player%1@example.com").arg(i));
+			account.insert("clientToken", QString("client%1").arg(i));
+			account.insert("accessToken", QString("access%1").arg(i));
+			account.insert("profiles", QJsonArray() << profile);
+			accounts.append(account);
+		}
+		QJsonObject root;
+		root.insert("formatVersion", 2);
+		root.insert("accounts", accounts);
+		return QJsonDocument(root).toJson();
+	}
+
+	static QByteArray ftbPacks(int count)
+	{
+		QByteArray xml = "<modpacks>\n";
+		for (int i = 0; i < count; i++)
+		{
+			xml += QString("<modpack name=\"Bench pack %1\" dir=\"pack%1\" logo=\"logo.png\" "
+						   "mcVersion=\"1.7.10\" version=\"1.0\" description=\"benchmark\"/>\n")
+					   .arg(i)
+					   .toUtf8();
+		}
+		return xml + "</modpacks>\n";
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+		BenchFixtures::createInstanceTree(path("instances"), 100);
+		BenchFixtures::writeFile(path("accounts.json"), accountList(10));
+		for (int i = 0; i < 60; i++)
+		{
+			QImage image(128, 128, QImage::Format_ARGB32);
+			image.fill(qRgba(i * 4, 255 - i * 4, i, 255));
+			QDir().mkpath(path("icons"));
+			image.save(path(QString("icons/icon%1.png").arg(i)));
+		}
+		BenchFixtures::writeFile(path("ftblauncher/ModPacks/modpacks.xml"), ftbPacks(30));
+		for (int i = 0; i < 30; i++)
+		{
+			QDir().mkpath(path(QString("ftb/pack%1").arg(i)));
+		}
+	}
+
+	void startup_data()
+	{
+		QTest::addColumn<bool>("serial");
+		QTest::newRow("serial") << true;
+		QTest::newRow("parallel") << false;
+	}
+	void startup()
+	{
+		QFETCH(bool, serial);
+		QBENCHMARK
+		{
+			StartupGraph graph;
+			graph.setSerial(serial);
+
+			std::shared_ptr<QTranslator> translator;
+			graph.add("Load translations", StartupGraph::Background, [&]()
+			{
+				translator.reset(new QTranslator());
+				translator->load("qt_de", QLibraryInfo::location(QLibraryInfo::TranslationsPath));
+				translator->moveToThread(QCoreApplication::instance()->thread());
+			});
+
+			QJsonDocument accountsDocument;
+			graph.add("Read accounts", StartupGraph::Background, [&]()
+			{
+				accountsDocument = MojangAccountList::readListFile(path("accounts.json"));
+			});
+			bool accountsLoaded = false;
+			int accountCount = 0;
+			graph.add("Accounts", StartupGraph::MainThread, [&]()
+			{
+				MojangAccountList accounts;
+				accountsLoaded = accounts.loadDocument(accountsDocument, path("accounts.json"));
+				accountCount = accounts.count();
+			}, {"Read accounts"});
+
+			QSet<FTBRecord> ftb;
+			graph.add("Discover FTB instances", StartupGraph::Background, [&]()
+			{
+				ftb = InstanceList::discoverFTBInstances(path("ftblauncher"), path("ftb"));
+			});
+
+			QHash<QString, QImage> images;
+			graph.add("Read icons", StartupGraph::Background, [&]()
+			{
+				images = IconList::readIcons(path("icons"));
+			});
+			QList<QIcon> icons;
+			graph.add("Icons", StartupGraph::MainThread, [&]()
+			{
+				// what IconList makes of the images
+				for (auto image : images)
+				{
+					icons.append(QIcon(QPixmap::fromImage(image)));
+				}
+			}, {"Read icons"});
+
+			int instanceCount = 0;
+			graph.add("Instances", StartupGraph::MainThread, [&]()
+			{
+				InstanceList list(path("instances"));
+				list.setDiscoveredFTBInstances(ftb);
+				list.loadList();
+				instanceCount = list.count();
+			}, {"Icons", "Discover FTB instances"});
+
+			QVERIFY(graph.run());
+			QVERIFY(translator);
+			QVERIFY(accountsLoaded);
+			QCOMPARE(accountCount, 10);
+			QCOMPARE(ftb.size(), 30);
+			QCOMPARE(icons.size(), 60);
+			QCOMPARE(instanceCount, 100);
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(StartupBench)
+
+#include "bench_Startup.moc"
@@ -0,0 +1,46 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+#include "BenchFixtures.h"
+
+#include "logic/InstanceFactory.h"
+#include "logic/OneSixInstance.h"
+#include "logic/minecraft/InstanceVersion.h"
+#include "logic/minecraft/VersionBuilder.h"
+
+class VersionBuilderBench : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void build_data()
+	{
+		QTest::addColumn<int>("libraries");
+		QTest::newRow("20") << 20;
+		QTest::newRow("200") << 200;
+	}
+	void build()
+	{
+		QFETCH(int, libraries);
+		QTemporaryDir root;
+		BenchFixtures::createInstanceTree(root.path(), 1, libraries);
+
+		InstancePtr inst;
+		auto error = InstanceFactory::get().loadInstance(
+			inst, QDir(root.path()).absoluteFilePath("instance0"));
+		QCOMPARE(error, InstanceFactory::NoLoadError);
+		auto onesix = std::dynamic_pointer_cast<OneSixInstance>(inst);
+		QVERIFY(onesix);
+
+		InstanceVersion version(onesix.get());
+		QBENCHMARK
+		{
+			VersionBuilder::build(&version, onesix.get(), QStringList());
+		}
+		QCOMPARE(version.VersionPatches.size(), 1);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(VersionBuilderBench)
+
+#include "bench_VersionBuilder.moc"
@@ -0,0 +1,139 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QIcon>
+#include "TestUtil.h"
+#include "BenchFixtures.h"
+
+#include "internal/qiconloader_p.h"
+
+using QtXdg::QIconLoader;
+
+class IconfixBench : public QObject
+{
+	Q_OBJECT
+	QTemporaryDir m_root;
+	QStringList m_present;
+	QStringList m_missing;
+
+	static QStringList contexts()
+	{
+		return {"actions", "apps", "categories", "devices", "emblems", "mimetypes", "places",
+				"status"};
+	}
+	static QList<int> sizes()
+	{
+		return {16, 22, 24, 32, 48, 64, 128, 256};
+	}
+
+	/// a theme laid out like the big desktop themes, with every icon in every size
+	void createTheme(const QString &name, int iconsPerContext)
+	{
+		const QString themeDir = QDir(m_root.path()).absoluteFilePath(name);
+		QString index = "[Icon Theme]\nName=" + name + "\nDirectories=";
+		QStringList sections;
+		QStringList dirs;
+		for (int size : sizes())
+		{
+			for (auto context : contexts())
+			{
+				QString dir = QString("%1x%1/%2").arg(size).arg(context);
+				dirs.append(dir);
+				sections.append(QString("[%1]\nSize=%2\nType=Fixed\n").arg(dir).arg(size));
+			}
+		}
+		index += dirs.join(',') + "\n\n" + sections.join('\n');
+		BenchFixtures::writeFile(themeDir + "/index.theme", index.toUtf8());
+		for (auto dir : dirs)
+		{
+			const QString context = dir.section('/', 1);
+			for (int i = 0; i < iconsPerContext; i++)
+			{
+				BenchFixtures::writeFile(
+					QString("%1/%2/%3-icon%4.png").arg(themeDir, dir, context).arg(i),
+					QByteArray());
+			}
+		}
+	}
+
+	void lookup(const QStringList &names)
+	{
+		auto loader = QIconLoader::instance();
+		for (auto name : names)
+		{
+			auto entries = loader->loadIcon(name);
+			qDeleteAll(entries);
+		}
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+		QVERIFY(m_root.isValid());
+		createTheme("benchtheme", 100);
+		QIcon::setThemeSearchPaths({m_root.path()});
+		QIconLoader::instance()->setThemeName("benchtheme");
+		for (int i = 0; i < 200; i++)
+		{
+			auto context = contexts()[i % contexts().size()];
+			m_present.append(QString("%1-icon%2").arg(context).arg(i % 100));
+			m_missing.append(QString("%1-missing%2").arg(context).arg(i));
+		}
+	}
+	void cleanupTestCase()
+	{
+		QIconLoader::instance()->setUseThemeIndex(true);
+		QIconLoader::instance()->setThemeIndexCacheDir(QString());
+	}
+
+	void loadIcon_data()
+	{
+		QTest::addColumn<bool>("indexed");
+		QTest::addColumn<bool>("present");
+		QTest::newRow("probing, present") << false << true;
+		QTest::newRow("indexed, present") << true << true;
+		QTest::newRow("probing, missing") << false << false;
+		QTest::newRow("indexed, missing") << true << false;
+	}
+	void loadIcon()
+	{
+		QFETCH(bool, indexed);
+		QFETCH(bool, present);
+		QIconLoader::instance()->setUseThemeIndex(indexed);
+		const QStringList &names = present ? m_present : m_missing;
+		// the first lookup reads the theme, and the index if there is one
+		lookup(names.mid(0, 1));
+		QBENCHMARK
+		{
+			lookup(names);
+		}
+	}
+
+	void buildIndex_data()
+	{
+		QTest::addColumn<bool>("cached");
+		QTest::newRow("scan") << false;
+		QTest::newRow("disk cache") << true;
+	}
+	void buildIndex()
+	{
+		QFETCH(bool, cached);
+		QTemporaryDir cacheDir;
+		auto loader = QIconLoader::instance();
+		loader->setThemeIndexCacheDir(cached ? cacheDir.path() : QString());
+		loader->setUseThemeIndex(true);
+		// leaves a saved index behind when caching
+		lookup(m_present.mid(0, 1));
+		QBENCHMARK
+		{
+			// drops the themes, so the next lookup reads them again
+			loader->setUseThemeIndex(true);
+			lookup(m_present.mid(0, 1));
+		}
+		loader->setThemeIndexCacheDir(QString());
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(IconfixBench)
+
+#include "bench_iconfix.moc"
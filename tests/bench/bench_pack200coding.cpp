@@ -0,0 +1,93 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "Pack200Encoder.h"
+
+/*!
+ * Decoding a band of 1M values one at a time, in batches and skipping over it.
+ *
+ * The short percentage is how many of the values fit a single byte. Real bands are mostly
+ * small values, class and member counts, bytecode offsets and characters.
+ */
+class Pack200CodingBench : public QObject
+{
+	Q_OBJECT
+	enum Method
+	{
+		Single,
+		Batched,
+		Skip
+	};
+
+private
+slots:
+	void decode_data()
+	{
+		QTest::addColumn<int>("spec");
+		QTest::addColumn<int>("shortPercent");
+		QTest::addColumn<int>("method");
+
+		struct
+		{
+			const char *name;
+			int spec;
+		} codings[] = {{"UNSIGNED5", UNSIGNED5_spec},
+					   {"DELTA5", DELTA5_spec},
+					   {"BCI5", BCI5_spec},
+					   {"CHAR3", CHAR3_spec},
+					   {"MDELTA5", MDELTA5_spec}};
+		for (auto named : codings)
+		{
+			for (int shortPercent : {70, 95})
+			{
+				auto name = QString("%1, %2% short, ").arg(named.name).arg(shortPercent);
+				QTest::newRow(qPrintable(name + "getInt")) << named.spec << shortPercent
+														   << (int)Single;
+				QTest::newRow(qPrintable(name + "getInts")) << named.spec << shortPercent
+															<< (int)Batched;
+				QTest::newRow(qPrintable(name + "parseMultiple")) << named.spec
+																  << shortPercent << (int)Skip;
+			}
+		}
+	}
+	void decode()
+	{
+		QFETCH(int, spec);
+		QFETCH(int, shortPercent);
+		QFETCH(int, method);
+
+		const int count = 1000000;
+		coding *c = coding::findBySpec(spec);
+		int length = 0;
+		QByteArray band =
+			Pack200Encoder::band(c, Pack200Encoder::sample(c, count, shortPercent, 42), &length);
+		byte *base = (byte *)band.data();
+		QVector<int> values(count);
+		int *out = values.data();
+		QBENCHMARK
+		{
+			value_stream vs;
+			vs.init(base, base + length, c);
+			switch (method)
+			{
+			case Single:
+				for (int i = 0; i < count; i++)
+				{
+					out[i] = vs.getInt();
+				}
+				break;
+			case Batched:
+				vs.getInts(out, count);
+				break;
+			case Skip:
+				coding::parseMultiple(vs.rp, count, base + length, c->B(), c->H());
+				break;
+			}
+			QCOMPARE(int(vs.rp - base), length);
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(Pack200CodingBench)
+
+#include "bench_pack200coding.moc"
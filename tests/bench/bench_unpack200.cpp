@@ -0,0 +1,135 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+#include "Pack200Encoder.h"
+
+#include <unpack200.h>
+#include <stdexcept>
+
+/*!
+ * Unpacks a pack the size of a Forge universal library: a few thousand files, some MB in all.
+ * The pack is made with Pack200Encoder and only holds resource files, so it measures the
+ * archive and file bands and the jar output rather than class reconstruction.
+ * To run on a real Forge library instead, point MMC_BENCH_PACK200 at a .pack file (a .pack.xz
+ * from the Forge maven, unxz'd).
+ */
+class Unpack200Bench : public QObject
+{
+	Q_OBJECT
+private:
+	QTemporaryDir m_root;
+	QString m_sample;
+	QByteArray m_pack;
+
+	static Pack200Encoder::Files forgeLikeFiles()
+	{
+		Pack200Encoder::Files files;
+		files.append(qMakePair(QByteArray("META-INF/MANIFEST.MF"),
+							   QByteArray("Manifest-Version: 1.0\r\n")));
+		uint32_t x = 1;
+		for (int i = 0; i < 2500; i++)
+		{
+			QByteArray name = "net/minecraftforge/bench/p" + QByteArray::number(i % 40) +
+							  "/Class" + QByteArray::number(i) + ".class";
+			// 0.2 to 3.4 KiB, some repetition as in constant pools
+			QByteArray data("\xCA\xFE\xBA\xBE", 4);
+			int size = 200 + (i * 397) % 3300;
+			while (data.size() < size)
+			{
+				x = x * 1103515245 + 12345;
+				data.append(char((x >> 16) % 3 ? (x >> 16) & 0x7F : 'a' + i % 26));
+			}
+			files.append(qMakePair(name, data));
+		}
+		return files;
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+		m_sample = QString::fromLocal8Bit(qgetenv("MMC_BENCH_PACK200"));
+		if (!m_sample.isEmpty() && QFile::exists(m_sample))
+		{
+			m_pack = TestsInternal::readFile(m_sample);
+			return;
+		}
+		m_pack = Pack200Encoder::resourceSegment(forgeLikeFiles());
+		m_sample = QDir(m_root.path()).absoluteFilePath("forge.pack");
+		QFile file(m_sample);
+		QVERIFY(file.open(QIODevice::WriteOnly));
+		QCOMPARE(file.write(m_pack), qint64(m_pack.size()));
+	}
+
+	void unpack_data()
+	{
+		QTest::addColumn<bool>("reuse");
+		QTest::newRow("files, new context") << false;
+		QTest::newRow("memory, reused context") << true;
+	}
+	void unpack()
+	{
+		QFETCH(bool, reuse);
+		QByteArray target = QDir(m_root.path()).absoluteFilePath("unpacked.jar").toLocal8Bit();
+		QByteArray source = m_sample.toLocal8Bit();
+		unpack200::Context context;
+		QBENCHMARK
+		{
+			try
+			{
+				if (reuse)
+				{
+					unpack200::MemoryInput in(m_pack.constData(), m_pack.size());
+					unpack200::MemoryOutput out;
+					context.unpack(in, out);
+				}
+				else
+				{
+					FILE *in = fopen(source.constData(), "rb");
+					FILE *out = fopen(target.constData(), "wb");
+					QVERIFY(in && out);
+					// both handles are closed by the unpacker
+					unpack_200(in, out);
+				}
+			}
+			catch (std::runtime_error &err)
+			{
+				QFAIL(err.what());
+			}
+		}
+	}
+
+	void memory_data()
+	{
+		QTest::addColumn<bool>("peak");
+		QTest::newRow("peak memory") << true;
+		QTest::newRow("allocations reused") << false;
+	}
+	void memory()
+	{
+		QFETCH(bool, peak);
+		// the second unpack gets the memory of the first
+		unpack200::Context context;
+		for (int i = 0; i < 2; i++)
+		{
+			try
+			{
+				unpack200::MemoryInput in(m_pack.constData(), m_pack.size());
+				unpack200::MemoryOutput out;
+				context.unpack(in, out);
+			}
+			catch (std::runtime_error &err)
+			{
+				QFAIL(err.what());
+			}
+		}
+		if (peak)
+			QTest::setBenchmarkResult(context.peakMemory(), QTest::BytesAllocated);
+		else
+			QTest::setBenchmarkResult(context.reusedAllocations(), QTest::Events);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(Unpack200Bench)
+
+#include "bench_unpack200.moc"
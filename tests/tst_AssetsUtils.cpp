@@ -0,0 +1,84 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "logic/assets/AssetsUtils.h"
+
+class AssetsUtilsTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_parse()
+	{
+		QByteArray json = "{\n"
+						  "  \"virtual\": true,\n"
+						  "  \"comment\": [1, {\"a\": null}, \"x\\\"y\", false],\n"
+						  "  \"objects\": {\n"
+						  "    \"icons/icon_16x16.png\": {\n"
+						  "      \"hash\": \"bdf48ef6b5d0d23bbb02e17d04865216179f510a\",\n"
+						  "      \"size\": 3665\n"
+						  "    },\n"
+						  "    \"sounds/caf\\u00e9\\/\\ud83d\\ude00.ogg\": {\"extra\": {}, \"size\": 1e2,\n"
+						  "      \"hash\": \"0000000000000000000000000000000000000001\"}\n"
+						  "  }\n"
+						  "}\n";
+		AssetsIndex index;
+		QString error;
+		QVERIFY2(AssetsUtils::parseAssetsIndexJson(json, &index, &error), qPrintable(error));
+		QVERIFY(index.isVirtual);
+		QCOMPARE(index.records.size(), 2);
+
+		QCOMPARE(index.name(index.records[0]), QString("icons/icon_16x16.png"));
+		auto icon = index.object(index.records[0]);
+		QCOMPARE(icon.hash, QString("bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+		QCOMPARE(icon.size, qint64(3665));
+
+		QCOMPARE(index.name(index.records[1]),
+				 QString::fromUtf8("sounds/caf\xC3\xA9/\xF0\x9F\x98\x80.ogg"));
+		auto sound = index.object(index.records[1]);
+		QCOMPARE(sound.hash, QString("0000000000000000000000000000000000000001"));
+		QCOMPARE(sound.size, qint64(100));
+	}
+
+	void test_parseEmpty()
+	{
+		AssetsIndex index;
+		QVERIFY(AssetsUtils::parseAssetsIndexJson("{\"objects\": {}}", &index));
+		QVERIFY(!index.isVirtual);
+		QCOMPARE(index.records.size(), 0);
+	}
+
+	void test_parseInvalid_data()
+	{
+		QTest::addColumn<QByteArray>("json");
+		QTest::newRow("empty") << QByteArray();
+		QTest::newRow("array root") << QByteArray("[]");
+		QTest::newRow("truncated") << QByteArray("{\"objects\": {\"a\": {\"hash\": ");
+		QTest::newRow("no hash") << QByteArray("{\"objects\": {\"a\": {\"size\": 1}}}");
+		QTest::newRow("short hash") << QByteArray("{\"objects\": {\"a\": {\"hash\": \"abcd\"}}}");
+		QTest::newRow("bad escape") << QByteArray("{\"obj\\qects\": {}}");
+		QTest::newRow("missing comma") << QByteArray("{\"virtual\": true \"objects\": {}}");
+		QTest::newRow("trailing garbage") << QByteArray("{\"objects\": {}} x");
+	}
+	void test_parseInvalid()
+	{
+		QFETCH(QByteArray, json);
+		AssetsIndex index;
+		QString error;
+		QVERIFY(!AssetsUtils::parseAssetsIndexJson(json, &index, &error));
+		QVERIFY(!error.isEmpty());
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(AssetsUtilsTest)
+
+#include "tst_AssetsUtils.moc"
@@ -0,0 +1,87 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "logic/java/ClassDataSharing.h"
+
+class ClassDataSharingTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_majorVersion_data()
+	{
+		QTest::addColumn<QString>("version");
+		QTest::addColumn<int>("major");
+
+		QTest::newRow("1.6") << "1.6.0_65" << 6;
+		QTest::newRow("1.8") << "1.8.0_45" << 8;
+		QTest::newRow("9") << "9" << 9;
+		QTest::newRow("11") << "11.0.2" << 11;
+		QTest::newRow("early access") << "17-ea" << 17;
+		QTest::newRow("build") << "21+35" << 21;
+		QTest::newRow("garbage") << "java" << 0;
+		QTest::newRow("empty") << "" << 0;
+	}
+	void test_majorVersion()
+	{
+		QFETCH(QString, version);
+		QFETCH(int, major);
+		QCOMPARE(ClassDataSharing::majorVersion(version), major);
+	}
+
+	void test_arguments()
+	{
+		const QString archive = "/cache/cds/abc.jsa";
+		QVERIFY(ClassDataSharing::arguments(8, ClassDataSharing::Create, archive).isEmpty());
+		QVERIFY(ClassDataSharing::arguments(12, ClassDataSharing::Use, archive).isEmpty());
+		QVERIFY(ClassDataSharing::arguments(17, ClassDataSharing::Disabled, archive).isEmpty());
+		QVERIFY(ClassDataSharing::arguments(21, ClassDataSharing::Busy, archive).isEmpty());
+
+		auto create = ClassDataSharing::arguments(13, ClassDataSharing::Create, archive);
+		QVERIFY(create.contains("-XX:ArchiveClassesAtExit=" + archive));
+		QVERIFY(create.contains("-Xshare:auto"));
+
+		auto use = ClassDataSharing::arguments(17, ClassDataSharing::Use, archive);
+		QVERIFY(use.contains("-XX:SharedArchiveFile=" + archive));
+		QVERIFY(!use.join(' ').contains("ArchiveClassesAtExit"));
+
+		// newer ones do both by themselves
+		auto automatic = ClassDataSharing::arguments(21, ClassDataSharing::Create, archive);
+		QVERIFY(automatic.contains("-XX:+AutoCreateSharedArchive"));
+		QVERIFY(automatic.contains("-XX:SharedArchiveFile=" + archive));
+	}
+
+	void test_isGameOutput_data()
+	{
+		QTest::addColumn<QString>("line");
+		QTest::addColumn<bool>("game");
+
+		QTest::newRow("launcher") << "Main Class:" << false;
+		QTest::newRow("launcher native path") << "  /home/user/instances/a/natives" << false;
+		QTest::newRow("launcher extracting") << "Extracting lwjgl-platform-2.9.1.jar" << false;
+		QTest::newRow("logger") << "[12:34:56] [Client thread/INFO]: Setting user: Player" << true;
+		QTest::newRow("logger warning") << "[01:02:03] [main/WARN]: Something" << true;
+		QTest::newRow("old user") << "Setting user: Player, 1234" << true;
+		QTest::newRow("old lwjgl") << "LWJGL Version: 2.4.2" << true;
+		QTest::newRow("empty") << "" << false;
+	}
+	void test_isGameOutput()
+	{
+		QFETCH(QString, line);
+		QFETCH(bool, game);
+		QCOMPARE(ClassDataSharing::isGameOutput(line), game);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(ClassDataSharingTest)
+
+#include "tst_ClassDataSharing.moc"
@@ -1,11 +1,15 @@
 #include <QTest>
 #include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QCryptographicHash>
 
 #include "TestUtil.h"
 
 #include "logic/updater/DownloadUpdateTask.h"
 #include "logic/updater/UpdateChecker.h"
 #include "depends/util/include/pathutils.h"
+#include "mmc_updater/src/BinaryPatch.h"
 
 DownloadUpdateTask::FileSourceList encodeBaseFile(const char *suffix)
 {
@@ -66,6 +70,9 @@ QDebug operator<<(QDebug dbg, const DownloadUpdateTask::UpdateOperation::Type &t
 	case DownloadUpdateTask::UpdateOperation::OP_CHMOD:
 		dbg << "OP_CHMOD";
 		break;
+	case DownloadUpdateTask::UpdateOperation::OP_PATCH:
+		dbg << "OP_PATCH";
+		break;
 	}
 	return dbg.maybeSpace();
 }
@@ -77,6 +84,70 @@ QDebug operator<<(QDebug dbg, const DownloadUpdateTask::UpdateOperation &u)
 	return dbg.maybeSpace();
 }
 
+/*!
+ * Serves files from memory over HTTP on localhost and counts the requests for each of them.
+ */
+class StaticHttpServer : public QTcpServer
+{
+public:
+	QMap<QString, QByteArray> files;
+	QMap<QString, int> hits;
+
+	QString url(const QString &path) const
+	{
+		return QString("http://127.0.0.1:%1%2").arg(serverPort()).arg(path);
+	}
+
+protected:
+	void incomingConnection(qintptr handle) override
+	{
+		auto socket = new QTcpSocket(this);
+		socket->setSocketDescriptor(handle);
+		auto request = std::make_shared<QByteArray>();
+		connect(socket, &QTcpSocket::readyRead, [this, socket, request]()
+		{
+			request->append(socket->readAll());
+			if (!request->contains("\r\n\r\n"))
+				return;
+			auto path = QString::fromLatin1(request->split(' ').value(1));
+			hits[path]++;
+			if (files.contains(path))
+			{
+				auto body = files[path];
+				socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\n");
+				socket->write(QString("Content-Length: %1\r\n").arg(body.size()).toLatin1());
+				socket->write("Connection: close\r\n\r\n");
+				socket->write(body);
+			}
+			else
+			{
+				socket->write("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n"
+							  "Connection: close\r\n\r\n");
+			}
+			socket->disconnectFromHost();
+		});
+		connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+	}
+};
+
+QString md5(const QByteArray &data)
+{
+	return QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex();
+}
+
+/// the same file mmc_updater/src/tests/TestBinaryPatch.cpp builds its patches for
+QByteArray randomFile(int size)
+{
+	QByteArray data;
+	quint32 x = 42;
+	for (int i = 0; i < size; i++)
+	{
+		x = x * 1103515245 + 12345;
+		data.append(char((x >> 16) & 0xFF));
+	}
+	return data;
+}
+
 class DownloadUpdateTaskTest : public QObject
 {
 	Q_OBJECT
@@ -208,6 +279,38 @@ slots:
 					   PathCombine(downloader->updateFilesDir(),
 								   QString("tests/data/fileOne").replace("/", "_")),
 					   "tests/data/fileOne", 493));
+
+		// fileTwo changed and there is a delta from the installed version
+		DownloadUpdateTask::VersionFileEntry patchedTwo{
+			"tests/data/fileTwo", 420,
+			DownloadUpdateTask::FileSourceList()
+				<< DownloadUpdateTask::FileSource("http", "http://host/path/fileTwo-3"),
+			"f12df554b21e320be6471d7154130e70"};
+		patchedTwo.deltas << DownloadUpdateTask::FileDelta{
+			"00000000000000000000000000000000", "http://host/path/fileTwo-1-3.delta",
+			"9eb84090956c484e32cb6c08455a667b"}
+						  << DownloadUpdateTask::FileDelta{
+			"38f94f54fa3eb72b0ea836538c10b043", "http://host/path/fileTwo-2-3.delta",
+			"42915a71277c9016668cce7b82c6b577"};
+		QTest::newRow("delta")
+			<< downloader << DownloadUpdateTask::VersionFileList()
+			<< (DownloadUpdateTask::VersionFileList() << patchedTwo)
+			<< (DownloadUpdateTask::UpdateOperationList()
+				<< DownloadUpdateTask::UpdateOperation::PatchOp(
+					   PathCombine(downloader->updateFilesDir(),
+								   QString("tests/data/fileTwo").replace("/", "_") + ".delta"),
+					   "tests/data/fileTwo", 420));
+
+		// no delta from the installed version, the whole file is downloaded
+		patchedTwo.deltas.removeLast();
+		QTest::newRow("no matching delta")
+			<< downloader << DownloadUpdateTask::VersionFileList()
+			<< (DownloadUpdateTask::VersionFileList() << patchedTwo)
+			<< (DownloadUpdateTask::UpdateOperationList()
+				<< DownloadUpdateTask::UpdateOperation::CopyOp(
+					   PathCombine(downloader->updateFilesDir(),
+								   QString("tests/data/fileTwo").replace("/", "_")),
+					   "tests/data/fileTwo", 420));
 	}
 	void test_processFileLists()
 	{
@@ -225,6 +328,102 @@ slots:
 		qDebug() << expectedOperations;
 		QCOMPARE(operations, expectedOperations);
 	}
+	void test_deltaDownload_data()
+	{
+		QTest::addColumn<bool>("goodDelta");
+
+		QTest::newRow("delta") << true;
+		QTest::newRow("delta with the wrong checksum") << false;
+	}
+	void test_deltaDownload()
+	{
+		QFETCH(bool, goodDelta);
+
+		// "MultiMC!" written over the middle of the old file and "v2" appended,
+		// tests/data/tst_DownloadUpdateTask-small-change.mmcdiff turns one into the other
+		QByteArray oldFile = randomFile(65536);
+		QByteArray newFile = oldFile;
+		newFile.replace(30000, 8, "MultiMC!");
+		newFile.append("v2");
+		QByteArray delta =
+			MULTIMC_GET_TEST_FILE("tests/data/tst_DownloadUpdateTask-small-change.mmcdiff");
+
+		StaticHttpServer server;
+		QVERIFY(server.listen(QHostAddress::LocalHost));
+		server.files["/old"] = oldFile;
+		server.files["/new"] = newFile;
+		server.files["/old-new.delta"] = delta;
+
+		// what is installed comes from the server too
+		const QString installed = "tst_DownloadUpdateTask-installed.bin";
+		{
+			DownloadUpdateTask::UpdateOperationList ops;
+			DownloadUpdateTask setup(QString(), -1);
+			auto job = new NetJob("Installed");
+			setup.addFileDownload(job, DownloadUpdateTask::VersionFileEntry{
+				installed, 420, DownloadUpdateTask::FileSourceList()
+									<< DownloadUpdateTask::FileSource("http", server.url("/old")),
+				md5(oldFile)}, false, ops);
+			QSignalSpy done(job, SIGNAL(succeeded()));
+			job->start();
+			QVERIFY(done.wait(10000));
+			QFile::remove(PathCombine(MMC->root(), installed));
+			QVERIFY(QFile::copy(ops.first().file, PathCombine(MMC->root(), installed)));
+			delete job;
+		}
+
+		DownloadUpdateTask task(QString(), -1);
+		DownloadUpdateTask::VersionFileEntry entry{
+			installed, 420, DownloadUpdateTask::FileSourceList()
+								<< DownloadUpdateTask::FileSource("http", server.url("/new")),
+			md5(newFile)};
+		entry.deltas << DownloadUpdateTask::FileDelta{
+			md5(oldFile), server.url("/old-new.delta"),
+			goodDelta ? md5(delta) : QString("00000000000000000000000000000000")};
+		task.m_nVersionFileList << entry;
+
+		QSignalSpy succeeded(&task, SIGNAL(succeeded()));
+		QSignalSpy failed(&task, SIGNAL(failed(QString)));
+		task.m_running = true;
+		task.processFileLists();
+		QTRY_VERIFY_WITH_TIMEOUT(succeeded.count() + failed.count() > 0, 10000);
+		QCOMPARE(failed.count(), 0);
+		QFile::remove(PathCombine(MMC->root(), installed));
+
+		QCOMPARE(task.m_operationList.size(), 1);
+		auto op = task.m_operationList.first();
+		QCOMPARE(op.dest, installed);
+		QByteArray downloaded = TestsInternal::readFile(op.file);
+		QVERIFY(TestsInternal::readFileUtf8(PathCombine(task.updateFilesDir(), "file_list.xml"))
+					.contains(QFileInfo(op.file).fileName()));
+		QCOMPARE(server.hits.value("/old-new.delta"), 1);
+		if (goodDelta)
+		{
+			QCOMPARE(op.type, DownloadUpdateTask::UpdateOperation::OP_PATCH);
+			QCOMPARE(server.hits.value("/new"), 0);
+			try
+			{
+				std::string patched = BinaryPatch::apply(
+					std::string(oldFile.constData(), oldFile.size()),
+					std::string(downloaded.constData(), downloaded.size()));
+				QCOMPARE(QByteArray(patched.data(), patched.size()), newFile);
+			}
+			catch (const std::string &error)
+			{
+				QFAIL(error.c_str());
+			}
+			// the delta is a lot smaller than the file
+			QVERIFY(downloaded.size() * 100 < newFile.size());
+		}
+		else
+		{
+			// the delta is thrown away, the whole file is downloaded instead
+			QCOMPARE(op.type, DownloadUpdateTask::UpdateOperation::OP_COPY);
+			QCOMPARE(server.hits.value("/new"), 1);
+			QCOMPARE(downloaded, newFile);
+			QVERIFY(!QFile::exists(PathCombine(task.updateFilesDir(), installed + ".delta")));
+		}
+	}
 /*
 	void test_masterTest()
 	{
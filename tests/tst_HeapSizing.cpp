@@ -0,0 +1,190 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "logic/java/HeapSizing.h"
+
+Q_DECLARE_METATYPE(HeapSizing::MemoryInfo)
+
+class HeapSizingTest : public QObject
+{
+	Q_OBJECT
+
+	static HeapSizing::Input automatic(qint64 totalMb, qint64 availableMb, int modCount)
+	{
+		HeapSizing::Input input;
+		input.automatic = true;
+		input.memory.totalMb = totalMb;
+		input.memory.availableMb = availableMb;
+		input.modCount = modCount;
+		return input;
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_parseMeminfo()
+	{
+		auto info = HeapSizing::parseMeminfo("MemTotal:       16314428 kB\n"
+											 "MemFree:         1203964 kB\n"
+											 "MemAvailable:   12000000 kB\n"
+											 "Buffers:          517160 kB\n"
+											 "HugePages_Total:       0\n");
+		QVERIFY(info.isValid());
+		QCOMPARE(info.totalMb, qint64(15932));
+		QCOMPARE(info.availableMb, qint64(11718));
+	}
+	void test_parseMeminfo_incomplete()
+	{
+		// kernels before 3.14 don't have MemAvailable
+		QVERIFY(!HeapSizing::parseMeminfo("MemTotal:       16314428 kB\n"
+										  "MemFree:         1203964 kB\n").isValid());
+		QVERIFY(!HeapSizing::parseMeminfo("").isValid());
+		QVERIFY(!HeapSizing::parseMeminfo("MemTotal: lots\nMemAvailable: some\n").isValid());
+	}
+
+	void test_manual()
+	{
+		auto input = automatic(16384, 12000, 100);
+		input.automatic = false;
+		input.manualMinMb = 700;
+		input.manualMaxMb = 1500;
+		auto choice = HeapSizing::choose(input);
+		QCOMPARE(choice.minMb, 700);
+		QCOMPARE(choice.maxMb, 1500);
+		QVERIFY(choice.gcArguments.isEmpty());
+		QCOMPARE(choice.reasons.size(), 1);
+	}
+	void test_unknownMemory()
+	{
+		HeapSizing::Input input;
+		input.automatic = true;
+		input.manualMinMb = 700;
+		input.manualMaxMb = 1500;
+		input.modCount = 100;
+		auto choice = HeapSizing::choose(input);
+		QCOMPARE(choice.minMb, 700);
+		QCOMPARE(choice.maxMb, 1500);
+		QVERIFY(choice.gcArguments.isEmpty());
+	}
+
+	void test_choose_data()
+	{
+		QTest::addColumn<HeapSizing::MemoryInfo>("memory");
+		QTest::addColumn<int>("modCount");
+		QTest::addColumn<qint64>("assetsMb");
+		QTest::addColumn<qint64>("otherHeapsMb");
+		QTest::addColumn<int>("minMb");
+		QTest::addColumn<int>("maxMb");
+		QTest::addColumn<bool>("g1");
+
+		auto memory = [](qint64 total, qint64 available)
+		{
+			HeapSizing::MemoryInfo info;
+			info.totalMb = total;
+			info.availableMb = available;
+			return info;
+		};
+		// 1024 + 10 * 24, rounded down to 64
+		QTest::newRow("vanilla-ish") << memory(4096, 3500) << 10 << qint64(0) << qint64(0) << 576
+									 << 1216 << false;
+		// 1024 + 100 * 24 + 400 / 8
+		QTest::newRow("modded") << memory(16384, 15000) << 100 << qint64(400) << qint64(0) << 1728
+								<< 3456 << true;
+		// assets count for at most 512
+		QTest::newRow("huge assets") << memory(16384, 15000) << 0 << qint64(100000) << qint64(0)
+									 << 768 << 1536 << false;
+		// 8192 - 1024 reserved - 4096 of the other instance
+		QTest::newRow("other instances") << memory(8192, 7000) << 200 << qint64(0) << qint64(4096)
+										 << 1536 << 3072 << true;
+		// 11000 - 256 available
+		QTest::newRow("little available") << memory(32768, 3000) << 200 << qint64(0) << qint64(0)
+										  << 1344 << 2688 << true;
+		QTest::newRow("floor") << memory(2048, 600) << 50 << qint64(0) << qint64(0) << 512 << 512
+							   << false;
+		QTest::newRow("ceiling") << memory(65536, 60000) << 1000 << qint64(0) << qint64(0) << 4096
+								 << 8192 << true;
+	}
+	void test_choose()
+	{
+		QFETCH(HeapSizing::MemoryInfo, memory);
+		QFETCH(int, modCount);
+		QFETCH(qint64, assetsMb);
+		QFETCH(qint64, otherHeapsMb);
+		QFETCH(int, minMb);
+		QFETCH(int, maxMb);
+		QFETCH(bool, g1);
+
+		HeapSizing::Input input;
+		input.automatic = true;
+		input.memory = memory;
+		input.modCount = modCount;
+		input.assetsMb = assetsMb;
+		input.otherHeapsMb = otherHeapsMb;
+		auto choice = HeapSizing::choose(input);
+		QCOMPARE(choice.minMb, minMb);
+		QCOMPARE(choice.maxMb, maxMb);
+		QCOMPARE(choice.gcArguments.contains("-XX:+UseG1GC"), g1);
+		QVERIFY(choice.minMb <= choice.maxMb);
+		QVERIFY(!choice.reasons.isEmpty());
+	}
+
+	void test_customGc()
+	{
+		auto input = automatic(16384, 15000, 100);
+		input.customGc = true;
+		auto choice = HeapSizing::choose(input);
+		QCOMPARE(choice.maxMb, 3392);
+		QVERIFY(choice.gcArguments.isEmpty());
+	}
+
+	void test_32bit_data()
+	{
+		QTest::addColumn<int>("javaBits");
+		QTest::addColumn<int>("maxMb");
+		QTest::newRow("32-bit") << 32 << 1024;
+		QTest::newRow("not checked yet") << 0 << 1024;
+		QTest::newRow("64-bit") << 64 << 3456;
+	}
+	void test_32bit()
+	{
+		QFETCH(int, javaBits);
+		QFETCH(int, maxMb);
+		auto input = automatic(16384, 15000, 100);
+		input.assetsMb = 400;
+		input.javaBits = javaBits;
+		auto choice = HeapSizing::choose(input);
+		QCOMPARE(choice.maxMb, maxMb);
+		QVERIFY(choice.minMb <= choice.maxMb);
+	}
+
+	void test_selectsGc_data()
+	{
+		QTest::addColumn<QStringList>("arguments");
+		QTest::addColumn<bool>("selects");
+
+		QTest::newRow("none") << QStringList() << false;
+		QTest::newRow("heap only") << QStringList({"-Xmx2G", "-XX:+DisableExplicitGC"}) << false;
+		QTest::newRow("G1") << QStringList({"-XX:+UseG1GC"}) << true;
+		QTest::newRow("CMS") << QStringList({"-Xmx2G", "-XX:+UseConcMarkSweepGC"}) << true;
+		QTest::newRow("incgc") << QStringList({"-Xincgc"}) << true;
+		QTest::newRow("disabled") << QStringList({"-XX:-UseG1GC"}) << false;
+	}
+	void test_selectsGc()
+	{
+		QFETCH(QStringList, arguments);
+		QFETCH(bool, selects);
+		QCOMPARE(HeapSizing::selectsGc(arguments), selects);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(HeapSizingTest)
+
+#include "tst_HeapSizing.moc"
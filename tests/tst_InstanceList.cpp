@@ -0,0 +1,258 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <random>
+#include "TestUtil.h"
+
+#include "logic/InstanceList.h"
+#include "logic/InstanceFactory.h"
+
+/// what a view knows about the list, from its signals alone
+struct ModelMirror
+{
+	QStringList ids;
+	int resets = 0;
+
+	void follow(InstanceList *list)
+	{
+		QObject::connect(list, &QAbstractItemModel::rowsInserted, list,
+						 [this, list](const QModelIndex &, int first, int last)
+		{
+			for (int row = first; row <= last; row++)
+				ids.insert(row, list->at(row)->id());
+		});
+		QObject::connect(list, &QAbstractItemModel::rowsRemoved, list,
+						 [this](const QModelIndex &, int first, int last)
+		{
+			for (int row = last; row >= first; row--)
+				ids.removeAt(row);
+		});
+		QObject::connect(list, &QAbstractItemModel::modelReset, list, [this, list]()
+		{
+			resets++;
+			ids.clear();
+			for (int row = 0; row < list->count(); row++)
+				ids.append(list->at(row)->id());
+		});
+	}
+};
+
+class InstanceListTest : public QObject
+{
+	Q_OBJECT
+private:
+	static bool createInstanceDir(const QDir &root, const QString &id)
+	{
+		QFile cfg(root.absoluteFilePath(id + "/instance.cfg"));
+		return root.mkpath(id) && cfg.open(QIODevice::WriteOnly) &&
+			   cfg.write(QString("InstanceType=Legacy\nname=%1\n").arg(id).toUtf8()) > 0;
+	}
+
+	static QStringList idsOnDisk(const QDir &root)
+	{
+		QStringList ids;
+		for (auto dir : root.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+		{
+			if (QFileInfo(root.absoluteFilePath(dir + "/instance.cfg")).exists())
+				ids.append(dir);
+		}
+		ids.sort();
+		return ids;
+	}
+
+	static QStringList rowIds(const InstanceList &list)
+	{
+		QStringList ids;
+		for (int row = 0; row < list.count(); row++)
+			ids.append(list.at(row)->id());
+		return ids;
+	}
+
+	static QMap<QString, QStringList> savedGroups(const QDir &root)
+	{
+		QFile file(root.absoluteFilePath("instgroups.json"));
+		QMap<QString, QStringList> groups;
+		if (!file.open(QIODevice::ReadOnly))
+			return groups;
+		auto obj = QJsonDocument::fromJson(file.readAll()).object().value("groups").toObject();
+		for (auto iter = obj.begin(); iter != obj.end(); iter++)
+		{
+			QStringList ids;
+			for (auto id : iter.value().toObject().value("instances").toArray())
+				ids.append(id.toString());
+			ids.sort();
+			groups.insert(iter.key(), ids);
+		}
+		return groups;
+	}
+
+	static QMap<QString, QStringList> instanceGroups(const InstanceList &list)
+	{
+		QMap<QString, QStringList> groups;
+		for (int row = 0; row < list.count(); row++)
+		{
+			auto inst = list.at(row);
+			if (!inst->group().isEmpty())
+				groups[inst->group()].append(inst->id());
+		}
+		for (auto &ids : groups)
+			ids.sort();
+		return groups;
+	}
+
+	static void verifyConsistent(InstanceList &list, const ModelMirror &mirror)
+	{
+		QCOMPARE(mirror.ids, rowIds(list));
+		QCOMPARE(list.rowCount(), list.count());
+		for (int row = 0; row < list.count(); row++)
+		{
+			auto inst = list.at(row);
+			QVERIFY(list.getInstanceById(inst->id()) == inst);
+			QCOMPARE(list.getInstanceIndexById(inst->id()).row(), row);
+			QCOMPARE(list.index(row).data(InstanceList::InstanceIDRole).toString(), inst->id());
+		}
+		QVERIFY(!list.getInstanceById("no such instance"));
+		QVERIFY(!list.getInstanceIndexById("no such instance").isValid());
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_randomMutations()
+	{
+		QTemporaryDir tmp;
+		QVERIFY(tmp.isValid());
+		QDir root(tmp.path());
+		for (int i = 0; i < 20; i++)
+			QVERIFY(createInstanceDir(root, QString("initial%1").arg(i)));
+
+		InstanceList list(tmp.path());
+		ModelMirror mirror;
+		mirror.follow(&list);
+		list.loadList();
+		verifyConsistent(list, mirror);
+
+		const QStringList groups = {"", "Modded", "Vanilla", "Old"};
+		std::mt19937 random(47);
+		auto pick = [&random](int count)
+		{
+			return int(random() % count);
+		};
+		int created = 0;
+		for (int step = 0; step < 300; step++)
+		{
+			switch (pick(5))
+			{
+			case 0:
+			{
+				QString id = QString("added%1").arg(created++);
+				QVERIFY(createInstanceDir(root, id));
+				InstancePtr inst;
+				QCOMPARE(InstanceFactory::get().loadInstance(inst, root.absoluteFilePath(id)),
+						 InstanceFactory::NoLoadError);
+				int row = list.add(inst);
+				QCOMPARE(row, list.count() - 1);
+				break;
+			}
+			case 1:
+				if (list.count() > 0)
+					list.at(pick(list.count()))->nuke();
+				break;
+			case 2:
+				if (list.count() > 0)
+					list.at(pick(list.count()))->setGroupPost(groups[pick(groups.size())]);
+				break;
+			case 3:
+				if (list.count() > 0)
+					list.at(pick(list.count()))->setName(QString("renamed%1").arg(step));
+				break;
+			case 4:
+			{
+				// someone else changed the folder, then the list is refreshed
+				if (pick(2))
+					QVERIFY(createInstanceDir(root, QString("external%1").arg(created++)));
+				if (list.count() > 0 && pick(2))
+					QVERIFY(QDir(list.at(pick(list.count()))->instanceRoot()).removeRecursively());
+				list.loadList();
+				break;
+			}
+			}
+			verifyConsistent(list, mirror);
+			if (QTest::currentTestFailed())
+				return;
+			auto ids = rowIds(list);
+			ids.sort();
+			QCOMPARE(ids, idsOnDisk(root));
+		}
+		// a view never had to start over
+		QCOMPARE(mirror.resets, 0);
+
+		list.saveGroupList();
+		QCOMPARE(savedGroups(root), instanceGroups(list));
+	}
+
+	void test_refreshKeepsRows()
+	{
+		QTemporaryDir tmp;
+		QDir root(tmp.path());
+		for (auto id : {"a", "b", "c", "d"})
+			QVERIFY(createInstanceDir(root, id));
+		InstanceList list(tmp.path());
+		ModelMirror mirror;
+		mirror.follow(&list);
+		list.loadList();
+		QStringList before = rowIds(list);
+
+		QVERIFY(QDir(root.absoluteFilePath("b")).removeRecursively());
+		QVERIFY(createInstanceDir(root, "e"));
+		list.loadList();
+		verifyConsistent(list, mirror);
+		before.removeAll("b");
+		before.append("e");
+		QCOMPARE(rowIds(list), before);
+	}
+
+	void test_groupsSavedLater()
+	{
+		QTemporaryDir tmp;
+		QDir root(tmp.path());
+		for (auto id : {"a", "b", "c"})
+			QVERIFY(createInstanceDir(root, id));
+		{
+			InstanceList list(tmp.path());
+			list.loadList();
+			list.getInstanceById("a")->setGroupPost("First");
+			list.getInstanceById("b")->setGroupPost("First");
+			list.getInstanceById("c")->setGroupPost("Second");
+			// a burst of changes is written once, a moment later
+			QVERIFY(!QFile::exists(root.absoluteFilePath("instgroups.json")));
+			QTRY_COMPARE(savedGroups(root), instanceGroups(list));
+
+			list.getInstanceById("c")->nuke();
+			list.getInstanceById("b")->setGroupPost("");
+		}
+		// the list writes what is still pending when it goes away
+		QMap<QString, QStringList> expected;
+		expected.insert("First", {"a"});
+		QCOMPARE(savedGroups(root), expected);
+
+		InstanceList list(tmp.path());
+		list.loadList();
+		QCOMPARE(list.getInstanceById("a")->group(), QString("First"));
+		QCOMPARE(list.getInstanceById("b")->group(), QString());
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(InstanceListTest)
+
+#include "tst_InstanceList.moc"
@@ -0,0 +1,121 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include "TestUtil.h"
+
+#include "logic/minecraft/LaunchArtifacts.h"
+
+class LaunchArtifactsTest : public QObject
+{
+	Q_OBJECT
+private:
+	static bool writeFile(const QString &path, const QByteArray &data)
+	{
+		QFile file(path);
+		return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_roundTrip()
+	{
+		QTemporaryDir tmp;
+		QDir root(tmp.path());
+		QString icon = root.absoluteFilePath("icon.png");
+		QVERIFY(writeFile(icon, "png"));
+		{
+			LaunchArtifacts artifacts(tmp.path());
+			QVERIFY(!artifacts.isCurrent("icon", "key"));
+			artifacts.record("icon", "key", icon, 42);
+			QVERIFY(artifacts.isCurrent("icon", "key"));
+			QVERIFY(artifacts.save());
+		}
+		LaunchArtifacts artifacts(tmp.path());
+		QVERIFY(artifacts.isCurrent("icon", "key"));
+		QCOMPARE(artifacts.duration("icon"), qint64(42));
+		// other inputs, or none at all, need the step to run
+		QVERIFY(!artifacts.isCurrent("icon", "other key"));
+		QVERIFY(!artifacts.isCurrent("icon", ""));
+		QVERIFY(!artifacts.isCurrent("virtualAssets", "key"));
+
+		artifacts.forget("icon");
+		QVERIFY(!artifacts.isCurrent("icon", "key"));
+		QCOMPARE(artifacts.duration("icon"), qint64(0));
+	}
+
+	void test_outputChanged()
+	{
+		QTemporaryDir tmp;
+		QDir root(tmp.path());
+		QString icon = root.absoluteFilePath("icon.png");
+		QVERIFY(writeFile(icon, "png"));
+		LaunchArtifacts artifacts(tmp.path());
+		artifacts.record("icon", "key", icon, 1);
+
+		QVERIFY(writeFile(icon, "something else"));
+		QVERIFY(!artifacts.isCurrent("icon", "key"));
+
+		artifacts.record("icon", "key", icon, 1);
+		QVERIFY(QFile::remove(icon));
+		QVERIFY(!artifacts.isCurrent("icon", "key"));
+	}
+
+	void test_folderChanged()
+	{
+		// a change deep inside the folder leaves the folder itself as it was
+		QTemporaryDir tmp;
+		QDir root(tmp.path());
+		QString virtualDir = root.absoluteFilePath("virtual/legacy");
+		QVERIFY(root.mkpath("virtual/legacy/sound/step"));
+		QString sound = root.absoluteFilePath("virtual/legacy/sound/step/grass1.ogg");
+		QVERIFY(writeFile(sound, "ogg"));
+		LaunchArtifacts artifacts(tmp.path());
+		artifacts.record("virtualAssets", "key", virtualDir, 1);
+		QVERIFY(artifacts.isCurrent("virtualAssets", "key"));
+
+		QVERIFY(writeFile(sound, "a longer ogg"));
+		QVERIFY(!artifacts.isCurrent("virtualAssets", "key"));
+
+		artifacts.record("virtualAssets", "key", virtualDir, 1);
+		QVERIFY(artifacts.isCurrent("virtualAssets", "key"));
+		QVERIFY(QFile::remove(sound));
+		QVERIFY(!artifacts.isCurrent("virtualAssets", "key"));
+
+		artifacts.record("virtualAssets", "key", virtualDir, 1);
+		QVERIFY(writeFile(root.absoluteFilePath("virtual/legacy/sound/step/grass2.ogg"), "ogg"));
+		QVERIFY(!artifacts.isCurrent("virtualAssets", "key"));
+	}
+
+	void test_broken()
+	{
+		QTemporaryDir tmp;
+		QDir root(tmp.path());
+		QVERIFY(writeFile(root.absoluteFilePath("launch-artifacts.json"), "{ not json"));
+		LaunchArtifacts artifacts(tmp.path());
+		QVERIFY(!artifacts.isCurrent("icon", "key"));
+		QVERIFY(artifacts.save());
+	}
+
+	void test_hashFile()
+	{
+		QTemporaryDir tmp;
+		QDir root(tmp.path());
+		QString path = root.absoluteFilePath("index.json");
+		QVERIFY(writeFile(path, "abc"));
+		QCOMPARE(LaunchArtifacts::hashFile(path),
+				 QString("a9993e364706816aba3e25717850c26c9cd0d89d"));
+		QCOMPARE(LaunchArtifacts::hashFile(root.absoluteFilePath("missing.json")), QString());
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(LaunchArtifactsTest)
+
+#include "tst_LaunchArtifacts.moc"
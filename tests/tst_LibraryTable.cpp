@@ -0,0 +1,206 @@
+#include <QTest>
+#include <QJsonObject>
+#include <QRegExp>
+#include "TestUtil.h"
+
+#include "logic/minecraft/GradleSpecifier.h"
+#include "logic/minecraft/InstanceVersion.h"
+#include "logic/minecraft/LibraryTable.h"
+#include "logic/minecraft/VersionFile.h"
+
+namespace
+{
+/// how the specifier used to be parsed
+struct RegExpSpecifier
+{
+	RegExpSpecifier(const QString &value)
+	{
+		QRegExp matcher("([^:@]+):([^:@]+):([^:@]+)" "(:([^:@]+))?" "(@([^:@]+))?");
+		valid = matcher.exactMatch(value);
+		auto elements = matcher.capturedTexts();
+		groupId = elements[1];
+		artifactId = elements[2];
+		version = elements[3];
+		classifier = elements[5];
+		extension = elements[7].isEmpty() ? QString("jar") : elements[7];
+	}
+	bool valid;
+	QString groupId, artifactId, version, classifier, extension;
+};
+
+/// how libraries used to be looked up
+int findLibraryByName(const QList<OneSixLibraryPtr> &haystack, const GradleSpecifier &needle)
+{
+	int retval = -1;
+	for (int i = 0; i < haystack.size(); ++i)
+	{
+		if (haystack.at(i)->rawName().artifactId() == needle.artifactId() &&
+			haystack.at(i)->rawName().groupId() == needle.groupId())
+		{
+			if (retval != -1)
+				return -1;
+			retval = i;
+		}
+	}
+	return retval;
+}
+
+QStringList names(const QList<OneSixLibraryPtr> &libraries)
+{
+	QStringList out;
+	for (auto lib : libraries)
+		out.append(lib->rawName());
+	return out;
+}
+
+RawLibraryPtr plusLibrary(const QString &name, const QString &insert)
+{
+	QJsonObject obj;
+	obj.insert("name", name);
+	obj.insert("insert", insert);
+	return RawLibrary::fromJsonPlus(obj, "test.json");
+}
+}
+
+class LibraryTableTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_parseMatchesRegExp()
+	{
+		QStringList inputs = {
+			"org.gradle.test.classifiers:service:1.0:jdk15@jar.pack.xz",
+			"a:b:c", "a:b:c:d", "a:b:c@e", "a:b:c:d@e", "a:b", "a:b:c:d:e", "a::c",
+			"a:b:c@", "@a:b:c", "a:b:c@d@e", "a:b:c@d:e", ":a:b:c", "", "I like turtles"};
+		// and a pile of short strings made of the interesting characters
+		qsrand(41);
+		const char alphabet[] = "ab:@";
+		for (int i = 0; i < 5000; i++)
+		{
+			QString input;
+			int length = qrand() % 10;
+			for (int j = 0; j < length; j++)
+				input += QChar(alphabet[qrand() % 4]);
+			inputs.append(input);
+		}
+		for (auto input : inputs)
+		{
+			RegExpSpecifier expected(input);
+			GradleSpecifier actual(input);
+			QCOMPARE(actual.valid(), expected.valid);
+			if (!expected.valid)
+				continue;
+			QCOMPARE(actual.groupId(), expected.groupId);
+			QCOMPARE(actual.artifactId(), expected.artifactId);
+			QCOMPARE(actual.version(), expected.version);
+			QCOMPARE(actual.classifier(), expected.classifier);
+			QCOMPARE(actual.extension(), expected.extension);
+			QCOMPARE(QString(actual), input);
+			QCOMPARE(actual.nameKey(), actual.artifactPrefix());
+		}
+	}
+
+	void test_tableMatchesList()
+	{
+		qsrand(42);
+		QList<OneSixLibraryPtr> reference;
+		LibraryTable table;
+		// few names, so there are plenty of duplicates and misses
+		auto randomName = []()
+		{
+			return QString("org.group%1:artifact%2:1.%3")
+				.arg(qrand() % 3)
+				.arg(qrand() % 5)
+				.arg(qrand() % 4);
+		};
+		for (int i = 0; i < 20000; i++)
+		{
+			GradleSpecifier name(randomName());
+			const int index = findLibraryByName(reference, name);
+			const auto slot = table.find(name);
+			QCOMPARE(slot >= 0, index >= 0);
+			if (index >= 0)
+			{
+				QVERIFY(table.at(slot) == reference.at(index));
+			}
+			auto library = std::make_shared<OneSixLibrary>(randomName());
+			switch (qrand() % 5)
+			{
+			case 0:
+				reference.append(library);
+				table.append(library);
+				break;
+			case 1:
+				reference.prepend(library);
+				table.prepend(library);
+				break;
+			case 2:
+				if (index >= 0)
+				{
+					reference.replace(index, library);
+					table.replace(slot, library);
+				}
+				break;
+			default:
+				if (index >= 0)
+				{
+					reference.removeAt(index);
+					table.remove(slot);
+				}
+				break;
+			}
+			QCOMPARE(table.size(), reference.size());
+		}
+		QCOMPARE(table.toList(), reference);
+	}
+
+	void test_applyTo()
+	{
+		InstanceVersion version(nullptr);
+		VersionFile vanilla;
+		vanilla.fileId = "net.minecraft";
+		vanilla.shouldOverwriteLibs = true;
+		for (auto name : {"a:one:1", "a:two:1", "b:three:1", "b:four:1"})
+		{
+			QJsonObject obj;
+			obj.insert("name", QString(name));
+			vanilla.overwriteLibs.append(RawLibrary::fromJson(obj, "vanilla.json"));
+		}
+		VersionFile patch;
+		patch.addLibs.append(plusLibrary("c:five:1", "prepend"));
+		patch.addLibs.append(plusLibrary("a:two:2", "append"));
+		patch.addLibs.append(plusLibrary("b:four:2", "replace"));
+		patch.addLibs.append(plusLibrary("c:seven:1", "append"));
+		patch.removeLibs.append("b:three:1");
+		vanilla.applyTo(&version);
+		patch.applyTo(&version);
+		QCOMPARE(names(version.libraries.toList()),
+				 QStringList({"c:five:1", "a:one:1", "a:two:2", "b:four:2", "c:seven:1"}));
+		QCOMPARE(names(version.vanillaLibraries),
+				 QStringList({"a:one:1", "a:two:1", "b:three:1", "b:four:1"}));
+	}
+
+	void test_activeNormalLibsKeepsDuplicates()
+	{
+		InstanceVersion version(nullptr);
+		version.libraries.append(std::make_shared<OneSixLibrary>("a:one:1"));
+		version.libraries.append(std::make_shared<OneSixLibrary>("a:two:1"));
+		version.libraries.append(std::make_shared<OneSixLibrary>("a:one:1"));
+		QCOMPARE(names(version.getActiveNormalLibs()),
+				 QStringList({"a:one:1", "a:two:1", "a:one:1"}));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(LibraryTableTest)
+
+#include "tst_LibraryTable.moc"
@@ -0,0 +1,194 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <quazip.h>
+#include <quazipfile.h>
+#include "TestUtil.h"
+
+#include "logic/LwjglCache.h"
+
+class LwjglCacheTest : public QObject
+{
+	Q_OBJECT
+private:
+	/// an archive laid out like the LWJGL downloads
+	static QByteArray lwjglArchive(const QByteArray &nativeContents)
+	{
+		QTemporaryDir tmp;
+		QString path = QDir(tmp.path()).absoluteFilePath("lwjgl.zip");
+		{
+			QuaZip zip(path);
+			if (!zip.open(QuaZip::mdCreate))
+				return QByteArray();
+			QuaZipFile file(&zip);
+			QList<QPair<QString, QByteArray>> entries = {
+				{"lwjgl-2.9.0/", QByteArray()},
+				{"lwjgl-2.9.0/jar/lwjgl.jar", "lwjgl classes"},
+				{"lwjgl-2.9.0/jar/lwjgl_util.jar", "util classes"},
+				{"lwjgl-2.9.0/jar/jinput.jar", "jinput classes"},
+				{"lwjgl-2.9.0/jar/unrelated.jar", "not extracted"},
+				{"lwjgl-2.9.0/native/" + LwjglCache::platformNatives() + "/native.bin",
+				 nativeContents},
+				{"lwjgl-2.9.0/native/elsewhere/other.bin", "other platform"}};
+			for (auto entry : entries)
+			{
+				if (!file.open(QIODevice::WriteOnly, QuaZipNewInfo(entry.first)))
+					return QByteArray();
+				file.write(entry.second);
+				file.close();
+			}
+			zip.close();
+		}
+		QFile file(path);
+		file.open(QIODevice::ReadOnly);
+		return file.readAll();
+	}
+
+	static QByteArray readFile(const QString &path)
+	{
+		QFile file(path);
+		file.open(QIODevice::ReadOnly);
+		return file.readAll();
+	}
+
+	static bool writeFile(const QString &path, const QByteArray &data)
+	{
+		QFile file(path);
+		return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_extract()
+	{
+		QTemporaryDir tmp;
+		LwjglCache cache(tmp.path());
+		QVERIFY(!cache.isIntact("2.9.0"));
+		QVERIFY(cache.archivePath("2.9.0").isEmpty());
+
+		QString error;
+		QString archive = cache.storeArchive(lwjglArchive("native code"), &error);
+		QVERIFY2(!archive.isEmpty(), qPrintable(error));
+		QVERIFY2(cache.extract("2.9.0", archive, &error), qPrintable(error));
+		QCOMPARE(cache.writtenFiles(), 4);
+		QVERIFY(cache.isIntact("2.9.0"));
+		QCOMPARE(cache.archivePath("2.9.0"), archive);
+
+		QDir version(cache.versionPath("2.9.0"));
+		QCOMPARE(readFile(version.absoluteFilePath("lwjgl.jar")), QByteArray("lwjgl classes"));
+		QCOMPARE(readFile(version.absoluteFilePath("lwjgl_util.jar")), QByteArray("util classes"));
+		QCOMPARE(readFile(version.absoluteFilePath("jinput.jar")), QByteArray("jinput classes"));
+		QVERIFY(!version.exists("unrelated.jar"));
+		QCOMPARE(QDir(cache.nativesPath("2.9.0")).entryList(QDir::Files),
+				 QStringList() << "native.bin");
+		QCOMPARE(readFile(QDir(cache.nativesPath("2.9.0")).absoluteFilePath("native.bin")),
+				 QByteArray("native code"));
+	}
+
+	void test_unchangedDoesNothing()
+	{
+		QTemporaryDir tmp;
+		LwjglCache cache(tmp.path());
+		QString error;
+		QByteArray data = lwjglArchive("native code");
+		QString archive = cache.storeArchive(data, &error);
+		QVERIFY(cache.extract("2.9.0", archive, &error));
+
+		QString manifest = QDir(cache.versionPath("2.9.0")).absoluteFilePath("extracted.json");
+		QDateTime manifestTime = QFileInfo(manifest).lastModified();
+		QDateTime archiveTime = QFileInfo(archive).lastModified();
+
+		// checking, storing the same download and extracting it again write nothing
+		for (int i = 0; i < 3; i++)
+		{
+			QVERIFY(cache.isIntact("2.9.0"));
+			QCOMPARE(cache.storeArchive(data, &error), archive);
+			QVERIFY(cache.extract("2.9.0", archive, &error));
+			QCOMPARE(cache.writtenFiles(), 0);
+		}
+		QCOMPARE(QFileInfo(manifest).lastModified(), manifestTime);
+		QCOMPARE(QFileInfo(archive).lastModified(), archiveTime);
+	}
+
+	void test_repair()
+	{
+		QTemporaryDir tmp;
+		LwjglCache cache(tmp.path());
+		QString error;
+		QString archive = cache.storeArchive(lwjglArchive("native code"), &error);
+		QVERIFY(cache.extract("2.9.0", archive, &error));
+
+		// a changed native and a missing jar are noticed, and only they are written again
+		QString native = QDir(cache.nativesPath("2.9.0")).absoluteFilePath("native.bin");
+		QVERIFY(writeFile(native, "broken"));
+		QVERIFY(!cache.isIntact("2.9.0"));
+		QVERIFY(QFile::remove(QDir(cache.versionPath("2.9.0")).absoluteFilePath("jinput.jar")));
+		QVERIFY(cache.extract("2.9.0", cache.archivePath("2.9.0"), &error));
+		QCOMPARE(cache.writtenFiles(), 2);
+		QVERIFY(cache.isIntact("2.9.0"));
+		QCOMPARE(readFile(native), QByteArray("native code"));
+	}
+
+	void test_newArchive()
+	{
+		QTemporaryDir tmp;
+		LwjglCache cache(tmp.path());
+		QString error;
+		QString first = cache.storeArchive(lwjglArchive("native code"), &error);
+		QVERIFY(cache.extract("2.9.0", first, &error));
+
+		// other contents are kept apart, and only what differs is written
+		QString second = cache.storeArchive(lwjglArchive("newer native code"), &error);
+		QVERIFY(!second.isEmpty());
+		QVERIFY(second != first);
+		QVERIFY(cache.extract("2.9.0", second, &error));
+		QCOMPARE(cache.writtenFiles(), 1);
+		QCOMPARE(cache.archivePath("2.9.0"), second);
+		QVERIFY(cache.isIntact("2.9.0"));
+	}
+
+	void test_olderExtraction()
+	{
+		// what older versions of MultiMC left behind: the files and a 'done' file
+		QTemporaryDir tmp;
+		LwjglCache cache(tmp.path());
+		QDir version(cache.versionPath("2.9.0"));
+		QVERIFY(version.mkpath("natives"));
+		for (auto jar : {"lwjgl.jar", "lwjgl_util.jar", "jinput.jar"})
+			QVERIFY(writeFile(version.absoluteFilePath(jar), "classes"));
+		QVERIFY(writeFile(version.absoluteFilePath("natives/native.bin"), "native code"));
+		QVERIFY(!cache.isIntact("2.9.0"));
+
+		QVERIFY(writeFile(version.absoluteFilePath("done"), "done."));
+		QVERIFY(cache.isIntact("2.9.0"));
+		// from now on, changes are noticed
+		QVERIFY(writeFile(version.absoluteFilePath("natives/native.bin"), "changed"));
+		QVERIFY(!cache.isIntact("2.9.0"));
+		// there is no archive to repair it from
+		QVERIFY(cache.archivePath("2.9.0").isEmpty());
+	}
+
+	void test_notAnArchive()
+	{
+		QTemporaryDir tmp;
+		LwjglCache cache(tmp.path());
+		QString error;
+		QString archive = cache.storeArchive("not a zip", &error);
+		QVERIFY(!archive.isEmpty());
+		QVERIFY(!cache.extract("2.9.0", archive, &error));
+		QVERIFY(!error.isEmpty());
+		QVERIFY(!cache.isIntact("2.9.0"));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(LwjglCacheTest)
+
+#include "tst_LwjglCache.moc"
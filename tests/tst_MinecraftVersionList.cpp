@@ -0,0 +1,86 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include "TestUtil.h"
+
+#include "logic/minecraft/MinecraftVersionList.h"
+
+/// loads the list from a test URL instead of the Mojang servers
+class TestListLoadTask : public MCVListLoadTask
+{
+public:
+	TestListLoadTask(MinecraftVersionList *list, const QUrl &url) : MCVListLoadTask(list)
+	{
+		m_url = url;
+	}
+};
+
+/// answers every request with a 404
+class NotFoundServer : public QTcpServer
+{
+protected:
+	void incomingConnection(qintptr handle) override
+	{
+		auto socket = new QTcpSocket(this);
+		socket->setSocketDescriptor(handle);
+		connect(socket, &QTcpSocket::readyRead, [socket]()
+		{
+			if (!socket->readAll().contains("\r\n\r\n"))
+				return;
+			socket->write("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n"
+						  "Connection: close\r\n\r\n");
+			socket->disconnectFromHost();
+		});
+		connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+	}
+};
+
+class MinecraftVersionListTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_failedDownload_data()
+	{
+		QTest::addColumn<bool>("reachable");
+		QTest::newRow("server not reachable") << false;
+		QTest::newRow("list not found") << true;
+	}
+	void test_failedDownload()
+	{
+		QFETCH(bool, reachable);
+		NotFoundServer server;
+		QVERIFY(server.listen(QHostAddress::LocalHost));
+		QUrl url(QString("http://127.0.0.1:%1/versions.json").arg(server.serverPort()));
+		if (!reachable)
+		{
+			// nothing listens on the port any more
+			server.close();
+		}
+
+		MinecraftVersionList list;
+		TestListLoadTask task(&list, url);
+		QSignalSpy failed(&task, SIGNAL(failed(QString)));
+		QSignalSpy succeeded(&task, SIGNAL(succeeded()));
+		task.start();
+		QVERIFY(failed.count() || failed.wait(10000));
+		QCOMPARE(succeeded.count(), 0);
+		QVERIFY(!task.isRunning());
+		QVERIFY(!task.successful());
+		QVERIFY(!task.failReason().isEmpty());
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(MinecraftVersionListTest)
+
+#include "tst_MinecraftVersionList.moc"
@@ -0,0 +1,97 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include "TestUtil.h"
+
+#include "logic/RecursiveFileSystemWatcher.h"
+
+class RecursiveFileSystemWatcherTest : public QObject
+{
+	Q_OBJECT
+private:
+	static bool writeFile(const QString &path, const QByteArray &data,
+						  QIODevice::OpenMode mode = QIODevice::WriteOnly)
+	{
+		QFile file(path);
+		return file.open(mode) && file.write(data) == data.size();
+	}
+
+	/// what the spy saw so far, column 0 added, 1 removed, 2 changed
+	static QStringList reported(const QSignalSpy &spy, int column)
+	{
+		QStringList files;
+		for (auto &arguments : spy)
+		{
+			files += arguments.at(column).toStringList();
+		}
+		return files;
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_nested()
+	{
+		QTemporaryDir tmp;
+		QDir root(tmp.path());
+		QVERIFY(root.mkpath("logs/old"));
+		QVERIFY(writeFile(root.absoluteFilePath("logs/latest.log"), "start\n"));
+		QVERIFY(writeFile(root.absoluteFilePath("logs/old/1.log"), "old\n"));
+		QVERIFY(writeFile(root.absoluteFilePath("logs/old/notes.txt"), "ignored\n"));
+
+		RecursiveFileSystemWatcher watcher(nullptr);
+		watcher.setFileExpression(".*\\.log$");
+		watcher.setRootDir(root);
+		watcher.enable();
+		QCOMPARE(watcher.files(), QStringList() << "logs/latest.log" << "logs/old/1.log");
+
+		QSignalSpy spy(&watcher, SIGNAL(filesChanged(QStringList, QStringList, QStringList)));
+
+		// added, in a new directory as well
+		QVERIFY(root.mkpath("logs/old/2015"));
+		QVERIFY(writeFile(root.absoluteFilePath("logs/old/2015/2.log"), "new\n"));
+		QTRY_VERIFY(reported(spy, 0).contains("logs/old/2015/2.log"));
+		QVERIFY(watcher.files().contains("logs/old/2015/2.log"));
+
+		// changed in place, the directory itself doesn't change
+		spy.clear();
+		QVERIFY(writeFile(root.absoluteFilePath("logs/old/1.log"), "more\n",
+						  QIODevice::WriteOnly | QIODevice::Append));
+		QTRY_COMPARE(reported(spy, 2), QStringList() << "logs/old/1.log");
+		QVERIFY(writeFile(root.absoluteFilePath("logs/old/2015/2.log"), "more\n",
+						  QIODevice::WriteOnly | QIODevice::Append));
+		QTRY_VERIFY(reported(spy, 2).contains("logs/old/2015/2.log"));
+		QVERIFY(reported(spy, 0).isEmpty());
+		QVERIFY(reported(spy, 1).isEmpty());
+
+		// removed
+		spy.clear();
+		QVERIFY(QFile::remove(root.absoluteFilePath("logs/old/1.log")));
+		QTRY_COMPARE(reported(spy, 1), QStringList() << "logs/old/1.log");
+		QVERIFY(QDir(root.absoluteFilePath("logs/old/2015")).removeRecursively());
+		QTRY_VERIFY(reported(spy, 1).contains("logs/old/2015/2.log"));
+		QCOMPARE(watcher.files(), QStringList() << "logs/latest.log");
+
+		// nothing is reported while disabled, and enabling catches up
+		watcher.disable();
+		spy.clear();
+		QVERIFY(writeFile(root.absoluteFilePath("logs/latest.log"), "end\n",
+						  QIODevice::WriteOnly | QIODevice::Append));
+		QTest::qWait(500);
+		QCOMPARE(spy.count(), 0);
+		watcher.enable();
+		QCOMPARE(reported(spy, 2), QStringList() << "logs/latest.log");
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(RecursiveFileSystemWatcherTest)
+
+#include "tst_RecursiveFileSystemWatcher.moc"
@@ -0,0 +1,175 @@
+#include <QTest>
+#include <QThread>
+#include <QMutex>
+#include <stdexcept>
+#include "TestUtil.h"
+
+#include "logic/StartupGraph.h"
+
+class StartupGraphTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_order()
+	{
+		StartupGraph graph;
+		QMutex lock;
+		QStringList order;
+		auto record = [&](const QString &name)
+		{
+			return [&, name]()
+			{
+				QMutexLocker locker(&lock);
+				order.append(name);
+			};
+		};
+		graph.add("c", StartupGraph::MainThread, record("c"), {"a", "b"});
+		graph.add("a", StartupGraph::Background, record("a"));
+		graph.add("b", StartupGraph::MainThread, record("b"), {"a"});
+		graph.add("d", StartupGraph::MainThread, record("d"));
+		QVERIFY(graph.run());
+		QCOMPARE(order.size(), 4);
+		QVERIFY(order.indexOf("a") < order.indexOf("b"));
+		QVERIFY(order.indexOf("b") < order.indexOf("c"));
+		for (auto phase : graph.phases())
+		{
+			QVERIFY(graph.isDone(phase));
+			QVERIFY(graph.duration(phase) >= 0);
+		}
+		QCOMPARE(graph.summary().size(), 4);
+
+		// everything ran already
+		QVERIFY(graph.run());
+		QCOMPARE(order.size(), 4);
+	}
+
+	void test_threads()
+	{
+		StartupGraph graph;
+		QThread *main = nullptr;
+		QThread *background = nullptr;
+		graph.add("main", StartupGraph::MainThread, [&]()
+		{
+			main = QThread::currentThread();
+		});
+		graph.add("background", StartupGraph::Background, [&]()
+		{
+			background = QThread::currentThread();
+		});
+		QVERIFY(graph.run());
+		QCOMPARE(main, QThread::currentThread());
+		QVERIFY(background != nullptr);
+		QVERIFY(background != QThread::currentThread());
+	}
+
+	void test_parallel()
+	{
+		// the main thread works while the background phase is running
+		StartupGraph graph;
+		QAtomicInt running;
+		bool overlapped = false;
+		graph.add("background", StartupGraph::Background, [&]()
+		{
+			running.ref();
+			QThread::msleep(200);
+			running.deref();
+		});
+		graph.add("main", StartupGraph::MainThread, [&]()
+		{
+			for (int i = 0; i < 100 && !overlapped; i++)
+			{
+				overlapped = running.load() > 0;
+				QThread::msleep(5);
+			}
+		});
+		QVERIFY(graph.run());
+		QVERIFY(overlapped);
+	}
+
+	void test_serial()
+	{
+		StartupGraph graph;
+		graph.setSerial(true);
+		QThread *background = nullptr;
+		graph.add("background", StartupGraph::Background, [&]()
+		{
+			background = QThread::currentThread();
+		});
+		QVERIFY(graph.run());
+		QCOMPARE(background, QThread::currentThread());
+		QCOMPARE(graph.summary(), QStringList() << QString("background: %1 ms")
+															  .arg(graph.duration("background")));
+	}
+
+	void test_targets()
+	{
+		StartupGraph graph;
+		QStringList ran;
+		graph.add("a", StartupGraph::MainThread, [&]() { ran.append("a"); });
+		graph.add("b", StartupGraph::MainThread, [&]() { ran.append("b"); }, {"a"});
+		graph.add("later", StartupGraph::MainThread, [&]() { ran.append("later"); }, {"a"});
+		QVERIFY(graph.run({"b"}));
+		QCOMPARE(ran, QStringList() << "a" << "b");
+		QVERIFY(!graph.isDone("later"));
+		QCOMPARE(graph.duration("later"), qint64(-1));
+
+		QVERIFY(graph.run());
+		QCOMPARE(ran, QStringList() << "a" << "b" << "later");
+	}
+
+	void test_broken()
+	{
+		bool ran = false;
+		StartupGraph missing;
+		missing.add("a", StartupGraph::MainThread, [&]() { ran = true; }, {"nothing"});
+		QVERIFY(!missing.run());
+		QVERIFY(!missing.run({"nothing"}));
+
+		StartupGraph circle;
+		circle.add("a", StartupGraph::MainThread, [&]() { ran = true; }, {"b"});
+		circle.add("b", StartupGraph::Background, [&]() { ran = true; }, {"a"});
+		QVERIFY(!circle.run());
+		QVERIFY(!ran);
+	}
+
+	void test_failingBackground()
+	{
+		// a failing background phase is logged, what comes after still runs
+		StartupGraph graph;
+		bool after = false;
+		graph.add("fails", StartupGraph::Background, []()
+		{
+			throw std::runtime_error("broken");
+		});
+		graph.add("after", StartupGraph::MainThread, [&]() { after = true; }, {"fails"});
+		QVERIFY(graph.run());
+		QVERIFY(after);
+	}
+
+	void test_trace()
+	{
+		auto trace = std::make_shared<Trace>("startup");
+		StartupGraph graph(trace);
+		graph.add("Settings", StartupGraph::MainThread, []() {});
+		graph.add("Read icons", StartupGraph::Background, []() {}, {"Settings"});
+		QVERIFY(graph.run());
+		QCOMPARE(trace->summary().size(), 2);
+		auto summary = trace->summary().join('\n');
+		QVERIFY2(summary.contains("Settings took") && summary.contains("Read icons took"),
+				 qPrintable(summary));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(StartupGraphTest)
+
+#include "tst_StartupGraph.moc"
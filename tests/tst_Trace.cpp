@@ -0,0 +1,79 @@
+#include <QTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "TestUtil.h"
+
+#include "logic/Trace.h"
+
+class TraceTest : public QObject
+{
+	Q_OBJECT
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_chromeTrace()
+	{
+		Trace trace("test");
+		int outer = trace.begin("outer", "task");
+		int inner = trace.begin("inner", "net");
+		trace.addBytes(inner, 2048);
+		trace.addCacheResults(inner, 3, 1);
+		trace.end(inner);
+		trace.mark("point", "launch");
+		trace.end(outer);
+		trace.begin("open", "task");
+
+		auto events = QJsonDocument::fromJson(trace.toChromeTrace())
+						  .object()
+						  .value("traceEvents")
+						  .toArray();
+		// the process name, three spans and the mark
+		QCOMPARE(events.size(), 5);
+
+		auto outerEvent = events[1].toObject();
+		QCOMPARE(outerEvent.value("name").toString(), QString("outer"));
+		QCOMPARE(outerEvent.value("ph").toString(), QString("X"));
+
+		auto innerEvent = events[2].toObject();
+		auto innerArgs = innerEvent.value("args").toObject();
+		QCOMPARE(innerEvent.value("cat").toString(), QString("net"));
+		QCOMPARE(innerArgs.value("bytes").toInt(), 2048);
+		QCOMPARE(innerArgs.value("cache_hits").toInt(), 3);
+		QCOMPARE(innerArgs.value("cache_misses").toInt(), 1);
+		// nested spans stay within their parent
+		QVERIFY(innerEvent.value("ts").toDouble() >= outerEvent.value("ts").toDouble());
+		QVERIFY(innerEvent.value("ts").toDouble() + innerEvent.value("dur").toDouble() <=
+				outerEvent.value("ts").toDouble() + outerEvent.value("dur").toDouble());
+
+		QCOMPARE(events[3].toObject().value("ph").toString(), QString("i"));
+		QVERIFY(events[4].toObject().value("args").toObject().value("unfinished").toBool());
+	}
+
+	void test_summary()
+	{
+		Trace trace("test");
+		int span = trace.begin("download", "net");
+		trace.addCacheResults(span, 1, 2);
+		trace.end(span);
+		trace.begin("open", "task");
+
+		auto lines = trace.summary();
+		QCOMPARE(lines.size(), 2);
+		QVERIFY(lines[0].contains("download took"));
+		QVERIFY(lines[0].contains("1 cached, 2 fetched"));
+		QVERIFY(lines[1].contains("(unfinished)"));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(TraceTest)
+
+#include "tst_Trace.moc"
@@ -0,0 +1,116 @@
+#include <QTest>
+#include <QTemporaryDir>
+#include <quazip.h>
+#include <quazipfile.h>
+#include "TestUtil.h"
+
+#include <javautils.h>
+
+class ClassParserTest : public QObject
+{
+	Q_OBJECT
+private:
+	static QByteArray u2(int value)
+	{
+		QByteArray out;
+		out.append(char(value >> 8));
+		out.append(char(value & 0xFF));
+		return out;
+	}
+	static QByteArray utf8(const QByteArray &value)
+	{
+		return QByteArray(1, 1) + u2(value.size()) + value;
+	}
+	/// a class without members, with a long and an invokedynamic in its constant pool
+	static QByteArray makeClass(const QByteArray &name, const QByteArray &extra = QByteArray())
+	{
+		QByteArray out("\xCA\xFE\xBA\xBE", 4);
+		out += u2(0) + u2(52);
+		out += u2(10);
+		out += utf8(name);
+		out += QByteArray(1, 7) + u2(1);
+		out += utf8("java/lang/Object");
+		out += QByteArray(1, 7) + u2(3);
+		out += QByteArray(1, 5) + QByteArray(8, 0);
+		out += utf8("Minecraft Minecraft 1.7.10");
+		out += QByteArray(1, 18) + u2(0) + u2(0);
+		out += utf8(extra);
+		// public super, this, super, no interfaces, fields, methods or attributes
+		out += u2(0x21) + u2(2) + u2(4) + u2(0) + u2(0) + u2(0) + u2(0);
+		return out;
+	}
+	static bool makeJar(const QString &path, const QList<QPair<QString, QByteArray>> &files)
+	{
+		QuaZip zip(path);
+		if (!zip.open(QuaZip::mdCreate))
+			return false;
+		QuaZipFile file(&zip);
+		for (auto &entry : files)
+		{
+			if (!file.open(QIODevice::WriteOnly, QuaZipNewInfo(entry.first)))
+				return false;
+			file.write(entry.second);
+			file.close();
+		}
+		zip.close();
+		return zip.getZipError() == 0;
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_GetMinecraftJarVersion()
+	{
+		QTemporaryDir root;
+		QString jar = QDir(root.path()).absoluteFilePath("minecraft.jar");
+		QVERIFY(makeJar(jar, {qMakePair(QString("net/minecraft/client/Minecraft.class"),
+										 makeClass("net/minecraft/client/Minecraft"))}));
+		QCOMPARE(javautils::GetMinecraftJarVersion(jar), QString("1.7.10"));
+	}
+
+	void test_IndexJarClasses()
+	{
+		QTemporaryDir root;
+		QDir dir(root.path());
+		QString first = dir.absoluteFilePath("first.jar");
+		QString second = dir.absoluteFilePath("second.jar");
+		QString broken = dir.absoluteFilePath("broken.jar");
+		QVERIFY(makeJar(first, {qMakePair(QString("a/Same.class"), makeClass("a/Same")),
+								qMakePair(QString("a/Changed.class"), makeClass("a/Changed")),
+								qMakePair(QString("a/Only.class"), makeClass("a/Only")),
+								qMakePair(QString("readme.txt"), QByteArray("hi"))}));
+		QVERIFY(makeJar(second, {qMakePair(QString("a/Same.class"), makeClass("a/Same")),
+								 qMakePair(QString("a/Changed.class"),
+										   makeClass("a/Changed", "different"))}));
+		QVERIFY(makeJar(broken, {qMakePair(QString("a/Broken.class"),
+										   makeClass("a/Broken").left(30))}));
+
+		auto index = javautils::IndexJarClasses(
+			{first, second, broken, dir.absoluteFilePath("missing.jar")});
+		QCOMPARE(index.classes.size(), 5);
+		QCOMPARE(index.errors.size(), 2);
+		QCOMPARE(index.classes[0].jar, first);
+		QCOMPARE(index.classes[0].superName, QString("java/lang/Object"));
+		QCOMPARE(index.classes[0].majorVersion, 52);
+
+		auto conflicts = javautils::FindClassConflicts(index);
+		QCOMPARE(conflicts.size(), 2);
+		for (auto &conflict : conflicts)
+		{
+			QCOMPARE(conflict.jars, QStringList({first, second}));
+			QCOMPARE(conflict.differs, conflict.name == "a/Changed");
+		}
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(ClassParserTest)
+
+#include "tst_classparser.moc"
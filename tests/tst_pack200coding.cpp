@@ -0,0 +1,135 @@
+#include <QTest>
+#include "TestUtil.h"
+
+#include "Pack200Encoder.h"
+
+class Pack200CodingTest : public QObject
+{
+	Q_OBJECT
+private:
+	static value_stream stream(QByteArray &band, int length, coding *c)
+	{
+		byte *base = (byte *)band.data();
+		value_stream vs;
+		vs.init(base, base + length, c);
+		return vs;
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_getInts_data()
+	{
+		QTest::addColumn<int>("B");
+		QTest::addColumn<int>("H");
+		QTest::addColumn<int>("S");
+		QTest::addColumn<int>("D");
+		QTest::addColumn<int>("shortPercent");
+
+		// the hand optimized codings
+		QTest::newRow("BYTE1") << 1 << 256 << 0 << 0 << 100;
+		QTest::newRow("CHAR3") << 3 << 128 << 0 << 0 << 70;
+		QTest::newRow("UNSIGNED5") << 5 << 64 << 0 << 0 << 70;
+		QTest::newRow("DELTA5") << 5 << 64 << 1 << 1 << 70;
+		QTest::newRow("BCI5") << 5 << 4 << 0 << 0 << 70;
+		QTest::newRow("BRANCH5") << 5 << 4 << 2 << 0 << 70;
+		// and the generic ones
+		QTest::newRow("SIGNED5") << 5 << 64 << 1 << 0 << 70;
+		QTest::newRow("UDELTA5") << 5 << 64 << 0 << 1 << 70;
+		QTest::newRow("MDELTA5") << 5 << 64 << 2 << 1 << 70;
+		QTest::newRow("(5,16,2,0)") << 5 << 16 << 2 << 0 << 70;
+		QTest::newRow("(2,192) subrange") << 2 << 192 << 0 << 0 << 70;
+		QTest::newRow("(2,8,0,1) subrange delta") << 2 << 8 << 0 << 1 << 70;
+		QTest::newRow("(3,16,1,1) subrange delta") << 3 << 16 << 1 << 1 << 70;
+		QTest::newRow("(5,4,2,1) subrange delta") << 5 << 4 << 2 << 1 << 70;
+		QTest::newRow("(4,256) fixed size") << 4 << 256 << 0 << 0 << 0;
+		QTest::newRow("(3,100,2,1) arbitrary") << 3 << 100 << 2 << 1 << 70;
+		// long runs of single bytes, and none at all
+		QTest::newRow("UNSIGNED5 mostly short") << 5 << 64 << 0 << 0 << 99;
+		QTest::newRow("UNSIGNED5 all long") << 5 << 64 << 0 << 0 << 0;
+	}
+	void test_getInts()
+	{
+		QFETCH(int, B);
+		QFETCH(int, H);
+		QFETCH(int, S);
+		QFETCH(int, D);
+		QFETCH(int, shortPercent);
+
+		coding *c = coding::findBySpec(B, H, S, D);
+		QVERIFY(c != nullptr);
+		const int count = 20000;
+		auto values = Pack200Encoder::sample(c, count, shortPercent, 42);
+		int length = 0;
+		QByteArray band = Pack200Encoder::band(c, values, &length);
+
+		// one value at a time is the reference
+		QVector<int> expected(count);
+		auto single = stream(band, length, c);
+		for (int i = 0; i < count; i++)
+		{
+			expected[i] = single.getInt();
+		}
+		byte *base = (byte *)band.data();
+		QCOMPARE(int(single.rp - base), length);
+		if (S == 0 && D == 0)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				QCOMPARE((uint32_t)expected[i], values[i]);
+			}
+		}
+
+		// all at once
+		QVector<int> all(count);
+		auto batched = stream(band, length, c);
+		batched.getInts(all.data(), count);
+		QCOMPARE(all, expected);
+		QCOMPARE(int(batched.rp - base), length);
+		QCOMPARE(batched.sum, single.sum);
+
+		// in pieces of every size, so runs are cut everywhere
+		QVector<int> pieces(count);
+		auto piecewise = stream(band, length, c);
+		for (int i = 0, size = 1; i < count; i += size, size = size % 300 + 1)
+		{
+			piecewise.getInts(pieces.data() + i, qMin(size, count - i));
+		}
+		QCOMPARE(pieces, expected);
+		QCOMPARE(int(piecewise.rp - base), length);
+
+		// skipping finds the same end
+		byte *rp = base;
+		coding::parseMultiple(rp, count, base + length, B, H);
+		QCOMPARE(int(rp - base), length);
+
+		c->free();
+	}
+
+	void test_getInts_eof()
+	{
+		coding *c = coding::findBySpec(UNSIGNED5_spec);
+		auto values = Pack200Encoder::sample(c, 100, 70, 7);
+		int length = 0;
+		QByteArray band = Pack200Encoder::band(c, values, &length);
+		QVector<int> out(101);
+		auto vs = stream(band, length, c);
+		QVERIFY_EXCEPTION_THROWN(vs.getInts(out.data(), 101), std::runtime_error);
+
+		byte *rp = (byte *)band.data();
+		QVERIFY_EXCEPTION_THROWN(coding::parseMultiple(rp, 101, rp + length, 5, 64),
+								 std::runtime_error);
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(Pack200CodingTest)
+
+#include "tst_pack200coding.moc"
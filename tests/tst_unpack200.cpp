@@ -0,0 +1,216 @@
+#include <QTest>
+#include <QBuffer>
+#include <QTemporaryFile>
+#include <quazip.h>
+#include <quazipfile.h>
+#include "TestUtil.h"
+
+#include "Pack200Encoder.h"
+#include <unpack200.h>
+#include <stdexcept>
+
+using Pack200Encoder::Files;
+
+class Unpack200Test : public QObject
+{
+	Q_OBJECT
+private:
+	/// the files of a jar, in order
+	static Files readJar(QByteArray jar)
+	{
+		QBuffer buffer(&jar);
+		QuaZip zip(&buffer);
+		Files files;
+		if (!zip.open(QuaZip::mdUnzip))
+			return files;
+		QuaZipFile file(&zip);
+		for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile())
+		{
+			if (!file.open(QIODevice::ReadOnly))
+				return Files();
+			files.append(qMakePair(zip.getCurrentFileName().toUtf8(), file.readAll()));
+			file.close();
+		}
+		return files;
+	}
+
+	static QByteArray unpack(unpack200::Context &context, const QByteArray &pack)
+	{
+		unpack200::MemoryInput in(pack.constData(), pack.size());
+		unpack200::MemoryOutput out;
+		context.unpack(in, out);
+		return QByteArray(out.data.data(), int(out.data.size()));
+	}
+
+	/// deterministic contents, as compressible as class files are not
+	static QByteArray contents(int size, uint32_t seed)
+	{
+		QByteArray data;
+		auto values = Pack200Encoder::sample(coding::findBySpec(1, 256, 0, 0), size, 100, seed);
+		for (auto value : values)
+			data.append(char(value));
+		return data;
+	}
+
+	static Files someFiles(int count, const QByteArray &prefix)
+	{
+		Files files;
+		for (int i = 0; i < count; i++)
+		{
+			files.append(qMakePair(prefix + QByteArray::number(i) + ".txt",
+								   contents((i * 397) % 3000, i + 1)));
+		}
+		return files;
+	}
+
+private
+slots:
+	void initTestCase()
+	{
+
+	}
+	void cleanupTestCase()
+	{
+
+	}
+
+	void test_multipleFiles()
+	{
+		Files files = someFiles(40, "assets/file");
+		files.append(qMakePair(QByteArray("META-INF/MANIFEST.MF"),
+							   QByteArray("Manifest-Version: 1.0\r\n")));
+		files.append(qMakePair(QByteArray("empty"), QByteArray()));
+		unpack200::Context context;
+		QCOMPARE(readJar(unpack(context, Pack200Encoder::resourceSegment(files))), files);
+	}
+
+	void test_multipleSegments()
+	{
+		Files first = someFiles(10, "first/");
+		Files second = someFiles(200, "second/");
+		QByteArray pack = Pack200Encoder::resourceSegment(first) +
+						  Pack200Encoder::resourceSegment(Files()) +
+						  Pack200Encoder::resourceSegment(second);
+		unpack200::Context context;
+		QCOMPARE(readJar(unpack(context, pack)), first + second);
+		// the second segment gets the memory of the first
+		QVERIFY(context.reusedAllocations() > 0);
+	}
+
+	void test_devices()
+	{
+		Files files = someFiles(30, "");
+		QByteArray pack = Pack200Encoder::resourceSegment(files);
+		QBuffer input(&pack);
+		QVERIFY(input.open(QIODevice::ReadOnly));
+		QTemporaryFile output;
+		QVERIFY(output.open());
+
+		unpack200::Context context;
+		unpack200::QIODeviceInput in(&input);
+		unpack200::QIODeviceOutput out(&output);
+		context.unpack(in, out);
+		output.seek(0);
+		QByteArray jar = output.readAll();
+		QCOMPARE(jar, unpack(context, pack));
+		QCOMPARE(readJar(jar), files);
+	}
+
+	void test_files()
+	{
+		Files files = someFiles(5, "");
+		QByteArray pack = Pack200Encoder::resourceSegment(files);
+		QTemporaryFile packFile, jarFile;
+		QVERIFY(packFile.open() && jarFile.open());
+		packFile.write(pack);
+		packFile.close();
+		jarFile.close();
+		FILE *in = fopen(QFile::encodeName(packFile.fileName()).constData(), "rb");
+		FILE *out = fopen(QFile::encodeName(jarFile.fileName()).constData(), "wb");
+		QVERIFY(in && out);
+		// closes both
+		unpack_200(in, out);
+		QVERIFY(jarFile.open());
+		QCOMPARE(readJar(jarFile.readAll()), files);
+	}
+
+	void test_copyJar()
+	{
+		// a pack that is a jar already is copied as it is
+		unpack200::Context context;
+		QByteArray jar = unpack(context, Pack200Encoder::resourceSegment(someFiles(3, "")));
+		QCOMPARE(unpack(context, jar), jar);
+	}
+
+	void test_reuse()
+	{
+		QByteArray pack = Pack200Encoder::resourceSegment(someFiles(100, "a/")) +
+						  Pack200Encoder::resourceSegment(someFiles(100, "b/"));
+		unpack200::Context context;
+		QByteArray jar = unpack(context, pack);
+		const size_t peak = context.peakMemory();
+		QVERIFY(peak > 0);
+		QVERIFY(context.keptMemory() > 0);
+
+		// later calls run entirely on the memory of the first
+		for (int i = 0; i < 5; i++)
+		{
+			const uint64_t allocations = context.allocations();
+			const uint64_t reused = context.reusedAllocations();
+			QCOMPARE(unpack(context, pack), jar);
+			QCOMPARE(context.reusedAllocations() - reused, context.allocations() - allocations);
+			QCOMPARE(context.peakMemory(), peak);
+		}
+
+		context.releaseMemory();
+		QCOMPARE(context.keptMemory(), size_t(0));
+		QCOMPARE(unpack(context, pack), jar);
+	}
+
+	void test_memoryLimit()
+	{
+		// one big file needs a big input buffer
+		Files files = someFiles(20, "");
+		files.append(qMakePair(QByteArray("big.bin"), contents(1 << 20, 7)));
+		QByteArray pack = Pack200Encoder::resourceSegment(files);
+
+		unpack200::Context context;
+		context.setMemoryLimit(256 << 10);
+		QCOMPARE(context.memoryLimit(), size_t(256 << 10));
+		try
+		{
+			unpack(context, pack);
+			QFAIL("the unpacker needs more than the limit");
+		}
+		catch (std::runtime_error &)
+		{
+		}
+		QVERIFY(context.peakMemory() <= size_t(256 << 10));
+
+		// everything went back, so the context can go on
+		context.setMemoryLimit(8 << 20);
+		context.resetPeakMemory();
+		QCOMPARE(readJar(unpack(context, pack)), files);
+		QVERIFY(context.peakMemory() > size_t(1 << 20));
+		QVERIFY(context.peakMemory() <= size_t(8 << 20));
+	}
+
+	void test_corrupt()
+	{
+		QByteArray pack = Pack200Encoder::resourceSegment(someFiles(10, ""));
+		unpack200::Context context;
+		try
+		{
+			unpack(context, pack.left(pack.size() - 100));
+			QFAIL("a truncated pack must not unpack");
+		}
+		catch (std::runtime_error &)
+		{
+		}
+		QCOMPARE(readJar(unpack(context, pack)), someFiles(10, ""));
+	}
+};
+
+QTEST_GUILESS_MAIN_MULTIMC(Unpack200Test)
+
+#include "tst_unpack200.moc"